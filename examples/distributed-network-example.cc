@@ -0,0 +1,210 @@
+/*
+ * This program simulates end devices around two gateways with a
+ * DistributedLoraChannel, for instance on two ranks with
+ *
+ *   mpirun -np 2 ./ns3 run distributed-network-example
+ *
+ * Gateways, and the end devices on their side, are split between ranks, while
+ * the network server runs on rank 0. Each end device sends a single packet,
+ * at a time when no other one is transmitting, so that outcomes only depend on
+ * the received power. Rank 0 prints the PHY and MAC counts of the whole
+ * network, merged from the trackers of all ranks.
+ *
+ * On a single rank, the same scenario is also simulated with a LoraChannel,
+ * and the program fails if results differ.
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/distributed-lora-channel.h"
+#include "ns3/forwarder-helper.h"
+#include "ns3/global-value.h"
+#include "ns3/log.h"
+#include "ns3/lorawan-helper.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/mpi-interface.h"
+#include "ns3/network-server-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/one-shot-sender-helper.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/position-allocator.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+
+#include <iostream>
+
+using namespace ns3;
+using namespace lorawan;
+
+NS_LOG_COMPONENT_DEFINE("DistributedNetworkExample");
+
+// Network settings
+int nDevices = 16;
+double spacing = 450;
+
+/**
+ * Simulate the network and count packets.
+ *
+ * \param distributed Whether to use a DistributedLoraChannel or a LoraChannel.
+ * \return The PHY and MAC counts, of the whole network at rank 0 and of the
+ *         packets sent by local devices at other ranks.
+ */
+std::string
+RunScenario(bool distributed)
+{
+    uint32_t nRanks = MpiInterface::GetSize();
+
+    // Delay of the links between gateways and server, also used as lookahead
+    Time linkDelay = MilliSeconds(2);
+
+    /************************
+     *  Create the channel  *
+     ************************/
+
+    Ptr<LogDistancePropagationLossModel> loss = CreateObject<LogDistancePropagationLossModel>();
+    loss->SetPathLossExponent(3.76);
+    loss->SetReference(1, 7.7);
+
+    Ptr<PropagationDelayModel> delay = CreateObject<ConstantSpeedPropagationDelayModel>();
+
+    Ptr<LoraChannel> channel;
+    if (distributed)
+    {
+        channel = CreateObject<DistributedLoraChannel>(loss, delay);
+        channel->SetAttribute("Lookahead", TimeValue(linkDelay));
+    }
+    else
+    {
+        channel = CreateObject<LoraChannel>(loss, delay);
+    }
+
+    /************************
+     *  Create the helpers  *
+     ************************/
+
+    LoraPhyHelper phyHelper;
+    phyHelper.SetChannel(channel);
+    LorawanMacHelper macHelper;
+    LorawanHelper helper;
+    helper.EnablePacketTracking();
+
+    /*************************************
+     *  Create gateways and end devices  *
+     *************************************/
+
+    // Gateway g on rank g, end devices on the side of their closest gateway
+    NodeContainer gateways;
+    Ptr<ListPositionAllocator> gwAllocator = CreateObject<ListPositionAllocator>();
+    for (uint32_t g = 0; g < 2; ++g)
+    {
+        gateways.Create(1, g % nRanks);
+        gwAllocator->Add(Vector((g == 0) ? -3000 : 3000, 0, 15));
+    }
+
+    NodeContainer endDevices;
+    Ptr<ListPositionAllocator> edAllocator = CreateObject<ListPositionAllocator>();
+    for (int i = 0; i < nDevices; ++i)
+    {
+        bool right = i % 2;
+        endDevices.Create(1, (right ? 1 : 0) % nRanks);
+        double x = (200 + spacing * i) * (right ? 1 : -1);
+        edAllocator->Add(Vector(x, 0, 1.2));
+    }
+
+    MobilityHelper mobility;
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mobility.SetPositionAllocator(gwAllocator);
+    mobility.Install(gateways);
+    mobility.SetPositionAllocator(edAllocator);
+    mobility.Install(endDevices);
+
+    phyHelper.SetType("ns3::GatewayLoraPhy");
+    macHelper.SetType("ns3::GatewayLorawanMac");
+    helper.Install(phyHelper, macHelper, gateways);
+
+    macHelper.SetAddressGenerator(CreateObject<LoraDeviceAddressGenerator>(54, 1864));
+    phyHelper.SetType("ns3::EndDeviceLoraPhy");
+    macHelper.SetType("ns3::ClassAEndDeviceLorawanMac");
+    helper.Install(phyHelper, macHelper, endDevices);
+
+    LorawanMacHelper::SetSpreadingFactorsUp(endDevices, gateways, channel);
+
+    /*********************************************
+     *  Install applications on the end devices  *
+     *********************************************/
+
+    // Transmissions do not overlap, so that channel selection does not matter
+    OneShotSenderHelper appHelper;
+    for (int i = 0; i < nDevices; ++i)
+    {
+        appHelper.SetSendTime(Seconds(1 + 4 * i));
+        appHelper.Install(endDevices.Get(i));
+    }
+    Time stopTime = Seconds(4 * nDevices + 10);
+
+    /**************************
+     *  Create Network Server  *
+     ***************************/
+
+    NodeContainer networkServer;
+    networkServer.Create(1, 0);
+
+    // Links between ranks, bounding the lookahead of the simulator
+    PointToPointHelper p2p;
+    p2p.SetDeviceAttribute("DataRate", StringValue("5Mbps"));
+    p2p.SetChannelAttribute("Delay", TimeValue(linkDelay));
+    for (auto gw = gateways.Begin(); gw != gateways.End(); ++gw)
+    {
+        p2p.Install(networkServer.Get(0), *gw);
+    }
+
+    NetworkServerHelper nsHelper;
+    nsHelper.SetEndDevices(endDevices);
+    nsHelper.Install(networkServer);
+
+    ForwarderHelper forHelper;
+    forHelper.Install(gateways);
+
+    ////////////////
+    // Simulation //
+    ////////////////
+
+    Simulator::Stop(stopTime);
+    Simulator::Run();
+
+    LoraPacketTracker& tracker = helper.GetPacketTracker();
+    tracker.MergeRanks();
+    std::string result = tracker.PrintPhyPacketsGlobally(Seconds(0), stopTime) + " | " +
+                         tracker.CountMacPacketsGlobally(Seconds(0), stopTime);
+
+    Simulator::Destroy();
+    return result;
+}
+
+int
+main(int argc, char* argv[])
+{
+    GlobalValue::Bind("SimulatorImplementationType", StringValue("ns3::DistributedSimulatorImpl"));
+    MpiInterface::Enable(&argc, &argv);
+
+    CommandLine cmd;
+    cmd.AddValue("nDevices", "Number of end devices to include in the simulation", nDevices);
+    cmd.AddValue("spacing", "Distance between consecutive end devices (m)", spacing);
+    cmd.Parse(argc, argv);
+
+    std::string result = RunScenario(true);
+    if (MpiInterface::GetSystemId() == 0)
+    {
+        // sent received interfered noMoreReceivers busyGateway underSensitivity | sent received
+        std::cout << result << std::endl;
+    }
+
+    if (MpiInterface::GetSize() == 1)
+    {
+        std::string reference = RunScenario(false);
+        NS_ABORT_MSG_IF(result != reference,
+                        "Results differ from the ones of a LoraChannel: " << reference);
+    }
+
+    MpiInterface::Disable();
+    return 0;
+}
@@ -0,0 +1,359 @@
+/*
+ * This program measures the time taken by operations on the hot paths of
+ * LoRaWAN simulations, for instance with
+ *
+ *   ./ns3 run "lorawan-benchmark --output=baseline.csv"
+ *
+ * Each benchmark repeats an operation until a run lasts at least minTime, and
+ * keeps the fastest of several runs. Results are printed as CSV lines
+ * (benchmark,parameter,iterations,ns_per_op), so that the output of two
+ * builds can be compared to catch regressions. Random inputs are drawn with
+ * the default seed, so that runs are repeatable.
+ */
+
+#include "ns3/LoRaMacCrypto.h"
+#include "ns3/core-module.h"
+#include "ns3/logical-channel-manager.h"
+#include "ns3/lora-frame-header.h"
+#include "ns3/lora-interference-helper.h"
+#include "ns3/lora-phy.h"
+#include "ns3/lorawan-mac-header.h"
+#include "ns3/udp-forwarder.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+using namespace ns3;
+using namespace lorawan;
+
+NS_LOG_COMPONENT_DEFINE("LorawanBenchmark");
+
+/**
+ * Run benchmarks and print their results.
+ */
+class Benchmark
+{
+  public:
+    /**
+     * \param out The stream of results.
+     * \param filter Only run benchmarks whose name contains this string.
+     * \param minTime The minimum duration of a run (s).
+     * \param runs The number of runs of each benchmark.
+     */
+    Benchmark(std::ostream& out, const std::string& filter, double minTime, uint32_t runs)
+        : m_out(out),
+          m_filter(filter),
+          m_minTime(minTime),
+          m_runs(runs),
+          m_sink(0)
+    {
+        m_out << "benchmark,parameter,iterations,ns_per_op" << std::endl;
+    }
+
+    /**
+     * Measure an operation.
+     *
+     * \param name The name of the benchmark.
+     * \param parameter The parameter of the benchmark.
+     * \param op The operation, returning a value that is kept so that the
+     * compiler cannot remove it.
+     */
+    template <typename Op>
+    void Run(const std::string& name, const std::string& parameter, Op op)
+    {
+        if (name.find(m_filter) == std::string::npos)
+        {
+            return;
+        }
+
+        // Double the iterations until a run is long enough
+        uint64_t iterations = 1;
+        double elapsed = Measure(op, iterations);
+        while (elapsed < m_minTime)
+        {
+            iterations *= 2;
+            elapsed = Measure(op, iterations);
+        }
+        double best = elapsed;
+        for (uint32_t run = 1; run < m_runs; ++run)
+        {
+            best = std::min(best, Measure(op, iterations));
+        }
+        m_out << name << "," << parameter << "," << iterations << "," << best * 1e9 / iterations
+              << std::endl;
+    }
+
+    /**
+     * \return The combination of the values returned by operations.
+     */
+    uint64_t GetSink() const
+    {
+        return m_sink;
+    }
+
+  private:
+    /**
+     * Repeat an operation.
+     *
+     * \param op The operation.
+     * \param iterations The number of repetitions.
+     * \return The time taken (s).
+     */
+    template <typename Op>
+    double Measure(Op& op, uint64_t iterations)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            m_sink += uint64_t(op());
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    }
+
+    std::ostream& m_out;  //!< Stream of results
+    std::string m_filter; //!< Filter of benchmark names
+    double m_minTime;     //!< Minimum duration of a run (s)
+    uint32_t m_runs;      //!< Number of runs of each benchmark
+    uint64_t m_sink;      //!< Combination of the values returned by operations
+};
+
+/**
+ * Measure the computation of time on air for all spreading factors.
+ *
+ * \param bench The benchmark runner.
+ */
+void
+BenchmarkTimeOnAir(Benchmark& bench)
+{
+    Ptr<Packet> packet = Create<Packet>(20);
+    LoraPhyTxParameters params;
+    for (uint8_t sf = 7; sf <= 12; ++sf)
+    {
+        params.sf = sf;
+        params.lowDataRateOptimizationEnabled = sf >= 11;
+        bench.Run("LoraPhy::GetTimeOnAir", "sf=" + std::to_string(sf), [&]() {
+            return LoraPhy::GetTimeOnAir(packet, params).GetTimeStep();
+        });
+    }
+}
+
+/**
+ * Measure the outcome of a reception overlapping a number of interferers.
+ *
+ * \param bench The benchmark runner.
+ */
+void
+BenchmarkInterference(Benchmark& bench)
+{
+    const double frequencies[] = {868100000, 868300000, 868500000};
+    auto rng = CreateObject<UniformRandomVariable>();
+    for (uint32_t density : {10, 100, 1000})
+    {
+        auto interference = CreateObject<LoraInterferenceHelper>();
+        interference->SetIsolationMatrix(LoraInterferenceHelper::GOURSAUD);
+        auto event = interference->Add(Seconds(2), -110, 9, nullptr, frequencies[0]);
+        // Interferers starting during the reception
+        for (uint32_t i = 0; i < density; ++i)
+        {
+            Time start = Seconds(rng->GetValue(0, 2));
+            Time duration = Seconds(rng->GetValue(0.05, 1.5));
+            double rxPower = rng->GetValue(-130, -90);
+            uint8_t sf = rng->GetInteger(7, 12);
+            double frequency = frequencies[rng->GetInteger(0, 2)];
+            Simulator::Schedule(start, [=]() {
+                interference->Add(duration, rxPower, sf, nullptr, frequency);
+            });
+        }
+        Simulator::Schedule(Seconds(2), [&bench, interference, event, density]() {
+            bench.Run("LoraInterferenceHelper::IsDestroyedByInterference",
+                      "interferers=" + std::to_string(density),
+                      [&]() { return interference->IsDestroyedByInterference(event); });
+        });
+        Simulator::Run();
+        Simulator::Destroy();
+    }
+}
+
+/**
+ * Measure the serialization and deserialization of headers.
+ *
+ * \param bench The benchmark runner.
+ */
+void
+BenchmarkHeaders(Benchmark& bench)
+{
+    Buffer buffer;
+    buffer.AddAtStart(64);
+
+    LorawanMacHeader mHdr;
+    mHdr.SetFType(LorawanMacHeader::UNCONFIRMED_DATA_UP);
+    bench.Run("LorawanMacHeader::Serialize+Deserialize", "", [&]() {
+        mHdr.Serialize(buffer.Begin());
+        LorawanMacHeader deserialized;
+        deserialized.Deserialize(buffer.Begin());
+        return deserialized.GetFType();
+    });
+
+    for (bool fOpts : {false, true})
+    {
+        LoraFrameHeader fHdr;
+        fHdr.SetAsUplink();
+        fHdr.SetAddress(LoraDeviceAddress(1, 1864));
+        fHdr.SetAdr(true);
+        fHdr.SetFCnt(42);
+        fHdr.SetFPort(1);
+        if (fOpts)
+        {
+            fHdr.AddLinkCheckReq();
+            fHdr.AddLinkAdrAns(true, true, true);
+            fHdr.AddDutyCycleAns();
+        }
+        bench.Run("LoraFrameHeader::Serialize+Deserialize",
+                  "fOptsLen=" + std::to_string(fHdr.GetFOptsLen()),
+                  [&]() {
+                      fHdr.Serialize(buffer.Begin());
+                      LoraFrameHeader deserialized;
+                      deserialized.SetAsUplink();
+                      deserialized.Deserialize(buffer.Begin());
+                      return deserialized.GetFCnt();
+                  });
+    }
+}
+
+/**
+ * Measure the computation of MICs and the encryption of payloads.
+ *
+ * \param bench The benchmark runner.
+ */
+void
+BenchmarkCrypto(Benchmark& bench)
+{
+    LoRaMacCrypto crypto;
+    uint8_t msg[255];
+    for (uint16_t i = 0; i < 255; ++i)
+    {
+        msg[i] = i * 7 + 20;
+    }
+    for (uint16_t len : {20, 64, 255})
+    {
+        bench.Run("LoRaMacCrypto::ComputeCmacB0", "len=" + std::to_string(len), [&]() {
+            uint32_t mic = 0;
+            crypto.ComputeCmacB0(msg, len, F_NWK_S_INT_KEY, false, UPLINK, 0x26011234, 42, &mic);
+            return mic;
+        });
+        bench.Run("LoRaMacCrypto::PayloadEncrypt", "len=" + std::to_string(len), [&]() {
+            crypto.PayloadEncrypt(msg, len, APP_S_KEY, 0x26011234, UPLINK, 42);
+            return msg[0];
+        });
+    }
+}
+
+/**
+ * Measure the JSON serialization of uplinks and parsing of downlinks of the
+ * UDP forwarder.
+ *
+ * \param bench The benchmark runner.
+ */
+void
+BenchmarkUdpForwarder(Benchmark& bench)
+{
+    lgw_pkt_rx_s rxpkt = {};
+    rxpkt.freq_hz = 868100000;
+    rxpkt.status = STAT_CRC_OK;
+    rxpkt.count_us = 3512348611;
+    rxpkt.modulation = MOD_LORA;
+    rxpkt.bandwidth = BW_125KHZ;
+    rxpkt.datarate = DR_LORA_SF9;
+    rxpkt.coderate = CR_LORA_4_5;
+    rxpkt.rssi = -112.5;
+    rxpkt.snr = 3.25;
+    rxpkt.size = 20;
+    for (uint16_t i = 0; i < rxpkt.size; ++i)
+    {
+        rxpkt.payload[i] = i;
+    }
+    char buff[TX_BUFF_SIZE];
+    bench.Run("UdpForwarder::SerializeRxpk", "size=20", [&]() {
+        return UdpForwarder::SerializeRxpk(rxpkt, buff, sizeof buff);
+    });
+
+    const char* txpk = "{\"txpk\":{\"imme\":false,\"tmst\":3513348611,\"freq\":869.525,\"rfch\":0,"
+                       "\"powe\":27,\"modu\":\"LORA\",\"datr\":\"SF9BW125\",\"codr\":\"4/5\","
+                       "\"ipol\":true,\"size\":32,"
+                       "\"data\":\"AAECAwQFBgcICQoLDA0ODxAREhMUFRYXGBkaGxwdHh8=\"}}";
+    bench.Run("UdpForwarder::ParseTxpk", "size=32", [&]() {
+        lgw_pkt_tx_s txpkt;
+        jit_error_e error;
+        UdpForwarder::ParseTxpk(txpk, 0, txpkt, error);
+        return txpkt.size;
+    });
+}
+
+/**
+ * Measure the duty cycle queries of the channel manager of end devices.
+ *
+ * \param bench The benchmark runner.
+ */
+void
+BenchmarkChannelManager(Benchmark& bench)
+{
+    auto manager = CreateObject<LogicalChannelManager>();
+    manager->AddSubBand(868000000, 868600000, 0.01, 14);
+    manager->AddSubBand(869400000, 869650000, 0.1, 27);
+    for (uint8_t i = 0; i < 3; ++i)
+    {
+        manager->AddChannel(i, Create<LogicalChannel>(868100000 + i * 200000));
+    }
+    Ptr<const LogicalChannel> channel = manager->GetChannel(0);
+    manager->AddEvent(MilliSeconds(100), channel);
+
+    bench.Run("LogicalChannelManager::GetWaitingTime", "", [&]() {
+        return manager->GetWaitingTime(channel).GetTimeStep();
+    });
+    bench.Run("LogicalChannelManager::GetMinWaitingTime", "", [&]() {
+        return manager->GetMinWaitingTime().GetTimeStep();
+    });
+    bench.Run("LogicalChannelManager::GetAggregatedWaitingTime", "", [&]() {
+        return manager->GetAggregatedWaitingTime(0.01).GetTimeStep();
+    });
+    bench.Run("LogicalChannelManager::GetEnabledChannelList", "", [&]() {
+        return manager->GetEnabledChannelList().size();
+    });
+}
+
+int
+main(int argc, char* argv[])
+{
+    std::string output = "";
+    std::string filter = "";
+    double minTime = 0.1;
+    uint32_t runs = 3;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("output", "File of results, instead of the standard output", output);
+    cmd.AddValue("filter", "Only run benchmarks whose name contains this string", filter);
+    cmd.AddValue("minTime", "Minimum duration of a run of a benchmark (s)", minTime);
+    cmd.AddValue("runs", "Number of runs of each benchmark, keeping the fastest", runs);
+    cmd.Parse(argc, argv);
+
+    std::ofstream file;
+    if (!output.empty())
+    {
+        file.open(output);
+        NS_ABORT_MSG_IF(!file.is_open(), "Unable to open " << output);
+    }
+    Benchmark bench(output.empty() ? std::cout : file, filter, minTime, runs);
+
+    BenchmarkTimeOnAir(bench);
+    BenchmarkInterference(bench);
+    BenchmarkHeaders(bench);
+    BenchmarkCrypto(bench);
+    BenchmarkUdpForwarder(bench);
+    BenchmarkChannelManager(bench);
+
+    NS_LOG_DEBUG("Sink: " << bench.GetSink());
+    return 0;
+}
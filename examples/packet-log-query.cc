@@ -0,0 +1,92 @@
+/*
+ * This program reads a binary packet log, written by the LoraPacketTracker
+ * after EnableBinaryLog, and prints the reports of the tracker over a time
+ * interval.
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/lora-packet-log.h"
+
+#include <iostream>
+
+using namespace ns3;
+using namespace lorawan;
+
+NS_LOG_COMPONENT_DEFINE("PacketLogQuery");
+
+int
+main(int argc, char* argv[])
+{
+    std::string filename = "packets.bin";
+    std::string report = "global";
+    double startSeconds = 0;
+    double stopSeconds = 1e9;
+
+    CommandLine cmd;
+    cmd.AddValue("file", "The binary packet log to read", filename);
+    cmd.AddValue("report",
+                 "The report to print: global, gws, devices, mac, cpsr, or records",
+                 report);
+    cmd.AddValue("start", "Start of the interval of sent packets (s)", startSeconds);
+    cmd.AddValue("stop", "End of the interval of sent packets (s)", stopSeconds);
+    cmd.Parse(argc, argv);
+
+    LoraPacketLogReader reader(filename);
+    Time start = Seconds(startSeconds);
+    Time stop = Seconds(stopSeconds);
+
+    if (report == "global")
+    {
+        // sent received interfered noMoreReceivers busyGateway underSensitivity
+        std::cout << reader.PrintPhyPacketsGlobally(start, stop) << std::endl;
+    }
+    else if (report == "gws")
+    {
+        GwsPhyPktCount gws;
+        reader.CountPhyPacketsAllGws(start, stop, gws);
+        for (const auto& gw : gws)
+        {
+            std::cout << gw.first << " " << LoraPacketTracker::PrintCounts(gw.second.v)
+                      << std::endl;
+        }
+    }
+    else if (report == "devices")
+    {
+        DevPktCount devices;
+        reader.CountAllDevicesPackets(start, stop, devices);
+        for (const auto& device : devices)
+        {
+            std::cout << device.first << " " << device.second.sent << " "
+                      << device.second.received << std::endl;
+        }
+    }
+    else if (report == "mac")
+    {
+        std::cout << reader.CountMacPacketsGlobally(start, stop) << std::endl;
+    }
+    else if (report == "cpsr")
+    {
+        std::cout << reader.CountMacPacketsGloballyCpsr(start, stop) << std::endl;
+    }
+    else if (report == "records")
+    {
+        LoraPacketLogRecord record;
+        while (reader.Next(record))
+        {
+            if (record.time < start || record.time > stop)
+            {
+                continue;
+            }
+            std::cout << record.time.GetSeconds() << " " << record.uid << " " << record.node
+                      << " " << unsigned(record.type) << " " << unsigned(record.outcome) << " "
+                      << unsigned(record.dataRate) << " " << record.size << " " << record.rxPower
+                      << " " << record.snr << std::endl;
+        }
+    }
+    else
+    {
+        NS_ABORT_MSG("Unknown report " << report);
+    }
+
+    return 0;
+}
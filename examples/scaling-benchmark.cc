@@ -0,0 +1,663 @@
+/*
+ * This program measures how end-to-end simulations scale, sweeping the number
+ * of devices, gateway rings, interference matrices and traffic models, for
+ * instance with
+ *
+ *   ./ns3 run "scaling-benchmark --devices=1000,10000,100000,1000000
+ *     --rings=1,3 --sir=CROCE,GOURSAUD --traffic=periodic,poisson,urban
+ *     --output=scaling.csv"
+ *
+ * Scenarios follow complete-network-example: end devices around a hexagonal
+ * grid of gateways, connected by point-to-point links to the in-simulator
+ * network server. Each one runs in a child process, so that its peak memory is
+ * measured alone and a crash does not stop the sweep. Results are printed as
+ * CSV lines, one per scenario, so that the reports of two releases can be
+ * compared:
+ *
+ *  - setup and run wall times (ms), executed events and events per second;
+ *  - peak resident set size (KiB);
+ *  - uplinks sent and received by the server, when packet tracking is on;
+ *  - wall time (ms) and memory allocations by layer.
+ *
+ * Layers are charged for the events they schedule, from the event type: the
+ * time from the removal of an event from the scheduler to the removal of the
+ * next one, and the allocations in between. Trace sinks run within the event
+ * of their source, so the in-simulation cost of the packet tracker is the
+ * difference between runs with --tracking=true,false, while its tracker column
+ * accounts for the computation of the final statistics. Profiling itself adds
+ * two clock reads per event.
+ *
+ * After the sweep, the heap memory taken by each device of a
+ * LoraDevicePopulation of --population devices is measured and checked
+ * against the about 60 bytes of its per-device tables, plus 8 bytes in the key
+ * store. The program fails if devices take more than twice as much, the most
+ * slack left by the growth of the tables.
+ */
+
+#include "utilities.cc"
+
+// ns3 imports
+#include "ns3/core-module.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/okumura-hata-propagation-loss-model.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/propagation-delay-model.h"
+#include "ns3/scheduler.h"
+
+// lorawan imports
+#include "ns3/forwarder-helper.h"
+#include "ns3/hex-grid-position-allocator.h"
+#include "ns3/lora-application.h"
+#include "ns3/lora-device-population.h"
+#include "ns3/lorawan-helper.h"
+#include "ns3/network-server-helper.h"
+#include "ns3/periodic-sender-helper.h"
+#include "ns3/range-position-allocator.h"
+#include "ns3/urban-traffic-helper.h"
+
+// cpp imports
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <functional>
+#include <iostream>
+#include <malloc.h>
+#include <sstream>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <typeindex>
+#include <unistd.h>
+
+using namespace ns3;
+using namespace lorawan;
+
+NS_LOG_COMPONENT_DEFINE_EXAMPLE_WITH_UTILITIES("ScalingBenchmark");
+
+/**
+ * Parts of the simulation charged for time and allocations.
+ */
+enum Layer : uint8_t
+{
+    SETUP,   //!< Construction of the scenario
+    APP,     //!< Applications of end devices
+    MAC,     //!< MAC layers of end devices and gateways
+    PHY,     //!< PHY layers and channel
+    SERVER,  //!< Forwarders, backhaul and network server
+    OTHER,   //!< Other events, e.g., the end of the simulation
+    TRACKER, //!< Computation of the statistics of the packet tracker
+    N_LAYERS,
+};
+
+const char* layerNames[N_LAYERS] = {"setup", "app", "mac", "phy", "server", "other", "tracker"};
+
+std::atomic<uint8_t> g_layer(SETUP);                //!< Layer currently running
+std::chrono::steady_clock::time_point g_layerStart; //!< Time the current layer started
+int64_t g_layerTime[N_LAYERS] = {};                 //!< Time charged to each layer (ns)
+std::atomic<uint64_t> g_layerAllocations[N_LAYERS]; //!< Allocations of each layer
+std::atomic<int64_t> g_heapBytes(0);                //!< Bytes currently allocated by new
+
+/**
+ * Clear the time and allocations of layers, and start the setup.
+ */
+void
+ResetLayers()
+{
+    for (int layer = SETUP; layer < N_LAYERS; ++layer)
+    {
+        g_layerTime[layer] = 0;
+        g_layerAllocations[layer] = 0;
+    }
+    g_layerStart = std::chrono::steady_clock::now();
+    g_layer = SETUP;
+}
+
+/**
+ * Charge the time since the last switch to the current layer, and switch.
+ *
+ * \param layer The layer now running.
+ */
+void
+EnterLayer(Layer layer)
+{
+    auto now = std::chrono::steady_clock::now();
+    g_layerTime[g_layer.load(std::memory_order_relaxed)] += (now - g_layerStart).count();
+    g_layerStart = now;
+    g_layer.store(layer, std::memory_order_relaxed);
+}
+
+// Count allocations of the current layer (other threads, e.g., of file writers, included)
+void*
+operator new(std::size_t size)
+{
+    g_layerAllocations[g_layer.load(std::memory_order_relaxed)].fetch_add(
+        1,
+        std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1))
+    {
+        g_heapBytes.fetch_add(malloc_usable_size(p), std::memory_order_relaxed);
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void
+operator delete(void* p) noexcept
+{
+    g_heapBytes.fetch_sub(malloc_usable_size(p), std::memory_order_relaxed);
+    std::free(p);
+}
+
+void
+operator delete(void* p, std::size_t) noexcept
+{
+    operator delete(p);
+}
+
+/**
+ * An event scheduler charging the execution of events to the layer scheduling them.
+ */
+class ProfilingScheduler : public Scheduler
+{
+  public:
+    static TypeId GetTypeId();
+
+    ProfilingScheduler();
+    ~ProfilingScheduler() override;
+
+    void Insert(const Event& ev) override;
+    bool IsEmpty() const override;
+    Event PeekNext() const override;
+    Event RemoveNext() override;
+    void Remove(const Event& ev) override;
+
+  private:
+    /**
+     * Get the layer of an event from its type, e.g., the class of the member
+     * function or of the lambda scheduled.
+     *
+     * \param impl The implementation of the event.
+     * \return The layer.
+     */
+    Layer Classify(const EventImpl* impl);
+
+    std::string m_schedulerType;                       //!< Type of the profiled scheduler
+    Ptr<Scheduler> m_scheduler;                        //!< Profiled scheduler
+    std::unordered_map<std::type_index, Layer> m_type; //!< Layer of each type of event
+};
+
+NS_OBJECT_ENSURE_REGISTERED(ProfilingScheduler);
+
+TypeId
+ProfilingScheduler::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::ProfilingScheduler")
+            .SetParent<Scheduler>()
+            .AddConstructor<ProfilingScheduler>()
+            .AddAttribute("SchedulerType",
+                          "Type of the profiled scheduler",
+                          StringValue("ns3::MapScheduler"),
+                          MakeStringAccessor(&ProfilingScheduler::m_schedulerType),
+                          MakeStringChecker());
+    return tid;
+}
+
+ProfilingScheduler::ProfilingScheduler()
+    : m_schedulerType("ns3::MapScheduler")
+{
+}
+
+ProfilingScheduler::~ProfilingScheduler()
+{
+}
+
+void
+ProfilingScheduler::Insert(const Event& ev)
+{
+    if (!m_scheduler)
+    {
+        ObjectFactory factory(m_schedulerType);
+        m_scheduler = factory.Create<Scheduler>();
+    }
+    m_scheduler->Insert(ev);
+}
+
+bool
+ProfilingScheduler::IsEmpty() const
+{
+    return !m_scheduler || m_scheduler->IsEmpty();
+}
+
+Scheduler::Event
+ProfilingScheduler::PeekNext() const
+{
+    NS_ASSERT(!IsEmpty());
+    return m_scheduler->PeekNext();
+}
+
+Scheduler::Event
+ProfilingScheduler::RemoveNext()
+{
+    NS_ASSERT(!IsEmpty());
+    Event ev = m_scheduler->RemoveNext();
+    EnterLayer(Classify(ev.impl));
+    return ev;
+}
+
+void
+ProfilingScheduler::Remove(const Event& ev)
+{
+    m_scheduler->Remove(ev);
+}
+
+Layer
+ProfilingScheduler::Classify(const EventImpl* impl)
+{
+    auto [it, inserted] = m_type.try_emplace(typeid(*impl), OTHER);
+    if (inserted)
+    {
+        std::string name = typeid(*impl).name();
+        auto has = [&name](auto... keys) { return ((name.find(keys) != name.npos) || ...); };
+        // Servers first, as backhaul events also mention MAC addresses
+        if (has("NetworkServer",
+                "NetworkScheduler",
+                "NetworkController",
+                "Forwarder",
+                "PointToPoint",
+                "Ipv4",
+                "Socket"))
+        {
+            it->second = SERVER;
+        }
+        else if (has("Sender", "Application"))
+        {
+            it->second = APP;
+        }
+        else if (has("Mac"))
+        {
+            it->second = MAC;
+        }
+        else if (has("Phy", "LoraChannel", "Interference"))
+        {
+            it->second = PHY;
+        }
+    }
+    return it->second;
+}
+
+/**
+ * A scenario of the sweep.
+ */
+struct Scenario
+{
+    uint32_t devices;    //!< Number of end devices
+    int rings;           //!< Number of gateway rings
+    std::string sir;     //!< Interference matrix
+    std::string traffic; //!< Traffic model: periodic, poisson or urban
+    bool tracking;       //!< Whether packet tracking is enabled
+};
+
+/**
+ * Settings shared by scenarios.
+ */
+struct Settings
+{
+    double range;  //!< Radius of the coverage of a gateway (m)
+    double period; //!< Period or mean interval of periodic and poisson traffic (s)
+    double hours;  //!< Simulated time (h)
+};
+
+/**
+ * Build and run a scenario, measuring it.
+ *
+ * \param scenario The scenario.
+ * \param settings The shared settings.
+ * \return The measures, as CSV fields after the ones of the scenario.
+ */
+std::string
+RunScenario(const Scenario& scenario, const Settings& settings)
+{
+    ResetLayers();
+    auto begin = std::chrono::steady_clock::now();
+
+    /* Radio channel */
+    auto loss = CreateObject<OkumuraHataPropagationLossModel>();
+    loss->SetAttribute("Frequency", DoubleValue(868100000.0));
+    loss->SetAttribute("Environment", EnumValue(UrbanEnvironment));
+    loss->SetAttribute("CitySize", EnumValue(LargeCity));
+    auto delay = CreateObject<ConstantSpeedPropagationDelayModel>();
+    auto channel = CreateObject<LoraChannel>(loss, delay);
+
+    /* Nodes on a hexagonal grid of gateways */
+    int nGateways = 3 * scenario.rings * scenario.rings - 3 * scenario.rings + 1;
+    NodeContainer gateways;
+    NodeContainer endDevices;
+    {
+        // In hex tiling, distance = range * cos (pi/6) * 2 to have no holes
+        double gatewayDistance = settings.range * std::cos(M_PI / 6) * 2;
+        MobilityHelper mobilityGw;
+        mobilityGw.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+        auto hexAllocator = CreateObject<HexGridPositionAllocator>();
+        hexAllocator->SetAttribute("Z", DoubleValue(30.0));
+        hexAllocator->SetAttribute("distance", DoubleValue(gatewayDistance));
+        mobilityGw.SetPositionAllocator(hexAllocator);
+        gateways.Create(nGateways);
+        mobilityGw.Install(gateways);
+
+        MobilityHelper mobilityEd;
+        mobilityEd.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+        double rho = settings.range + 2.0 * gatewayDistance * (scenario.rings - 1);
+        auto rangeAllocator = CreateObject<RangePositionAllocator>();
+        rangeAllocator->SetAttribute("rho", DoubleValue(rho));
+        rangeAllocator->SetAttribute("ZRV",
+                                     StringValue("ns3::UniformRandomVariable[Min=1|Max=10]"));
+        rangeAllocator->SetAttribute("range", DoubleValue(settings.range));
+        rangeAllocator->SetNodes(gateways);
+        mobilityEd.SetPositionAllocator(rangeAllocator);
+        endDevices.Create(scenario.devices);
+        mobilityEd.Install(endDevices);
+    }
+
+    /* Radio side */
+    LorawanHelper helper;
+    if (scenario.tracking)
+    {
+        helper.EnablePacketTracking();
+    }
+    {
+        LoraPhyHelper phyHelper;
+        phyHelper.SetInterference("IsolationMatrix", EnumValue(sirMap.at(scenario.sir)));
+        phyHelper.SetChannel(channel);
+        LorawanMacHelper macHelper;
+        macHelper.SetRegion(LorawanMacHelper::EU);
+        macHelper.SetAddressGenerator(CreateObject<LoraDeviceAddressGenerator>(54, 1864));
+
+        phyHelper.SetType("ns3::GatewayLoraPhy");
+        macHelper.SetType("ns3::GatewayLorawanMac");
+        helper.Install(phyHelper, macHelper, gateways);
+
+        phyHelper.SetType("ns3::EndDeviceLoraPhy");
+        macHelper.SetType("ns3::ClassAEndDeviceLorawanMac");
+        helper.Install(phyHelper, macHelper, endDevices);
+    }
+    LorawanMacHelper::SetSpreadingFactorsUp(endDevices, gateways, channel);
+
+    /* Network server, connected to gateways by point-to-point links */
+    {
+        NodeContainer networkServer;
+        networkServer.Create(1);
+        PointToPointHelper p2p;
+        p2p.SetDeviceAttribute("DataRate", StringValue("5Mbps"));
+        p2p.SetChannelAttribute("Delay", StringValue("2ms"));
+        for (auto gw = gateways.Begin(); gw != gateways.End(); ++gw)
+        {
+            p2p.Install(networkServer.Get(0), *gw);
+        }
+        NetworkServerHelper nsHelper;
+        nsHelper.SetEndDevices(endDevices);
+        nsHelper.Install(networkServer);
+        ForwarderHelper forHelper;
+        forHelper.Install(gateways);
+    }
+
+    /* Applications */
+    if (scenario.traffic == "periodic")
+    {
+        PeriodicSenderHelper appHelper;
+        appHelper.SetPeriod(Seconds(settings.period));
+        appHelper.Install(endDevices);
+    }
+    else if (scenario.traffic == "poisson")
+    {
+        ObjectFactory factory("ns3::PoissonSender");
+        factory.Set("Interval", TimeValue(Seconds(settings.period)));
+        auto initialDelay = CreateObject<UniformRandomVariable>();
+        for (auto ed = endDevices.Begin(); ed != endDevices.End(); ++ed)
+        {
+            auto app = factory.Create<LoraApplication>();
+            app->SetInitialDelay(Seconds(initialDelay->GetValue(0, settings.period)));
+            app->SetNode(*ed);
+            (*ed)->AddApplication(app);
+        }
+    }
+    else
+    {
+        UrbanTrafficHelper appHelper;
+        appHelper.SetDeviceGroups(Commercial);
+        appHelper.Install(endDevices);
+    }
+
+    /* Simulation */
+    Time stop = Hours(settings.hours);
+    Simulator::Stop(stop);
+    auto start = std::chrono::steady_clock::now();
+    EnterLayer(OTHER);
+    Simulator::Run();
+    EnterLayer(TRACKER);
+    auto end = std::chrono::steady_clock::now();
+    uint64_t events = Simulator::GetEventCount();
+
+    std::string sentReceived = ",";
+    if (scenario.tracking)
+    {
+        LoraPacketTracker& tracker = helper.GetPacketTracker();
+        std::istringstream counts(tracker.CountMacPacketsGlobally(Seconds(0), stop));
+        uint64_t sent;
+        uint64_t received;
+        counts >> sent >> received;
+        sentReceived = std::to_string(sent) + "," + std::to_string(received);
+    }
+    EnterLayer(OTHER);
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    double runMs = std::chrono::duration<double, std::milli>(end - start).count();
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(0) << nGateways << ",ok,"
+        << std::chrono::duration<double, std::milli>(start - begin).count() << "," << runMs
+        << "," << events << "," << events * 1e3 / std::max(runMs, 1e-3) << "," << usage.ru_maxrss
+        << "," << sentReceived;
+    for (int layer = APP; layer < N_LAYERS; ++layer)
+    {
+        out << "," << g_layerTime[layer] / 1e6;
+    }
+    for (const auto& allocations : g_layerAllocations)
+    {
+        out << "," << allocations.load();
+    }
+
+    Simulator::Destroy();
+    return out.str();
+}
+
+/**
+ * Measure the heap memory taken by each device of a LoraDevicePopulation,
+ * with cryptography enabled and all uplinks scheduled.
+ *
+ * \param devices The number of devices.
+ * \param settings The shared settings.
+ * \return The bytes per device.
+ */
+std::string
+RunPopulation(uint32_t devices, const Settings& settings)
+{
+    auto loss = CreateObject<OkumuraHataPropagationLossModel>();
+    auto delay = CreateObject<ConstantSpeedPropagationDelayModel>();
+    auto population = CreateObject<LoraDevicePopulation>();
+    population->SetAttribute("EnableCryptography", BooleanValue(true));
+    population->SetChannel(CreateObject<LoraChannel>(loss, delay));
+    auto coordinate = CreateObject<UniformRandomVariable>();
+    coordinate->SetAttribute("Min", DoubleValue(-settings.range));
+    coordinate->SetAttribute("Max", DoubleValue(settings.range));
+
+    // Create the simulator and the default key store before measuring
+    Simulator::Now();
+    LoraKeyStore::GetDefault();
+    int64_t before = g_heapBytes.load();
+    for (uint32_t i = 0; i < devices; ++i)
+    {
+        Vector position(coordinate->GetValue(), coordinate->GetValue(), 1.5);
+        population->AddDevice(position, LoraDeviceAddress(54, i), 5, Seconds(settings.period));
+    }
+    population->Start(Seconds(0));
+    double bytes = double(g_heapBytes.load() - before) / std::max(devices, 1U);
+
+    Simulator::Destroy();
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1) << bytes;
+    return out.str();
+}
+
+/**
+ * Run a measure in a child process.
+ *
+ * \param measure The measure, returning CSV fields.
+ * \return The measures, or an empty string if the child failed.
+ */
+std::string
+RunInChild(const std::function<std::string()>& measure)
+{
+    int fds[2];
+    NS_ABORT_MSG_IF(pipe(fds) != 0, "Unable to create a pipe");
+    std::cout.flush();
+    pid_t pid = fork();
+    NS_ABORT_MSG_IF(pid < 0, "Unable to fork");
+    if (pid == 0)
+    {
+        close(fds[0]);
+        std::string result = measure();
+        bool written = write(fds[1], result.data(), result.size()) == ssize_t(result.size());
+        _exit(written ? 0 : 1);
+    }
+
+    close(fds[1]);
+    std::string result;
+    char buffer[1024];
+    for (ssize_t n; (n = read(fds[0], buffer, sizeof(buffer))) > 0;)
+    {
+        result.append(buffer, n);
+    }
+    close(fds[0]);
+    int status;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0 ? result : "";
+}
+
+/**
+ * Split a comma-separated list.
+ *
+ * \param list The list.
+ * \return The elements.
+ */
+std::vector<std::string>
+Split(const std::string& list)
+{
+    std::vector<std::string> elements;
+    std::istringstream stream(list);
+    for (std::string element; std::getline(stream, element, ',');)
+    {
+        elements.push_back(element);
+    }
+    return elements;
+}
+
+int
+main(int argc, char* argv[])
+{
+    std::string devices = "1000,10000";
+    std::string rings = "1,2";
+    std::string sirs = "CROCE";
+    std::string traffics = "periodic,poisson,urban";
+    std::string tracking = "true";
+    std::string scheduler = "ns3::MapScheduler";
+    std::string output = "";
+    uint32_t population = 100000;
+    Settings settings = {2540.25, 600, 1};
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("devices", "Comma-separated numbers of end devices", devices);
+    cmd.AddValue("rings", "Comma-separated numbers of gateway rings", rings);
+    cmd.AddValue("sir", "Comma-separated interference matrices (CROCE, GOURSAUD, ALOHA)", sirs);
+    cmd.AddValue("traffic", "Comma-separated traffic models (periodic, poisson, urban)", traffics);
+    cmd.AddValue("tracking", "Comma-separated packet tracking settings (true, false)", tracking);
+    cmd.AddValue("scheduler", "Type of the event scheduler", scheduler);
+    cmd.AddValue("range", "Radius of the coverage of a gateway (m)", settings.range);
+    cmd.AddValue("period", "Period of periodic and poisson traffic (s)", settings.period);
+    cmd.AddValue("hours", "Simulated time (h)", settings.hours);
+    cmd.AddValue("output", "File to write the report to, in addition to stdout", output);
+    cmd.AddValue("population", "Number of devices of the population memory check", population);
+    cmd.Parse(argc, argv);
+
+    GlobalValue::Bind("SchedulerType", StringValue("ns3::ProfilingScheduler"));
+    Config::SetDefault("ns3::ProfilingScheduler::SchedulerType", StringValue(scheduler));
+
+    std::ofstream file;
+    if (!output.empty())
+    {
+        file.open(output, std::ios::trunc);
+        NS_ABORT_MSG_IF(!file.is_open(), "Unable to open " << output);
+    }
+    auto print = [&file](const std::string& line) {
+        std::cout << line << std::endl;
+        if (file.is_open())
+        {
+            file << line << std::endl;
+        }
+    };
+
+    std::ostringstream header;
+    header << "devices,rings,sir,traffic,tracking,gateways,status,setup_ms,run_ms,events,"
+              "events_per_s,peak_rss_kib,sent,received";
+    for (int layer = APP; layer < N_LAYERS; ++layer)
+    {
+        header << "," << layerNames[layer] << "_ms";
+    }
+    for (const auto& name : layerNames)
+    {
+        header << ",alloc_" << name;
+    }
+    print(header.str());
+
+    for (const auto& nDevices : Split(devices))
+    {
+        for (const auto& nRings : Split(rings))
+        {
+            for (const auto& sir : Split(sirs))
+            {
+                NS_ABORT_MSG_IF(!sirMap.count(sir), "Unknown interference matrix " << sir);
+                for (const auto& traffic : Split(traffics))
+                {
+                    NS_ABORT_MSG_IF(traffic != "periodic" && traffic != "poisson" &&
+                                        traffic != "urban",
+                                    "Unknown traffic model " << traffic);
+                    for (const auto& track : Split(tracking))
+                    {
+                        Scenario scenario = {uint32_t(std::stoul(nDevices)),
+                                             std::stoi(nRings),
+                                             sir,
+                                             traffic,
+                                             track == "true" || track == "1"};
+                        std::string result =
+                            RunInChild([&]() { return RunScenario(scenario, settings); });
+                        print(nDevices + "," + nRings + "," + sir + "," + traffic + "," +
+                              (scenario.tracking ? "true" : "false") + "," +
+                              (result.empty() ? ",failed" : result));
+                    }
+                }
+            }
+        }
+    }
+
+    // Per-device tables of the population (position, address, period, frame
+    // counter, data rate, tx power, key index and queue entry), plus the key
+    // indices of the device in the key store
+    const double expectedBytes = 60 + 8;
+    std::string result = RunInChild([&]() { return RunPopulation(population, settings); });
+    NS_ABORT_MSG_IF(result.empty(), "Population memory check failed");
+    double bytes = std::stod(result);
+    std::cout << "Population of " << population << " devices: " << result
+              << " bytes per device, " << expectedBytes << " expected" << std::endl;
+    return (bytes <= 2 * expectedBytes) ? 0 : 1;
+}
@@ -0,0 +1,213 @@
+/*
+ * This program compares event schedulers on a sequence of scheduler
+ * operations. The sequence is either recorded from a simulation with the
+ * EventTraceScheduler, for instance with
+ *
+ *   ./ns3 run "aloha-throughput --SchedulerType=ns3::EventTraceScheduler
+ *     --ns3::EventTraceScheduler::Filename=aloha.evt"
+ *   ./ns3 run "scheduler-benchmark --trace=aloha.evt"
+ *
+ * or generated to mimic periodic end devices: far future application events,
+ * each one followed by near future PHY and MAC events.
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/event-trace-scheduler.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <queue>
+#include <sstream>
+
+using namespace ns3;
+using namespace lorawan;
+
+NS_LOG_COMPONENT_DEFINE("SchedulerBenchmark");
+
+/**
+ * Kinds of generated events, each one scheduling the next.
+ */
+enum EventKind : uint8_t
+{
+    SEND,   //!< Application sends a packet
+    TX_END, //!< End of transmission
+    RX1,    //!< Opening of the first receive window
+    RX2,    //!< Opening of the second receive window
+    RX_END, //!< Closing of a receive window
+};
+
+/**
+ * Generate the scheduler operations of periodic end devices.
+ *
+ * \param nDevices The number of devices.
+ * \param period The period of devices (s).
+ * \param nEvents The number of events to execute.
+ * \return The operations.
+ */
+std::vector<EventTraceScheduler::Record>
+GenerateOperations(uint32_t nDevices, double period, uint64_t nEvents)
+{
+    using Record = EventTraceScheduler::Record;
+    std::vector<Record> records;
+    std::vector<EventKind> kinds;
+    std::vector<uint32_t> rx2; // Pending second window of each event
+    std::priority_queue<std::pair<uint64_t, uint32_t>,
+                        std::vector<std::pair<uint64_t, uint32_t>>,
+                        std::greater<>>
+        queue;
+    std::vector<bool> removed;
+    auto phase = CreateObject<UniformRandomVariable>();
+    auto toa = CreateObject<UniformRandomVariable>();
+    toa->SetAttribute("Min", DoubleValue(0.05));
+    toa->SetAttribute("Max", DoubleValue(1.5));
+
+    auto schedule = [&](uint64_t ts, EventKind kind) {
+        uint32_t uid = kinds.size();
+        kinds.push_back(kind);
+        removed.push_back(false);
+        queue.emplace(ts, uid);
+        records.push_back({ts, uid, EventTraceScheduler::INSERT});
+        return uid;
+    };
+    for (uint32_t i = 0; i < nDevices; ++i)
+    {
+        schedule(Seconds(phase->GetValue(0, period)).GetTimeStep(), SEND);
+    }
+
+    uint64_t executed = 0;
+    while (executed < nEvents && !queue.empty())
+    {
+        auto [ts, uid] = queue.top();
+        queue.pop();
+        if (removed[uid])
+        {
+            continue;
+        }
+        records.push_back({ts, uid, EventTraceScheduler::REMOVE_NEXT});
+        ++executed;
+        switch (kinds[uid])
+        {
+        case SEND:
+            schedule(ts + Seconds(period).GetTimeStep(), SEND);
+            schedule(ts + Seconds(toa->GetValue()).GetTimeStep(), TX_END);
+            break;
+        case TX_END: {
+            uint32_t first = schedule(ts + Seconds(1).GetTimeStep(), RX1);
+            rx2.resize(kinds.size());
+            rx2[first] = schedule(ts + Seconds(2).GetTimeStep(), RX2);
+            break;
+        }
+        case RX1:
+            // A downlink in the first window cancels the second one
+            if (uid % 10 == 0)
+            {
+                uint32_t second = rx2[uid];
+                removed[second] = true;
+                records.push_back({ts + Seconds(1).GetTimeStep(),
+                                   second,
+                                   EventTraceScheduler::REMOVE});
+            }
+            schedule(ts + MilliSeconds(33).GetTimeStep(), RX_END);
+            break;
+        case RX2:
+            schedule(ts + MilliSeconds(33).GetTimeStep(), RX_END);
+            break;
+        case RX_END:
+            break;
+        }
+    }
+    return records;
+}
+
+/**
+ * Replay operations on a scheduler.
+ *
+ * \param type The type of the scheduler.
+ * \param records The operations.
+ * \param mismatches The number of events removed out of the recorded order.
+ * \return The time taken (ms).
+ */
+int64_t
+Replay(const std::string& type,
+       const std::vector<EventTraceScheduler::Record>& records,
+       uint64_t& mismatches)
+{
+    ObjectFactory factory(type);
+    Ptr<Scheduler> scheduler = factory.Create<Scheduler>();
+    Scheduler::Event ev;
+    ev.impl = nullptr;
+    ev.key.m_context = 0;
+    mismatches = 0;
+
+    SystemWallClockMs clock;
+    clock.Start();
+    for (const auto& record : records)
+    {
+        switch (record.operation)
+        {
+        case EventTraceScheduler::INSERT:
+            ev.key.m_ts = record.ts;
+            ev.key.m_uid = record.uid;
+            scheduler->Insert(ev);
+            break;
+        case EventTraceScheduler::REMOVE_NEXT:
+            mismatches += (scheduler->RemoveNext().key.m_uid != record.uid);
+            break;
+        case EventTraceScheduler::REMOVE:
+            ev.key.m_ts = record.ts;
+            ev.key.m_uid = record.uid;
+            scheduler->Remove(ev);
+            break;
+        }
+    }
+    return clock.End();
+}
+
+int
+main(int argc, char* argv[])
+{
+    std::string trace = "";
+    std::string schedulers = "ns3::MapScheduler,ns3::HeapScheduler,ns3::CalendarScheduler,"
+                             "ns3::PriorityQueueScheduler,ns3::LadderScheduler";
+    uint32_t nDevices = 100000;
+    double period = 600;
+    uint64_t nEvents = 2000000;
+    uint32_t runs = 3;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("trace", "File of operations recorded by EventTraceScheduler", trace);
+    cmd.AddValue("schedulers", "Comma-separated types of the compared schedulers", schedulers);
+    cmd.AddValue("devices", "Number of devices of generated operations", nDevices);
+    cmd.AddValue("period", "Period of devices of generated operations (s)", period);
+    cmd.AddValue("events", "Number of events of generated operations", nEvents);
+    cmd.AddValue("runs", "Number of runs of each scheduler, keeping the fastest", runs);
+    cmd.Parse(argc, argv);
+
+    std::vector<EventTraceScheduler::Record> records =
+        trace.empty() ? GenerateOperations(nDevices, period, nEvents)
+                      : EventTraceScheduler::Read(trace);
+    uint64_t nRemoved = std::count_if(records.begin(), records.end(), [](const auto& record) {
+        return record.operation == EventTraceScheduler::REMOVE_NEXT;
+    });
+
+    // scheduler operations time(ms) operations/s mismatches
+    std::cout << "# " << records.size() << " operations, " << nRemoved << " events" << std::endl;
+    std::istringstream types(schedulers);
+    std::string type;
+    while (std::getline(types, type, ','))
+    {
+        int64_t best = std::numeric_limits<int64_t>::max();
+        uint64_t mismatches = 0;
+        for (uint32_t run = 0; run < runs; ++run)
+        {
+            best = std::min(best, Replay(type, records, mismatches));
+        }
+        std::cout << type << " " << records.size() << " " << best << " " << std::fixed
+                  << std::setprecision(0) << records.size() * 1e3 / std::max<int64_t>(best, 1)
+                  << " " << mismatches << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2026 University of Bologna
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Alessandro Aimi <alessandro.aimi@unibo.it>
+ */
+
+#include "async-file-writer.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+namespace ns3
+{
+namespace lorawan
+{
+
+NS_LOG_COMPONENT_DEFINE("AsyncFileWriter");
+
+AsyncFileWriter::AsyncFileWriter(const std::string& filename,
+                                 bool append,
+                                 std::size_t maxQueuedBytes)
+    : m_queuedBytes(0),
+      m_maxQueuedBytes(maxQueuedBytes),
+      m_writing(false),
+      m_stop(false)
+{
+    NS_LOG_FUNCTION(this << filename << append << maxQueuedBytes);
+
+    auto mode = (append) ? std::ofstream::app : std::ofstream::trunc;
+    m_file.open(filename, std::ofstream::out | std::ofstream::binary | mode);
+    NS_ABORT_MSG_IF(!m_file.is_open(), "Unable to open output file " << filename);
+    m_thread = std::thread(&AsyncFileWriter::Run, this);
+}
+
+AsyncFileWriter::~AsyncFileWriter()
+{
+    NS_LOG_FUNCTION(this);
+    Close();
+}
+
+void
+AsyncFileWriter::Close()
+{
+    NS_LOG_FUNCTION(this);
+
+    if (!m_thread.joinable())
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_pending.notify_one();
+    m_thread.join();
+    m_file.close();
+}
+
+bool
+AsyncFileWriter::IsOpen() const
+{
+    return m_thread.joinable();
+}
+
+void
+AsyncFileWriter::Write(std::string block)
+{
+    NS_ASSERT_MSG(IsOpen(), "Writing to a closed file");
+    if (block.empty())
+    {
+        return;
+    }
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        // Wait for the file system to catch up
+        m_written.wait(lock, [this] { return m_queuedBytes < m_maxQueuedBytes; });
+        m_queuedBytes += block.size();
+        m_queue.push_back({"", std::move(block)});
+    }
+    m_pending.notify_one();
+}
+
+void
+AsyncFileWriter::Rotate(const std::string& filename)
+{
+    NS_LOG_FUNCTION(this << filename);
+    NS_ASSERT_MSG(IsOpen(), "Rotating a closed file");
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back({filename, ""});
+    }
+    m_pending.notify_one();
+}
+
+void
+AsyncFileWriter::Flush()
+{
+    NS_LOG_FUNCTION(this);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_written.wait(lock, [this] { return m_queue.empty() && !m_writing; });
+}
+
+void
+AsyncFileWriter::Run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_pending.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+        if (m_queue.empty())
+        {
+            // Stopping with nothing left to write
+            break;
+        }
+        Block block = std::move(m_queue.front());
+        m_queue.pop_front();
+        m_writing = true;
+        lock.unlock();
+        if (!block.filename.empty())
+        {
+            m_file.close();
+            m_file.open(block.filename,
+                        std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+            NS_ABORT_MSG_IF(!m_file.is_open(), "Unable to open output file " << block.filename);
+        }
+        m_file.write(block.data.data(), block.data.size());
+        m_file.flush();
+        lock.lock();
+        m_queuedBytes -= block.data.size();
+        m_writing = false;
+        m_written.notify_all();
+    }
+}
+
+} // namespace lorawan
+} // namespace ns3
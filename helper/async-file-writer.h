@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2026 University of Bologna
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Alessandro Aimi <alessandro.aimi@unibo.it>
+ */
+
+#ifndef ASYNC_FILE_WRITER_H
+#define ASYNC_FILE_WRITER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace ns3
+{
+namespace lorawan
+{
+
+/**
+ * Write text or binary data to a file from a background thread.
+ *
+ * The file is opened once, and each block passed to Write is handed to the
+ * background thread, so that the simulation thread does not wait for the file
+ * system. Blocks are written in order, and all of them are written when the
+ * writer is closed or destroyed. If the file system cannot keep up, Write
+ * waits once the queued blocks exceed a maximum size, bounding memory.
+ */
+class AsyncFileWriter
+{
+  public:
+    /**
+     * Open a file and start the background thread.
+     *
+     * \param filename The name of the file.
+     * \param append Whether to append to the file instead of truncating it.
+     * \param maxQueuedBytes The size of queued blocks over which Write waits.
+     */
+    AsyncFileWriter(const std::string& filename,
+                    bool append = false,
+                    std::size_t maxQueuedBytes = 64 << 20);
+
+    /**
+     * Close the writer, if not closed already.
+     */
+    ~AsyncFileWriter();
+
+    AsyncFileWriter(const AsyncFileWriter&) = delete;
+    AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+
+    /**
+     * Queue a block to be written.
+     *
+     * \param block The data.
+     */
+    void Write(std::string block);
+
+    /**
+     * Queue the switch to a new file, truncating it. Blocks queued afterwards
+     * are written to the new file.
+     *
+     * \param filename The name of the new file.
+     */
+    void Rotate(const std::string& filename);
+
+    /**
+     * Wait until all queued blocks are written to the file.
+     */
+    void Flush();
+
+    /**
+     * Write the remaining blocks, stop the background thread and close the
+     * file. Nothing can be written afterwards.
+     */
+    void Close();
+
+    /**
+     * \return Whether the writer was not closed yet.
+     */
+    bool IsOpen() const;
+
+  private:
+    /**
+     * A queued block of data, or the switch to a new file.
+     */
+    struct Block
+    {
+        std::string filename; //!< The new file to write to, if not empty
+        std::string data;     //!< The data to write
+    };
+
+    /**
+     * Body of the background thread.
+     */
+    void Run();
+
+    std::ofstream m_file;              //!< The output file
+    std::deque<Block> m_queue;         //!< Blocks not yet written
+    std::size_t m_queuedBytes;         //!< Size of the data of queued blocks
+    std::size_t m_maxQueuedBytes;      //!< Size of queued blocks over which Write waits
+    bool m_writing;                    //!< Whether the thread is writing a block
+    bool m_stop;                       //!< Whether the thread must exit
+    std::mutex m_mutex;                //!< Protects the queue and flags
+    std::condition_variable m_pending; //!< Signals new blocks or stop to the thread
+    std::condition_variable m_written; //!< Signals that a block was written
+    std::thread m_thread;              //!< The background thread
+};
+
+} // namespace lorawan
+} // namespace ns3
+
+#endif /* ASYNC_FILE_WRITER_H */
@@ -46,6 +46,11 @@ ForwarderHelper::SetAttribute(std::string name, const AttributeValue& value)
 ApplicationContainer
 ForwarderHelper::Install(Ptr<Node> node) const
 {
+    // Nodes simulated by another rank of a distributed simulation
+    if (node->GetSystemId() != Simulator::GetSystemId())
+    {
+        return ApplicationContainer();
+    }
     return ApplicationContainer(InstallPriv(node));
 }
 
@@ -55,7 +60,7 @@ ForwarderHelper::Install(NodeContainer c) const
     ApplicationContainer apps;
     for (auto i = c.Begin(); i != c.End(); ++i)
     {
-        apps.Add(InstallPriv(*i));
+        apps.Add(Install(*i));
     }
 
     return apps;
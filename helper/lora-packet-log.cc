@@ -0,0 +1,365 @@
+/*
+ * Copyright (c) 2026 University of Bologna
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Alessandro Aimi <alessandro.aimi@unibo.it>
+ */
+
+#include "lora-packet-log.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace ns3
+{
+namespace lorawan
+{
+
+NS_LOG_COMPONENT_DEFINE("LoraPacketLog");
+
+/**
+ * File header: magic, format version and record size.
+ */
+static const char LOG_MAGIC[8] = {'L', 'O', 'R', 'A', 'P', 'L', 'O', 'G'};
+static const uint32_t LOG_VERSION = 2;
+static const uint32_t LOG_HEADER_SIZE = 16;
+
+static void
+WriteLe(uint8_t*& buffer, uint64_t value, uint32_t bytes)
+{
+    for (uint32_t i = 0; i < bytes; i++)
+    {
+        *buffer++ = (value >> (8 * i)) & 0xff;
+    }
+}
+
+static uint64_t
+ReadLe(const uint8_t*& buffer, uint32_t bytes)
+{
+    uint64_t value = 0;
+    for (uint32_t i = 0; i < bytes; i++)
+    {
+        value |= uint64_t(*buffer++) << (8 * i);
+    }
+    return value;
+}
+
+static uint32_t
+FloatToBits(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static float
+BitsToFloat(uint32_t bits)
+{
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/////////////////////////
+// LoraPacketLogRecord //
+/////////////////////////
+
+void
+LoraPacketLogRecord::Serialize(uint8_t* buffer) const
+{
+    WriteLe(buffer, time.GetNanoSeconds(), 8);
+    WriteLe(buffer, uid, 8);
+    WriteLe(buffer, node, 4);
+    WriteLe(buffer, type, 1);
+    WriteLe(buffer, outcome, 1);
+    WriteLe(buffer, dataRate, 1);
+    WriteLe(buffer, success, 1);
+    WriteLe(buffer, size, 4);
+    WriteLe(buffer, FloatToBits(rxPower), 4);
+    WriteLe(buffer, FloatToBits(snr), 4);
+    WriteLe(buffer, firstAttempt.GetNanoSeconds(), 8);
+    WriteLe(buffer, phyTx, 8);
+}
+
+void
+LoraPacketLogRecord::Deserialize(const uint8_t* buffer)
+{
+    time = NanoSeconds(int64_t(ReadLe(buffer, 8)));
+    uid = ReadLe(buffer, 8);
+    node = ReadLe(buffer, 4);
+    type = Type(ReadLe(buffer, 1));
+    outcome = ReadLe(buffer, 1);
+    dataRate = ReadLe(buffer, 1);
+    success = ReadLe(buffer, 1);
+    size = ReadLe(buffer, 4);
+    rxPower = BitsToFloat(ReadLe(buffer, 4));
+    snr = BitsToFloat(ReadLe(buffer, 4));
+    firstAttempt = NanoSeconds(int64_t(ReadLe(buffer, 8)));
+    phyTx = ReadLe(buffer, 8);
+}
+
+/////////////////////////
+// LoraPacketLogWriter //
+/////////////////////////
+
+LoraPacketLogWriter::LoraPacketLogWriter(const std::string& filename, uint32_t bufferedRecords)
+    : m_capacity(std::max(bufferedRecords, 1U) * LoraPacketLogRecord::SIZE)
+{
+    NS_LOG_FUNCTION(this << filename << bufferedRecords);
+
+    m_file.open(filename, std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+    NS_ABORT_MSG_IF(!m_file.is_open(), "Unable to open packet log " << filename);
+
+    uint8_t header[LOG_HEADER_SIZE];
+    std::memcpy(header, LOG_MAGIC, sizeof(LOG_MAGIC));
+    uint8_t* it = header + sizeof(LOG_MAGIC);
+    WriteLe(it, LOG_VERSION, 4);
+    WriteLe(it, LoraPacketLogRecord::SIZE, 4);
+    m_file.write(reinterpret_cast<const char*>(header), LOG_HEADER_SIZE);
+
+    m_buffer.reserve(m_capacity);
+}
+
+LoraPacketLogWriter::~LoraPacketLogWriter()
+{
+    NS_LOG_FUNCTION(this);
+    Flush();
+    m_file.close();
+}
+
+void
+LoraPacketLogWriter::Append(const LoraPacketLogRecord& record)
+{
+    std::size_t offset = m_buffer.size();
+    m_buffer.resize(offset + LoraPacketLogRecord::SIZE);
+    record.Serialize(m_buffer.data() + offset);
+    if (m_buffer.size() >= m_capacity)
+    {
+        Flush();
+    }
+}
+
+void
+LoraPacketLogWriter::Flush()
+{
+    NS_LOG_FUNCTION(this);
+
+    if (m_buffer.empty())
+    {
+        return;
+    }
+    m_file.write(reinterpret_cast<const char*>(m_buffer.data()), m_buffer.size());
+    m_file.flush();
+    m_buffer.clear();
+}
+
+/////////////////////////
+// LoraPacketLogReader //
+/////////////////////////
+
+LoraPacketLogReader::LoraPacketLogReader(const std::string& filename)
+{
+    NS_LOG_FUNCTION(this << filename);
+
+    m_file.open(filename, std::ifstream::in | std::ifstream::binary);
+    NS_ABORT_MSG_IF(!m_file.is_open(), "Unable to open packet log " << filename);
+
+    uint8_t header[LOG_HEADER_SIZE];
+    m_file.read(reinterpret_cast<char*>(header), LOG_HEADER_SIZE);
+    NS_ABORT_MSG_IF(!m_file || std::memcmp(header, LOG_MAGIC, sizeof(LOG_MAGIC)),
+                    filename << " is not a packet log");
+    const uint8_t* it = header + sizeof(LOG_MAGIC);
+    NS_ABORT_MSG_IF(ReadLe(it, 4) != LOG_VERSION, "Unsupported packet log version");
+    NS_ABORT_MSG_IF(ReadLe(it, 4) != LoraPacketLogRecord::SIZE, "Unsupported packet log record");
+
+    m_file.seekg(0, std::ifstream::end);
+    m_nRecords = (uint64_t(m_file.tellg()) - LOG_HEADER_SIZE) / LoraPacketLogRecord::SIZE;
+    Rewind();
+}
+
+LoraPacketLogReader::~LoraPacketLogReader()
+{
+    NS_LOG_FUNCTION(this);
+    m_file.close();
+}
+
+uint64_t
+LoraPacketLogReader::GetNRecords() const
+{
+    return m_nRecords;
+}
+
+bool
+LoraPacketLogReader::Next(LoraPacketLogRecord& record)
+{
+    uint8_t buffer[LoraPacketLogRecord::SIZE];
+    if (!m_file.read(reinterpret_cast<char*>(buffer), LoraPacketLogRecord::SIZE))
+    {
+        return false;
+    }
+    record.Deserialize(buffer);
+    return true;
+}
+
+void
+LoraPacketLogReader::Rewind()
+{
+    NS_LOG_FUNCTION(this);
+
+    m_file.clear();
+    m_file.seekg(LOG_HEADER_SIZE, std::ifstream::beg);
+}
+
+void
+LoraPacketLogReader::CountPhyPacketsAllGws(Time startTime, Time stopTime, GwsPhyPktCount& output)
+{
+    NS_LOG_FUNCTION(this << startTime << stopTime);
+
+    output.clear();
+    // Gateways with an outcome for each transmission in the interval
+    std::unordered_map<uint64_t, std::vector<uint32_t>> packets;
+    LoraPacketLogRecord record;
+    for (Rewind(); Next(record);)
+    {
+        if (record.type == LoraPacketLogRecord::PHY_TX && record.time >= startTime &&
+            record.time <= stopTime)
+        {
+            packets[record.phyTx];
+        }
+        else if (record.type == LoraPacketLogRecord::PHY_OUTCOME)
+        {
+            auto it = packets.find(record.phyTx);
+            if (it == packets.end() ||
+                std::find(it->second.begin(), it->second.end(), record.node) != it->second.end())
+            {
+                continue;
+            }
+            it->second.push_back(record.node);
+            std::vector<int>& count = output[record.node].v;
+            count[0]++;
+            count[LoraPacketTracker::GetOutcomeColumn(PhyPacketOutcome(record.outcome))]++;
+        }
+    }
+}
+
+std::string
+LoraPacketLogReader::PrintPhyPacketsGlobally(Time startTime, Time stopTime)
+{
+    NS_LOG_FUNCTION(this << startTime << stopTime);
+
+    // Best outcome column of each transmission in the interval
+    std::unordered_map<uint64_t, int> packets;
+    LoraPacketLogRecord record;
+    for (Rewind(); Next(record);)
+    {
+        if (record.type == LoraPacketLogRecord::PHY_TX && record.time >= startTime &&
+            record.time <= stopTime)
+        {
+            packets[record.phyTx] = LoraPacketTracker::GetOutcomeColumn(UNSET);
+        }
+        else if (record.type == LoraPacketLogRecord::PHY_OUTCOME)
+        {
+            auto it = packets.find(record.phyTx);
+            if (it != packets.end())
+            {
+                int column =
+                    LoraPacketTracker::GetOutcomeColumn(PhyPacketOutcome(record.outcome));
+                it->second = std::min(it->second, column);
+            }
+        }
+    }
+
+    std::vector<int> count(6, 0);
+    for (const auto& packet : packets)
+    {
+        count[0]++;
+        count[packet.second]++;
+    }
+    return LoraPacketTracker::PrintCounts(count);
+}
+
+void
+LoraPacketLogReader::CountAllDevicesPackets(Time startTime, Time stopTime, DevPktCount& out)
+{
+    NS_LOG_FUNCTION(this << startTime << stopTime);
+
+    out.clear();
+    // Packets first sent before the interval, whose retransmissions are ignored
+    std::unordered_set<uint64_t> previous;
+    // Sender of each packet first sent in the interval, and whether it was received
+    std::unordered_map<uint64_t, std::pair<uint32_t, bool>> packets;
+    LoraPacketLogRecord record;
+    for (Rewind(); Next(record);)
+    {
+        if (record.type == LoraPacketLogRecord::MAC_TX && record.time < startTime)
+        {
+            previous.insert(record.uid);
+        }
+        else if (record.type == LoraPacketLogRecord::MAC_TX && record.time <= stopTime)
+        {
+            if (!previous.count(record.uid) &&
+                packets.emplace(record.uid, std::make_pair(record.node, false)).second)
+            {
+                out[record.node].sent++;
+            }
+        }
+        else if (record.type == LoraPacketLogRecord::MAC_GW_RX)
+        {
+            auto it = packets.find(record.uid);
+            if (it != packets.end() && !it->second.second)
+            {
+                out[it->second.first].received++;
+                it->second.second = true;
+            }
+        }
+    }
+}
+
+std::string
+LoraPacketLogReader::CountMacPacketsGlobally(Time startTime, Time stopTime)
+{
+    NS_LOG_FUNCTION(this << startTime << stopTime);
+
+    DevPktCount devices;
+    CountAllDevicesPackets(startTime, stopTime, devices);
+    int sent = 0;
+    int received = 0;
+    for (const auto& device : devices)
+    {
+        sent += device.second.sent;
+        received += device.second.received;
+    }
+    return std::to_string(sent) + " " + std::to_string(received);
+}
+
+std::string
+LoraPacketLogReader::CountMacPacketsGloballyCpsr(Time startTime, Time stopTime)
+{
+    NS_LOG_FUNCTION(this << startTime << stopTime);
+
+    int sent = 0;
+    int received = 0;
+    LoraPacketLogRecord record;
+    for (Rewind(); Next(record);)
+    {
+        if (record.type == LoraPacketLogRecord::MAC_DONE && record.firstAttempt >= startTime &&
+            record.firstAttempt <= stopTime)
+        {
+            sent++;
+            if (record.success)
+            {
+                received++;
+            }
+        }
+    }
+    return std::to_string(sent) + " " + std::to_string(received);
+}
+
+} // namespace lorawan
+} // namespace ns3
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2026 University of Bologna
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Alessandro Aimi <alessandro.aimi@unibo.it>
+ */
+
+#ifndef LORA_PACKET_LOG_H
+#define LORA_PACKET_LOG_H
+
+#include "lora-packet-tracker.h"
+
+#include "ns3/nstime.h"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+namespace lorawan
+{
+
+/**
+ * Fixed-size record of a packet event in a binary packet log.
+ *
+ * Packets are identified by their uid, which is kept by copies. Since
+ * retransmissions send the same packet, PHY events are identified by the
+ * sequence number of the transmission instead.
+ */
+struct LoraPacketLogRecord
+{
+    enum Type : uint8_t
+    {
+        PHY_TX,      //!< Transmission of an uplink by the PHY of a device
+        PHY_OUTCOME, //!< Outcome of an uplink at the PHY of a gateway
+        MAC_TX,      //!< New uplink sent by the MAC of a device
+        MAC_GW_RX,   //!< Reception of an uplink by the MAC of a gateway
+        MAC_DONE     //!< End of the transmission attempts of an uplink
+    };
+
+    static constexpr uint32_t SIZE = 52; //!< Serialized size (bytes)
+
+    Time time;         //!< Time of the event
+    uint64_t uid = 0;  //!< Uid of the packet
+    uint32_t node = 0; //!< Device (transmissions) or gateway (receptions) node id
+    Type type = PHY_TX;
+    uint8_t outcome = UNSET; //!< PhyPacketOutcome of PHY_OUTCOME, attempts of MAC_DONE
+    uint8_t dataRate = 0;    //!< Data rate in the LoraTag of the packet
+    bool success = false;    //!< Whether MAC_DONE is successful
+    uint32_t size = 0;       //!< Size of the packet (bytes)
+    float rxPower = 0;       //!< Receive power of RECEIVED outcomes (dBm)
+    float snr = 0;           //!< SNR of RECEIVED outcomes (dB)
+    Time firstAttempt;       //!< Time of the first transmission attempt of MAC_DONE
+    uint64_t phyTx = 0;      //!< Sequence number of the transmission of PHY events
+
+    /**
+     * Write the record in little-endian order.
+     *
+     * \param buffer The buffer of at least SIZE bytes.
+     */
+    void Serialize(uint8_t* buffer) const;
+
+    /**
+     * Read the record in little-endian order.
+     *
+     * \param buffer The buffer of at least SIZE bytes.
+     */
+    void Deserialize(const uint8_t* buffer);
+};
+
+/**
+ * Append packet event records to a binary log file.
+ *
+ * Records are buffered in memory and written in blocks, so that the cost of
+ * logging does not depend on the length of the simulation.
+ */
+class LoraPacketLogWriter
+{
+  public:
+    /**
+     * Create a log file, overwriting existing ones.
+     *
+     * \param filename The name of the file.
+     * \param bufferedRecords The number of records written at once.
+     */
+    LoraPacketLogWriter(const std::string& filename, uint32_t bufferedRecords = 4096);
+    ~LoraPacketLogWriter();
+
+    /**
+     * Append a record to the log.
+     *
+     * \param record The record.
+     */
+    void Append(const LoraPacketLogRecord& record);
+
+    /**
+     * Write buffered records to the file.
+     */
+    void Flush();
+
+  private:
+    std::ofstream m_file;          //!< The log file
+    std::vector<uint8_t> m_buffer; //!< Records not yet written
+    uint32_t m_capacity;           //!< Maximum size of the buffer (bytes)
+};
+
+/**
+ * Read binary packet logs offline.
+ *
+ * Besides sequential access to records, the reader gives the same reports as
+ * the counting functions of the LoraPacketTracker. Reports are computed in a
+ * single pass over the file, keeping in memory only packets sent in the
+ * requested interval (and the uids of MAC packets sent before it, which are
+ * counted at their first transmission). Outcomes are all the ones in the log,
+ * independently of the time they were recorded.
+ */
+class LoraPacketLogReader
+{
+  public:
+    /**
+     * Open a log file.
+     *
+     * \param filename The name of the file.
+     */
+    LoraPacketLogReader(const std::string& filename);
+    ~LoraPacketLogReader();
+
+    /**
+     * \return The number of records in the log.
+     */
+    uint64_t GetNRecords() const;
+
+    /**
+     * Read the next record.
+     *
+     * \param record The record to fill.
+     * \return Whether a record was read, i.e., the end of the log was not reached.
+     */
+    bool Next(LoraPacketLogRecord& record);
+
+    /**
+     * Move back to the first record.
+     */
+    void Rewind();
+
+    void CountPhyPacketsAllGws(Time startTime, Time stopTime, GwsPhyPktCount& output);
+    std::string PrintPhyPacketsGlobally(Time startTime, Time stopTime);
+    void CountAllDevicesPackets(Time startTime, Time stopTime, DevPktCount& out);
+    std::string CountMacPacketsGlobally(Time startTime, Time stopTime);
+    std::string CountMacPacketsGloballyCpsr(Time startTime, Time stopTime);
+
+  private:
+    std::ifstream m_file; //!< The log file
+    uint64_t m_nRecords;  //!< Number of records in the file
+};
+
+} // namespace lorawan
+} // namespace ns3
+
+#endif /* LORA_PACKET_LOG_H */
@@ -12,24 +12,135 @@
 
 #include "lora-packet-tracker.h"
 
+#include "lora-packet-log.h"
+
 #include "ns3/log.h"
 #include "ns3/lora-phy.h"
 #include "ns3/lora-tag.h"
 #include "ns3/lorawan-mac-header.h"
 #include "ns3/simulator.h"
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 
+#ifdef NS3_MPI
+#include "ns3/distributed-lora-channel.h"
+#include "ns3/mpi-interface.h"
+
+#include <cstring>
+#include <mpi.h>
+#endif
+
 namespace ns3
 {
 namespace lorawan
 {
 NS_LOG_COMPONENT_DEFINE("LoraPacketTracker");
 
+#ifdef NS3_MPI
+namespace
+{
+
+/**
+ * Append the bytes of a value to a buffer exchanged between ranks.
+ *
+ * \param buffer The buffer.
+ * \param value The value.
+ */
+template <typename T>
+void
+Put(std::vector<uint8_t>& buffer, const T& value)
+{
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+/**
+ * Read a value from a buffer exchanged between ranks.
+ *
+ * \param buffer The buffer.
+ * \param pos The position of the value, advanced past it.
+ * \return The value.
+ */
+template <typename T>
+T
+Get(const std::vector<uint8_t>& buffer, size_t& pos)
+{
+    T value;
+    std::memcpy(&value, buffer.data() + pos, sizeof(T));
+    pos += sizeof(T);
+    return value;
+}
+
+/**
+ * Exchange buffers between the ranks of a distributed simulation.
+ *
+ * \param buffer The buffer of this rank.
+ * \param all Whether all ranks receive the buffers, or only rank 0.
+ * \return The buffers of all ranks, concatenated in order of rank.
+ */
+std::vector<uint8_t>
+Exchange(const std::vector<uint8_t>& buffer, bool all)
+{
+    MPI_Comm comm = MpiInterface::GetCommunicator();
+    int size = MpiInterface::GetSize();
+    int length = buffer.size();
+    std::vector<int> lengths(size, 0);
+    if (all)
+    {
+        MPI_Allgather(&length, 1, MPI_INT, lengths.data(), 1, MPI_INT, comm);
+    }
+    else
+    {
+        MPI_Gather(&length, 1, MPI_INT, lengths.data(), 1, MPI_INT, 0, comm);
+    }
+
+    std::vector<int> offsets(size, 0);
+    int total = 0;
+    for (int r = 0; r < size; ++r)
+    {
+        offsets[r] = total;
+        total += lengths[r];
+    }
+
+    std::vector<uint8_t> output(total);
+    if (all)
+    {
+        MPI_Allgatherv(buffer.data(),
+                       length,
+                       MPI_BYTE,
+                       output.data(),
+                       lengths.data(),
+                       offsets.data(),
+                       MPI_BYTE,
+                       comm);
+    }
+    else
+    {
+        MPI_Gatherv(buffer.data(),
+                    length,
+                    MPI_BYTE,
+                    output.data(),
+                    lengths.data(),
+                    offsets.data(),
+                    MPI_BYTE,
+                    0,
+                    comm);
+    }
+    return output;
+}
+
+} // namespace
+#endif
+
 LoraPacketTracker::LoraPacketTracker()
     : m_oldPacketThreshold(Seconds(0)),
-      m_lastPacketCleanup(Seconds(0))
+      m_lastPacketCleanup(Seconds(0)),
+      m_lastPhyTransmissionsCleanup(Seconds(0)),
+      m_nPhyPackets(0),
+      m_nMacPackets(0),
+      m_storePackets(true)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -53,13 +164,36 @@ LoraPacketTracker::MacTransmissionCallback(Ptr<const Packet> packet)
     {
         NS_LOG_INFO("A new packet was sent by the MAC layer");
 
+        if (m_log)
+        {
+            LogEvent(LoraPacketLogRecord::MAC_TX, packet, Simulator::GetContext());
+        }
+        if (!m_storePackets)
+        {
+            return;
+        }
+
         MacPacketStatus status;
         status.packet = packet;
         status.sendTime = Simulator::Now();
         status.senderId = Simulator::GetContext();
         status.receivedTime = Time::Max();
+        status.index = m_nMacPackets;
+
+        // Retransmissions send the same packet, which is only counted once
+        if (!m_macPacketTracker
+                 .insert(std::pair<Ptr<const Packet>, MacPacketStatus>(packet, status))
+                 .second)
+        {
+            return;
+        }
+        m_nMacPackets++;
+
+        for (auto& window : m_windows)
+        {
+            window.devices[status.senderId].sent++;
+        }
 
-        m_macPacketTracker.insert(std::pair<Ptr<const Packet>, MacPacketStatus>(packet, status));
         CleanupOldPackets();
     }
 }
@@ -74,6 +208,24 @@ LoraPacketTracker::RequiredTransmissionsCallback(uint8_t reqTx,
     NS_LOG_DEBUG("Packet: " << packet << "ReqTx " << unsigned(reqTx) << ", succ: " << success
                             << ", firstAttempt: " << firstAttempt.GetSeconds());
 
+    if (m_log)
+    {
+        LoraPacketLogRecord record;
+        record.time = Simulator::Now();
+        record.uid = packet->GetUid();
+        record.node = Simulator::GetContext();
+        record.type = LoraPacketLogRecord::MAC_DONE;
+        record.outcome = reqTx;
+        record.success = success;
+        record.size = packet->GetSize();
+        record.firstAttempt = firstAttempt;
+        m_log->Append(record);
+    }
+    if (!m_storePackets)
+    {
+        return;
+    }
+
     RetransmissionStatus entry;
     entry.firstAttempt = firstAttempt;
     entry.finishTime = Simulator::Now();
@@ -92,16 +244,31 @@ LoraPacketTracker::MacGwReceptionCallback(Ptr<const Packet> packet)
         NS_LOG_INFO("A packet was successfully received"
                     << " at the MAC layer of gateway " << Simulator::GetContext());
 
+        if (m_log)
+        {
+            LogEvent(LoraPacketLogRecord::MAC_GW_RX, packet, Simulator::GetContext());
+        }
+        if (!m_storePackets)
+        {
+            return;
+        }
+
+        // Packet sent by a device of another rank, merged by MergeRanks
+        uint32_t systemId;
+        if (IsFromOtherRank(packet, systemId))
+        {
+            m_remoteMacReceptions.push_back({packet->GetUid(),
+                                             systemId,
+                                             Simulator::GetContext(),
+                                             Simulator::Now().GetTimeStep()});
+            return;
+        }
+
         // Find the received packet in the m_macPacketTracker
         auto it = m_macPacketTracker.find(packet);
         if (it != m_macPacketTracker.end())
         {
-            (*it).second.receptionTimes.insert(
-                std::pair<int, Time>(Simulator::GetContext(), Simulator::Now()));
-            if (Simulator::Now() < (*it).second.receivedTime)
-            {
-                (*it).second.receivedTime = Simulator::Now();
-            }
+            StoreMacReception((*it).second, Simulator::GetContext(), Simulator::Now());
         }
         else
         {
@@ -110,6 +277,26 @@ LoraPacketTracker::MacGwReceptionCallback(Ptr<const Packet> packet)
     }
 }
 
+void
+LoraPacketTracker::StoreMacReception(MacPacketStatus& status, uint32_t gwId, Time time)
+{
+    if (status.receptionTimes.empty())
+    {
+        for (auto& window : m_windows)
+        {
+            if (status.index >= window.firstMacPacket)
+            {
+                window.devices[status.senderId].received++;
+            }
+        }
+    }
+    status.receptionTimes.insert(std::pair<int, Time>(gwId, time));
+    if (time < status.receivedTime)
+    {
+        status.receivedTime = time;
+    }
+}
+
 /////////////////
 // PHY metrics //
 /////////////////
@@ -120,13 +307,37 @@ LoraPacketTracker::TransmissionCallback(Ptr<const Packet> packet, uint32_t edId)
     if (IsUplink(packet))
     {
         NS_LOG_INFO("PHY packet " << packet << " was transmitted by device " << edId);
+
+        // Retransmissions send the same packet: outcomes at gateways are
+        // matched with its latest transmission
+        uint64_t index = m_nPhyPackets++;
+        m_phyTransmissions[packet] = {index, Simulator::Now()};
+        CleanupPhyTransmissions();
+
+        if (m_log)
+        {
+            LogEvent(LoraPacketLogRecord::PHY_TX, packet, edId, UNSET, index);
+        }
+        if (!m_storePackets)
+        {
+            return;
+        }
+
         // Create a packetStatus
         PacketStatus status;
         status.packet = packet;
         status.sendTime = Simulator::Now();
         status.senderId = edId;
+        status.index = index;
+        status.globalOutcome = GetOutcomeColumn(UNSET);
 
-        m_packetTracker.insert(std::pair<Ptr<const Packet>, PacketStatus>(packet, status));
+        for (auto& window : m_windows)
+        {
+            window.global[0]++;
+            window.global[status.globalOutcome]++;
+        }
+
+        m_packetTracker.insert(std::pair<uint64_t, PacketStatus>(index, status));
         CleanupOldPackets();
     }
 }
@@ -139,8 +350,7 @@ LoraPacketTracker::PacketReceptionCallback(Ptr<const Packet> packet, uint32_t gw
         // Remove the successfully received packet from the list of sent ones
         NS_LOG_INFO("PHY packet " << packet << " was successfully received at gateway " << gwId);
 
-        auto it = m_packetTracker.find(packet);
-        (*it).second.outcomes.insert(std::pair<int, enum PhyPacketOutcome>(gwId, RECEIVED));
+        RecordPhyOutcome(packet, gwId, RECEIVED);
     }
 }
 
@@ -151,8 +361,7 @@ LoraPacketTracker::InterferenceCallback(Ptr<const Packet> packet, uint32_t gwId)
     {
         NS_LOG_INFO("PHY packet " << packet << " was interfered at gateway " << gwId);
 
-        auto it = m_packetTracker.find(packet);
-        (*it).second.outcomes.insert(std::pair<int, enum PhyPacketOutcome>(gwId, INTERFERED));
+        RecordPhyOutcome(packet, gwId, INTERFERED);
     }
 }
 
@@ -163,9 +372,7 @@ LoraPacketTracker::NoMoreReceiversCallback(Ptr<const Packet> packet, uint32_t gw
     {
         NS_LOG_INFO("PHY packet " << packet << " was lost because no more receivers at gateway "
                                   << gwId);
-        auto it = m_packetTracker.find(packet);
-        (*it).second.outcomes.insert(
-            std::pair<int, enum PhyPacketOutcome>(gwId, NO_MORE_RECEIVERS));
+        RecordPhyOutcome(packet, gwId, NO_MORE_RECEIVERS);
     }
 }
 
@@ -177,9 +384,7 @@ LoraPacketTracker::UnderSensitivityCallback(Ptr<const Packet> packet, uint32_t g
         NS_LOG_INFO("PHY packet " << packet << " was lost because under sensitivity at gateway "
                                   << gwId);
 
-        auto it = m_packetTracker.find(packet);
-        (*it).second.outcomes.insert(
-            std::pair<int, enum PhyPacketOutcome>(gwId, UNDER_SENSITIVITY));
+        RecordPhyOutcome(packet, gwId, UNDER_SENSITIVITY);
     }
 }
 
@@ -191,11 +396,123 @@ LoraPacketTracker::LostBecauseTxCallback(Ptr<const Packet> packet, uint32_t gwId
         NS_LOG_INFO("PHY packet " << packet << " was lost because of GW transmission at gateway "
                                   << gwId);
 
-        auto it = m_packetTracker.find(packet);
-        (*it).second.outcomes.insert(std::pair<int, enum PhyPacketOutcome>(gwId, LOST_BECAUSE_TX));
+        RecordPhyOutcome(packet, gwId, LOST_BECAUSE_TX);
     }
 }
 
+void
+LoraPacketTracker::RecordPhyOutcome(Ptr<const Packet> packet,
+                                    uint32_t gwId,
+                                    enum PhyPacketOutcome outcome)
+{
+    // Packet sent by a device of another rank, merged by MergeRanks
+    uint32_t systemId;
+    if (IsFromOtherRank(packet, systemId))
+    {
+        if (m_storePackets)
+        {
+            m_remotePhyOutcomes.push_back(
+                {packet->GetUid(), systemId, gwId, outcome, Simulator::Now().GetTimeStep()});
+        }
+        return;
+    }
+
+    auto tx = m_phyTransmissions.find(packet);
+    NS_ASSERT_MSG(tx != m_phyTransmissions.end(), "Packet not found in tracker");
+    uint64_t index = tx->second.first;
+    if (m_log)
+    {
+        LogEvent(LoraPacketLogRecord::PHY_OUTCOME, packet, gwId, outcome, index);
+    }
+    if (!m_storePackets)
+    {
+        return;
+    }
+
+    auto it = m_packetTracker.find(index);
+    NS_ASSERT_MSG(it != m_packetTracker.end(), "Packet not found in tracker");
+    StorePhyOutcome((*it).second, gwId, outcome);
+}
+
+void
+LoraPacketTracker::CleanupPhyTransmissions()
+{
+    // Outcomes are known by the end of receptions, within a few seconds
+    Time horizon = Minutes(1);
+    if (Simulator::Now() < m_lastPhyTransmissionsCleanup + horizon)
+    {
+        return;
+    }
+
+    for (auto it = m_phyTransmissions.begin(); it != m_phyTransmissions.end();)
+    {
+        if (it->second.second < Simulator::Now() - horizon)
+        {
+            it = m_phyTransmissions.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    m_lastPhyTransmissionsCleanup = Simulator::Now();
+}
+
+void
+LoraPacketTracker::StorePhyOutcome(PacketStatus& status,
+                                   uint32_t gwId,
+                                   enum PhyPacketOutcome outcome)
+{
+    if (!status.outcomes.insert(std::pair<int, enum PhyPacketOutcome>(gwId, outcome)).second)
+    {
+        return;
+    }
+
+    int column = GetOutcomeColumn(outcome);
+    int previous = status.globalOutcome;
+    status.globalOutcome = std::min(previous, column);
+    for (auto& window : m_windows)
+    {
+        if (status.index < window.firstPhyPacket)
+        {
+            continue;
+        }
+        std::vector<int>& gwCount = window.gws[gwId].v;
+        gwCount[0]++;
+        gwCount[column]++;
+        window.global[previous]--;
+        window.global[status.globalOutcome]++;
+    }
+}
+
+void
+LoraPacketTracker::LogEvent(uint8_t type,
+                            Ptr<const Packet> packet,
+                            uint32_t nodeId,
+                            enum PhyPacketOutcome outcome,
+                            uint64_t phyTx)
+{
+    LoraPacketLogRecord record;
+    record.time = Simulator::Now();
+    record.uid = packet->GetUid();
+    record.phyTx = phyTx;
+    record.node = nodeId;
+    record.type = LoraPacketLogRecord::Type(type);
+    record.outcome = outcome;
+    record.size = packet->GetSize();
+    LoraTag tag;
+    if (packet->PeekPacketTag(tag))
+    {
+        record.dataRate = tag.GetDataRate();
+        if (outcome == RECEIVED)
+        {
+            record.rxPower = tag.GetReceivePower();
+            record.snr = tag.GetSnr();
+        }
+    }
+    m_log->Append(record);
+}
+
 bool
 LoraPacketTracker::IsUplink(Ptr<const Packet> packet)
 {
@@ -336,13 +653,7 @@ LoraPacketTracker::PrintPhyPacketsAllGws(Time startTime, Time stopTime, GwsPhyPk
     CountPhyPacketsAllGws(startTime, stopTime, count);
     for (const auto& gw : count)
     {
-        std::string out("");
-        for (int i = 0; i < 5; ++i)
-        {
-            out += std::to_string(gw.second.v[i]) + " ";
-        }
-        out += std::to_string(gw.second.v[5]);
-        output[gw.first].s = out;
+        output[gw.first].s = PrintCounts(gw.second.v);
     }
 }
 
@@ -405,13 +716,7 @@ LoraPacketTracker::PrintPhyPacketsGlobally(Time startTime, Time stopTime)
         }
     }
 
-    std::string output("");
-    for (int i = 0; i < 5; ++i)
-    {
-        output += std::to_string(count[i]) + " ";
-    }
-    output += std::to_string(count[5]);
-    return output;
+    return PrintCounts(count);
 }
 
 std::string
@@ -537,13 +842,13 @@ LoraPacketTracker::PrintSimulationStatistics(Time startTime)
 
         LoraPhyTxParameters params;
         LoraTag tag;
-        pd.first->Copy()->RemovePacketTag(tag);
+        pd.second.packet->PeekPacketTag(tag);
         params.sf = tag.GetTxParameters().sf;
         params.lowDataRateOptimizationEnabled = LoraPhy::GetTSym(params) > MilliSeconds(16);
-        totOffTraff += LoraPhy::GetTimeOnAir(pd.first->Copy(), params).GetSeconds();
+        totOffTraff += LoraPhy::GetTimeOnAir(pd.second.packet->GetSize(), params).GetSeconds();
 
         total++;
-        totBytesSent += pd.first->GetSize();
+        totBytesSent += pd.second.packet->GetSize();
         sentSF[tag.GetDataRate()]++;
         for (const auto& out : pd.second.outcomes)
         {
@@ -551,7 +856,7 @@ LoraPacketTracker::PrintSimulationStatistics(Time startTime)
             {
                 received = true;
                 receivedSF[tag.GetDataRate()]++;
-                totBytesReceived += pd.first->GetSize();
+                totBytesReceived += pd.second.packet->GetSize();
                 break;
             }
             else if (!interfered and out.second == INTERFERED)
@@ -614,6 +919,49 @@ LoraPacketTracker::PrintSimulationStatistics(Time startTime)
     return ss.str();
 }
 
+void
+LoraPacketTracker::EnableBinaryLog(std::string filename, bool storePackets)
+{
+    NS_LOG_FUNCTION(this << filename << storePackets);
+
+    NS_ABORT_MSG_IF(!storePackets && !m_windows.empty(),
+                    "Counting windows (e.g., of periodic printers) need stored packets");
+    m_log = std::make_unique<LoraPacketLogWriter>(filename);
+    m_storePackets = storePackets;
+}
+
+int
+LoraPacketTracker::GetOutcomeColumn(enum PhyPacketOutcome outcome)
+{
+    switch (outcome)
+    {
+    case RECEIVED:
+        return 1;
+    case INTERFERED:
+        return 2;
+    case NO_MORE_RECEIVERS:
+        return 3;
+    case LOST_BECAUSE_TX:
+        return 4;
+    case UNDER_SENSITIVITY:
+    case UNSET:
+    default:
+        return 5;
+    }
+}
+
+std::string
+LoraPacketTracker::PrintCounts(const std::vector<int>& counts)
+{
+    std::string output("");
+    for (int i = 0; i < 5; ++i)
+    {
+        output += std::to_string(counts[i]) + " ";
+    }
+    output += std::to_string(counts[5]);
+    return output;
+}
+
 void
 LoraPacketTracker::EnableOldPacketsCleanup(Time oldPacketThreshold)
 {
@@ -674,5 +1022,260 @@ LoraPacketTracker::CleanupOldPackets()
     m_lastPacketCleanup = Simulator::Now();
 }
 
+//////////////////////
+// Counting windows //
+//////////////////////
+
+uint32_t
+LoraPacketTracker::OpenCountingWindow()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_IF(!m_storePackets,
+                    "Counting windows (e.g., of periodic printers) need stored packets");
+
+    m_windows.emplace_back();
+    uint32_t window = m_windows.size() - 1;
+    ResetCountingWindow(window);
+    return window;
+}
+
+void
+LoraPacketTracker::ResetCountingWindow(uint32_t window)
+{
+    NS_LOG_FUNCTION(this << window);
+    NS_ASSERT_MSG(window < m_windows.size(), "Unknown counting window");
+
+    PacketCountingWindow& w = m_windows[window];
+    w.firstPhyPacket = m_nPhyPackets;
+    w.firstMacPacket = m_nMacPackets;
+    w.gws.clear();
+    w.global.assign(6, 0);
+    w.devices.clear();
+}
+
+const PacketCountingWindow&
+LoraPacketTracker::GetCountingWindow(uint32_t window) const
+{
+    NS_ASSERT_MSG(window < m_windows.size(), "Unknown counting window");
+    return m_windows[window];
+}
+
+void
+LoraPacketTracker::PrintPhyPacketsAllGws(uint32_t window, GwsPhyPktPrint& output)
+{
+    NS_LOG_FUNCTION(this << window);
+
+    output.clear();
+    for (const auto& gw : GetCountingWindow(window).gws)
+    {
+        output[gw.first].s = PrintCounts(gw.second.v);
+    }
+}
+
+std::string
+LoraPacketTracker::PrintPhyPacketsGlobally(uint32_t window)
+{
+    NS_LOG_FUNCTION(this << window);
+
+    return PrintCounts(GetCountingWindow(window).global);
+}
+
+void
+LoraPacketTracker::CountAllDevicesPackets(uint32_t window, DevPktCount& out)
+{
+    NS_LOG_FUNCTION(this << window);
+
+    out = GetCountingWindow(window).devices;
+}
+
+////////////////////////////
+// Distributed simulation //
+////////////////////////////
+
+bool
+LoraPacketTracker::IsFromOtherRank(Ptr<const Packet> packet, uint32_t& systemId)
+{
+#ifdef NS3_MPI
+    LoraRankTag tag;
+    if (packet->PeekPacketTag(tag))
+    {
+        systemId = tag.GetSystemId();
+        return true;
+    }
+#endif
+    return false;
+}
+
+void
+LoraPacketTracker::MergeRanks()
+{
+    NS_LOG_FUNCTION(this);
+
+#ifdef NS3_MPI
+    if (!MpiInterface::IsEnabled() || MpiInterface::GetSize() == 1)
+    {
+        return;
+    }
+    NS_ABORT_MSG_IF(!m_storePackets, "Packets must be stored to be merged across ranks");
+    uint32_t systemId = MpiInterface::GetSystemId();
+
+    // Return the outcomes at gateways of this rank to the rank of the sender
+    std::vector<uint8_t> buffer;
+    Put(buffer, uint64_t(m_remotePhyOutcomes.size()));
+    for (const auto& outcome : m_remotePhyOutcomes)
+    {
+        Put(buffer, outcome);
+    }
+    Put(buffer, uint64_t(m_remoteMacReceptions.size()));
+    for (const auto& reception : m_remoteMacReceptions)
+    {
+        Put(buffer, reception);
+    }
+    m_remotePhyOutcomes.clear();
+    m_remoteMacReceptions.clear();
+    std::vector<uint8_t> received = Exchange(buffer, true);
+
+    // Packet uids are preserved by transfers between ranks. Retransmissions
+    // share the uid, in order of transmission.
+    std::unordered_map<uint64_t, std::vector<PacketStatus*>> phyPackets;
+    for (auto& ppd : m_packetTracker)
+    {
+        phyPackets[ppd.second.packet->GetUid()].push_back(&ppd.second);
+    }
+    std::unordered_map<uint64_t, MacPacketStatus*> macPackets;
+    for (auto& mpd : m_macPacketTracker)
+    {
+        macPackets[mpd.first->GetUid()] = &mpd.second;
+    }
+    for (size_t pos = 0; pos < received.size();)
+    {
+        auto nOutcomes = Get<uint64_t>(received, pos);
+        for (uint64_t i = 0; i < nOutcomes; ++i)
+        {
+            auto outcome = Get<RemotePhyOutcome>(received, pos);
+            auto it = phyPackets.find(outcome.uid);
+            if (outcome.systemId != systemId || it == phyPackets.end())
+            {
+                continue;
+            }
+            // Latest transmission before the outcome
+            for (auto tx = it->second.rbegin(); tx != it->second.rend(); ++tx)
+            {
+                if ((*tx)->sendTime <= TimeStep(outcome.time))
+                {
+                    StorePhyOutcome(**tx, outcome.gwId, outcome.outcome);
+                    break;
+                }
+            }
+        }
+        auto nReceptions = Get<uint64_t>(received, pos);
+        for (uint64_t i = 0; i < nReceptions; ++i)
+        {
+            auto reception = Get<RemoteMacReception>(received, pos);
+            auto it = macPackets.find(reception.uid);
+            if (reception.systemId == systemId && it != macPackets.end())
+            {
+                StoreMacReception(*it->second, reception.gwId, TimeStep(reception.time));
+            }
+        }
+    }
+
+    // Gather the packets of all ranks at rank 0
+    buffer.clear();
+    if (systemId != 0)
+    {
+        Put(buffer, uint64_t(m_packetTracker.size()));
+        for (const auto& ppd : m_packetTracker)
+        {
+            Put(buffer, ppd.second.senderId);
+            Put(buffer, ppd.second.sendTime.GetTimeStep());
+            Put(buffer, uint64_t(ppd.second.outcomes.size()));
+            for (const auto& out : ppd.second.outcomes)
+            {
+                Put(buffer, int32_t(out.first));
+                Put(buffer, int32_t(out.second));
+            }
+        }
+        Put(buffer, uint64_t(m_macPacketTracker.size()));
+        for (const auto& mpd : m_macPacketTracker)
+        {
+            Put(buffer, mpd.second.senderId);
+            Put(buffer, mpd.second.sendTime.GetTimeStep());
+            Put(buffer, mpd.second.receivedTime.GetTimeStep());
+            Put(buffer, uint64_t(mpd.second.receptionTimes.size()));
+            for (const auto& rx : mpd.second.receptionTimes)
+            {
+                Put(buffer, int32_t(rx.first));
+                Put(buffer, rx.second.GetTimeStep());
+            }
+        }
+        Put(buffer, uint64_t(m_reTransmissionTracker.size()));
+        for (const auto& rtd : m_reTransmissionTracker)
+        {
+            Put(buffer, rtd.second.firstAttempt.GetTimeStep());
+            Put(buffer, rtd.second.finishTime.GetTimeStep());
+            Put(buffer, rtd.second.reTxAttempts);
+            Put(buffer, uint8_t(rtd.second.successful));
+        }
+    }
+    received = Exchange(buffer, false);
+
+    // Packets of other ranks are stored with placeholder packets as keys
+    for (size_t pos = 0; pos < received.size();)
+    {
+        auto nPhyPackets = Get<uint64_t>(received, pos);
+        for (uint64_t i = 0; i < nPhyPackets; ++i)
+        {
+            PacketStatus status;
+            status.packet = Create<Packet>();
+            status.senderId = Get<uint32_t>(received, pos);
+            status.sendTime = TimeStep(Get<int64_t>(received, pos));
+            status.index = m_nPhyPackets++;
+            status.globalOutcome = GetOutcomeColumn(UNSET);
+            auto nOutcomes = Get<uint64_t>(received, pos);
+            for (uint64_t j = 0; j < nOutcomes; ++j)
+            {
+                auto gwId = Get<int32_t>(received, pos);
+                auto outcome = PhyPacketOutcome(Get<int32_t>(received, pos));
+                status.outcomes[gwId] = outcome;
+                status.globalOutcome = std::min(status.globalOutcome, GetOutcomeColumn(outcome));
+            }
+            m_packetTracker.insert(std::pair<uint64_t, PacketStatus>(status.index, status));
+        }
+        auto nMacPackets = Get<uint64_t>(received, pos);
+        for (uint64_t i = 0; i < nMacPackets; ++i)
+        {
+            MacPacketStatus status;
+            status.packet = Create<Packet>();
+            status.senderId = Get<uint32_t>(received, pos);
+            status.sendTime = TimeStep(Get<int64_t>(received, pos));
+            status.receivedTime = TimeStep(Get<int64_t>(received, pos));
+            status.index = m_nMacPackets++;
+            auto nReceptions = Get<uint64_t>(received, pos);
+            for (uint64_t j = 0; j < nReceptions; ++j)
+            {
+                auto gwId = Get<int32_t>(received, pos);
+                status.receptionTimes[gwId] = TimeStep(Get<int64_t>(received, pos));
+            }
+            m_macPacketTracker.insert(
+                std::pair<Ptr<const Packet>, MacPacketStatus>(status.packet, status));
+        }
+        auto nRetransmissions = Get<uint64_t>(received, pos);
+        for (uint64_t i = 0; i < nRetransmissions; ++i)
+        {
+            RetransmissionStatus entry;
+            entry.firstAttempt = TimeStep(Get<int64_t>(received, pos));
+            entry.finishTime = TimeStep(Get<int64_t>(received, pos));
+            entry.reTxAttempts = Get<uint8_t>(received, pos);
+            entry.successful = Get<uint8_t>(received, pos);
+            m_reTransmissionTracker.insert(
+                std::pair<Ptr<Packet>, RetransmissionStatus>(Create<Packet>(), entry));
+        }
+    }
+    NS_LOG_INFO("Rank " << systemId << " tracks " << m_packetTracker.size() << " PHY packets and "
+                        << m_macPacketTracker.size() << " MAC packets after merging");
+#endif
+}
+
 } // namespace lorawan
 } // namespace ns3
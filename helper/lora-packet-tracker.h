@@ -17,7 +17,10 @@
 #include "ns3/packet.h"
 
 #include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -40,6 +43,8 @@ struct PacketStatus
     uint32_t senderId;
     Time sendTime;
     std::map<int, enum PhyPacketOutcome> outcomes;
+    uint64_t index;    //!< Order of transmission among PHY packets
+    int globalOutcome; //!< Column of the best outcome in global performance counts
 };
 
 struct MacPacketStatus
@@ -49,6 +54,7 @@ struct MacPacketStatus
     Time sendTime;
     Time receivedTime;
     std::map<int, Time> receptionTimes;
+    uint64_t index; //!< Order of transmission among MAC packets
 };
 
 struct RetransmissionStatus
@@ -60,7 +66,8 @@ struct RetransmissionStatus
 };
 
 typedef std::map<Ptr<const Packet>, MacPacketStatus> MacPacketData;
-typedef std::map<Ptr<const Packet>, PacketStatus> PhyPacketData;
+/// PHY transmissions by order, since retransmissions send the same packet
+typedef std::map<uint64_t, PacketStatus> PhyPacketData;
 typedef std::map<Ptr<const Packet>, RetransmissionStatus> RetransmissionData;
 
 struct devCount_t
@@ -85,6 +92,23 @@ struct phyPrint_t
 
 using GwsPhyPktPrint = std::unordered_map<uint32_t, phyPrint_t>;
 
+/**
+ * Packet counts of a counting window, i.e., of the packets sent since the last
+ * reset of the window. Counts are kept up to date by the trace callbacks of
+ * the tracker as packets are sent and their outcomes become known, so that they
+ * can be read without scanning the packet history.
+ */
+struct PacketCountingWindow
+{
+    uint64_t firstPhyPacket; //!< Index of the first PHY packet of the window
+    uint64_t firstMacPacket; //!< Index of the first MAC packet of the window
+    GwsPhyPktCount gws;      //!< PHY outcomes at each gateway, as in CountPhyPacketsAllGws
+    std::vector<int> global = std::vector<int>(6, 0); //!< As in PrintPhyPacketsGlobally
+    DevPktCount devices;                              //!< As in CountAllDevicesPackets
+};
+
+class LoraPacketLogWriter;
+
 class LoraPacketTracker
 {
   public:
@@ -177,15 +201,168 @@ class LoraPacketTracker
 
     void EnableOldPacketsCleanup(Time oldPacketThreshold = Hours(12));
 
+    /**
+     * Append every traced packet event to a binary log file, to be read with
+     * the LoraPacketLogReader.
+     *
+     * \param filename The name of the log file.
+     * \param storePackets Whether to also keep packets in memory. If not, the
+     *                     memory used by the tracker is constant, but its
+     *                     counting functions stop counting, and counting
+     *                     windows (e.g., of the periodic printers of the
+     *                     LorawanHelper) cannot be opened.
+     */
+    void EnableBinaryLog(std::string filename, bool storePackets = true);
+
+    /**
+     * \param outcome A PHY outcome.
+     * \return The column of the outcome in per-gateway and global performance
+     *         counts, also giving the priority of outcomes when merging those of
+     *         different gateways.
+     */
+    static int GetOutcomeColumn(enum PhyPacketOutcome outcome);
+
+    /**
+     * \param counts Performance counts.
+     * \return The counts as space-separated values.
+     */
+    static std::string PrintCounts(const std::vector<int>& counts);
+
+    //////////////////////
+    // Counting windows //
+    //////////////////////
+
+    /**
+     * Start counting the packets sent from now on, updating counts as trace
+     * callbacks are executed.
+     *
+     * Counts are the same as the ones of the corresponding counting functions
+     * over the time interval from the opening (or last reset) of the window,
+     * but reading them does not depend on the number of tracked packets.
+     *
+     * \return The identifier of the window.
+     */
+    uint32_t OpenCountingWindow();
+
+    /**
+     * Restart counting packets from now on.
+     *
+     * \param window The identifier of the window.
+     */
+    void ResetCountingWindow(uint32_t window);
+
+    /**
+     * \param window The identifier of the window.
+     * \return The packet counts of the window.
+     */
+    const PacketCountingWindow& GetCountingWindow(uint32_t window) const;
+
+    void PrintPhyPacketsAllGws(uint32_t window, GwsPhyPktPrint& output);
+    std::string PrintPhyPacketsGlobally(uint32_t window);
+    void CountAllDevicesPackets(uint32_t window, DevPktCount& out);
+
+    ////////////////////////////
+    // Distributed simulation //
+    ////////////////////////////
+
+    /**
+     * Merge the packets tracked by the ranks of a distributed simulation into
+     * the tracker of rank 0. It must be called by every rank once the
+     * simulation is over.
+     *
+     * Outcomes of transmissions at gateways of other ranks are first returned
+     * to the rank of the sender, then rank 0 gathers the packets of all ranks,
+     * so that its counting functions cover the whole network. Counting windows
+     * only include the packets of their rank. Without MPI, or with a single
+     * rank, this does nothing.
+     */
+    void MergeRanks();
+
   private:
+    /**
+     * Outcome at a gateway of this rank of a PHY packet sent by another rank.
+     */
+    struct RemotePhyOutcome
+    {
+        uint64_t uid;                  //!< Uid of the packet
+        uint32_t systemId;             //!< Rank of the sender
+        uint32_t gwId;                 //!< Gateway
+        enum PhyPacketOutcome outcome; //!< Outcome
+        int64_t time;                  //!< Time step of the outcome
+    };
+
+    /**
+     * Reception at a gateway of this rank of a MAC packet sent by another rank.
+     */
+    struct RemoteMacReception
+    {
+        uint64_t uid;      //!< Uid of the packet
+        uint32_t systemId; //!< Rank of the sender
+        uint32_t gwId;     //!< Gateway
+        int64_t time;      //!< Time step of the reception
+    };
+
+    /**
+     * \param packet A received packet.
+     * \param systemId Set to the rank of the sender, if it is another rank.
+     * \return Whether the packet was sent by a device of another rank.
+     */
+    static bool IsFromOtherRank(Ptr<const Packet> packet, uint32_t& systemId);
+
     void CleanupOldPackets();
 
+    /**
+     * Forget the transmissions of packets whose outcomes are all known.
+     */
+    void CleanupPhyTransmissions();
+
+    /**
+     * Log the outcome of a PHY packet at a gateway and store it, or keep it
+     * for MergeRanks if the packet was sent by another rank.
+     */
+    void RecordPhyOutcome(Ptr<const Packet> packet, uint32_t gwId, enum PhyPacketOutcome outcome);
+
+    /**
+     * Store the outcome of a tracked PHY packet at a gateway and update the
+     * counting windows, if it is the first outcome of the packet at the gateway.
+     */
+    void StorePhyOutcome(PacketStatus& status, uint32_t gwId, enum PhyPacketOutcome outcome);
+
+    /**
+     * Store the reception of a tracked MAC packet at a gateway and update the
+     * counting windows, if it is the first reception of the packet.
+     */
+    void StoreMacReception(MacPacketStatus& status, uint32_t gwId, Time time);
+
+    /**
+     * Append a packet event to the binary log.
+     */
+    void LogEvent(uint8_t type,
+                  Ptr<const Packet> packet,
+                  uint32_t nodeId,
+                  enum PhyPacketOutcome outcome = UNSET,
+                  uint64_t phyTx = 0);
+
     PhyPacketData m_packetTracker;
     MacPacketData m_macPacketTracker;
     RetransmissionData m_reTransmissionTracker;
 
     Time m_oldPacketThreshold;
     Time m_lastPacketCleanup;
+
+    /// Latest PHY transmission (index, time) of packets recently sent
+    std::map<Ptr<const Packet>, std::pair<uint64_t, Time>> m_phyTransmissions;
+    Time m_lastPhyTransmissionsCleanup; //!< Time of the last CleanupPhyTransmissions
+
+    uint64_t m_nPhyPackets;                      //!< Number of PHY packets tracked so far
+    uint64_t m_nMacPackets;                      //!< Number of MAC packets tracked so far
+    std::vector<PacketCountingWindow> m_windows; //!< Open counting windows
+
+    std::unique_ptr<LoraPacketLogWriter> m_log; //!< Binary log of packet events, if enabled
+    bool m_storePackets;                        //!< Whether packets are kept in memory
+
+    std::vector<RemotePhyOutcome> m_remotePhyOutcomes;     //!< To be merged by MergeRanks
+    std::vector<RemoteMacReception> m_remoteMacReceptions; //!< To be merged by MergeRanks
 };
 } // namespace lorawan
 } // namespace ns3
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2026 University of Bologna
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Alessandro Aimi <alessandro.aimi@unibo.it>
+ */
+
+#include "lora-pcapng-capture.h"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/trace-helper.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace ns3
+{
+namespace lorawan
+{
+
+NS_LOG_COMPONENT_DEFINE("LoraPcapngCapture");
+
+// Block types and options of the pcapng format
+static const uint32_t SECTION_HEADER_BLOCK = 0x0a0d0d0a;
+static const uint32_t INTERFACE_DESCRIPTION_BLOCK = 0x00000001;
+static const uint32_t ENHANCED_PACKET_BLOCK = 0x00000006;
+static const uint32_t BYTE_ORDER_MAGIC = 0x1a2b3c4d;
+static const uint16_t OPT_ENDOFOPT = 0;
+static const uint16_t IF_NAME = 2;
+static const uint16_t IF_TSRESOL = 9;
+
+// Size of accumulated blocks handed at once to the writer (bytes)
+static const std::size_t SUBMIT_SIZE = 1 << 16;
+
+static void
+Append(std::string& blocks, uint64_t value, uint32_t bytes)
+{
+    for (uint32_t i = 0; i < bytes; i++)
+    {
+        blocks.push_back(char((value >> (8 * i)) & 0xff));
+    }
+}
+
+static void
+Pad(std::string& blocks)
+{
+    blocks.append((4 - blocks.size() % 4) % 4, '\0');
+}
+
+LoraPcapngCapture::LoraPcapngCapture(const std::string& prefix,
+                                     uint64_t maxFileBytes,
+                                     Time maxFileDuration,
+                                     uint32_t snapLen)
+    : m_prefix(prefix),
+      m_maxFileBytes(maxFileBytes),
+      m_maxFileDuration(maxFileDuration),
+      m_snapLen(snapLen),
+      m_nFiles(0),
+      m_fileBytes(0),
+      m_fileFrames(0)
+{
+    NS_LOG_FUNCTION(this << prefix << maxFileBytes << maxFileDuration << snapLen);
+
+    m_headerBuffer.AddAtStart(m_header.GetSerializedSize());
+    m_blocks.reserve(SUBMIT_SIZE + (1 << 10));
+}
+
+LoraPcapngCapture::~LoraPcapngCapture()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+uint32_t
+LoraPcapngCapture::AddInterface(const std::string& name)
+{
+    NS_LOG_FUNCTION(this << name);
+
+    m_interfaces.push_back(name);
+    if (m_writer)
+    {
+        AppendInterface(name);
+    }
+    return m_interfaces.size() - 1;
+}
+
+void
+LoraPcapngCapture::Write(uint32_t interface, Ptr<const Packet> packet)
+{
+    NS_LOG_FUNCTION(this << interface << packet);
+    NS_ASSERT_MSG(interface < m_interfaces.size(), "Unknown capture interface");
+
+    uint32_t headerSize = m_headerBuffer.GetSize();
+    uint32_t length = headerSize + packet->GetSize();
+    uint32_t captured = (m_snapLen) ? std::min(length, m_snapLen) : length;
+    uint32_t blockSize = 32 + captured + (4 - captured % 4) % 4;
+
+    Time now = Simulator::Now();
+    bool tooLarge = m_maxFileBytes && m_fileBytes + m_blocks.size() + blockSize > m_maxFileBytes;
+    bool tooLong = m_maxFileDuration.IsStrictlyPositive() && now - m_fileStart >= m_maxFileDuration;
+    if (!m_writer || (m_fileFrames && (tooLarge || tooLong)))
+    {
+        StartFile();
+    }
+    m_fileFrames++;
+
+    LoraTag tag;
+    packet->PeekPacketTag(tag);
+    m_header.Fill(tag);
+    m_header.Serialize(m_headerBuffer.Begin());
+
+    uint64_t timestamp = now.GetNanoSeconds();
+    Append(m_blocks, ENHANCED_PACKET_BLOCK, 4);
+    Append(m_blocks, blockSize, 4);
+    Append(m_blocks, interface, 4);
+    Append(m_blocks, timestamp >> 32, 4);
+    Append(m_blocks, timestamp & 0xffffffff, 4);
+    Append(m_blocks, captured, 4);
+    Append(m_blocks, length, 4);
+    std::size_t offset = m_blocks.size();
+    m_blocks.resize(offset + captured);
+    auto data = reinterpret_cast<uint8_t*>(&m_blocks[offset]);
+    m_headerBuffer.CopyData(data, std::min(captured, headerSize));
+    if (captured > headerSize)
+    {
+        packet->CopyData(data + headerSize, captured - headerSize);
+    }
+    Pad(m_blocks);
+    Append(m_blocks, blockSize, 4);
+
+    if (m_blocks.size() >= SUBMIT_SIZE)
+    {
+        Submit();
+    }
+}
+
+void
+LoraPcapngCapture::Close()
+{
+    NS_LOG_FUNCTION(this);
+
+    if (!m_writer)
+    {
+        return;
+    }
+    Submit();
+    m_writer->Close();
+    m_writer.reset();
+}
+
+void
+LoraPcapngCapture::StartFile()
+{
+    NS_LOG_FUNCTION(this);
+
+    std::string filename = m_prefix + "-" + std::to_string(m_nFiles++) + ".pcapng";
+    if (m_writer)
+    {
+        Submit();
+        m_writer->Rotate(filename);
+    }
+    else
+    {
+        m_writer = std::make_unique<AsyncFileWriter>(filename);
+        // Callbacks of trace sources may keep the capture after the simulation
+        Simulator::ScheduleDestroy(&LoraPcapngCapture::Close, Ptr<LoraPcapngCapture>(this));
+    }
+    m_fileBytes = 0;
+    m_fileFrames = 0;
+    m_fileStart = Simulator::Now();
+
+    Append(m_blocks, SECTION_HEADER_BLOCK, 4);
+    Append(m_blocks, 28, 4);
+    Append(m_blocks, BYTE_ORDER_MAGIC, 4);
+    Append(m_blocks, 1, 2);          // Major version
+    Append(m_blocks, 0, 2);          // Minor version
+    Append(m_blocks, UINT64_MAX, 8); // Unspecified section length
+    Append(m_blocks, 28, 4);
+    for (const auto& name : m_interfaces)
+    {
+        AppendInterface(name);
+    }
+}
+
+void
+LoraPcapngCapture::AppendInterface(const std::string& name)
+{
+    uint32_t nameSize = name.size() + (4 - name.size() % 4) % 4;
+    uint32_t blockSize = 20 + (4 + nameSize) + (4 + 4) + 4;
+
+    Append(m_blocks, INTERFACE_DESCRIPTION_BLOCK, 4);
+    Append(m_blocks, blockSize, 4);
+    Append(m_blocks, PcapHelper::DLT_LORATAP, 2);
+    Append(m_blocks, 0, 2);
+    Append(m_blocks, m_snapLen, 4);
+    Append(m_blocks, IF_NAME, 2);
+    Append(m_blocks, name.size(), 2);
+    m_blocks.append(name);
+    Pad(m_blocks);
+    Append(m_blocks, IF_TSRESOL, 2);
+    Append(m_blocks, 1, 2);
+    Append(m_blocks, 9, 1); // Nanoseconds
+    Pad(m_blocks);
+    Append(m_blocks, OPT_ENDOFOPT, 2);
+    Append(m_blocks, 0, 2);
+    Append(m_blocks, blockSize, 4);
+}
+
+void
+LoraPcapngCapture::Submit()
+{
+    m_fileBytes += m_blocks.size();
+    m_writer->Write(std::move(m_blocks));
+    m_blocks.clear();
+    m_blocks.reserve(SUBMIT_SIZE + (1 << 10));
+}
+
+} // namespace lorawan
+} // namespace ns3
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2026 University of Bologna
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Alessandro Aimi <alessandro.aimi@unibo.it>
+ */
+
+#ifndef LORA_PCAPNG_CAPTURE_H
+#define LORA_PCAPNG_CAPTURE_H
+
+#include "async-file-writer.h"
+
+#include "ns3/buffer.h"
+#include "ns3/loratap-header.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/simple-ref-count.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+namespace lorawan
+{
+
+/**
+ * Capture of LoRaTap frames of many devices in a single pcapng file.
+ *
+ * Each device is an interface of the capture, and frames are recorded as
+ * pcapng enhanced packet blocks tagged with the interface id. Blocks are
+ * accumulated in memory and written by a background thread, and the file is
+ * completed and closed at Simulator::Destroy. The capture can
+ * be rotated to a new file when it exceeds a size or a duration, and frames
+ * can be truncated to a snapshot length.
+ */
+class LoraPcapngCapture : public SimpleRefCount<LoraPcapngCapture>
+{
+  public:
+    /**
+     * Create a capture, written to files named prefix-<n>.pcapng.
+     *
+     * \param prefix The prefix of file names.
+     * \param maxFileBytes The size after which the capture is rotated, 0 for no limit.
+     * \param maxFileDuration The duration after which the capture is rotated, 0 for no limit.
+     * \param snapLen The maximum number of captured bytes of frames, 0 for no limit.
+     */
+    LoraPcapngCapture(const std::string& prefix,
+                      uint64_t maxFileBytes = 0,
+                      Time maxFileDuration = Seconds(0),
+                      uint32_t snapLen = 0);
+    ~LoraPcapngCapture();
+
+    /**
+     * Add an interface to the capture.
+     *
+     * \param name The name of the interface.
+     * \return The id of the interface.
+     */
+    uint32_t AddInterface(const std::string& name);
+
+    /**
+     * Capture a frame with its LoRaTap header, filled from its LoraTag.
+     *
+     * \param interface The id of the interface the frame was sniffed on.
+     * \param packet The frame.
+     */
+    void Write(uint32_t interface, Ptr<const Packet> packet);
+
+    /**
+     * Write the accumulated blocks and close the current file. A later frame
+     * starts a new file.
+     */
+    void Close();
+
+  private:
+    /**
+     * Start a new file with the section header and all interfaces.
+     */
+    void StartFile();
+
+    /**
+     * Append the interface description block of an interface.
+     */
+    void AppendInterface(const std::string& name);
+
+    /**
+     * Hand the accumulated blocks to the background writer.
+     */
+    void Submit();
+
+    std::string m_prefix;                      //!< Prefix of file names
+    uint64_t m_maxFileBytes;                   //!< Size limit of files (bytes)
+    Time m_maxFileDuration;                    //!< Duration limit of files
+    uint32_t m_snapLen;                        //!< Maximum captured length of frames
+    std::vector<std::string> m_interfaces;     //!< Names of interfaces
+    uint32_t m_nFiles;                         //!< Number of files started
+    uint64_t m_fileBytes;                      //!< Bytes in the current file
+    Time m_fileStart;                          //!< Start of the current file
+    uint32_t m_fileFrames;                     //!< Number of frames in the current file
+    std::string m_blocks;                      //!< Blocks not yet handed to the writer
+    LoratapHeader m_header;                    //!< LoRaTap header, refilled for each frame
+    Buffer m_headerBuffer;                     //!< Serialization of the LoRaTap header
+    std::unique_ptr<AsyncFileWriter> m_writer; //!< Background writer of files
+};
+
+} // namespace lorawan
+} // namespace ns3
+
+#endif /* LORA_PCAPNG_CAPTURE_H */
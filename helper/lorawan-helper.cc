@@ -17,8 +17,9 @@
 #include "ns3/log.h"
 #include "ns3/lora-application.h"
 #include "ns3/loratap-header.h"
+#include "ns3/simulator.h"
 
-#include <fstream>
+#include <sstream>
 
 namespace ns3
 {
@@ -31,7 +32,11 @@ LorawanHelper::LorawanHelper()
     : m_lastPhyPerformanceUpdate(Seconds(0)),
       m_lastGlobalPerformanceUpdate(Seconds(0)),
       m_lastDeviceStatusUpdate(Seconds(0)),
-      m_lastSFStatusUpdate(Seconds(0))
+      m_lastSFStatusUpdate(Seconds(0)),
+      m_phyPerformanceWindow(NO_WINDOW),
+      m_globalPerformanceWindow(NO_WINDOW),
+      m_deviceStatusWindow(NO_WINDOW),
+      m_sfStatusWindow(NO_WINDOW)
 {
 }
 
@@ -102,6 +107,20 @@ LorawanHelper::Install(const LoraPhyHelper& phy, const LorawanMacHelper& mac, Pt
     return Install(phy, mac, NodeContainer(node));
 }
 
+void
+LorawanHelper::TrackPopulation(Ptr<LoraDevicePopulation> population) const
+{
+    NS_LOG_FUNCTION(this << population);
+    NS_ASSERT_MSG(m_packetTracker, "Packet tracking was not enabled");
+
+    population->TraceConnectWithoutContext(
+        "StartSending",
+        MakeCallback(&LoraPacketTracker::TransmissionCallback, m_packetTracker));
+    population->TraceConnectWithoutContext(
+        "SentNewPacket",
+        MakeCallback(&LoraPacketTracker::MacTransmissionCallback, m_packetTracker));
+}
+
 void
 LorawanHelper::EnablePacketTracking()
 {
@@ -119,6 +138,17 @@ LorawanHelper::GetPacketTracker()
     return *m_packetTracker;
 }
 
+void
+LorawanHelper::EnableSharedPcap(std::string prefix,
+                                uint64_t maxFileBytes,
+                                Time maxFileDuration,
+                                uint32_t snapLen)
+{
+    NS_LOG_FUNCTION(this << prefix << maxFileBytes << maxFileDuration << snapLen);
+
+    m_pcapCapture = Create<LoraPcapngCapture>(prefix, maxFileBytes, maxFileDuration, snapLen);
+}
+
 void
 LorawanHelper::EnableSimulationTimePrinting(Time interval)
 {
@@ -145,6 +175,10 @@ LorawanHelper::EnablePeriodicDeviceStatusPrinting(NodeContainer endDevices,
 {
     NS_LOG_FUNCTION(this);
 
+    if (m_deviceStatusWindow == NO_WINDOW)
+    {
+        m_deviceStatusWindow = m_packetTracker->OpenCountingWindow();
+    }
     DoPrintDeviceStatus(endDevices, gateways, filename);
 
     // Schedule periodic printing
@@ -162,65 +196,57 @@ LorawanHelper::DoPrintDeviceStatus(NodeContainer endDevices,
                                    NodeContainer gateways,
                                    std::string filename)
 {
-    const char* c = filename.c_str();
-    std::ofstream outputFile;
-    if (Simulator::Now() == Seconds(0))
+    PrintOutput& output = GetPrintOutput(filename, endDevices, gateways);
+
+    Time currentTime = Simulator::Now();
+    DevPktCount devPktCount;
+    if (m_deviceStatusWindow != NO_WINDOW)
     {
-        // Delete contents of the file as it is opened
-        outputFile.open(c, std::ofstream::out | std::ofstream::trunc);
+        m_packetTracker->CountAllDevicesPackets(m_deviceStatusWindow, devPktCount);
+        m_packetTracker->ResetCountingWindow(m_deviceStatusWindow);
     }
     else
     {
-        // Only append to the file
-        outputFile.open(c, std::ofstream::out | std::ofstream::app);
+        m_packetTracker->CountAllDevicesPackets(m_lastDeviceStatusUpdate,
+                                                currentTime,
+                                                devPktCount);
     }
 
-    Time currentTime = Simulator::Now();
-    DevPktCount devPktCount;
-    m_packetTracker->CountAllDevicesPackets(m_lastDeviceStatusUpdate, currentTime, devPktCount);
-
-    for (auto j = endDevices.Begin(); j != endDevices.End(); ++j)
+    std::ostringstream block;
+    for (const auto& device : output.devices)
     {
-        auto node = *j;
-        auto position = node->GetObject<MobilityModel>();
-        auto loraNetDevice = DynamicCast<LoraNetDevice>(node->GetDevice(0));
-        auto mac = DynamicCast<BaseEndDeviceLorawanMac>(loraNetDevice->GetMac());
-        auto app = DynamicCast<LoraApplication>(node->GetApplication(0));
-
-        Vector pos = position->GetPosition();
+        Vector pos = device.mobility->GetPosition();
 
         double gwdist = std::numeric_limits<double>::max();
-        for (auto gw = gateways.Begin(); gw != gateways.End(); ++gw)
+        for (const auto& gw : output.gateways)
         {
-            gwdist = std::min(gwdist, (*gw)->GetObject<MobilityModel>()->GetDistanceFrom(position));
+            gwdist = std::min(gwdist, gw.mobility->GetDistanceFrom(device.mobility));
         }
 
-        int dr = int(mac->GetDataRate());
+        int dr = int(device.mac->GetDataRate());
 
-        double txPower = mac->GetTransmissionPower();
+        double txPower = device.mac->GetTransmissionPower();
 
-        devCount_t& count = devPktCount[node->GetId()];
+        devCount_t& count = devPktCount[device.id];
 
         // Add: #sent, #received, max-offered-traffic, duty-cycle
-        uint8_t size = app->GetPacketSize();
-        double interval = app->GetInterval().GetSeconds();
+        uint8_t size = device.app->GetPacketSize();
+        double interval = device.app->GetInterval().GetSeconds();
         LoraPhyTxParameters params;
         params.sf = 12 - dr;
         params.lowDataRateOptimizationEnabled = LoraPhy::GetTSym(params) > MilliSeconds(16);
-        double maxot =
-            LoraPhy::GetTimeOnAir(Create<Packet>(size + 13), params).GetSeconds() / interval;
+        double maxot = LoraPhy::GetTimeOnAir(size + 13, params).GetSeconds() / interval;
         maxot = std::min(maxot, 0.01);
 
-        double ot = mac->GetAggregatedDutyCycle();
+        double ot = device.mac->GetAggregatedDutyCycle();
         ot = std::min(ot, maxot);
 
-        outputFile << currentTime.GetSeconds() << " " << node->GetId() << " " << pos.x << " "
-                   << pos.y << " " << pos.z << " " << gwdist << " " << dr << " "
-                   << unsigned(txPower) << " " << count.sent << " " << count.received << " "
-                   << maxot << " " << ot << std::endl;
+        block << currentTime.GetSeconds() << " " << device.id << " " << pos.x << " " << pos.y
+              << " " << pos.z << " " << gwdist << " " << dr << " " << unsigned(txPower) << " "
+              << count.sent << " " << count.received << " " << maxot << " " << ot << "\n";
     }
+    output.writer->Write(block.str());
     m_lastDeviceStatusUpdate = Simulator::Now();
-    outputFile.close();
 }
 
 void
@@ -230,6 +256,10 @@ LorawanHelper::EnablePeriodicGwsPerformancePrinting(NodeContainer gateways,
 {
     NS_LOG_FUNCTION(this);
 
+    if (m_phyPerformanceWindow == NO_WINDOW)
+    {
+        m_phyPerformanceWindow = m_packetTracker->OpenCountingWindow();
+    }
     DoPrintGwsPerformance(gateways, filename);
 
     Simulator::Schedule(interval,
@@ -245,31 +275,29 @@ LorawanHelper::DoPrintGwsPerformance(NodeContainer gateways, std::string filenam
 {
     NS_LOG_FUNCTION(this);
 
-    const char* c = filename.c_str();
-    std::ofstream outputFile;
-    if (Simulator::Now() == Seconds(0))
+    PrintOutput& output = GetPrintOutput(filename, NodeContainer(), gateways);
+
+    GwsPhyPktPrint strings;
+    if (m_phyPerformanceWindow != NO_WINDOW)
     {
-        // Delete contents of the file as it is opened
-        outputFile.open(c, std::ofstream::out | std::ofstream::trunc);
+        m_packetTracker->PrintPhyPacketsAllGws(m_phyPerformanceWindow, strings);
+        m_packetTracker->ResetCountingWindow(m_phyPerformanceWindow);
     }
     else
     {
-        // Only append to the file
-        outputFile.open(c, std::ofstream::out | std::ofstream::app);
+        m_packetTracker->PrintPhyPacketsAllGws(m_lastPhyPerformanceUpdate,
+                                               Simulator::Now(),
+                                               strings);
     }
-
-    GwsPhyPktPrint strings;
-    m_packetTracker->PrintPhyPacketsAllGws(m_lastPhyPerformanceUpdate, Simulator::Now(), strings);
-    for (auto it = gateways.Begin(); it != gateways.End(); ++it)
+    std::ostringstream block;
+    for (const auto& gw : output.gateways)
     {
-        int systemId = (*it)->GetId();
-        outputFile << Simulator::Now().GetSeconds() << " " << std::to_string(systemId) << " "
-                   << strings[systemId].s << std::endl;
+        block << Simulator::Now().GetSeconds() << " " << std::to_string(gw.id) << " "
+              << strings[gw.id].s << "\n";
     }
+    output.writer->Write(block.str());
 
     m_lastPhyPerformanceUpdate = Simulator::Now();
-
-    outputFile.close();
 }
 
 void
@@ -277,6 +305,10 @@ LorawanHelper::EnablePeriodicGlobalPerformancePrinting(std::string filename, Tim
 {
     NS_LOG_FUNCTION(this << filename << interval);
 
+    if (m_globalPerformanceWindow == NO_WINDOW)
+    {
+        m_globalPerformanceWindow = m_packetTracker->OpenCountingWindow();
+    }
     DoPrintGlobalPerformance(filename);
 
     Simulator::Schedule(interval,
@@ -291,27 +323,24 @@ LorawanHelper::DoPrintGlobalPerformance(std::string filename)
 {
     NS_LOG_FUNCTION(this);
 
-    const char* c = filename.c_str();
-    std::ofstream outputFile;
-    if (Simulator::Now() == Seconds(0))
+    PrintOutput& output = GetPrintOutput(filename, NodeContainer(), NodeContainer());
+
+    std::string counts;
+    if (m_globalPerformanceWindow != NO_WINDOW)
     {
-        // Delete contents of the file as it is opened
-        outputFile.open(c, std::ofstream::out | std::ofstream::trunc);
+        counts = m_packetTracker->PrintPhyPacketsGlobally(m_globalPerformanceWindow);
+        m_packetTracker->ResetCountingWindow(m_globalPerformanceWindow);
     }
     else
     {
-        // Only append to the file
-        outputFile.open(c, std::ofstream::out | std::ofstream::app);
+        counts = m_packetTracker->PrintPhyPacketsGlobally(m_lastGlobalPerformanceUpdate,
+                                                          Simulator::Now());
     }
-
-    outputFile << Simulator::Now().GetSeconds() << " "
-               << m_packetTracker->PrintPhyPacketsGlobally(m_lastGlobalPerformanceUpdate,
-                                                           Simulator::Now())
-               << std::endl;
+    std::ostringstream block;
+    block << Simulator::Now().GetSeconds() << " " << counts << "\n";
+    output.writer->Write(block.str());
 
     m_lastGlobalPerformanceUpdate = Simulator::Now();
-
-    outputFile.close();
 }
 
 void
@@ -322,6 +351,10 @@ LorawanHelper::EnablePeriodicSFStatusPrinting(NodeContainer endDevices,
 {
     NS_LOG_FUNCTION(this);
 
+    if (m_sfStatusWindow == NO_WINDOW)
+    {
+        m_sfStatusWindow = m_packetTracker->OpenCountingWindow();
+    }
     DoPrintSFStatus(endDevices, gateways, filename);
 
     // Schedule periodic printing
@@ -339,23 +372,20 @@ LorawanHelper::DoPrintSFStatus(NodeContainer endDevices,
                                NodeContainer gateways,
                                std::string filename)
 {
-    const char* c = filename.c_str();
-    std::ofstream outputFile;
-    if (Simulator::Now() == Seconds(0))
+    PrintOutput& output = GetPrintOutput(filename, endDevices, gateways);
+
+    Time currentTime = Simulator::Now();
+    DevPktCount devPktCount;
+    if (m_sfStatusWindow != NO_WINDOW)
     {
-        // Delete contents of the file as it is opened
-        outputFile.open(c, std::ofstream::out | std::ofstream::trunc);
+        m_packetTracker->CountAllDevicesPackets(m_sfStatusWindow, devPktCount);
+        m_packetTracker->ResetCountingWindow(m_sfStatusWindow);
     }
     else
     {
-        // Only append to the file
-        outputFile.open(c, std::ofstream::out | std::ofstream::app);
+        m_packetTracker->CountAllDevicesPackets(m_lastSFStatusUpdate, currentTime, devPktCount);
     }
 
-    Time currentTime = Simulator::Now();
-    DevPktCount devPktCount;
-    m_packetTracker->CountAllDevicesPackets(m_lastSFStatusUpdate, currentTime, devPktCount);
-
     struct sfStatus_t
     {
         int sent = 0;
@@ -368,56 +398,112 @@ LorawanHelper::DoPrintSFStatus(NodeContainer endDevices,
     using sfMap_t = std::map<int, sfStatus_t>;
     sfMap_t sfmap;
 
-    for (auto j = endDevices.Begin(); j != endDevices.End(); ++j)
+    for (const auto& device : output.devices)
     {
-        // Obtain device information
-        auto node = *j;
-        auto loraNetDevice = DynamicCast<LoraNetDevice>(node->GetDevice(0));
-        auto mac = DynamicCast<BaseEndDeviceLorawanMac>(loraNetDevice->GetMac());
-        auto app = DynamicCast<LoraApplication>(node->GetApplication(0));
-
-        int dr = int(mac->GetDataRate());
+        int dr = int(device.mac->GetDataRate());
         sfStatus_t& sfstat = sfmap[dr];
 
         // Sent, received
-        devCount_t& count = devPktCount[node->GetId()];
+        devCount_t& count = devPktCount[device.id];
         sfstat.sent += count.sent;
         sfstat.received += count.received;
 
         // Max-offered-traffic, duty-cycle
-        uint8_t size = app->GetPacketSize();
-        double interval = app->GetInterval().GetSeconds();
+        uint8_t size = device.app->GetPacketSize();
+        double interval = device.app->GetInterval().GetSeconds();
         LoraPhyTxParameters params;
         params.sf = 12 - dr;
         params.lowDataRateOptimizationEnabled = LoraPhy::GetTSym(params) > MilliSeconds(16);
-        double maxot =
-            LoraPhy::GetTimeOnAir(Create<Packet>(size + 13), params).GetSeconds() / interval;
+        double maxot = LoraPhy::GetTimeOnAir(size + 13, params).GetSeconds() / interval;
         maxot = std::min(maxot, 0.01);
-        double ot = mac->GetAggregatedDutyCycle();
+        double ot = device.mac->GetAggregatedDutyCycle();
         ot = std::min(ot, maxot);
         sfstat.totMaxOT += maxot;
         sfstat.totAggDC += ot;
 
         // Total energy consumed
+        if (device.energy)
+        {
+            sfstat.totEnergy += device.energy->GetTotalEnergyConsumption();
+        }
+    }
+
+    std::ostringstream block;
+    for (const auto& sf : sfmap)
+    {
+        block << currentTime.GetSeconds() << " " << sf.first << " " << sf.second.sent << " "
+              << sf.second.received << " " << sf.second.totMaxOT << " " << sf.second.totAggDC
+              << " " << sf.second.totEnergy << "\n";
+    }
+    output.writer->Write(block.str());
+
+    m_lastSFStatusUpdate = Simulator::Now();
+}
+
+LorawanHelper::PrintOutput&
+LorawanHelper::GetPrintOutput(const std::string& filename,
+                              NodeContainer endDevices,
+                              NodeContainer gateways)
+{
+    PrintOutput& output = m_outputs[filename];
+    if (!output.writer || !output.writer->IsOpen())
+    {
+        NS_LOG_FUNCTION(this << filename);
+        // Overwrite files at the start of the simulation, otherwise append to them
+        output.writer = std::make_shared<AsyncFileWriter>(filename, !Simulator::Now().IsZero());
+        // Write everything when the simulation ends, even if the helper outlives it
+        Simulator::ScheduleDestroy([writer = std::weak_ptr<AsyncFileWriter>(output.writer)]() {
+            if (auto w = writer.lock())
+            {
+                w->Close();
+            }
+        });
+        output.devices.clear();
+        output.gateways.clear();
+    }
+
+    // Keep the objects if the nodes are the ones of the previous print
+    bool same = output.devices.size() == endDevices.GetN() &&
+                output.gateways.size() == gateways.GetN();
+    for (uint32_t i = 0; same && i < endDevices.GetN(); ++i)
+    {
+        same = output.devices[i].id == endDevices.Get(i)->GetId();
+    }
+    for (uint32_t i = 0; same && i < gateways.GetN(); ++i)
+    {
+        same = output.gateways[i].id == gateways.Get(i)->GetId();
+    }
+    if (same)
+    {
+        return output;
+    }
+
+    output.devices.clear();
+    output.gateways.clear();
+    for (auto j = endDevices.Begin(); j != endDevices.End(); ++j)
+    {
+        auto node = *j;
+        auto loraNetDevice = DynamicCast<LoraNetDevice>(node->GetDevice(0));
+        DeviceHandles device;
+        device.id = node->GetId();
+        device.mobility = node->GetObject<MobilityModel>();
+        device.mac = DynamicCast<BaseEndDeviceLorawanMac>(loraNetDevice->GetMac());
+        device.app = DynamicCast<LoraApplication>(node->GetApplication(0));
         if (auto esc = node->GetObject<energy::EnergySourceContainer>())
         {
             auto demc = esc->Get(0)->FindDeviceEnergyModels("ns3::LoraRadioEnergyModel");
             if (demc.GetN())
             {
-                sfstat.totEnergy += demc.Get(0)->GetTotalEnergyConsumption();
+                device.energy = demc.Get(0);
             }
         }
+        output.devices.push_back(device);
     }
-
-    for (const auto& sf : sfmap)
+    for (auto j = gateways.Begin(); j != gateways.End(); ++j)
     {
-        outputFile << currentTime.GetSeconds() << " " << sf.first << " " << sf.second.sent << " "
-                   << sf.second.received << " " << sf.second.totMaxOT << " " << sf.second.totAggDC
-                   << " " << sf.second.totEnergy << std::endl;
+        output.gateways.push_back({(*j)->GetId(), (*j)->GetObject<MobilityModel>()});
     }
-
-    m_lastSFStatusUpdate = Simulator::Now();
-    outputFile.close();
+    return output;
 }
 
 void
@@ -495,6 +581,16 @@ LorawanHelper::EnablePcapInternal(std::string prefix,
         filename = pcapHelper.GetFilenameFromDevice(prefix, device);
     }
 
+    if (m_pcapCapture)
+    {
+        uint32_t interface = m_pcapCapture->AddInterface(filename);
+        auto callback =
+            MakeBoundCallback(&LorawanHelper::PcapngSniffEvent, m_pcapCapture, interface);
+        phy->TraceConnectWithoutContext("SnifferRx", callback);
+        phy->TraceConnectWithoutContext("SnifferTx", callback);
+        return;
+    }
+
     auto file = pcapHelper.CreateFile(filename, std::ios::out, PcapHelper::DLT_LORATAP);
     phy->TraceConnectWithoutContext("SnifferRx",
                                     MakeBoundCallback(&LorawanHelper::PcapSniffRxEvent, file));
@@ -502,12 +598,20 @@ LorawanHelper::EnablePcapInternal(std::string prefix,
                                     MakeBoundCallback(&LorawanHelper::PcapSniffTxEvent, file));
 }
 
+void
+LorawanHelper::PcapngSniffEvent(Ptr<LoraPcapngCapture> capture,
+                                uint32_t interface,
+                                Ptr<const Packet> packet)
+{
+    capture->Write(interface, packet);
+}
+
 void
 LorawanHelper::PcapSniffRxEvent(Ptr<PcapFileWrapper> file, Ptr<const Packet> packet)
 {
     Ptr<Packet> p = packet->Copy();
     LoraTag tag;
-    p->RemovePacketTag(tag);
+    p->PeekPacketTag(tag);
     LoratapHeader header;
     header.Fill(tag);
     p->AddHeader(header);
@@ -519,7 +623,7 @@ LorawanHelper::PcapSniffTxEvent(Ptr<PcapFileWrapper> file, Ptr<const Packet> pac
 {
     Ptr<Packet> p = packet->Copy();
     LoraTag tag;
-    p->RemovePacketTag(tag);
+    p->PeekPacketTag(tag);
     LoratapHeader header;
     header.Fill(tag);
     p->AddHeader(header);
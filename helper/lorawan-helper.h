@@ -13,17 +13,28 @@
 #ifndef LORAWAN_HELPER_H
 #define LORAWAN_HELPER_H
 
+#include "async-file-writer.h"
 #include "lora-packet-tracker.h"
+#include "lora-pcapng-capture.h"
 #include "lora-phy-helper.h"
 #include "lorawan-mac-helper.h"
 
+#include "ns3/base-end-device-lorawan-mac.h"
+#include "ns3/device-energy-model.h"
+#include "ns3/lora-application.h"
+#include "ns3/lora-device-population.h"
 #include "ns3/lora-net-device.h"
+#include "ns3/mobility-model.h"
 #include "ns3/net-device-container.h"
 #include "ns3/net-device.h"
 #include "ns3/node-container.h"
 #include "ns3/trace-helper.h"
 
+#include <cstdint>
 #include <ctime>
+#include <map>
+#include <memory>
+#include <vector>
 
 namespace ns3
 {
@@ -77,6 +88,14 @@ class LorawanHelper : public PcapHelperForDevice
                                        const LorawanMacHelper& macHelper,
                                        Ptr<Node> node) const;
 
+    /**
+     * Connect the traces of a population of compact devices to the packet
+     * tracker, which must be already enabled.
+     *
+     * \param population The population.
+     */
+    void TrackPopulation(Ptr<LoraDevicePopulation> population) const;
+
     /**
      * Enable tracking of packets via trace sources.
      *
@@ -85,6 +104,21 @@ class LorawanHelper : public PcapHelperForDevice
      */
     void EnablePacketTracking();
 
+    /**
+     * Capture the frames of all devices later enabled for pcap tracing in a
+     * single pcapng file, written in the background, instead of one pcap file
+     * per device. Each device is an interface of the capture.
+     *
+     * \param prefix The prefix of capture file names, numbered by rotation.
+     * \param maxFileBytes The size after which a new file is started, 0 for no limit.
+     * \param maxFileDuration The duration after which a new file is started, 0 for no limit.
+     * \param snapLen The maximum number of captured bytes of frames, 0 for no limit.
+     */
+    void EnableSharedPcap(std::string prefix,
+                          uint64_t maxFileBytes = 0,
+                          Time maxFileDuration = Seconds(0),
+                          uint32_t snapLen = 0);
+
     /**
      * Periodically prints the simulation time to the standard output.
      */
@@ -100,6 +134,10 @@ class LorawanHelper : public PcapHelperForDevice
 
     /**
      * Print a summary of the status of all devices in the network.
+     *
+     * Output files are written in the background. The objects of the nodes
+     * are looked up again only when the nodes given differ from the ones of
+     * the previous print to the same file.
      */
     void DoPrintDeviceStatus(NodeContainer endDevices,
                              NodeContainer gateways,
@@ -144,6 +182,10 @@ class LorawanHelper : public PcapHelperForDevice
 
     static void PcapSniffTxEvent(Ptr<PcapFileWrapper> file, Ptr<const Packet> packet);
 
+    static void PcapngSniffEvent(Ptr<LoraPcapngCapture> capture,
+                                 uint32_t interface,
+                                 Ptr<const Packet> packet);
+
   private:
     /**
      * Actually print the simulation time and re-schedule execution of this
@@ -160,6 +202,60 @@ class LorawanHelper : public PcapHelperForDevice
     Time m_lastGlobalPerformanceUpdate;
     Time m_lastDeviceStatusUpdate;
     Time m_lastSFStatusUpdate;
+
+    /**
+     * Counting windows of the packet tracker used by periodic printing, which
+     * otherwise falls back to counting packets sent since the last update
+     */
+    static constexpr uint32_t NO_WINDOW = UINT32_MAX;
+    uint32_t m_phyPerformanceWindow;
+    uint32_t m_globalPerformanceWindow;
+    uint32_t m_deviceStatusWindow;
+    uint32_t m_sfStatusWindow;
+    /**
+     * Objects of an end device used by periodic printing
+     */
+    struct DeviceHandles
+    {
+        uint32_t id;                           //!< Node id
+        Ptr<MobilityModel> mobility;           //!< Position of the device
+        Ptr<BaseEndDeviceLorawanMac> mac;      //!< MAC layer
+        Ptr<LoraApplication> app;              //!< Application
+        Ptr<energy::DeviceEnergyModel> energy; //!< Radio energy model, if any
+    };
+
+    /**
+     * Objects of a gateway used by periodic printing
+     */
+    struct GatewayHandles
+    {
+        uint32_t id;                 //!< Node id
+        Ptr<MobilityModel> mobility; //!< Position of the gateway
+    };
+
+    /**
+     * Output file of a periodic print, with the nodes it reports about
+     */
+    struct PrintOutput
+    {
+        std::shared_ptr<AsyncFileWriter> writer; //!< Writes the file in the background
+        std::vector<DeviceHandles> devices;      //!< End devices
+        std::vector<GatewayHandles> gateways;    //!< Gateways
+    };
+
+    /**
+     * Get the output of a periodic print, opening its file at the first call
+     * of a simulation and closing it at Simulator::Destroy. Objects of the
+     * nodes are resolved again whenever a print sharing the file passes
+     * different nodes than the previous one.
+     */
+    PrintOutput& GetPrintOutput(const std::string& filename,
+                                NodeContainer endDevices,
+                                NodeContainer gateways);
+
+    std::map<std::string, PrintOutput> m_outputs; //!< Outputs of periodic prints by file name
+
+    Ptr<LoraPcapngCapture> m_pcapCapture; //!< Shared capture of all devices, if enabled
 };
 
 } // namespace lorawan
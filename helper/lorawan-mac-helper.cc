@@ -33,6 +33,7 @@ LorawanMacHelper::LorawanMacHelper()
 LorawanMacHelper::~LorawanMacHelper()
 {
     m_addrGen = nullptr;
+    m_keyStore = nullptr;
 }
 
 void
@@ -47,6 +48,12 @@ LorawanMacHelper::SetAddressGenerator(Ptr<LoraDeviceAddressGenerator> addrGen)
     m_addrGen = addrGen;
 }
 
+void
+LorawanMacHelper::SetKeyStore(Ptr<LoraKeyStore> keyStore)
+{
+    m_keyStore = keyStore;
+}
+
 Ptr<LorawanMac>
 LorawanMacHelper::Install(Ptr<LoraNetDevice> device) const
 {
@@ -65,6 +72,10 @@ LorawanMacHelper::Install(Ptr<LoraNetDevice> device) const
     default:
         NS_LOG_ERROR("This region isn't supported yet!");
     }
+    if (auto edMac = DynamicCast<BaseEndDeviceLorawanMac>(mac); edMac && m_keyStore)
+    {
+        edMac->SetKeyStore(m_keyStore, m_keyStore->AddDevice());
+    }
     device->SetMac(mac);
     return mac;
 }
@@ -76,16 +87,21 @@ LorawanMacHelper::ConfigureForAlohaRegion(Ptr<LorawanMac> mac) const
     // SubBands //
     //////////////
 
-    auto channelHelper = CreateObject<LogicalChannelManager>();
-    channelHelper->AddSubBand(868000000, 868600000, 1, 14);
+    // The plan is shared by all devices of the region
+    static auto plan = [] {
+        auto plan = Create<RegionalChannelPlan>();
+        plan->AddSubBand(Create<SubBand>(868000000, 868600000, 1, 14));
 
-    //////////////////////
-    // Default channels //
-    //////////////////////
+        //////////////////////
+        // Default channels //
+        //////////////////////
 
-    Ptr<LogicalChannel> lc0 = Create<LogicalChannel>(868100000, 0, 5);
-    channelHelper->AddChannel(0, lc0);
+        plan->SetChannel(0, Create<LogicalChannel>(868100000, 0, 5));
+        return plan;
+    }();
 
+    auto channelHelper = CreateObject<LogicalChannelManager>();
+    channelHelper->SetChannelPlan(plan);
     mac->SetLogicalChannelManager(channelHelper);
 
     ///////////////////////////////////////////////
@@ -154,25 +170,28 @@ LorawanMacHelper::ConfigureForEuRegion(Ptr<LorawanMac> mac) const
     // SubBands //
     //////////////
 
-    auto channelHelper = CreateObject<LogicalChannelManager>();
-    channelHelper->AddSubBand(863000000, 865000000, 0.001, 14);
-    channelHelper->AddSubBand(865000000, 868000000, 0.01, 14);
-    channelHelper->AddSubBand(868000000, 868600000, 0.01, 14);
-    channelHelper->AddSubBand(868700000, 869200000, 0.001, 14);
-    channelHelper->AddSubBand(869400000, 869650000, 0.1, 27);
-    channelHelper->AddSubBand(869700000, 870000000, 0.01, 14);
-
-    //////////////////////
-    // Default channels //
-    //////////////////////
-
-    Ptr<LogicalChannel> lc0 = Create<LogicalChannel>(868100000, 0, 5);
-    Ptr<LogicalChannel> lc1 = Create<LogicalChannel>(868300000, 0, 5);
-    Ptr<LogicalChannel> lc2 = Create<LogicalChannel>(868500000, 0, 5);
-    channelHelper->AddChannel(0, lc0);
-    channelHelper->AddChannel(1, lc1);
-    channelHelper->AddChannel(2, lc2);
+    // The plan is shared by all devices of the region
+    static auto plan = [] {
+        auto plan = Create<RegionalChannelPlan>();
+        plan->AddSubBand(Create<SubBand>(863000000, 865000000, 0.001, 14));
+        plan->AddSubBand(Create<SubBand>(865000000, 868000000, 0.01, 14));
+        plan->AddSubBand(Create<SubBand>(868000000, 868600000, 0.01, 14));
+        plan->AddSubBand(Create<SubBand>(868700000, 869200000, 0.001, 14));
+        plan->AddSubBand(Create<SubBand>(869400000, 869650000, 0.1, 27));
+        plan->AddSubBand(Create<SubBand>(869700000, 870000000, 0.01, 14));
+
+        //////////////////////
+        // Default channels //
+        //////////////////////
+
+        plan->SetChannel(0, Create<LogicalChannel>(868100000, 0, 5));
+        plan->SetChannel(1, Create<LogicalChannel>(868300000, 0, 5));
+        plan->SetChannel(2, Create<LogicalChannel>(868500000, 0, 5));
+        return plan;
+    }();
 
+    auto channelHelper = CreateObject<LogicalChannelManager>();
+    channelHelper->SetChannelPlan(plan);
     mac->SetLogicalChannelManager(channelHelper);
 
     ///////////////////////////////////////////////
@@ -242,18 +261,23 @@ LorawanMacHelper::ConfigureForSingleChannelRegion(Ptr<LorawanMac> mac) const
     // SubBands //
     //////////////
 
-    auto channelHelper = CreateObject<LogicalChannelManager>();
-    channelHelper->AddSubBand(868000000, 868600000, 0.01, 14);
-    channelHelper->AddSubBand(868700000, 869200000, 0.001, 14);
-    channelHelper->AddSubBand(869400000, 869650000, 0.1, 27);
+    // The plan is shared by all devices of the region
+    static auto plan = [] {
+        auto plan = Create<RegionalChannelPlan>();
+        plan->AddSubBand(Create<SubBand>(868000000, 868600000, 0.01, 14));
+        plan->AddSubBand(Create<SubBand>(868700000, 869200000, 0.001, 14));
+        plan->AddSubBand(Create<SubBand>(869400000, 869650000, 0.1, 27));
 
-    //////////////////////
-    // Default channels //
-    //////////////////////
+        //////////////////////
+        // Default channels //
+        //////////////////////
 
-    Ptr<LogicalChannel> lc0 = Create<LogicalChannel>(868100000, 0, 5);
-    channelHelper->AddChannel(0, lc0);
+        plan->SetChannel(0, Create<LogicalChannel>(868100000, 0, 5));
+        return plan;
+    }();
 
+    auto channelHelper = CreateObject<LogicalChannelManager>();
+    channelHelper->SetChannelPlan(plan);
     mac->SetLogicalChannelManager(channelHelper);
 
     ///////////////////////////////////////////////
@@ -14,6 +14,7 @@
 #define LORAWAN_MAC_HELPER_H
 
 #include "ns3/lora-device-address-generator.h"
+#include "ns3/lora-key-store.h"
 #include "ns3/lora-net-device.h"
 #include "ns3/node-container.h"
 #include "ns3/object-factory.h"
@@ -71,6 +72,12 @@ class LorawanMacHelper
      */
     void SetAddressGenerator(Ptr<LoraDeviceAddressGenerator> addrGen);
 
+    /**
+     * Set the key store in which end devices created by this helper are
+     * registered with the default session keys.
+     */
+    void SetKeyStore(Ptr<LoraKeyStore> keyStore);
+
     /**
      * Create the LorawanMac instance and connect it to a device
      *
@@ -104,6 +111,7 @@ class LorawanMacHelper
 
     ObjectFactory m_mac;
     Ptr<LoraDeviceAddressGenerator> m_addrGen; //!< Pointer to the address generator to use
+    Ptr<LoraKeyStore> m_keyStore;              //!< Pointer to the key store to use
     enum Regions m_region;                     //!< The region in which the device will operate
 };
 
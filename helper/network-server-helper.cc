@@ -55,6 +55,11 @@ NetworkServerHelper::SetEndDevices(NodeContainer endDevices)
 ApplicationContainer
 NetworkServerHelper::Install(Ptr<Node> node)
 {
+    // Nodes simulated by another rank of a distributed simulation
+    if (node->GetSystemId() != Simulator::GetSystemId())
+    {
+        return ApplicationContainer();
+    }
     return ApplicationContainer(InstallPriv(node));
 }
 
@@ -64,7 +69,7 @@ NetworkServerHelper::Install(NodeContainer c)
     ApplicationContainer apps;
     for (auto i = c.Begin(); i != c.End(); ++i)
     {
-        apps.Add(InstallPriv(*i));
+        apps.Add(Install(*i));
     }
 
     return apps;
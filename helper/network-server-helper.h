@@ -32,6 +32,7 @@ namespace lorawan
 
 /**
  * This class can install Network Server applications on multiple nodes at once.
+ * Nodes simulated by another rank of a distributed simulation are skipped.
  */
 class NetworkServerHelper
 {
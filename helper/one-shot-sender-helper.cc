@@ -50,6 +50,11 @@ OneShotSenderHelper::SetAttribute(std::string name, const AttributeValue& value)
 ApplicationContainer
 OneShotSenderHelper::Install(Ptr<Node> node) const
 {
+    // Nodes simulated by another rank of a distributed simulation
+    if (node->GetSystemId() != Simulator::GetSystemId())
+    {
+        return ApplicationContainer();
+    }
     return ApplicationContainer(InstallPriv(node));
 }
 
@@ -59,7 +64,7 @@ OneShotSenderHelper::Install(NodeContainer c) const
     ApplicationContainer apps;
     for (auto i = c.Begin(); i != c.End(); ++i)
     {
-        apps.Add(InstallPriv(*i));
+        apps.Add(Install(*i));
     }
 
     return apps;
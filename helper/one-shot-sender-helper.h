@@ -31,7 +31,8 @@ namespace lorawan
 
 /**
  * This class can be used to install OneShotSender applications on multiple
- * nodes at once.
+ * nodes at once. Nodes simulated by another rank of a distributed simulation
+ * are skipped.
  */
 class OneShotSenderHelper
 {
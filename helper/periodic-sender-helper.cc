@@ -67,6 +67,11 @@ PeriodicSenderHelper::SetAttribute(std::string name, const AttributeValue& value
 ApplicationContainer
 PeriodicSenderHelper::Install(Ptr<Node> node) const
 {
+    // Nodes simulated by another rank of a distributed simulation
+    if (node->GetSystemId() != Simulator::GetSystemId())
+    {
+        return ApplicationContainer();
+    }
     return ApplicationContainer(InstallPriv(node));
 }
 
@@ -76,7 +81,7 @@ PeriodicSenderHelper::Install(NodeContainer c) const
     ApplicationContainer apps;
     for (auto i = c.Begin(); i != c.End(); ++i)
     {
-        apps.Add(InstallPriv(*i));
+        apps.Add(Install(*i));
     }
 
     return apps;
@@ -32,6 +32,10 @@ namespace lorawan
 /**
  * This class can be used to install PeriodicSender applications on a wide
  * range of nodes.
+ *
+ * Nodes simulated by another rank of a distributed simulation are skipped,
+ * without drawing their initial delay and interval, so the values drawn for
+ * local nodes depend on how nodes are split between ranks.
  */
 class PeriodicSenderHelper
 {
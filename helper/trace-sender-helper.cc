@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2026 University of Bologna
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Alessandro Aimi <alessandro.aimi@unibo.it>
+ */
+
+#include "trace-sender-helper.h"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+
+namespace ns3
+{
+namespace lorawan
+{
+
+NS_LOG_COMPONENT_DEFINE("TraceSenderHelper");
+
+TraceSenderHelper::TraceSenderHelper(const std::string& filename)
+    : m_nextIndex(0)
+{
+    m_factory.SetTypeId("ns3::TraceSender");
+    m_trace = CreateObject<TrafficTrace>();
+    m_trace->SetAttribute("Filename", StringValue(filename));
+}
+
+TraceSenderHelper::~TraceSenderHelper()
+{
+    m_trace = nullptr;
+}
+
+void
+TraceSenderHelper::SetAttribute(std::string name, const AttributeValue& value)
+{
+    m_factory.Set(name, value);
+}
+
+void
+TraceSenderHelper::SetTraceAttribute(std::string name, const AttributeValue& value)
+{
+    m_trace->SetAttribute(name, value);
+}
+
+ApplicationContainer
+TraceSenderHelper::Install(Ptr<Node> node) const
+{
+    // Nodes simulated by another rank of a distributed simulation
+    if (node->GetSystemId() != Simulator::GetSystemId())
+    {
+        // Keep indices consistent across ranks
+        ++m_nextIndex;
+        return ApplicationContainer();
+    }
+    return ApplicationContainer(InstallPriv(node));
+}
+
+ApplicationContainer
+TraceSenderHelper::Install(NodeContainer c) const
+{
+    ApplicationContainer apps;
+    for (auto i = c.Begin(); i != c.End(); ++i)
+    {
+        apps.Add(Install(*i));
+    }
+
+    return apps;
+}
+
+Ptr<TrafficTrace>
+TraceSenderHelper::GetTrace() const
+{
+    return m_trace;
+}
+
+Ptr<Application>
+TraceSenderHelper::InstallPriv(Ptr<Node> node) const
+{
+    NS_LOG_FUNCTION(this << node);
+
+    Ptr<TraceSender> app = m_factory.Create<TraceSender>();
+    app->SetTrace(m_trace, m_nextIndex++);
+    NS_LOG_DEBUG("Created an application with index " << m_nextIndex - 1);
+
+    app->SetNode(node);
+    node->AddApplication(app);
+
+    return app;
+}
+
+} // namespace lorawan
+} // namespace ns3
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2026 University of Bologna
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Alessandro Aimi <alessandro.aimi@unibo.it>
+ */
+
+#ifndef TRACE_SENDER_HELPER_H
+#define TRACE_SENDER_HELPER_H
+
+#include "ns3/application-container.h"
+#include "ns3/attribute.h"
+#include "ns3/node-container.h"
+#include "ns3/object-factory.h"
+#include "ns3/trace-sender.h"
+#include "ns3/traffic-trace.h"
+
+#include <string>
+
+namespace ns3
+{
+namespace lorawan
+{
+
+/**
+ * This class can be used to install TraceSender applications replaying a
+ * traffic trace on a wide range of nodes.
+ *
+ * All applications share the same TrafficTrace. Nodes are given indices in
+ * the order of installation, starting from 0, which identify them in traces
+ * of NODE_INDEX devices. Nodes simulated by another rank of a distributed
+ * simulation are skipped, but still take their index, so that indices are the
+ * same on all ranks.
+ */
+class TraceSenderHelper
+{
+  public:
+    /**
+     * \param filename The name of the CSV or binary trace.
+     */
+    TraceSenderHelper(const std::string& filename);
+
+    ~TraceSenderHelper();
+
+    void SetAttribute(std::string name, const AttributeValue& value);
+
+    /**
+     * Set an attribute of the shared TrafficTrace.
+     *
+     * \param name The name of the attribute.
+     * \param value The value of the attribute.
+     */
+    void SetTraceAttribute(std::string name, const AttributeValue& value);
+
+    ApplicationContainer Install(NodeContainer c) const;
+
+    ApplicationContainer Install(Ptr<Node> node) const;
+
+    /**
+     * \return The trace shared by the applications.
+     */
+    Ptr<TrafficTrace> GetTrace() const;
+
+  private:
+    Ptr<Application> InstallPriv(Ptr<Node> node) const;
+
+    ObjectFactory m_factory;
+
+    Ptr<TrafficTrace> m_trace; //!< The trace shared by the applications
+
+    mutable uint32_t m_nextIndex; //!< Index of the next installed node
+};
+
+} // namespace lorawan
+} // namespace ns3
+
+#endif /* TRACE_SENDER_HELPER_H */
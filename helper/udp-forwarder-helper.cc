@@ -44,6 +44,11 @@ UdpForwarderHelper::SetAttribute(std::string name, const AttributeValue& value)
 ApplicationContainer
 UdpForwarderHelper::Install(Ptr<Node> node) const
 {
+    // Nodes simulated by another rank of a distributed simulation
+    if (node->GetSystemId() != Simulator::GetSystemId())
+    {
+        return ApplicationContainer();
+    }
     return ApplicationContainer(InstallPriv(node));
 }
 
@@ -53,7 +58,7 @@ UdpForwarderHelper::Install(NodeContainer c) const
     ApplicationContainer apps;
     for (auto i = c.Begin(); i != c.End(); ++i)
     {
-        apps.Add(InstallPriv(*i));
+        apps.Add(Install(*i));
     }
     return apps;
 }
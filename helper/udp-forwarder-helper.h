@@ -22,7 +22,8 @@ namespace lorawan
 
 /**
  * This class can be used to install UDP Forwarder applications on a set of
- * gateways.
+ * gateways. Gateways simulated by another rank of a distributed simulation
+ * are skipped.
  */
 class UdpForwarderHelper
 {
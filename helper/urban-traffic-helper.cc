@@ -91,6 +91,11 @@ UrbanTrafficHelper::SetDeviceGroups(M2MDeviceGroups groups)
 ApplicationContainer
 UrbanTrafficHelper::Install(Ptr<Node> node) const
 {
+    // Nodes simulated by another rank of a distributed simulation
+    if (node->GetSystemId() != Simulator::GetSystemId())
+    {
+        return ApplicationContainer();
+    }
     return ApplicationContainer(InstallPriv(node));
 }
 
@@ -100,7 +105,7 @@ UrbanTrafficHelper::Install(NodeContainer c) const
     ApplicationContainer apps;
     for (auto i = c.Begin(); i != c.End(); ++i)
     {
-        apps.Add(InstallPriv(*i));
+        apps.Add(Install(*i));
     }
 
     return apps;
@@ -250,6 +255,8 @@ UrbanTrafficHelper::InstallPriv(Ptr<Node> node) const
         type = "Smart meter";
     }
 
+    Time initialDelay = Seconds(m_intervalProb->GetValue(0, interval.GetSeconds()));
+
     if (poisson)
     {
         app = CreateObjectWithAttributes<PoissonSender>("Interval",
@@ -267,7 +274,7 @@ UrbanTrafficHelper::InstallPriv(Ptr<Node> node) const
 
     NS_LOG_DEBUG("Created: " << type << " (" << interval.GetSeconds() << "s, " << (unsigned)pktSize
                              << "B, " << ((poisson) ? "poisson)" : "uniform)"));
-    app->SetInitialDelay(Seconds(m_intervalProb->GetValue(0, interval.GetSeconds())));
+    app->SetInitialDelay(initialDelay);
 
     app->SetNode(node);
     node->AddApplication(app);
@@ -25,6 +25,9 @@ namespace lorawan
  * This class can be used to install a range of realistic sender applications
  * on a wide range of nodes. Traffic types and their distribution are from
  * [IEEE C802.16p-11/0102r2] for the urban scenario
+ *
+ * Nodes simulated by another rank of a distributed simulation are skipped,
+ * without drawing their traffic profile, as in the other application helpers.
  */
 
 enum M2MDeviceGroups
@@ -48,6 +51,12 @@ class UrbanTrafficHelper
     void SetDeviceGroups(M2MDeviceGroups groups);
 
   private:
+    /**
+     * Draw the traffic profile of a node and install the application.
+     *
+     * \param node The node.
+     * \return The application.
+     */
     Ptr<Application> InstallPriv(Ptr<Node> node) const;
 
     Ptr<UniformRandomVariable> m_intervalProb;
@@ -35,9 +35,15 @@ AdrComponent::GetTypeId()
             .SetParent<NetworkControllerComponent>()
             .AddAttribute("MultipleGwCombiningMethod",
                           "Whether to average the received power of gateways or to use the maximum",
-                          EnumValue(MAXIMUM),
-                          MakeEnumAccessor<CombiningMethod>(&AdrComponent::tpAveraging),
-                          MakeEnumChecker(AVERAGE, "avg", MAXIMUM, "max", MINIMUM, "min"))
+                          EnumValue(EndDeviceStatus::MAXIMUM),
+                          MakeEnumAccessor<EndDeviceStatus::RxPowerCombining>(
+                              &AdrComponent::tpAveraging),
+                          MakeEnumChecker(EndDeviceStatus::AVERAGE,
+                                          "avg",
+                                          EndDeviceStatus::MAXIMUM,
+                                          "max",
+                                          EndDeviceStatus::MINIMUM,
+                                          "min"))
             .AddAttribute("MultiplePacketsCombiningMethod",
                           "Whether to average SNRs from multiple packets or to use the maximum",
                           EnumValue(MAXIMUM),
@@ -72,11 +78,9 @@ AdrComponent::~AdrComponent()
 }
 
 void
-AdrComponent::OnReceivedPacket(Ptr<const Packet> packet,
-                               Ptr<EndDeviceStatus> status,
-                               Ptr<NetworkStatus> networkStatus)
+AdrComponent::OnReceivedPacket(const UplinkContext& uplink, Ptr<NetworkStatus> networkStatus)
 {
-    NS_LOG_FUNCTION(this->GetTypeId() << packet << networkStatus);
+    NS_LOG_FUNCTION(this->GetTypeId() << uplink.packet << networkStatus);
 
     // We will only act just before reply, when all Gateways will have received
     // the packet, since we need their respective received power.
@@ -87,20 +91,17 @@ AdrComponent::BeforeSendingReply(Ptr<EndDeviceStatus> status, Ptr<NetworkStatus>
 {
     NS_LOG_FUNCTION(this << status << networkStatus);
 
-    Ptr<Packet> myPacket = status->GetLastPacketReceivedFromDevice()->Copy();
-    LorawanMacHeader mHdr;
-    myPacket->RemoveHeader(mHdr);
-    LoraFrameHeader fHdr;
-    fHdr.SetAsUplink();
-    myPacket->RemoveHeader(fHdr);
-
     // Execute the ADR algotithm only if the request bit is set
-    if (fHdr.GetAdr())
+    if (status->GetLastReceivedPacketInfo().adr)
     {
-        if (int(status->GetReceivedPacketList().size()) < historyRange)
+        NS_ABORT_MSG_IF(uint32_t(historyRange) > status->GetHistorySize(),
+                        "ADR HistoryRange (" << historyRange << ") exceeds the HistorySize ("
+                                             << status->GetHistorySize()
+                                             << ") of the device status");
+        if (int(status->GetNReceivedPackets()) < historyRange)
         {
             NS_LOG_ERROR("Not enough packets received by this device ("
-                         << status->GetReceivedPacketList().size()
+                         << status->GetNReceivedPackets()
                          << ") for the algorithm to work (need " << historyRange << ")");
         }
         else
@@ -172,17 +173,18 @@ AdrComponent::AdrImplementation(uint8_t* newDataRate,
                                 Ptr<EndDeviceStatus> status)
 {
     // Compute the maximum or median SNR, based on the boolean value historyAveraging
+    EndDeviceStatus::SnrStatistics snr = status->GetSnrStatistics(tpAveraging, historyRange);
     double m_SNR = 0;
     switch (historyAveraging)
     {
     case AdrComponent::AVERAGE:
-        m_SNR = GetAverageSNR(status->GetReceivedPacketList(), historyRange);
+        m_SNR = snr.average;
         break;
     case AdrComponent::MAXIMUM:
-        m_SNR = GetMaxSNR(status->GetReceivedPacketList(), historyRange);
+        m_SNR = snr.max;
         break;
     case AdrComponent::MINIMUM:
-        m_SNR = GetMinSNR(status->GetReceivedPacketList(), historyRange);
+        m_SNR = snr.min;
     }
 
     NS_LOG_DEBUG("m_SNR = " << m_SNR);
@@ -246,157 +248,6 @@ AdrComponent::AdrImplementation(uint8_t* newDataRate,
     *newTxPower = transmissionPower;
 }
 
-// Get the maximum received power (it considers the values in dB!)
-double
-AdrComponent::GetMinTxFromGateways(EndDeviceStatus::GatewayList gwList)
-{
-    auto it = gwList.begin();
-    double min = it->second.rxPower;
-
-    for (; it != gwList.end(); it++)
-    {
-        if (it->second.rxPower < min)
-        {
-            min = it->second.rxPower;
-        }
-    }
-
-    return min;
-}
-
-// Get the maximum received power (it considers the values in dB!)
-double
-AdrComponent::GetMaxTxFromGateways(EndDeviceStatus::GatewayList gwList)
-{
-    auto it = gwList.begin();
-    double max = it->second.rxPower;
-
-    for (; it != gwList.end(); it++)
-    {
-        if (it->second.rxPower > max)
-        {
-            max = it->second.rxPower;
-        }
-    }
-
-    return max;
-}
-
-// Get the maximum received power
-double
-AdrComponent::GetAverageTxFromGateways(EndDeviceStatus::GatewayList gwList)
-{
-    double sum = 0;
-
-    for (auto it = gwList.begin(); it != gwList.end(); it++)
-    {
-        NS_LOG_DEBUG("Gateway at " << it->first << " has TP " << it->second.rxPower);
-        sum += it->second.rxPower;
-    }
-
-    double average = sum / gwList.size();
-
-    NS_LOG_DEBUG("TP (average) = " << average);
-
-    return average;
-}
-
-double
-AdrComponent::GetReceivedPower(EndDeviceStatus::GatewayList gwList)
-{
-    switch (tpAveraging)
-    {
-    case AdrComponent::AVERAGE:
-        return GetAverageTxFromGateways(gwList);
-    case AdrComponent::MAXIMUM:
-        return GetMaxTxFromGateways(gwList);
-    case AdrComponent::MINIMUM:
-        return GetMinTxFromGateways(gwList);
-    default:
-        return -1;
-    }
-}
-
-// TODO Make this more elegant
-double
-AdrComponent::GetMinSNR(const EndDeviceStatus::ReceivedPacketList& packetList, int historyRange)
-{
-    double m_SNR;
-
-    // Take elements from the list starting at the end
-    auto it = packetList.rbegin();
-    double min = LoraPhy::RxPowerToSNR(GetReceivedPower(it->second.gwList));
-
-    for (int i = 0; i < historyRange; i++, it++)
-    {
-        m_SNR = LoraPhy::RxPowerToSNR(GetReceivedPower(it->second.gwList));
-
-        NS_LOG_DEBUG("Received power: " << GetReceivedPower(it->second.gwList));
-        NS_LOG_DEBUG("m_SNR = " << m_SNR);
-
-        if (m_SNR < min)
-        {
-            min = m_SNR;
-        }
-    }
-
-    NS_LOG_DEBUG("SNR (min) = " << min);
-
-    return min;
-}
-
-double
-AdrComponent::GetMaxSNR(const EndDeviceStatus::ReceivedPacketList& packetList, int historyRange)
-{
-    double m_SNR;
-
-    // Take elements from the list starting at the end
-    auto it = packetList.rbegin();
-    double max = LoraPhy::RxPowerToSNR(GetReceivedPower(it->second.gwList));
-
-    for (int i = 0; i < historyRange; i++, it++)
-    {
-        m_SNR = LoraPhy::RxPowerToSNR(GetReceivedPower(it->second.gwList));
-
-        NS_LOG_DEBUG("Received power: " << GetReceivedPower(it->second.gwList));
-        NS_LOG_DEBUG("m_SNR = " << m_SNR);
-
-        if (m_SNR > max)
-        {
-            max = m_SNR;
-        }
-    }
-
-    NS_LOG_DEBUG("SNR (max) = " << max);
-
-    return max;
-}
-
-double
-AdrComponent::GetAverageSNR(const EndDeviceStatus::ReceivedPacketList& packetList, int historyRange)
-{
-    double sum = 0;
-    double m_SNR;
-
-    // Take elements from the list starting at the end
-    auto it = packetList.rbegin();
-    for (int i = 0; i < historyRange; i++, it++)
-    {
-        m_SNR = LoraPhy::RxPowerToSNR(GetReceivedPower(it->second.gwList));
-
-        NS_LOG_DEBUG("Received power: " << GetReceivedPower(it->second.gwList));
-        NS_LOG_DEBUG("m_SNR = " << m_SNR);
-
-        sum += m_SNR;
-    }
-
-    double average = sum / historyRange;
-
-    NS_LOG_DEBUG("SNR (average) = " << average);
-
-    return average;
-}
-
 int
 AdrComponent::GetTxPowerIndex(int txPower)
 {
@@ -46,9 +46,7 @@ class AdrComponent : public NetworkControllerComponent
     // Destructor
     ~AdrComponent() override;
 
-    void OnReceivedPacket(Ptr<const Packet> packet,
-                          Ptr<EndDeviceStatus> status,
-                          Ptr<NetworkStatus> networkStatus) override;
+    void OnReceivedPacket(const UplinkContext& uplink, Ptr<NetworkStatus> networkStatus) override;
 
     void BeforeSendingReply(Ptr<EndDeviceStatus> status, Ptr<NetworkStatus> networkStatus) override;
 
@@ -57,24 +55,10 @@ class AdrComponent : public NetworkControllerComponent
   private:
     void AdrImplementation(uint8_t* newDataRate, uint8_t* newTxPower, Ptr<EndDeviceStatus> status);
 
-    double GetMinTxFromGateways(EndDeviceStatus::GatewayList gwList);
-
-    double GetMaxTxFromGateways(EndDeviceStatus::GatewayList gwList);
-
-    double GetAverageTxFromGateways(EndDeviceStatus::GatewayList gwList);
-
-    double GetReceivedPower(EndDeviceStatus::GatewayList gwList);
-
-    double GetMinSNR(const EndDeviceStatus::ReceivedPacketList& packetList, int historyRange);
-
-    double GetMaxSNR(const EndDeviceStatus::ReceivedPacketList& packetList, int historyRange);
-
-    double GetAverageSNR(const EndDeviceStatus::ReceivedPacketList& packetList, int historyRange);
-
     int GetTxPowerIndex(int txPower);
 
     // TX power from gateways policy
-    enum CombiningMethod tpAveraging;
+    EndDeviceStatus::RxPowerCombining tpAveraging;
 
     // Number of previous packets to consider
     int historyRange;
@@ -16,11 +16,13 @@
 #include "ns3/command-line.h"
 #include "ns3/log.h"
 #include "ns3/lora-frame-header.h"
+#include "ns3/lora-phy.h"
 #include "ns3/lora-tag.h"
 #include "ns3/lorawan-mac-header.h"
 #include "ns3/packet.h"
 #include "ns3/pointer.h"
 #include "ns3/simulator.h"
+#include "ns3/uinteger.h"
 
 #include <algorithm>
 
@@ -34,10 +36,18 @@ NS_LOG_COMPONENT_DEFINE("EndDeviceStatus");
 TypeId
 EndDeviceStatus::GetTypeId()
 {
-    static TypeId tid = TypeId("ns3::EndDeviceStatus")
-                            .SetParent<Object>()
-                            .AddConstructor<EndDeviceStatus>()
-                            .SetGroupName("lorawan");
+    static TypeId tid =
+        TypeId("ns3::EndDeviceStatus")
+            .SetParent<Object>()
+            .AddConstructor<EndDeviceStatus>()
+            .SetGroupName("lorawan")
+            .AddAttribute("HistorySize",
+                          "Number of received packets kept in the history of the device "
+                          "(should not be lower than the ADR HistoryRange)",
+                          UintegerValue(100),
+                          MakeUintegerAccessor(&EndDeviceStatus::SetHistorySize,
+                                               &EndDeviceStatus::GetHistorySize),
+                          MakeUintegerChecker<uint32_t>(1));
     return tid;
 }
 
@@ -45,7 +55,6 @@ EndDeviceStatus::EndDeviceStatus(LoraDeviceAddress endDeviceAddress,
                                  Ptr<ClassAEndDeviceLorawanMac> endDeviceMac)
     : m_reply(EndDeviceStatus::Reply()),
       m_endDeviceAddress(endDeviceAddress),
-      m_receivedPacketList(ReceivedPacketList()),
       m_mac(endDeviceMac)
 {
     NS_LOG_FUNCTION(this << endDeviceAddress);
@@ -57,7 +66,6 @@ EndDeviceStatus::EndDeviceStatus()
 
     // Initialize data structure
     m_reply = EndDeviceStatus::Reply();
-    m_receivedPacketList = ReceivedPacketList();
 }
 
 EndDeviceStatus::~EndDeviceStatus()
@@ -120,13 +128,7 @@ EndDeviceStatus::GetCompleteReplyPacket()
 
     // Add headers
     m_reply.frameHeader.SetAddress(m_endDeviceAddress);
-    Ptr<Packet> lastPacket = GetLastPacketReceivedFromDevice()->Copy();
-    LorawanMacHeader mHdr;
-    lastPacket->RemoveHeader(mHdr);
-    LoraFrameHeader fHdr;
-    fHdr.SetAsUplink();
-    lastPacket->RemoveHeader(fHdr);
-    m_reply.frameHeader.SetFCnt(fHdr.GetFCnt());
+    m_reply.frameHeader.SetFCnt(GetLastReceivedPacketInfo().fCnt);
     m_reply.macHeader.SetFType(LorawanMacHeader::UNCONFIRMED_DATA_DOWN);
     replyPacket->AddHeader(m_reply.frameHeader);
     replyPacket->AddHeader(m_reply.macHeader);
@@ -174,11 +176,82 @@ EndDeviceStatus::GetMac()
     return m_mac;
 }
 
-const EndDeviceStatus::ReceivedPacketList&
-EndDeviceStatus::GetReceivedPacketList() const
+uint32_t
+EndDeviceStatus::GetNReceivedPackets() const
 {
-    NS_LOG_FUNCTION_NOARGS();
-    return m_receivedPacketList;
+    return m_historyCount;
+}
+
+void
+EndDeviceStatus::SetHistorySize(uint32_t size)
+{
+    NS_LOG_FUNCTION(this << size);
+    NS_ABORT_MSG_IF(size == 0, "The history must hold at least one packet");
+
+    // Move the most recent packets to the first slots of the new buffer
+    std::vector<ReceivedPacketInfo> history(size);
+    uint32_t count = std::min(m_historyCount, size);
+    m_fCntSlot.clear();
+    for (uint32_t slot = 0; slot < count; slot++)
+    {
+        uint32_t age = count - 1 - slot;
+        history[slot] = std::move(m_history[(m_historyHead + m_historySize - age) % m_historySize]);
+        m_fCntSlot[history[slot].fCnt] = slot;
+    }
+    m_history = std::move(history);
+    m_historySize = size;
+    m_historyCount = count;
+    m_historyHead = (count) ? count - 1 : size - 1;
+    // Windows are filled again from the history when requested
+    m_snrWindows.clear();
+}
+
+uint32_t
+EndDeviceStatus::GetHistorySize() const
+{
+    return m_historySize;
+}
+
+const EndDeviceStatus::ReceivedPacketInfo&
+EndDeviceStatus::GetReceivedPacketInfo(uint32_t age) const
+{
+    NS_ASSERT_MSG(age < m_historyCount, "Packet not in the history");
+    return m_history[(m_historyHead + m_historySize - age) % m_historySize];
+}
+
+EndDeviceStatus::SnrStatistics
+EndDeviceStatus::GetSnrStatistics(RxPowerCombining combining, uint32_t window)
+{
+    NS_LOG_FUNCTION(this << combining << window);
+
+    SnrStatistics result;
+    if (m_historyCount == 0 || window == 0)
+    {
+        return result;
+    }
+
+    auto it = std::find_if(m_snrWindows.begin(), m_snrWindows.end(), [=](const SnrWindow& w) {
+        return w.combining == combining && w.stats.GetSize() == window - 1;
+    });
+    if (it == m_snrWindows.end())
+    {
+        // Fill the new window with the previous packets still in the history
+        SnrWindow snrWindow = {combining, SlidingWindowStatistics(window - 1)};
+        for (uint32_t age = std::min(window, m_historyCount) - 1; age > 0; age--)
+        {
+            snrWindow.stats.Push(GetSnr(GetReceivedPacketInfo(age), combining));
+        }
+        it = m_snrWindows.insert(m_snrWindows.end(), snrWindow);
+    }
+
+    // Combine with the last packet
+    const SlidingWindowStatistics& stats = it->stats;
+    double last = GetSnr(m_history[m_historyHead], combining);
+    result.count = stats.GetCount() + 1;
+    result.min = (stats.GetCount()) ? std::min(stats.GetMin(), last) : last;
+    result.max = (stats.GetCount()) ? std::max(stats.GetMax(), last) : last;
+    result.average = (stats.GetSum() + last) / result.count;
+    return result;
 }
 
 void
@@ -239,110 +312,105 @@ EndDeviceStatus::InsertReceivedPacket(Ptr<const Packet> receivedPacket, const Ad
 {
     NS_LOG_FUNCTION_NOARGS();
 
-    // Create a copy of the packet
-    Ptr<Packet> myPacket = receivedPacket->Copy();
+    InsertReceivedPacket(UplinkContext(receivedPacket, gwAddress));
+}
 
-    // Extract the headers
-    LorawanMacHeader mHdr;
-    myPacket->RemoveHeader(mHdr);
+void
+EndDeviceStatus::InsertReceivedPacket(const UplinkContext& uplink)
+{
+    NS_LOG_FUNCTION_NOARGS();
 
-    LoraFrameHeader fHdr;
-    fHdr.SetAsUplink();
-    myPacket->RemoveHeader(fHdr);
+    const LorawanMacHeader& mHdr = uplink.macHeader;
+    const LoraFrameHeader& fHdr = uplink.frameHeader;
+    const LoraTag& tag = uplink.tag;
+    const Address& gwAddress = uplink.gwAddress;
 
     // Update current parameters
-    LoraTag tag;
-    myPacket->RemovePacketTag(tag);
     SetFirstReceiveWindowDataRate(tag.GetDataRate());
     SetFirstReceiveWindowFrequency(tag.GetFrequency());
 
-    // Update Information on the received packet
-    ReceivedPacketInfo info;
-    info.sf = tag.GetTxParameters().sf;
-    info.frequency = tag.GetFrequency();
+    PacketInfoPerGw gwInfo;
+    gwInfo.receivedTime = tag.GetReceptionTime();
+    gwInfo.rxPower = tag.GetReceivePower();
+    gwInfo.gwAddress = gwAddress;
 
-    double rcvPower = tag.GetReceivePower();
-
-    // Perform insertion in list, also checking that the packet isn't already in
-    // the list (it could have been received by another GW already)
-
-    // Start searching from the end
-    auto it = m_receivedPacketList.rbegin();
-    for (; it != m_receivedPacketList.rend(); it++)
+    // Check that the packet isn't already in the history (it could have been
+    // received by another GW already)
+    if (auto it = m_fCntSlot.find(fHdr.GetFCnt()); it != m_fCntSlot.end())
     {
-        // Get the frame counter of the current packet to compare it with the
-        // newly received one
-        Ptr<Packet> packetCopy = ((*it).first)->Copy();
-        LorawanMacHeader currentMacHdr;
-        packetCopy->RemoveHeader(currentMacHdr);
-        LoraFrameHeader currentFrameHdr;
-        fHdr.SetAsUplink();
-        packetCopy->RemoveHeader(currentFrameHdr);
-
-        NS_LOG_DEBUG("Received packet's frame counter: " << unsigned(fHdr.GetFCnt())
-                                                         << "\nCurrent packet's frame counter: "
-                                                         << unsigned(currentFrameHdr.GetFCnt()));
-
-        if (fHdr.GetFCnt() == currentFrameHdr.GetFCnt())
-        {
-            NS_LOG_INFO("Packet was already received by another gateway");
-
-            // This packet had already been received from another gateway:
-            // add this gateway's reception information.
-            GatewayList& gwList = it->second.gwList;
-
-            PacketInfoPerGw gwInfo;
-            gwInfo.receivedTime = tag.GetReceptionTime();
-            gwInfo.rxPower = rcvPower;
-            gwInfo.gwAddress = gwAddress;
-            gwList.insert(std::pair<Address, PacketInfoPerGw>(gwAddress, gwInfo));
-
-            NS_LOG_DEBUG("Size of gateway list: " << gwList.size());
+        NS_LOG_INFO("Packet was already received by another gateway");
 
-            break; // Exit from the cycle
+        // This packet had already been received from another gateway:
+        // add this gateway's reception information.
+        ReceivedPacketInfo& info = m_history[it->second];
+        if (info.gwList.insert(std::pair<Address, PacketInfoPerGw>(gwAddress, gwInfo)).second)
+        {
+            info.minRxPower = std::min(info.minRxPower, gwInfo.rxPower);
+            info.maxRxPower = std::max(info.maxRxPower, gwInfo.rxPower);
+            info.sumRxPower += gwInfo.rxPower;
+        }
+        if (it->second == m_historyHead)
+        {
+            RankGateway(uplink.gwId, gwInfo.rxPower);
         }
+
+        NS_LOG_DEBUG("Size of gateway list: " << info.gwList.size());
     }
-    if (it == m_receivedPacketList.rend())
+    else
     {
         NS_LOG_INFO("Packet was received for the first time");
-        PacketInfoPerGw gwInfo;
-        gwInfo.receivedTime = tag.GetReceptionTime();
-        gwInfo.rxPower = rcvPower;
-        gwInfo.gwAddress = gwAddress;
+
+        // The gateway list of the previous packet is now final
+        if (m_historyCount)
+        {
+            for (auto& snrWindow : m_snrWindows)
+            {
+                snrWindow.stats.Push(GetSnr(m_history[m_historyHead], snrWindow.combining));
+            }
+        }
+
+        // Overwrite the oldest packet of the history
+        m_historyHead = (m_historyHead + 1) % m_historySize;
+        ReceivedPacketInfo& info = m_history[m_historyHead];
+        if (m_historyCount == m_historySize)
+        {
+            m_fCntSlot.erase(info.fCnt);
+        }
+        else
+        {
+            m_historyCount++;
+        }
+
+        info.gwList.clear();
         info.gwList.insert(std::pair<Address, PacketInfoPerGw>(gwAddress, gwInfo));
-        m_receivedPacketList.emplace_back(receivedPacket, info);
+        info.minRxPower = info.maxRxPower = info.sumRxPower = gwInfo.rxPower;
+        info.sf = tag.GetTxParameters().sf;
+        info.frequency = tag.GetFrequency();
+        info.fCnt = fHdr.GetFCnt();
+        info.adr = fHdr.GetAdr();
+        info.adrAckReq = fHdr.GetAdrAckReq();
+        info.fType = mHdr.GetFType();
+        m_fCntSlot[info.fCnt] = m_historyHead;
+        m_lastPacket = uplink.packet;
+        m_nRanked = 0;
+        RankGateway(uplink.gwId, gwInfo.rxPower);
     }
     NS_LOG_DEBUG(*this);
 }
 
-EndDeviceStatus::ReceivedPacketInfo
-EndDeviceStatus::GetLastReceivedPacketInfo()
+const EndDeviceStatus::ReceivedPacketInfo&
+EndDeviceStatus::GetLastReceivedPacketInfo() const
 {
     NS_LOG_FUNCTION_NOARGS();
-    auto it = m_receivedPacketList.rbegin();
-    if (it != m_receivedPacketList.rend())
-    {
-        return it->second;
-    }
-    else
-    {
-        return EndDeviceStatus::ReceivedPacketInfo();
-    }
+    static const ReceivedPacketInfo empty = ReceivedPacketInfo();
+    return (m_historyCount) ? m_history[m_historyHead] : empty;
 }
 
 Ptr<const Packet>
 EndDeviceStatus::GetLastPacketReceivedFromDevice()
 {
     NS_LOG_FUNCTION_NOARGS();
-    auto it = m_receivedPacketList.rbegin();
-    if (it != m_receivedPacketList.rend())
-    {
-        return it->first;
-    }
-    else
-    {
-        return nullptr;
-    }
+    return m_lastPacket;
 }
 
 void
@@ -383,8 +451,7 @@ EndDeviceStatus::GetPowerGatewayMap()
     // Create a map of the gateways
     // Key: received power
     // Value: address of the corresponding gateway
-    ReceivedPacketInfo info = m_receivedPacketList.back().second;
-    GatewayList gwList = info.gwList;
+    const GatewayList& gwList = GetLastReceivedPacketInfo().gwList;
 
     std::map<double, Address> gatewayPowers;
 
@@ -398,12 +465,87 @@ EndDeviceStatus::GetPowerGatewayMap()
     return gatewayPowers;
 }
 
+uint8_t
+EndDeviceStatus::GetNRankedGateways() const
+{
+    return m_nRanked;
+}
+
+const EndDeviceStatus::RankedGateway&
+EndDeviceStatus::GetRankedGateway(uint8_t rank) const
+{
+    NS_ASSERT(rank < m_nRanked);
+    return m_ranking[rank];
+}
+
+void
+EndDeviceStatus::RankGateway(uint32_t gwId, double rxPower)
+{
+    NS_LOG_FUNCTION(this << gwId << rxPower);
+
+    if (gwId == UplinkContext::UNKNOWN_GATEWAY)
+    {
+        return;
+    }
+    for (uint8_t i = 0; i < m_nRanked; i++)
+    {
+        if (m_ranking[i].gwId == gwId)
+        {
+            return; // Already ranked
+        }
+    }
+
+    // Find the position, after the gateways with higher or equal power
+    uint8_t pos = 0;
+    while (pos < m_nRanked && m_ranking[pos].rxPower >= rxPower)
+    {
+        pos++;
+    }
+    if (pos == MAX_RANKED_GATEWAYS)
+    {
+        return;
+    }
+
+    // Shift down the worse gateways, dropping the last one if full
+    if (m_nRanked < MAX_RANKED_GATEWAYS)
+    {
+        m_nRanked++;
+    }
+    for (uint8_t i = m_nRanked - 1; i > pos; i--)
+    {
+        m_ranking[i] = m_ranking[i - 1];
+    }
+    m_ranking[pos] = {gwId, rxPower};
+}
+
+double
+EndDeviceStatus::GetSnr(const ReceivedPacketInfo& info, RxPowerCombining combining)
+{
+    double rxPower = 0;
+    switch (combining)
+    {
+    case AVERAGE:
+        rxPower = info.sumRxPower / info.gwList.size();
+        break;
+    case MAXIMUM:
+        rxPower = info.maxRxPower;
+        break;
+    case MINIMUM:
+        rxPower = info.minRxPower;
+        break;
+    }
+    return LoraPhy::RxPowerToSNR(rxPower);
+}
+
 void
 EndDeviceStatus::DoDispose()
 {
     NS_LOG_FUNCTION(this);
     m_receiveWindowEvent.Cancel();
-    m_receivedPacketList.clear();
+    m_history.clear();
+    m_snrWindows.clear();
+    m_fCntSlot.clear();
+    m_lastPacket = nullptr;
     m_mac = nullptr;
     Object::DoDispose();
 }
@@ -411,14 +553,13 @@ EndDeviceStatus::DoDispose()
 std::ostream&
 operator<<(std::ostream& os, const EndDeviceStatus& status)
 {
-    os << "Recently received packets: " << status.m_receivedPacketList.size() << std::endl;
+    os << "Recently received packets: " << status.m_historyCount << std::endl;
 
-    for (auto j = status.m_receivedPacketList.begin(); j != status.m_receivedPacketList.end(); j++)
+    for (uint32_t age = status.m_historyCount; age-- > 0;)
     {
-        EndDeviceStatus::ReceivedPacketInfo info = (*j).second;
-        EndDeviceStatus::GatewayList gatewayList = info.gwList;
-        Ptr<const Packet> pkt = (*j).first;
-        os << pkt << " " << gatewayList.size() << std::endl;
+        const EndDeviceStatus::ReceivedPacketInfo& info = status.GetReceivedPacketInfo(age);
+        const EndDeviceStatus::GatewayList& gatewayList = info.gwList;
+        os << "FCnt=" << unsigned(info.fCnt) << " " << gatewayList.size() << std::endl;
         for (auto k = gatewayList.begin(); k != gatewayList.end(); k++)
         {
             EndDeviceStatus::PacketInfoPerGw infoPerGw = (*k).second;
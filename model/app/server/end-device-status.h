@@ -14,6 +14,9 @@
 #ifndef END_DEVICE_STATUS_H
 #define END_DEVICE_STATUS_H
 
+#include "sliding-window-statistics.h"
+#include "uplink-context.h"
+
 #include "ns3/class-a-end-device-lorawan-mac.h"
 #include "ns3/lora-device-address.h"
 #include "ns3/lora-frame-header.h"
@@ -21,7 +24,10 @@
 #include "ns3/object.h"
 #include "ns3/pointer.h"
 
+#include <array>
 #include <iostream>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -58,15 +64,15 @@ namespace lorawan
  *                   - Need for reply (true/false)
  *                   - Updated reply
  *               --- Received Packets
- *                   - Received packets list (see below).
+ *                   - Bounded history of received packets (see below).
  *
  *
  * Private Access:
  *
- *  (Received packets list) - List of gateways that received the packet (see below)
- *                          - SF of the received packet
- *                          - Frequency of the received packet
- *                          - Bandwidth of the received packet
+ *  (Received packets history) - List of gateways that received the packet (see below)
+ *                             - SF of the received packet
+ *                             - Frequency of the received packet
+ *                             - Header fields (FCnt, ADR bits, message type)
  *
  *  (Gateway list) - Time at which the packet was received
  *                 - Reception power
@@ -75,6 +81,17 @@ namespace lorawan
 class EndDeviceStatus : public Object
 {
   public:
+    static constexpr uint8_t MAX_RANKED_GATEWAYS = 8; //!< Size of the gateway ranking
+
+    /**
+     * A gateway that received the last packet of the device.
+     */
+    struct RankedGateway
+    {
+        uint32_t gwId;  //!< Id of the gateway in the NetworkStatus
+        double rxPower; //!< Power of reception (dBm)
+    };
+
     /********************/
     /* Reply management */
     /********************/
@@ -163,9 +180,37 @@ class EndDeviceStatus : public Object
         GatewayList gwList; //!< List of gateways that received this packet.
         uint8_t sf;
         double frequency;
+        // Header fields of the packet, parsed on first reception
+        uint16_t fCnt = 0;      //!< Frame counter
+        bool adr = false;       //!< ADR bit
+        bool adrAckReq = false; //!< ADRACKReq bit
+        uint8_t fType = 0;      //!< Message type (LorawanMacHeader::MType)
+        // Received power at the gateways, combined as gateways are added
+        double minRxPower = 0; //!< Minimum received power (dBm)
+        double maxRxPower = 0; //!< Maximum received power (dBm)
+        double sumRxPower = 0; //!< Sum of the received powers (dBm)
+    };
+
+    /**
+     * Ways of combining the received powers of a packet at multiple gateways.
+     */
+    enum RxPowerCombining
+    {
+        AVERAGE,
+        MAXIMUM,
+        MINIMUM,
     };
 
-    typedef std::list<std::pair<Ptr<const Packet>, ReceivedPacketInfo>> ReceivedPacketList;
+    /**
+     * Statistics of the SNR of the last received packets.
+     */
+    struct SnrStatistics
+    {
+        uint32_t count = 0; //!< Number of packets the statistics are computed on
+        double min = 0;     //!< Minimum SNR (dB)
+        double max = 0;     //!< Maximum SNR (dB)
+        double average = 0; //!< Average SNR (dB)
+    };
 
     /*******************************************/
     /* Proper EndDeviceStatus class definition */
@@ -205,11 +250,48 @@ class EndDeviceStatus : public Object
     double GetSecondReceiveWindowFrequency() const;
 
     /**
-     * Get the received packet list.
+     * Get the number of packets in the history of received packets.
+     *
+     * \return The number of packets, at most the HistorySize attribute.
+     */
+    uint32_t GetNReceivedPackets() const;
+
+    /**
+     * Set the capacity of the history of received packets, keeping the most
+     * recent packets that fit.
+     *
+     * \param size The number of packets.
+     */
+    void SetHistorySize(uint32_t size);
+
+    /**
+     * Get the capacity of the history of received packets.
+     *
+     * \return The number of packets.
+     */
+    uint32_t GetHistorySize() const;
+
+    /**
+     * Get the information about a packet in the history of received packets.
+     *
+     * \param age The age of the packet, 0 being the last received one.
+     * \return The information about the packet.
+     */
+    const ReceivedPacketInfo& GetReceivedPacketInfo(uint32_t age) const;
+
+    /**
+     * Get statistics of the SNR of the last received packets, the received
+     * power of each packet being a combination of its powers at the gateways.
      *
-     * \return The received packet list.
+     * The first request for a combination and number of packets sets up a
+     * window that is then updated every time a new packet is received, so
+     * that subsequent requests (by any controller component) cost O(1).
+     *
+     * \param combining How the received powers at the gateways are combined.
+     * \param window The maximum number of packets, including the last one.
+     * \return The statistics, on at most the packets in the history.
      */
-    const ReceivedPacketList& GetReceivedPacketList() const;
+    SnrStatistics GetSnrStatistics(RxPowerCombining combining, uint32_t window);
 
     /**
      * Set the data rate this device is using in the first receive window.
@@ -254,6 +336,13 @@ class EndDeviceStatus : public Object
 
     /**
      * Insert a received packet in the packet list.
+     *
+     * \param uplink The parsed packet and the gateway it was received from.
+     */
+    void InsertReceivedPacket(const UplinkContext& uplink);
+
+    /**
+     * Parse a received packet and insert it in the packet list.
      */
     void InsertReceivedPacket(Ptr<const Packet> receivedPacket, const Address& gwAddress);
 
@@ -266,7 +355,7 @@ class EndDeviceStatus : public Object
      * Return the information about the last packet that was received from the
      * device.
      */
-    EndDeviceStatus::ReceivedPacketInfo GetLastReceivedPacketInfo();
+    const EndDeviceStatus::ReceivedPacketInfo& GetLastReceivedPacketInfo() const;
 
     /**
      * Initialize reply.
@@ -292,6 +381,21 @@ class EndDeviceStatus : public Object
      */
     std::map<double, Address> GetPowerGatewayMap();
 
+    /**
+     * Get the number of gateways ranked for the last received packet.
+     *
+     * Only the MAX_RANKED_GATEWAYS gateways with the highest received power
+     * are kept, and only those registered with an id in the NetworkStatus.
+     */
+    uint8_t GetNRankedGateways() const;
+
+    /**
+     * Get a gateway that received the last packet, by decreasing received power.
+     *
+     * \param rank The rank of the gateway, 0 being the best.
+     */
+    const RankedGateway& GetRankedGateway(uint8_t rank) const;
+
     struct Reply m_reply; //<! Next reply intended for this device
 
     LoraDeviceAddress m_endDeviceAddress; //<! The address of this device
@@ -302,6 +406,23 @@ class EndDeviceStatus : public Object
     void DoDispose() override;
 
   private:
+    /**
+     * Insert a gateway in the ranking of the last received packet.
+     *
+     * \param gwId The id of the gateway.
+     * \param rxPower The power of reception at the gateway (dBm).
+     */
+    void RankGateway(uint32_t gwId, double rxPower);
+
+    /**
+     * Get the SNR of a received packet.
+     *
+     * \param info The information about the packet.
+     * \param combining How the received powers at the gateways are combined.
+     * \return The SNR (dB).
+     */
+    static double GetSnr(const ReceivedPacketInfo& info, RxPowerCombining combining);
+
     // Receive window data
     uint8_t m_firstReceiveWindowDataRate = 0;
     double m_firstReceiveWindowFrequency = 0;
@@ -309,7 +430,35 @@ class EndDeviceStatus : public Object
     double m_secondReceiveWindowFrequency = 869525000;
     EventId m_receiveWindowEvent;
 
-    ReceivedPacketList m_receivedPacketList; //<! List of received packets
+    /**
+     * History of received packets, as a ring buffer of size m_historySize
+     * where m_historyHead is the slot of the last received packet.
+     */
+    std::vector<ReceivedPacketInfo> m_history;
+    uint32_t m_historySize = 1;                        //!< Capacity of the history
+    uint32_t m_historyHead = 0;                        //!< Slot of the last received packet
+    uint32_t m_historyCount = 0;                       //!< Number of packets in the history
+    std::unordered_map<uint16_t, uint32_t> m_fCntSlot; //!< Slot of each FCnt in the history
+    Ptr<const Packet> m_lastPacket;                    //!< Last packet received from the device
+
+    /**
+     * Gateways that received the last packet, sorted by decreasing received
+     * power, kept up to date as copies of the packet arrive.
+     */
+    std::array<RankedGateway, MAX_RANKED_GATEWAYS> m_ranking;
+    uint8_t m_nRanked = 0; //!< Number of gateways in the ranking
+
+    /**
+     * SNR of the received packets, but the last one whose gateway list may
+     * still grow, one window per requested combination and size.
+     */
+    struct SnrWindow
+    {
+        RxPowerCombining combining;    //!< Combination of the received powers
+        SlidingWindowStatistics stats; //!< Statistics of the previous packets
+    };
+
+    std::vector<SnrWindow> m_snrWindows; //!< Windows requested by GetSnrStatistics
 
     // NOTE Using this attribute is 'cheating', since we are assuming perfect
     // synchronization between the info at the device and at the network server
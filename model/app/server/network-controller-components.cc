@@ -62,19 +62,15 @@ ConfirmedMessagesComponent::~ConfirmedMessagesComponent()
 }
 
 void
-ConfirmedMessagesComponent::OnReceivedPacket(Ptr<const Packet> packet,
-                                             Ptr<EndDeviceStatus> status,
+ConfirmedMessagesComponent::OnReceivedPacket(const UplinkContext& uplink,
                                              Ptr<NetworkStatus> networkStatus)
 {
-    NS_LOG_FUNCTION(this->GetTypeId() << packet << networkStatus);
+    NS_LOG_FUNCTION(this->GetTypeId() << uplink.packet << networkStatus);
 
     // Check whether the received packet requires an acknowledgment.
-    Ptr<Packet> myPacket = packet->Copy();
-    LorawanMacHeader mHdr;
-    myPacket->RemoveHeader(mHdr);
-    LoraFrameHeader fHdr;
-    fHdr.SetAsUplink();
-    myPacket->RemoveHeader(fHdr);
+    const LorawanMacHeader& mHdr = uplink.macHeader;
+    const LoraFrameHeader& fHdr = uplink.frameHeader;
+    Ptr<EndDeviceStatus> status = uplink.status;
 
     NS_LOG_INFO("Received packet Mac Header: " << mHdr);
     NS_LOG_INFO("Received packet Frame Header: " << fHdr);
@@ -142,14 +138,21 @@ LinkCheckComponent::~LinkCheckComponent()
 }
 
 void
-LinkCheckComponent::OnReceivedPacket(Ptr<const Packet> packet,
-                                     Ptr<EndDeviceStatus> status,
-                                     Ptr<NetworkStatus> networkStatus)
+LinkCheckComponent::OnReceivedPacket(const UplinkContext& uplink, Ptr<NetworkStatus> networkStatus)
 {
-    NS_LOG_FUNCTION(this->GetTypeId() << packet << networkStatus);
+    NS_LOG_FUNCTION(this->GetTypeId() << uplink.packet << networkStatus);
 
     // We will only act just before reply, when all Gateways will have received
-    // the packet.
+    // the packet. For now, remember whether the device requested a LinkCheck.
+    // FindMacCommand returns nullptr if no command is found
+    if (uplink.frameHeader.FindMacCommand<LinkCheckReq>())
+    {
+        m_requests.insert(uplink.status);
+    }
+    else
+    {
+        m_requests.erase(uplink.status);
+    }
 }
 
 void
@@ -158,17 +161,7 @@ LinkCheckComponent::BeforeSendingReply(Ptr<EndDeviceStatus> status,
 {
     NS_LOG_FUNCTION(this << status << networkStatus);
 
-    Ptr<Packet> myPacket = status->GetLastPacketReceivedFromDevice()->Copy();
-    LorawanMacHeader mHdr;
-    myPacket->RemoveHeader(mHdr);
-    LoraFrameHeader fHdr;
-    fHdr.SetAsUplink();
-    myPacket->RemoveHeader(fHdr);
-
-    Ptr<LinkCheckReq> command = fHdr.GetMacCommand<LinkCheckReq>();
-
-    // GetMacCommand returns 0 if no command is found
-    if (command)
+    if (m_requests.count(status))
     {
         status->m_reply.needsReply = true;
 
@@ -193,5 +186,13 @@ LinkCheckComponent::OnFailedReply(Ptr<EndDeviceStatus> status, Ptr<NetworkStatus
 {
     NS_LOG_FUNCTION(this->GetTypeId() << networkStatus);
 }
+
+void
+LinkCheckComponent::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_requests.clear();
+    NetworkControllerComponent::DoDispose();
+}
 } // namespace lorawan
 } // namespace ns3
@@ -14,11 +14,14 @@
 #define NETWORK_CONTROLLER_COMPONENTS_H
 
 #include "network-status.h"
+#include "uplink-context.h"
 
 #include "ns3/log.h"
 #include "ns3/object.h"
 #include "ns3/packet.h"
 
+#include <set>
+
 namespace ns3
 {
 namespace lorawan
@@ -50,11 +53,11 @@ class NetworkControllerComponent : public Object
     /**
      * Method that is called when a new packet is received by the NetworkServer.
      *
-     * \param packet The newly received packet
+     * \param uplink The newly received packet, parsed, with the status of
+     *               the device that sent it
      * \param networkStatus A pointer to the NetworkStatus object
      */
-    virtual void OnReceivedPacket(Ptr<const Packet> packet,
-                                  Ptr<EndDeviceStatus> status,
+    virtual void OnReceivedPacket(const UplinkContext& uplink,
                                   Ptr<NetworkStatus> networkStatus) = 0;
 
     virtual void BeforeSendingReply(Ptr<EndDeviceStatus> status,
@@ -87,12 +90,10 @@ class ConfirmedMessagesComponent : public NetworkControllerComponent
      * This method checks whether the received packet requires an acknowledgment
      * and sets up the appropriate reply in case it does.
      *
-     * \param packet The newly received packet
+     * \param uplink The newly received packet
      * \param networkStatus A pointer to the NetworkStatus object
      */
-    void OnReceivedPacket(Ptr<const Packet> packet,
-                          Ptr<EndDeviceStatus> status,
-                          Ptr<NetworkStatus> networkStatus) override;
+    void OnReceivedPacket(const UplinkContext& uplink, Ptr<NetworkStatus> networkStatus) override;
 
     void BeforeSendingReply(Ptr<EndDeviceStatus> status, Ptr<NetworkStatus> networkStatus) override;
 
@@ -116,19 +117,20 @@ class LinkCheckComponent : public NetworkControllerComponent
      * This method checks whether the received packet requires an acknowledgment
      * and sets up the appropriate reply in case it does.
      *
-     * \param packet The newly received packet
+     * \param uplink The newly received packet
      * \param networkStatus A pointer to the NetworkStatus object
      */
-    void OnReceivedPacket(Ptr<const Packet> packet,
-                          Ptr<EndDeviceStatus> status,
-                          Ptr<NetworkStatus> networkStatus) override;
+    void OnReceivedPacket(const UplinkContext& uplink, Ptr<NetworkStatus> networkStatus) override;
 
     void BeforeSendingReply(Ptr<EndDeviceStatus> status, Ptr<NetworkStatus> networkStatus) override;
 
     void OnFailedReply(Ptr<EndDeviceStatus> status, Ptr<NetworkStatus> networkStatus) override;
 
+  protected:
+    void DoDispose() override;
+
   private:
-    void UpdateLinkCheckAns(Ptr<const Packet> packet, Ptr<EndDeviceStatus> status);
+    std::set<Ptr<EndDeviceStatus>> m_requests; //!< Devices whose last packet had a LinkCheckReq
 };
 } // namespace lorawan
 
@@ -55,9 +55,9 @@ NetworkController::Install(Ptr<NetworkControllerComponent> component)
 }
 
 void
-NetworkController::OnNewPacket(Ptr<const Packet> packet)
+NetworkController::OnNewPacket(const UplinkContext& uplink)
 {
-    NS_LOG_FUNCTION(this << packet);
+    NS_LOG_FUNCTION(this << uplink.packet);
 
     // NOTE As a future optimization, we can allow components to register their
     // callbacks and only be called in case a certain MAC command is contained.
@@ -66,7 +66,7 @@ NetworkController::OnNewPacket(Ptr<const Packet> packet)
     // Inform each component about the new packet
     for (auto it = m_components.begin(); it != m_components.end(); ++it)
     {
-        (*it)->OnReceivedPacket(packet, m_status->GetEndDeviceStatus(packet), m_status);
+        (*it)->OnReceivedPacket(uplink, m_status);
     }
 }
 
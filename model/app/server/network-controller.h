@@ -15,6 +15,7 @@
 
 #include "network-controller-components.h"
 #include "network-status.h"
+#include "uplink-context.h"
 
 #include "ns3/object.h"
 #include "ns3/packet.h"
@@ -49,9 +50,9 @@ class NetworkController : public Object
     /**
      * Method that is called by the NetworkServer when a new packet is received.
      *
-     * \param packet The newly received packet.
+     * \param uplink The newly received packet, parsed.
      */
-    void OnNewPacket(Ptr<const Packet> packet);
+    void OnNewPacket(const UplinkContext& uplink);
 
     /**
      * Method that is called by the NetworkScheduler just before sending a reply
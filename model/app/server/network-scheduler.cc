@@ -54,26 +54,18 @@ NetworkScheduler::~NetworkScheduler()
 }
 
 void
-NetworkScheduler::OnReceivedPacket(Ptr<const Packet> packet)
+NetworkScheduler::OnReceivedPacket(const UplinkContext& uplink)
 {
-    NS_LOG_FUNCTION(packet);
-
-    // Get the current packet's frame counter
-    Ptr<Packet> packetCopy = packet->Copy();
-    LorawanMacHeader receivedMacHdr;
-    packetCopy->RemoveHeader(receivedMacHdr);
-    LoraFrameHeader receivedFrameHdr;
-    receivedFrameHdr.SetAsUplink();
-    packetCopy->RemoveHeader(receivedFrameHdr);
+    NS_LOG_FUNCTION(uplink.packet);
 
     // Need to decide whether to schedule a receive window
-    if (!m_status->GetEndDeviceStatus(packet)->HasReceiveWindowOpportunityScheduled())
+    if (!uplink.status->HasReceiveWindowOpportunityScheduled())
     {
         // Extract the address
-        LoraDeviceAddress deviceAddress = receivedFrameHdr.GetAddress();
+        LoraDeviceAddress deviceAddress = uplink.frameHeader.GetAddress();
 
         // Schedule OnReceiveWindowOpportunity event
-        m_status->GetEndDeviceStatus(packet)->SetReceiveWindowOpportunity(
+        uplink.status->SetReceiveWindowOpportunity(
             Simulator::Schedule(Seconds(1),
                                 &NetworkScheduler::OnReceiveWindowOpportunity,
                                 this,
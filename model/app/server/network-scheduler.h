@@ -15,6 +15,7 @@
 
 #include "network-controller.h"
 #include "network-status.h"
+#include "uplink-context.h"
 
 #include "ns3/core-module.h"
 #include "ns3/lora-device-address.h"
@@ -44,8 +45,10 @@ class NetworkScheduler : public Object
      * Method called by NetworkServer to inform the Scheduler of a newly arrived
      * uplink packet. This function schedules the OnReceiveWindowOpportunity
      * events 1 and 2 seconds later.
+     *
+     * \param uplink The parsed uplink packet.
      */
-    void OnReceivedPacket(Ptr<const Packet> packet);
+    void OnReceivedPacket(const UplinkContext& uplink);
 
     /**
      * Method that is scheduled after packet arrivals in order to act on
@@ -150,20 +150,27 @@ NetworkServer::Receive(Ptr<NetDevice> device,
 {
     NS_LOG_FUNCTION(this << packet << protocol << address);
 
-    // Create a copy of the packet
-    Ptr<Packet> myPacket = packet->Copy();
-
     // Fire the trace source
     m_receivedPacket(packet);
 
+    // Parse the packet once for all the server's components
+    UplinkContext uplink(packet, address);
+    uplink.gwId = m_status->GetGatewayId(address);
+    uplink.status = m_status->GetEndDeviceStatus(uplink.frameHeader.GetAddress());
+    if (!uplink.status)
+    {
+        NS_LOG_ERROR("Dropping packet of unknown device " << uplink.frameHeader.GetAddress());
+        return true;
+    }
+
     // Inform the scheduler of the newly arrived packet
-    m_scheduler->OnReceivedPacket(packet);
+    m_scheduler->OnReceivedPacket(uplink);
 
     // Inform the status of the newly arrived packet
-    m_status->OnReceivedPacket(packet, address);
+    m_status->OnReceivedPacket(uplink);
 
     // Inform the controller of the newly arrived packet
-    m_controller->OnNewPacket(packet);
+    m_controller->OnNewPacket(uplink);
 
     return true;
 }
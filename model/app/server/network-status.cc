@@ -58,12 +58,13 @@ NetworkStatus::AddNode(Ptr<ClassAEndDeviceLorawanMac> edMac)
     NS_LOG_FUNCTION(this << edMac);
     // Check whether this device already exists in our list
     LoraDeviceAddress edAddress = edMac->GetDeviceAddress();
-    if (m_endDeviceStatuses.find(edAddress) == m_endDeviceStatuses.end())
+    if (m_endDeviceIds.find(edAddress.Get()) == m_endDeviceIds.end())
     {
         // The device doesn't exist. Create new EndDeviceStatus
         auto edStatus = CreateObject<EndDeviceStatus>(edAddress, edMac);
-        // Add it to the map
-        m_endDeviceStatuses.insert({edAddress, edStatus});
+        // Give it the next dense id
+        m_endDeviceIds.emplace(edAddress.Get(), m_endDeviceStatuses.size());
+        m_endDeviceStatuses.push_back(edStatus);
         NS_LOG_DEBUG("Added to the list a device with address " << edAddress.Print());
     }
 }
@@ -74,49 +75,41 @@ NetworkStatus::AddGateway(Address& address, Ptr<GatewayStatus> gwStatus)
     NS_LOG_FUNCTION(this);
 
     // Check whether this device already exists in the list
-    if (m_gatewayStatuses.find(address) == m_gatewayStatuses.end())
+    if (m_gatewayIds.find(address) == m_gatewayIds.end())
     {
         // The device doesn't exist.
 
-        // Add it to the map
-        m_gatewayStatuses.insert(std::pair<Address, Ptr<GatewayStatus>>(address, gwStatus));
+        // Give it the next dense id
+        m_gatewayIds.emplace(address, m_gatewayStatuses.size());
+        m_gatewayStatuses.push_back(gwStatus);
         NS_LOG_DEBUG("Added to the list a gateway with address " << address);
     }
 }
 
 void
-NetworkStatus::OnReceivedPacket(Ptr<const Packet> packet, const Address& gwAddress)
+NetworkStatus::OnReceivedPacket(const UplinkContext& uplink)
 {
-    NS_LOG_FUNCTION(this << packet << gwAddress);
-
-    // Create a copy of the packet
-    Ptr<Packet> myPacket = packet->Copy();
-
-    // Extract the headers
-    LorawanMacHeader mHdr;
-    myPacket->RemoveHeader(mHdr);
-    LoraFrameHeader fHdr;
-    fHdr.SetAsUplink();
-    myPacket->RemoveHeader(fHdr);
+    NS_LOG_FUNCTION(this << uplink.packet << uplink.gwAddress);
 
     // Update the correct EndDeviceStatus object
-    LoraDeviceAddress edAddr = fHdr.GetAddress();
-    NS_LOG_DEBUG("Node address: " << edAddr);
-    m_endDeviceStatuses.at(edAddr)->InsertReceivedPacket(packet, gwAddress);
+    NS_LOG_DEBUG("Node address: " << uplink.frameHeader.GetAddress());
+    uplink.status->InsertReceivedPacket(uplink);
 }
 
 bool
 NetworkStatus::NeedsReply(LoraDeviceAddress deviceAddress)
 {
-    // Throws out of range if no device is found
-    return m_endDeviceStatuses.at(deviceAddress)->NeedsReply();
+    Ptr<EndDeviceStatus> edStatus = GetEndDeviceStatus(deviceAddress);
+    NS_ABORT_MSG_IF(!edStatus, "Unknown device " << deviceAddress);
+    return edStatus->NeedsReply();
 }
 
 Address
 NetworkStatus::GetBestGatewayForDevice(LoraDeviceAddress deviceAddress, int window)
 {
     // Get the endDeviceStatus we are interested in
-    Ptr<EndDeviceStatus> edStatus = m_endDeviceStatuses.at(deviceAddress);
+    Ptr<EndDeviceStatus> edStatus = GetEndDeviceStatus(deviceAddress);
+    NS_ABORT_MSG_IF(!edStatus, "Unknown device " << deviceAddress);
     double replyFrequency;
     if (window == 1)
     {
@@ -131,28 +124,45 @@ NetworkStatus::GetBestGatewayForDevice(LoraDeviceAddress deviceAddress, int wind
         NS_ABORT_MSG("Invalid window value");
     }
 
-    // Get the list of gateways that this device can reach
+    // Get the gateways that this device can reach, ranked at reception by
+    // received power.
     // NOTE: At this point, we could also take into account the whole network to
     // identify the best gateway according to various metrics. For now, we just
-    // ask the EndDeviceStatus to pick the best gateway for us via its method.
-    std::map<double, Address> gwAddresses = edStatus->GetPowerGatewayMap();
+    // go from the 'best' gateway, i.e. the one with the highest received
+    // power, to the worst.
+    for (uint8_t rank = 0; rank < edStatus->GetNRankedGateways(); rank++)
+    {
+        Ptr<GatewayStatus> gwStatus = m_gatewayStatuses[edStatus->GetRankedGateway(rank).gwId];
+        if (gwStatus->IsAvailableForTransmission(replyFrequency))
+        {
+            return gwStatus->GetAddress();
+        }
+    }
 
-    // By iterating on the map in reverse, we go from the 'best'
-    // gateway, i.e. the one with the highest received power, to the
-    // worst.
-    Address bestGwAddress;
+    // The ranking only keeps the best gateways: if they are all busy, go
+    // through the other gateways that received the packet
+    uint8_t nRanked = edStatus->GetNRankedGateways();
+    if (edStatus->GetLastReceivedPacketInfo().gwList.size() <= nRanked)
+    {
+        return Address();
+    }
+    std::map<double, Address> gwAddresses = edStatus->GetPowerGatewayMap();
     for (auto it = gwAddresses.rbegin(); it != gwAddresses.rend(); it++)
     {
-        bool isAvailable =
-            m_gatewayStatuses.find(it->second)->second->IsAvailableForTransmission(replyFrequency);
-        if (isAvailable)
+        uint32_t gwId = GetGatewayId(it->second);
+        bool ranked = false;
+        for (uint8_t rank = 0; rank < nRanked && !ranked; rank++)
         {
-            bestGwAddress = it->second;
-            break;
+            ranked = (edStatus->GetRankedGateway(rank).gwId == gwId);
+        }
+        if (gwId != UplinkContext::UNKNOWN_GATEWAY && !ranked &&
+            m_gatewayStatuses[gwId]->IsAvailableForTransmission(replyFrequency))
+        {
+            return it->second;
         }
     }
 
-    return bestGwAddress;
+    return Address();
 }
 
 void
@@ -160,19 +170,19 @@ NetworkStatus::SendThroughGateway(Ptr<Packet> packet, Address gwAddress)
 {
     NS_LOG_FUNCTION(packet << gwAddress);
 
-    m_gatewayStatuses.find(gwAddress)->second->GetNetDevice()->Send(packet, gwAddress, 0x0800);
+    m_gatewayStatuses[m_gatewayIds.at(gwAddress)]->GetNetDevice()->Send(packet, gwAddress, 0x0800);
 }
 
 Ptr<Packet>
 NetworkStatus::GetReplyForDevice(LoraDeviceAddress edAddress, int windowNumber)
 {
     // Get the reply packet
-    Ptr<EndDeviceStatus> edStatus = m_endDeviceStatuses.find(edAddress)->second;
+    Ptr<EndDeviceStatus> edStatus = GetEndDeviceStatus(edAddress);
     Ptr<Packet> packet = edStatus->GetCompleteReplyPacket();
 
     // Apply the appropriate tag
     LoraTag tag;
-    packet->RemovePacketTag(tag);
+    packet->PeekPacketTag(tag);
     switch (windowNumber)
     {
     case 1:
@@ -184,7 +194,7 @@ NetworkStatus::GetReplyForDevice(LoraDeviceAddress edAddress, int windowNumber)
         tag.SetFrequency(edStatus->GetSecondReceiveWindowFrequency());
         break;
     }
-    packet->AddPacketTag(tag);
+    tag.WriteTo(packet);
     return packet;
 }
 
@@ -200,16 +210,7 @@ NetworkStatus::GetEndDeviceStatus(Ptr<const Packet> packet)
     LoraFrameHeader fHdr;
     fHdr.SetAsUplink();
     myPacket->RemoveHeader(fHdr);
-    auto it = m_endDeviceStatuses.find(fHdr.GetAddress());
-    if (it != m_endDeviceStatuses.end())
-    {
-        return (*it).second;
-    }
-    else
-    {
-        NS_LOG_ERROR("EndDeviceStatus not found");
-        return nullptr;
-    }
+    return GetEndDeviceStatus(fHdr.GetAddress());
 }
 
 Ptr<EndDeviceStatus>
@@ -217,10 +218,10 @@ NetworkStatus::GetEndDeviceStatus(LoraDeviceAddress address)
 {
     NS_LOG_FUNCTION(this << address);
 
-    auto it = m_endDeviceStatuses.find(address);
-    if (it != m_endDeviceStatuses.end())
+    auto it = m_endDeviceIds.find(address.Get());
+    if (it != m_endDeviceIds.end())
     {
-        return (*it).second;
+        return m_endDeviceStatuses[it->second];
     }
     else
     {
@@ -229,6 +230,19 @@ NetworkStatus::GetEndDeviceStatus(LoraDeviceAddress address)
     }
 }
 
+uint32_t
+NetworkStatus::GetGatewayId(const Address& address) const
+{
+    auto it = m_gatewayIds.find(address);
+    return (it != m_gatewayIds.end()) ? it->second : UplinkContext::UNKNOWN_GATEWAY;
+}
+
+Ptr<GatewayStatus>
+NetworkStatus::GetGatewayStatus(uint32_t gwId) const
+{
+    return (gwId < m_gatewayStatuses.size()) ? m_gatewayStatuses[gwId] : nullptr;
+}
+
 int
 NetworkStatus::CountEndDevices()
 {
@@ -241,16 +255,18 @@ void
 NetworkStatus::DoDispose()
 {
     NS_LOG_FUNCTION(this);
-    for (auto dev : m_endDeviceStatuses)
+    for (auto& dev : m_endDeviceStatuses)
     {
-        dev.second->Dispose();
+        dev->Dispose();
     }
     m_endDeviceStatuses.clear();
-    for (auto gw : m_gatewayStatuses)
+    m_endDeviceIds.clear();
+    for (auto& gw : m_gatewayStatuses)
     {
-        gw.second->Dispose();
+        gw->Dispose();
     }
     m_gatewayStatuses.clear();
+    m_gatewayIds.clear();
     Object::DoDispose();
 }
 
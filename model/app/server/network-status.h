@@ -22,6 +22,9 @@
 #include "ns3/lora-device-address.h"
 
 #include <iterator>
+#include <map>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -60,10 +63,10 @@ class NetworkStatus : public Object
     /**
      * Update network status on the received packet.
      *
-     * \param packet the received packet.
-     * \param address the gateway this packet was received from.
+     * \param uplink the parsed packet, with the gateway it was received from
+     *               and the status of its sender.
      */
-    void OnReceivedPacket(Ptr<const Packet> packet, const Address& gwaddress);
+    void OnReceivedPacket(const UplinkContext& uplink);
 
     /**
      * Return whether the specified device needs a reply.
@@ -104,6 +107,19 @@ class NetworkStatus : public Object
      */
     Ptr<EndDeviceStatus> GetEndDeviceStatus(LoraDeviceAddress address);
 
+    /**
+     * Get the dense id the server assigned to a gateway.
+     *
+     * \param address The address of the gateway in the NS-GW network.
+     * \return The id, UplinkContext::UNKNOWN_GATEWAY if the gateway is unknown.
+     */
+    uint32_t GetGatewayId(const Address& address) const;
+
+    /**
+     * Get the GatewayStatus corresponding to a gateway id.
+     */
+    Ptr<GatewayStatus> GetGatewayStatus(uint32_t gwId) const;
+
     /**
      * Return the number of end devices currently managed by the server.
      */
@@ -112,9 +128,12 @@ class NetworkStatus : public Object
   protected:
     void DoDispose() override;
 
-  public:
-    std::map<LoraDeviceAddress, Ptr<EndDeviceStatus>> m_endDeviceStatuses;
-    std::map<Address, Ptr<GatewayStatus>> m_gatewayStatuses;
+  private:
+    // Devices and gateways are given dense ids in order of registration
+    std::vector<Ptr<EndDeviceStatus>> m_endDeviceStatuses; //!< Devices, by id
+    std::unordered_map<uint32_t, uint32_t> m_endDeviceIds; //!< Id of each device address
+    std::vector<Ptr<GatewayStatus>> m_gatewayStatuses;     //!< Gateways, by id
+    std::map<Address, uint32_t> m_gatewayIds;              //!< Id of each gateway address
 };
 
 } // namespace lorawan
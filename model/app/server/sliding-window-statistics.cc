@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2026 University of Bologna
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Alessandro Aimi <alessandro.aimi@unibo.it>
+ */
+
+#include "sliding-window-statistics.h"
+
+#include "ns3/log.h"
+
+namespace ns3
+{
+namespace lorawan
+{
+
+NS_LOG_COMPONENT_DEFINE("SlidingWindowStatistics");
+
+SlidingWindowStatistics::SlidingWindowStatistics(uint32_t size)
+    : m_size(size),
+      m_pushed(0),
+      m_sum(0)
+{
+}
+
+void
+SlidingWindowStatistics::Push(double value)
+{
+    NS_LOG_FUNCTION(this << value);
+
+    if (m_size == 0)
+    {
+        return;
+    }
+    uint64_t index = m_pushed++;
+
+    // Rolling sum
+    m_values.push_back(value);
+    m_sum += value;
+    if (m_values.size() > m_size)
+    {
+        m_sum -= m_values.front();
+        m_values.pop_front();
+    }
+
+    // Candidates dominated by the new value can never be the minimum (maximum)
+    // again: remove them, then expire the candidate that left the window.
+    while (!m_min.empty() && m_min.back().second >= value)
+    {
+        m_min.pop_back();
+    }
+    m_min.emplace_back(index, value);
+    if (m_min.front().first + m_size <= index)
+    {
+        m_min.pop_front();
+    }
+
+    while (!m_max.empty() && m_max.back().second <= value)
+    {
+        m_max.pop_back();
+    }
+    m_max.emplace_back(index, value);
+    if (m_max.front().first + m_size <= index)
+    {
+        m_max.pop_front();
+    }
+}
+
+void
+SlidingWindowStatistics::Clear()
+{
+    m_pushed = 0;
+    m_sum = 0;
+    m_values.clear();
+    m_min.clear();
+    m_max.clear();
+}
+
+uint32_t
+SlidingWindowStatistics::GetSize() const
+{
+    return m_size;
+}
+
+uint32_t
+SlidingWindowStatistics::GetCount() const
+{
+    return m_values.size();
+}
+
+double
+SlidingWindowStatistics::GetMin() const
+{
+    NS_ASSERT_MSG(!m_min.empty(), "Empty window");
+    return m_min.front().second;
+}
+
+double
+SlidingWindowStatistics::GetMax() const
+{
+    NS_ASSERT_MSG(!m_max.empty(), "Empty window");
+    return m_max.front().second;
+}
+
+double
+SlidingWindowStatistics::GetSum() const
+{
+    return m_sum;
+}
+
+double
+SlidingWindowStatistics::GetAverage() const
+{
+    NS_ASSERT_MSG(!m_values.empty(), "Empty window");
+    return m_sum / m_values.size();
+}
+
+} // namespace lorawan
+} // namespace ns3
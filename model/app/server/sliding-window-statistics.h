@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2026 University of Bologna
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Alessandro Aimi <alessandro.aimi@unibo.it>
+ */
+
+#ifndef SLIDING_WINDOW_STATISTICS_H
+#define SLIDING_WINDOW_STATISTICS_H
+
+#include <cstdint>
+#include <deque>
+#include <utility>
+
+namespace ns3
+{
+namespace lorawan
+{
+
+/**
+ * Minimum, maximum and average of the last values of a series.
+ *
+ * Values are pushed one at a time and every statistic is updated in amortized
+ * constant time: minimum and maximum are kept with monotonic deques of
+ * candidates, the average with a rolling sum.
+ */
+class SlidingWindowStatistics
+{
+  public:
+    /**
+     * Create an empty window.
+     *
+     * \param size The number of values in the window.
+     */
+    SlidingWindowStatistics(uint32_t size = 0);
+
+    /**
+     * Push a new value, dropping the oldest one if the window is full.
+     *
+     * \param value The value.
+     */
+    void Push(double value);
+
+    /**
+     * Remove all values.
+     */
+    void Clear();
+
+    /**
+     * \return The number of values in the window when full.
+     */
+    uint32_t GetSize() const;
+
+    /**
+     * \return The number of values currently in the window.
+     */
+    uint32_t GetCount() const;
+
+    /**
+     * \return The minimum of the values in the window, which must not be empty.
+     */
+    double GetMin() const;
+
+    /**
+     * \return The maximum of the values in the window, which must not be empty.
+     */
+    double GetMax() const;
+
+    /**
+     * \return The sum of the values in the window.
+     */
+    double GetSum() const;
+
+    /**
+     * \return The average of the values in the window, which must not be empty.
+     */
+    double GetAverage() const;
+
+  private:
+    uint32_t m_size;                               //!< Capacity of the window
+    uint64_t m_pushed;                             //!< Values pushed since the last Clear
+    double m_sum;                                  //!< Rolling sum of the values in the window
+    std::deque<double> m_values;                   //!< Values in the window, oldest first
+    std::deque<std::pair<uint64_t, double>> m_min; //!< Increasing minimum candidates
+    std::deque<std::pair<uint64_t, double>> m_max; //!< Decreasing maximum candidates
+};
+
+} // namespace lorawan
+} // namespace ns3
+
+#endif /* SLIDING_WINDOW_STATISTICS_H */
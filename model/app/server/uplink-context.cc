@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2026 University of Bologna
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Alessandro Aimi <alessandro.aimi@unibo.it>
+ */
+
+#include "uplink-context.h"
+
+#include "end-device-status.h"
+
+#include "ns3/log.h"
+
+namespace ns3
+{
+namespace lorawan
+{
+
+NS_LOG_COMPONENT_DEFINE("UplinkContext");
+
+UplinkContext::UplinkContext(Ptr<const Packet> packet, const Address& gwAddress)
+    : packet(packet),
+      gwAddress(gwAddress),
+      gwId(UNKNOWN_GATEWAY)
+{
+    NS_LOG_FUNCTION(this << packet << gwAddress);
+
+    // The only copy of the packet made by the server on reception
+    Ptr<Packet> myPacket = packet->Copy();
+    myPacket->RemoveHeader(macHeader);
+    frameHeader.SetAsUplink();
+    myPacket->RemoveHeader(frameHeader);
+    packet->PeekPacketTag(tag);
+}
+
+UplinkContext::~UplinkContext()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+} // namespace lorawan
+} // namespace ns3
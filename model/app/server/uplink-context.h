@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2026 University of Bologna
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Alessandro Aimi <alessandro.aimi@unibo.it>
+ */
+
+#ifndef UPLINK_CONTEXT_H
+#define UPLINK_CONTEXT_H
+
+#include "ns3/address.h"
+#include "ns3/lora-frame-header.h"
+#include "ns3/lora-tag.h"
+#include "ns3/lorawan-mac-header.h"
+#include "ns3/packet.h"
+
+#include <cstdint>
+
+namespace ns3
+{
+namespace lorawan
+{
+
+class EndDeviceStatus;
+
+/**
+ * An uplink packet received by the Network Server, parsed once.
+ *
+ * The context is built by the NetworkServer upon reception from a gateway and
+ * is then handed to the scheduler, the network status and the controller
+ * components, so that none of them needs to copy and parse the packet again.
+ */
+struct UplinkContext
+{
+    static constexpr uint32_t UNKNOWN_GATEWAY = UINT32_MAX; //!< Id of unregistered gateways
+
+    /**
+     * Parse an uplink packet.
+     *
+     * \param packet The packet, as received from the gateway.
+     * \param gwAddress The address of the gateway that forwarded the packet.
+     */
+    UplinkContext(Ptr<const Packet> packet, const Address& gwAddress);
+    ~UplinkContext();
+
+    Ptr<const Packet> packet;    //!< The received packet, headers included
+    LorawanMacHeader macHeader;  //!< The MAC header of the packet
+    LoraFrameHeader frameHeader; //!< The frame header of the packet (with MAC commands)
+    LoraTag tag;                 //!< The reception parameters of the gateway
+    Address gwAddress;           //!< The gateway that forwarded the packet
+    uint32_t gwId;               //!< The id of the gateway in the NetworkStatus
+    Ptr<EndDeviceStatus> status; //!< The status of the sender, nullptr if unknown
+};
+
+} // namespace lorawan
+} // namespace ns3
+
+#endif /* UPLINK_CONTEXT_H */
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2026 University of Bologna
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Alessandro Aimi <alessandro.aimi@unibo.it>
+ */
+
+#include "trace-sender.h"
+
+namespace ns3
+{
+namespace lorawan
+{
+
+NS_LOG_COMPONENT_DEFINE("TraceSender");
+
+NS_OBJECT_ENSURE_REGISTERED(TraceSender);
+
+TypeId
+TraceSender::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::TraceSender")
+                            .SetParent<LoraApplication>()
+                            .AddConstructor<TraceSender>()
+                            .SetGroupName("lorawan");
+    return tid;
+}
+
+TraceSender::TraceSender()
+    : m_trace(nullptr),
+      m_index(0),
+      m_device(0),
+      m_registered(false)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TraceSender::~TraceSender()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+TraceSender::SetTrace(Ptr<TrafficTrace> trace, uint32_t index)
+{
+    NS_LOG_FUNCTION(this << trace << index);
+    m_trace = trace;
+    m_index = index;
+}
+
+void
+TraceSender::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    StopApplication();
+    m_trace = nullptr;
+    LoraApplication::DoDispose();
+}
+
+void
+TraceSender::StartApplication()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_UNLESS(m_trace, "No traffic trace was set");
+    // The address is only known once the device joined the network
+    m_device = m_trace->GetDeviceKey() == TrafficTrace::DEV_ADDR
+                   ? m_mac->GetDeviceAddress().Get()
+                   : m_index;
+    m_trace->Register(m_device, MakeCallback(&TraceSender::Send, this));
+    m_registered = true;
+    NS_LOG_DEBUG("Replaying the records of device " << m_device);
+}
+
+void
+TraceSender::StopApplication()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_registered)
+    {
+        m_trace->Unregister(m_device);
+        m_registered = false;
+    }
+}
+
+void
+TraceSender::Send(const TrafficTrace::Record& record)
+{
+    NS_LOG_FUNCTION(this);
+    // Create and send a new packet
+    Ptr<Packet> packet = record.payload.empty()
+                             ? Create<Packet>(record.size)
+                             : Create<Packet>(record.payload.data(), record.payload.size());
+    if (record.fPort)
+    {
+        m_mac->SetFPort(record.fPort);
+    }
+    m_mac->Send(packet);
+    NS_LOG_DEBUG("Sent a packet of size " << packet->GetSize());
+}
+
+} // namespace lorawan
+} // namespace ns3
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2026 University of Bologna
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Alessandro Aimi <alessandro.aimi@unibo.it>
+ */
+
+#ifndef TRACE_SENDER_H
+#define TRACE_SENDER_H
+
+#include "lora-application.h"
+#include "traffic-trace.h"
+
+namespace ns3
+{
+namespace lorawan
+{
+
+/**
+ * Send the uplink packets of a device in a traffic trace.
+ *
+ * The application does not schedule events itself: while running, it is
+ * registered to the shared TrafficTrace, which hands it its records in time.
+ */
+class TraceSender : public LoraApplication
+{
+  public:
+    TraceSender();
+    ~TraceSender() override;
+
+    static TypeId GetTypeId();
+
+    /**
+     * Set the trace replayed by this application.
+     *
+     * \param trace The trace.
+     * \param index The index of the device, used if the trace identifies
+     * devices by NODE_INDEX.
+     */
+    void SetTrace(Ptr<TrafficTrace> trace, uint32_t index);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /**
+     * Register to the trace.
+     */
+    void StartApplication() override;
+
+    /**
+     * Unregister from the trace.
+     */
+    void StopApplication() override;
+
+    /**
+     * Send the packet of a record using the MAC layer's Send method.
+     *
+     * \param record The record.
+     */
+    void Send(const TrafficTrace::Record& record);
+
+    Ptr<TrafficTrace> m_trace; //!< The replayed trace
+    uint32_t m_index;          //!< Index of the device
+    uint32_t m_device;         //!< Device in the trace
+    bool m_registered;         //!< Whether the application is registered to the trace
+};
+
+} // namespace lorawan
+} // namespace ns3
+
+#endif /* TRACE_SENDER_H */
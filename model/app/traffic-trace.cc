@@ -0,0 +1,393 @@
+/*
+ * Copyright (c) 2026 University of Bologna
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Alessandro Aimi <alessandro.aimi@unibo.it>
+ */
+
+#include "traffic-trace.h"
+
+#include "ns3/abort.h"
+#include "ns3/enum.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+namespace ns3
+{
+namespace lorawan
+{
+
+NS_LOG_COMPONENT_DEFINE("TrafficTrace");
+
+NS_OBJECT_ENSURE_REGISTERED(TrafficTrace);
+
+static const char TRACE_MAGIC[8] = {'L', 'O', 'R', 'A', 'T', 'R', 'F', 'C'};
+static const uint32_t TRACE_VERSION = 1;
+static const std::size_t TRACE_HEADER_SIZE = 16;
+static const std::size_t TRACE_RECORD_SIZE = 16; // Without payload
+
+/**
+ * Read an unsigned integer in little-endian order.
+ *
+ * \param buffer The buffer.
+ * \param n The number of bytes.
+ * \return The integer.
+ */
+static uint64_t
+ReadLe(const uint8_t* buffer, uint8_t n)
+{
+    uint64_t value = 0;
+    for (uint8_t i = 0; i < n; ++i)
+    {
+        value |= uint64_t(buffer[i]) << (8 * i);
+    }
+    return value;
+}
+
+/**
+ * Write an unsigned integer in little-endian order.
+ *
+ * \param buffer The buffer.
+ * \param value The integer.
+ * \param n The number of bytes.
+ */
+static void
+WriteLe(uint8_t* buffer, uint64_t value, uint8_t n)
+{
+    for (uint8_t i = 0; i < n; ++i)
+    {
+        buffer[i] = (value >> (8 * i)) & 0xff;
+    }
+}
+
+TypeId
+TrafficTrace::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::TrafficTrace")
+            .SetParent<Object>()
+            .SetGroupName("lorawan")
+            .AddConstructor<TrafficTrace>()
+            .AddAttribute("Filename",
+                          "Name of the CSV or binary trace",
+                          StringValue(""),
+                          MakeStringAccessor(&TrafficTrace::m_filename),
+                          MakeStringChecker())
+            .AddAttribute("DeviceKey",
+                          "How devices are identified in the trace",
+                          EnumValue(NODE_INDEX),
+                          MakeEnumAccessor<DeviceKey>(&TrafficTrace::m_deviceKey),
+                          MakeEnumChecker(NODE_INDEX, "NodeIndex", DEV_ADDR, "DevAddr"))
+            .AddAttribute("Offset",
+                          "Time subtracted from the times of records, e.g., the capture start",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&TrafficTrace::m_offset),
+                          MakeTimeChecker())
+            .AddAttribute("ReadAhead",
+                          "Maximum number of records read ahead of the simulation",
+                          UintegerValue(1024),
+                          MakeUintegerAccessor(&TrafficTrace::m_readAhead),
+                          MakeUintegerChecker<uint32_t>(1));
+    return tid;
+}
+
+TrafficTrace::TrafficTrace()
+    : m_filename(""),
+      m_deviceKey(NODE_INDEX),
+      m_offset(Seconds(0)),
+      m_readAhead(1024),
+      m_fileBuffer(1 << 20),
+      m_binary(false),
+      m_line(0),
+      m_lastTime(Time::Min())
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TrafficTrace::~TrafficTrace()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TrafficTrace::DeviceKey
+TrafficTrace::GetDeviceKey() const
+{
+    return m_deviceKey;
+}
+
+void
+TrafficTrace::Register(uint32_t device, SendCallback callback)
+{
+    NS_LOG_FUNCTION(this << device);
+    NS_ABORT_MSG_IF(m_senders.count(device), "Device " << device << " is already registered");
+
+    m_senders[device] = callback;
+    if (!m_file.is_open())
+    {
+        Open();
+    }
+    if (!m_nextEvent.IsPending())
+    {
+        ScheduleNext();
+    }
+}
+
+void
+TrafficTrace::Unregister(uint32_t device)
+{
+    NS_LOG_FUNCTION(this << device);
+
+    m_senders.erase(device);
+    if (m_senders.empty())
+    {
+        m_nextEvent.Cancel();
+    }
+}
+
+uint64_t
+TrafficTrace::Convert(const std::string& csv, const std::string& binary)
+{
+    NS_LOG_FUNCTION(csv << binary);
+
+    Ptr<TrafficTrace> trace = CreateObject<TrafficTrace>();
+    trace->m_filename = csv;
+    trace->Open();
+    NS_ABORT_MSG_IF(trace->m_binary, csv << " is already a binary traffic trace");
+
+    std::ofstream file(binary, std::ios::binary | std::ios::trunc);
+    NS_ABORT_MSG_IF(!file.is_open(), "Unable to open traffic trace " << binary);
+    char header[TRACE_HEADER_SIZE] = {};
+    std::memcpy(header, TRACE_MAGIC, 8);
+    WriteLe(reinterpret_cast<uint8_t*>(header + 8), TRACE_VERSION, 4);
+    file.write(header, TRACE_HEADER_SIZE);
+
+    uint64_t n = 0;
+    Record record;
+    uint8_t data[TRACE_RECORD_SIZE];
+    while (trace->Read(record))
+    {
+        WriteLe(data, record.time.GetNanoSeconds(), 8);
+        WriteLe(data + 8, record.device, 4);
+        data[12] = record.size;
+        data[13] = record.fPort;
+        WriteLe(data + 14, record.payload.size(), 2);
+        file.write(reinterpret_cast<char*>(data), TRACE_RECORD_SIZE);
+        file.write(reinterpret_cast<char*>(record.payload.data()), record.payload.size());
+        ++n;
+    }
+    NS_ABORT_MSG_IF(!file, "Unable to write traffic trace " << binary);
+    trace->Dispose();
+    return n;
+}
+
+void
+TrafficTrace::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_nextEvent.Cancel();
+    m_senders.clear();
+    m_buffer.clear();
+    m_file.close();
+    Object::DoDispose();
+}
+
+void
+TrafficTrace::Open()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_IF(m_filename.empty(), "No traffic trace file was set");
+
+    m_file.rdbuf()->pubsetbuf(m_fileBuffer.data(), m_fileBuffer.size());
+    m_file.open(m_filename, std::ios::binary);
+    NS_ABORT_MSG_IF(!m_file.is_open(), "Unable to open traffic trace " << m_filename);
+
+    char header[TRACE_HEADER_SIZE];
+    m_file.read(header, TRACE_HEADER_SIZE);
+    m_binary = m_file.gcount() == TRACE_HEADER_SIZE && std::memcmp(header, TRACE_MAGIC, 8) == 0;
+    if (m_binary)
+    {
+        uint32_t version = ReadLe(reinterpret_cast<uint8_t*>(header + 8), 4);
+        NS_ABORT_MSG_IF(version != TRACE_VERSION,
+                        "Unsupported version " << version << " of traffic trace " << m_filename);
+    }
+    else
+    {
+        m_file.clear();
+        m_file.seekg(0);
+    }
+    NS_LOG_INFO("Replaying " << (m_binary ? "binary" : "CSV") << " traffic trace " << m_filename);
+}
+
+bool
+TrafficTrace::Read(Record& record)
+{
+    if (!(m_binary ? ReadBinary(record) : ReadCsv(record)))
+    {
+        return false;
+    }
+    record.time -= m_offset;
+    NS_ABORT_MSG_IF(record.time < m_lastTime,
+                    "Records of traffic trace " << m_filename << " are not sorted by time");
+    m_lastTime = record.time;
+    return true;
+}
+
+bool
+TrafficTrace::ReadCsv(Record& record)
+{
+    std::string line;
+    while (std::getline(m_file, line))
+    {
+        ++m_line;
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == '#' || std::isalpha(static_cast<unsigned char>(line[0])))
+        {
+            continue;
+        }
+
+        std::vector<std::string> fields;
+        std::istringstream stream(line);
+        for (std::string field; std::getline(stream, field, ',');)
+        {
+            fields.push_back(field);
+        }
+        NS_ABORT_MSG_IF(fields.size() < 3 || fields.size() > 5,
+                        "Wrong number of fields at line " << m_line << " of " << m_filename);
+
+        // Parse a number, aborting on trailing characters
+        auto parse = [this](const std::string& field, auto convert) {
+            char* end;
+            auto value = convert(field.c_str(), &end);
+            NS_ABORT_MSG_IF(end == field.c_str() || *end != '\0',
+                            "Invalid field '" << field << "' at line " << m_line << " of "
+                                              << m_filename);
+            return value;
+        };
+        auto integer = [](const char* s, char** end) { return std::strtoull(s, end, 0); };
+        record.time = Seconds(parse(fields[0], [](const char* s, char** end) {
+            return std::strtod(s, end);
+        }));
+        record.device = parse(fields[1], integer);
+        uint64_t size = parse(fields[2], integer);
+        NS_ABORT_MSG_IF(size > 255, "Payload too large at line " << m_line << " of " << m_filename);
+        record.size = size;
+        record.fPort = 0;
+        if (fields.size() > 3 && !fields[3].empty())
+        {
+            uint64_t fPort = parse(fields[3], integer);
+            NS_ABORT_MSG_IF(fPort < 1 || fPort > 223,
+                            "Invalid frame port " << fPort << " (1 to 223) at line " << m_line
+                                                  << " of " << m_filename);
+            record.fPort = fPort;
+        }
+        record.payload.clear();
+        if (fields.size() > 4)
+        {
+            const std::string& hex = fields[4];
+            NS_ABORT_MSG_IF(hex.size() != 2 * size,
+                            "Payload of the wrong size at line " << m_line << " of " << m_filename);
+            for (std::size_t i = 0; i < hex.size(); i += 2)
+            {
+                record.payload.push_back(parse(hex.substr(i, 2), [](const char* s, char** end) {
+                    return std::strtoul(s, end, 16);
+                }));
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+bool
+TrafficTrace::ReadBinary(Record& record)
+{
+    uint8_t data[TRACE_RECORD_SIZE];
+    m_file.read(reinterpret_cast<char*>(data), TRACE_RECORD_SIZE);
+    if (m_file.gcount() == 0)
+    {
+        return false;
+    }
+    NS_ABORT_MSG_IF(!m_file, "Truncated traffic trace " << m_filename);
+
+    record.time = NanoSeconds(int64_t(ReadLe(data, 8)));
+    record.device = ReadLe(data + 8, 4);
+    record.size = data[12];
+    record.fPort = data[13];
+    NS_ABORT_MSG_IF(record.fPort > 223,
+                    "Invalid frame port " << unsigned(record.fPort) << " in traffic trace "
+                                          << m_filename);
+    record.payload.resize(ReadLe(data + 14, 2));
+    m_file.read(reinterpret_cast<char*>(record.payload.data()), record.payload.size());
+    NS_ABORT_MSG_IF(!m_file, "Truncated traffic trace " << m_filename);
+    NS_ABORT_MSG_IF(!record.payload.empty() && record.payload.size() != record.size,
+                    "Payload of the wrong size in traffic trace " << m_filename);
+    return true;
+}
+
+void
+TrafficTrace::ScheduleNext()
+{
+    NS_LOG_FUNCTION(this);
+
+    Time now = Simulator::Now();
+    while (true)
+    {
+        if (m_buffer.empty())
+        {
+            Record record;
+            while (m_buffer.size() < m_readAhead && Read(record))
+            {
+                m_buffer.push_back(record);
+            }
+            if (m_buffer.empty())
+            {
+                NS_LOG_INFO("End of traffic trace " << m_filename);
+                return;
+            }
+        }
+        if (m_buffer.front().time >= now)
+        {
+            break;
+        }
+        NS_LOG_DEBUG("Skipping record of device " << m_buffer.front().device << " at "
+                                                  << m_buffer.front().time.As(Time::S));
+        m_buffer.pop_front();
+    }
+    m_nextEvent = Simulator::Schedule(m_buffer.front().time - now, &TrafficTrace::Dispatch, this);
+}
+
+void
+TrafficTrace::Dispatch()
+{
+    NS_LOG_FUNCTION(this);
+
+    Record record = std::move(m_buffer.front());
+    m_buffer.pop_front();
+    if (auto it = m_senders.find(record.device); it != m_senders.end())
+    {
+        it->second(record);
+    }
+    else
+    {
+        NS_LOG_DEBUG("Skipping record of unregistered device " << record.device);
+    }
+    // Senders may have stopped the replay
+    if (!m_senders.empty())
+    {
+        ScheduleNext();
+    }
+}
+
+} // namespace lorawan
+} // namespace ns3
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2026 University of Bologna
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Alessandro Aimi <alessandro.aimi@unibo.it>
+ */
+
+#ifndef TRAFFIC_TRACE_H
+#define TRAFFIC_TRACE_H
+
+#include "ns3/callback.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+
+#include <deque>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+namespace lorawan
+{
+
+/**
+ * Uplink packets of devices replayed from a trace file.
+ *
+ * The file is streamed: records are parsed a block at a time into a bounded
+ * read-ahead buffer, and a single event is scheduled at the time of the next
+ * record, which is handed to the callback registered for its device. Records
+ * of devices without callback, or earlier than the time of the first
+ * registration, are skipped. Records must be sorted by time.
+ *
+ * CSV traces have one record per line,
+ *
+ *   time,device,size[,fport[,payload]]
+ *
+ * with the time in seconds, the device as a decimal or 0x-prefixed
+ * hexadecimal number, the application frame port from 1 to 223, and the
+ * payload as hexadecimal bytes. Packets without frame port are sent on the
+ * current port of the MAC. Empty lines and lines starting with '#' or a
+ * letter (headers) are ignored.
+ *
+ * Binary traces, which are faster to parse, start with a 16-byte header
+ * (magic "LORATRFC", version), followed by records of time (int64, ns),
+ * device (uint32), size (uint8), frame port (uint8, 0 if absent), payload
+ * length (uint16) and payload, in little-endian order. Convert CSV traces
+ * with the Convert function.
+ */
+class TrafficTrace : public Object
+{
+  public:
+    /**
+     * Identifier of devices in the trace.
+     */
+    enum DeviceKey
+    {
+        NODE_INDEX, //!< Index of installation by the TraceSenderHelper
+        DEV_ADDR,   //!< Network address of the device
+    };
+
+    /**
+     * An uplink packet of the trace.
+     */
+    struct Record
+    {
+        Time time;                    //!< Time of the packet
+        uint32_t device = 0;          //!< Device sending the packet
+        uint8_t size = 0;             //!< Size of the application payload (bytes)
+        uint8_t fPort = 0;            //!< Frame port, 0 if absent
+        std::vector<uint8_t> payload; //!< Application payload, empty if absent
+    };
+
+    /**
+     * Callback handing a record to its device.
+     */
+    typedef Callback<void, const Record&> SendCallback;
+
+    static TypeId GetTypeId();
+
+    TrafficTrace();
+    ~TrafficTrace() override;
+
+    /**
+     * Get how devices are identified in the trace.
+     *
+     * \return The device key.
+     */
+    DeviceKey GetDeviceKey() const;
+
+    /**
+     * Hand the records of a device to a callback, opening the trace and
+     * scheduling its next record at the first registration.
+     *
+     * \param device The device in the trace.
+     * \param callback The callback.
+     */
+    void Register(uint32_t device, SendCallback callback);
+
+    /**
+     * Stop handing the records of a device, stopping the replay when no
+     * device is left.
+     *
+     * \param device The device in the trace.
+     */
+    void Unregister(uint32_t device);
+
+    /**
+     * Convert a CSV trace to a binary one.
+     *
+     * \param csv The name of the CSV trace.
+     * \param binary The name of the binary trace, overwritten if existing.
+     * \return The number of records.
+     */
+    static uint64_t Convert(const std::string& csv, const std::string& binary);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /**
+     * Open the trace and detect its format.
+     */
+    void Open();
+
+    /**
+     * Read the next record from the file.
+     *
+     * \param record The record to fill.
+     * \return Whether a record was read, i.e., the end of the trace was not reached.
+     */
+    bool Read(Record& record);
+
+    /**
+     * Read the next line of a CSV trace.
+     *
+     * \param record The record to fill.
+     * \return Whether a record was read.
+     */
+    bool ReadCsv(Record& record);
+
+    /**
+     * Read the next record of a binary trace.
+     *
+     * \param record The record to fill.
+     * \return Whether a record was read.
+     */
+    bool ReadBinary(Record& record);
+
+    /**
+     * Schedule the next record not in the past, refilling the buffer if needed.
+     */
+    void ScheduleNext();
+
+    /**
+     * Hand the next record to its device and schedule the following one.
+     */
+    void Dispatch();
+
+    std::string m_filename; //!< Name of the trace
+    DeviceKey m_deviceKey;  //!< How devices are identified
+    Time m_offset;          //!< Time subtracted from the times of records
+    uint32_t m_readAhead;   //!< Maximum number of records in the buffer
+
+    std::ifstream m_file;           //!< The trace file
+    std::vector<char> m_fileBuffer; //!< Buffer of the file stream
+    bool m_binary;                  //!< Whether the trace is binary
+    uint64_t m_line;                //!< Current line of a CSV trace
+    Time m_lastTime;                //!< Time of the last record read
+
+    std::deque<Record> m_buffer;                          //!< Records read ahead
+    std::unordered_map<uint32_t, SendCallback> m_senders; //!< Callback of each device
+    EventId m_nextEvent;                                  //!< Dispatch of the next record
+};
+
+} // namespace lorawan
+} // namespace ns3
+
+#endif /* TRAFFIC_TRACE_H */
@@ -105,10 +105,8 @@ bool
 UdpForwarder::ReceiveFromLora(Ptr<LorawanMac> mac, Ptr<const Packet> packet)
 {
     NS_LOG_FUNCTION(this << packet);
-    Ptr<Packet> pktcpy = packet->Copy();
-
     LoraTag tag;
-    pktcpy->RemovePacketTag(tag);
+    packet->PeekPacketTag(tag);
 
     /* The following timestamp is used as reference by the server to schedule downlinks for
      * reception windows openings. In the simulation we have 0 processing delay, the packet arrives
@@ -154,8 +152,8 @@ UdpForwarder::ReceiveFromLora(Ptr<LorawanMac> mac, Ptr<const Packet> packet)
     p.snr_min = tag.GetSnr();
     p.snr_max = tag.GetSnr();
     p.crc = 0; //!> TODO: ?
-    p.size = pktcpy->GetSize();
-    pktcpy->CopyData(p.payload, 256);
+    p.size = packet->GetSize();
+    packet->CopyData(p.payload, 256);
 
     m_rxPktBuff.push(p);
     return true;
@@ -477,231 +475,15 @@ UdpForwarder::ThreadUp()
         meas_up_pkt_fwd += 1;
         meas_up_payload_byte += p->size;
 
-        /* Start of packet, add inter-packet separator if necessary */
-        if (pkt_in_dgram == 0)
-        {
-            buff_up[buff_index] = '{';
-            ++buff_index;
-        }
-        else
+        /* Add inter-packet separator if necessary */
+        if (pkt_in_dgram > 0)
         {
             buff_up[buff_index] = ',';
-            buff_up[buff_index + 1] = '{';
-            buff_index += 2;
-        }
-
-        /* RAW timestamp, 8-17 useful chars */
-        j = snprintf((char*)(buff_up + buff_index),
-                     TX_BUFF_SIZE - buff_index,
-                     "\"tmst\":%u",
-                     p->count_us);
-        if (j > 0)
-        {
-            buff_index += j;
-        }
-        else
-        {
-            NS_FATAL_ERROR("[up] snprintf failed line " << (unsigned)(__LINE__ - 4));
-        }
-
-        /* Packet concentrator channel, RF chain & RX frequency, 34-36 useful chars */
-        j = snprintf((char*)(buff_up + buff_index),
-                     TX_BUFF_SIZE - buff_index,
-                     ",\"chan\":%1u,\"rfch\":%1u,\"freq\":%.6lf",
-                     p->if_chain,
-                     p->rf_chain,
-                     ((double)p->freq_hz / 1e6));
-        if (j > 0)
-        {
-            buff_index += j;
-        }
-        else
-        {
-            NS_FATAL_ERROR("[up] snprintf failed line " << (unsigned)(__LINE__ - 4));
-        }
-
-        /* Packet status, 9-10 useful chars */
-        switch (p->status)
-        {
-        case STAT_CRC_OK:
-            memcpy((void*)(buff_up + buff_index), (void*)",\"stat\":1", 9);
-            buff_index += 9;
-            break;
-        case STAT_CRC_BAD:
-            memcpy((void*)(buff_up + buff_index), (void*)",\"stat\":-1", 10);
-            buff_index += 10;
-            break;
-        case STAT_NO_CRC:
-            memcpy((void*)(buff_up + buff_index), (void*)",\"stat\":0", 9);
-            buff_index += 9;
-            break;
-        default:
-            memcpy((void*)(buff_up + buff_index), (void*)",\"stat\":?", 9);
-            buff_index += 9;
-            NS_FATAL_ERROR("[up] received packet with unknown status");
-        }
-
-        /* Packet modulation, 13-14 useful chars */
-        if (p->modulation == MOD_LORA)
-        {
-            memcpy((void*)(buff_up + buff_index), (void*)",\"modu\":\"LORA\"", 14);
-            buff_index += 14;
-
-            /* Lora datarate & bandwidth, 16-19 useful chars */
-            switch (p->datarate)
-            {
-            case DR_LORA_SF7:
-                memcpy((void*)(buff_up + buff_index), (void*)",\"datr\":\"SF7", 12);
-                buff_index += 12;
-                break;
-            case DR_LORA_SF8:
-                memcpy((void*)(buff_up + buff_index), (void*)",\"datr\":\"SF8", 12);
-                buff_index += 12;
-                break;
-            case DR_LORA_SF9:
-                memcpy((void*)(buff_up + buff_index), (void*)",\"datr\":\"SF9", 12);
-                buff_index += 12;
-                break;
-            case DR_LORA_SF10:
-                memcpy((void*)(buff_up + buff_index), (void*)",\"datr\":\"SF10", 13);
-                buff_index += 13;
-                break;
-            case DR_LORA_SF11:
-                memcpy((void*)(buff_up + buff_index), (void*)",\"datr\":\"SF11", 13);
-                buff_index += 13;
-                break;
-            case DR_LORA_SF12:
-                memcpy((void*)(buff_up + buff_index), (void*)",\"datr\":\"SF12", 13);
-                buff_index += 13;
-                break;
-            default:
-                memcpy((void*)(buff_up + buff_index), (void*)",\"datr\":\"SF?", 12);
-                buff_index += 12;
-                NS_FATAL_ERROR("[up] lora packet with unknown datarate");
-            }
-            switch (p->bandwidth)
-            {
-            case BW_125KHZ:
-                memcpy((void*)(buff_up + buff_index), (void*)"BW125\"", 6);
-                buff_index += 6;
-                break;
-            case BW_250KHZ:
-                memcpy((void*)(buff_up + buff_index), (void*)"BW250\"", 6);
-                buff_index += 6;
-                break;
-            case BW_500KHZ:
-                memcpy((void*)(buff_up + buff_index), (void*)"BW500\"", 6);
-                buff_index += 6;
-                break;
-            default:
-                memcpy((void*)(buff_up + buff_index), (void*)"BW?\"", 4);
-                buff_index += 4;
-                NS_FATAL_ERROR("[up] lora packet with unknown bandwidth");
-            }
-
-            /* Packet ECC coding rate, 11-13 useful chars */
-            switch (p->coderate)
-            {
-            case CR_LORA_4_5:
-                memcpy((void*)(buff_up + buff_index), (void*)",\"codr\":\"4/5\"", 13);
-                buff_index += 13;
-                break;
-            case CR_LORA_4_6:
-                memcpy((void*)(buff_up + buff_index), (void*)",\"codr\":\"4/6\"", 13);
-                buff_index += 13;
-                break;
-            case CR_LORA_4_7:
-                memcpy((void*)(buff_up + buff_index), (void*)",\"codr\":\"4/7\"", 13);
-                buff_index += 13;
-                break;
-            case CR_LORA_4_8:
-                memcpy((void*)(buff_up + buff_index), (void*)",\"codr\":\"4/8\"", 13);
-                buff_index += 13;
-                break;
-            case 0: /* treat the CR0 case (mostly false sync) */
-                memcpy((void*)(buff_up + buff_index), (void*)",\"codr\":\"OFF\"", 13);
-                buff_index += 13;
-                break;
-            default:
-                memcpy((void*)(buff_up + buff_index), (void*)",\"codr\":\"?\"", 11);
-                buff_index += 11;
-                NS_FATAL_ERROR("[up] lora packet with unknown coderate");
-            }
-
-            /* Lora SNR, 11-13 useful chars */
-            j = snprintf((char*)(buff_up + buff_index),
-                         TX_BUFF_SIZE - buff_index,
-                         ",\"lsnr\":%.1f",
-                         p->snr);
-            if (j > 0)
-            {
-                buff_index += j;
-            }
-            else
-            {
-                NS_FATAL_ERROR("[up] snprintf failed line " << (unsigned)(__LINE__ - 4));
-            }
-        }
-        else if (p->modulation == MOD_FSK)
-        {
-            memcpy((void*)(buff_up + buff_index), (void*)",\"modu\":\"FSK\"", 13);
-            buff_index += 13;
-
-            /* FSK datarate, 11-14 useful chars */
-            j = snprintf((char*)(buff_up + buff_index),
-                         TX_BUFF_SIZE - buff_index,
-                         ",\"datr\":%u",
-                         p->datarate);
-            if (j > 0)
-            {
-                buff_index += j;
-            }
-            else
-            {
-                NS_FATAL_ERROR("[up] snprintf failed line " << (unsigned)(__LINE__ - 4));
-            }
-        }
-        else
-        {
-            NS_FATAL_ERROR("[up] received packet with unknown modulation");
-        }
-
-        /* Packet RSSI, payload size, 18-23 useful chars */
-        j = snprintf((char*)(buff_up + buff_index),
-                     TX_BUFF_SIZE - buff_index,
-                     ",\"rssi\":%.0f,\"size\":%u",
-                     p->rssi,
-                     p->size);
-        if (j > 0)
-        {
-            buff_index += j;
-        }
-        else
-        {
-            NS_FATAL_ERROR("[up] snprintf failed line " << (unsigned)(__LINE__ - 4));
-        }
-
-        /* Packet base64-encoded payload, 14-350 useful chars */
-        memcpy((void*)(buff_up + buff_index), (void*)",\"data\":\"", 9);
-        buff_index += 9;
-        j = bin_to_b64(p->payload,
-                       p->size,
-                       (char*)(buff_up + buff_index),
-                       341); /* 255 bytes = 340 chars in b64 + null char */
-        if (j >= 0)
-        {
-            buff_index += j;
-        }
-        else
-        {
-            NS_FATAL_ERROR("[up] bin_to_b64 failed line " << (unsigned)(__LINE__ - 5));
+            ++buff_index;
         }
-        buff_up[buff_index] = '"';
-        ++buff_index;
 
-        /* End of packet serialization */
-        buff_up[buff_index] = '}';
-        ++buff_index;
+        /* Packet metadata and payload */
+        buff_index += SerializeRxpk(*p, (char*)(buff_up + buff_index), TX_BUFF_SIZE - buff_index);
         ++pkt_in_dgram;
     }
 
@@ -822,6 +604,215 @@ UdpForwarder::ReceiveAck(Ptr<Socket> sockUp)
 }
 
 /* The following function sends a PULL request to the server */
+int
+UdpForwarder::SerializeRxpk(const lgw_pkt_rx_s& p, char* buff, int size)
+{
+    int j;     /* return value of formatting functions */
+    int n = 0; /* number of written chars */
+
+    /* Start of packet */
+    buff[n] = '{';
+    ++n;
+
+    /* RAW timestamp, 8-17 useful chars */
+    j = snprintf(buff + n, size - n, "\"tmst\":%u", p.count_us);
+    if (j > 0)
+    {
+        n += j;
+    }
+    else
+    {
+        NS_FATAL_ERROR("[up] snprintf failed line " << (unsigned)(__LINE__ - 4));
+    }
+
+    /* Packet concentrator channel, RF chain & RX frequency, 34-36 useful chars */
+    j = snprintf(buff + n,
+                 size - n,
+                 ",\"chan\":%1u,\"rfch\":%1u,\"freq\":%.6lf",
+                 p.if_chain,
+                 p.rf_chain,
+                 ((double)p.freq_hz / 1e6));
+    if (j > 0)
+    {
+        n += j;
+    }
+    else
+    {
+        NS_FATAL_ERROR("[up] snprintf failed line " << (unsigned)(__LINE__ - 4));
+    }
+
+    /* Packet status, 9-10 useful chars */
+    switch (p.status)
+    {
+    case STAT_CRC_OK:
+        memcpy(buff + n, (void*)",\"stat\":1", 9);
+        n += 9;
+        break;
+    case STAT_CRC_BAD:
+        memcpy(buff + n, (void*)",\"stat\":-1", 10);
+        n += 10;
+        break;
+    case STAT_NO_CRC:
+        memcpy(buff + n, (void*)",\"stat\":0", 9);
+        n += 9;
+        break;
+    default:
+        memcpy(buff + n, (void*)",\"stat\":?", 9);
+        n += 9;
+        NS_FATAL_ERROR("[up] received packet with unknown status");
+    }
+
+    /* Packet modulation, 13-14 useful chars */
+    if (p.modulation == MOD_LORA)
+    {
+        memcpy(buff + n, (void*)",\"modu\":\"LORA\"", 14);
+        n += 14;
+
+        /* Lora datarate & bandwidth, 16-19 useful chars */
+        switch (p.datarate)
+        {
+        case DR_LORA_SF7:
+            memcpy(buff + n, (void*)",\"datr\":\"SF7", 12);
+            n += 12;
+            break;
+        case DR_LORA_SF8:
+            memcpy(buff + n, (void*)",\"datr\":\"SF8", 12);
+            n += 12;
+            break;
+        case DR_LORA_SF9:
+            memcpy(buff + n, (void*)",\"datr\":\"SF9", 12);
+            n += 12;
+            break;
+        case DR_LORA_SF10:
+            memcpy(buff + n, (void*)",\"datr\":\"SF10", 13);
+            n += 13;
+            break;
+        case DR_LORA_SF11:
+            memcpy(buff + n, (void*)",\"datr\":\"SF11", 13);
+            n += 13;
+            break;
+        case DR_LORA_SF12:
+            memcpy(buff + n, (void*)",\"datr\":\"SF12", 13);
+            n += 13;
+            break;
+        default:
+            memcpy(buff + n, (void*)",\"datr\":\"SF?", 12);
+            n += 12;
+            NS_FATAL_ERROR("[up] lora packet with unknown datarate");
+        }
+        switch (p.bandwidth)
+        {
+        case BW_125KHZ:
+            memcpy(buff + n, (void*)"BW125\"", 6);
+            n += 6;
+            break;
+        case BW_250KHZ:
+            memcpy(buff + n, (void*)"BW250\"", 6);
+            n += 6;
+            break;
+        case BW_500KHZ:
+            memcpy(buff + n, (void*)"BW500\"", 6);
+            n += 6;
+            break;
+        default:
+            memcpy(buff + n, (void*)"BW?\"", 4);
+            n += 4;
+            NS_FATAL_ERROR("[up] lora packet with unknown bandwidth");
+        }
+
+        /* Packet ECC coding rate, 11-13 useful chars */
+        switch (p.coderate)
+        {
+        case CR_LORA_4_5:
+            memcpy(buff + n, (void*)",\"codr\":\"4/5\"", 13);
+            n += 13;
+            break;
+        case CR_LORA_4_6:
+            memcpy(buff + n, (void*)",\"codr\":\"4/6\"", 13);
+            n += 13;
+            break;
+        case CR_LORA_4_7:
+            memcpy(buff + n, (void*)",\"codr\":\"4/7\"", 13);
+            n += 13;
+            break;
+        case CR_LORA_4_8:
+            memcpy(buff + n, (void*)",\"codr\":\"4/8\"", 13);
+            n += 13;
+            break;
+        case 0: /* treat the CR0 case (mostly false sync) */
+            memcpy(buff + n, (void*)",\"codr\":\"OFF\"", 13);
+            n += 13;
+            break;
+        default:
+            memcpy(buff + n, (void*)",\"codr\":\"?\"", 11);
+            n += 11;
+            NS_FATAL_ERROR("[up] lora packet with unknown coderate");
+        }
+
+        /* Lora SNR, 11-13 useful chars */
+        j = snprintf(buff + n, size - n, ",\"lsnr\":%.1f", p.snr);
+        if (j > 0)
+        {
+            n += j;
+        }
+        else
+        {
+            NS_FATAL_ERROR("[up] snprintf failed line " << (unsigned)(__LINE__ - 4));
+        }
+    }
+    else if (p.modulation == MOD_FSK)
+    {
+        memcpy(buff + n, (void*)",\"modu\":\"FSK\"", 13);
+        n += 13;
+
+        /* FSK datarate, 11-14 useful chars */
+        j = snprintf(buff + n, size - n, ",\"datr\":%u", p.datarate);
+        if (j > 0)
+        {
+            n += j;
+        }
+        else
+        {
+            NS_FATAL_ERROR("[up] snprintf failed line " << (unsigned)(__LINE__ - 4));
+        }
+    }
+    else
+    {
+        NS_FATAL_ERROR("[up] received packet with unknown modulation");
+    }
+
+    /* Packet RSSI, payload size, 18-23 useful chars */
+    j = snprintf(buff + n, size - n, ",\"rssi\":%.0f,\"size\":%u", p.rssi, p.size);
+    if (j > 0)
+    {
+        n += j;
+    }
+    else
+    {
+        NS_FATAL_ERROR("[up] snprintf failed line " << (unsigned)(__LINE__ - 4));
+    }
+
+    /* Packet base64-encoded payload, 14-350 useful chars */
+    memcpy(buff + n, (void*)",\"data\":\"", 9);
+    n += 9;
+    j = bin_to_b64(p.payload, p.size, buff + n, 341); /* 255 bytes = 340 chars in b64 + null */
+    if (j >= 0)
+    {
+        n += j;
+    }
+    else
+    {
+        NS_FATAL_ERROR("[up] bin_to_b64 failed line " << (unsigned)(__LINE__ - 5));
+    }
+    buff[n] = '"';
+    ++n;
+
+    /* End of packet serialization */
+    buff[n] = '}';
+    ++n;
+    return n;
+}
+
 void
 UdpForwarder::ThreadDown()
 {
@@ -915,12 +906,7 @@ UdpForwarder::ReceiveDatagram(Ptr<Socket> sockDown)
     int msg_len;
 
     /* JSON parsing variables */
-    JSON_Value* root_val = nullptr;
-    JSON_Object* txpk_obj = nullptr;
-    JSON_Value* val = nullptr; /* needed to detect the absence of some fields */
-    const char* str;           /* pointer to sub-strings in the JSON data */
-    short x0;
-    short x1;
+    enum jit_error_e parse_error;
 
     /* Just In Time downlink */
     struct timeval current_unix_time;
@@ -981,13 +967,104 @@ UdpForwarder::ReceiveDatagram(Ptr<Socket> sockDown)
                                                       << "] :)"); /* very verbose */
     NS_LOG_DEBUG("JSON down: " << (char*)(buff_down + 4));        /* DEBUG: display JSON payload */
 
+    /* initialize TX struct and try to parse JSON */
+    if (!ParseTxpk((const char*)(buff_down + 4), antenna_gain, txpkt, parse_error))
+    {
+        if (parse_error != JIT_ERROR_OK)
+        {
+            /* send acknoledge datagram to server */
+            send_tx_ack(buff_down[1], buff_down[2], parse_error);
+        }
+        return CheckPullCondition();
+    }
+
+    /* Concentrator timestamp is given, we consider it is a Class A downlink */
+    downlink_type = JIT_PKT_TYPE_DOWNLINK_CLASS_A;
+
+    /* select TX mode */
+    txpkt.tx_mode = TIMESTAMPED;
+
+    /* record measurement data */
+    meas_dw_dgram_rcv += 1;          /* count only datagrams with no JSON errors */
+    meas_dw_network_byte += msg_len; /* meas_dw_network_byte */
+    meas_dw_payload_byte += txpkt.size;
+
+    /* check TX parameter before trying to queue packet */
+    jit_result = JIT_ERROR_OK;
+    if ((txpkt.freq_hz < tx_freq_min[txpkt.rf_chain]) ||
+        (txpkt.freq_hz > tx_freq_max[txpkt.rf_chain]))
+    {
+        jit_result = JIT_ERROR_TX_FREQ;
+        NS_LOG_ERROR("Packet REJECTED, unsupported frequency - "
+                     << (unsigned)txpkt.freq_hz << " (min:" << (unsigned)tx_freq_min[txpkt.rf_chain]
+                     << ",max:" << (unsigned)tx_freq_max[txpkt.rf_chain] << ")");
+    }
+    if (jit_result == JIT_ERROR_OK)
+    {
+        for (i = 0; i < txlut.size; i++)
+        {
+            if (txlut.lut[i].rf_power == txpkt.rf_power)
+            {
+                /* this RF power is supported, we can continue */
+                break;
+            }
+        }
+        if (i == txlut.size)
+        {
+            /* this RF power is not supported */
+            jit_result = JIT_ERROR_TX_POWER;
+            NS_LOG_ERROR("Packet REJECTED, unsupported RF power for TX - "
+                         << (unsigned)txpkt.rf_power);
+        }
+    }
+
+    /* insert packet to be sent into JIT queue */
+    if (jit_result == JIT_ERROR_OK)
+    {
+        uint32_t time_us = GetRawConcentratorTimestamp();
+        NS_LOG_DEBUG("current_concentrator_time=" << time_us << ", count_us=" << txpkt.count_us
+                                                  << ", time_diff=" << txpkt.count_us - time_us);
+        GetTimeOfDay(&current_unix_time);
+        get_concentrator_time(&current_concentrator_time, current_unix_time);
+        jit_result = jit_enqueue(&jit_queue, &current_concentrator_time, &txpkt, downlink_type);
+        if (jit_result != JIT_ERROR_OK)
+        {
+            NS_LOG_ERROR("Packet REJECTED (jit error=" << jit_result << ")");
+        }
+        meas_nb_tx_requested += 1;
+    }
+
+    /* Send acknoledge datagram to server */
+    send_tx_ack(buff_down[1], buff_down[2], jit_result);
+
+    CheckPullCondition();
+}
+
+bool
+UdpForwarder::ParseTxpk(const char* json,
+                        int8_t antennaGain,
+                        lgw_pkt_tx_s& txpkt,
+                        enum jit_error_e& error)
+{
+    int i; /* loop variables */
+
+    /* JSON parsing variables */
+    JSON_Value* root_val = nullptr;
+    JSON_Object* txpk_obj = nullptr;
+    JSON_Value* val = nullptr; /* needed to detect the absence of some fields */
+    const char* str;           /* pointer to sub-strings in the JSON data */
+    short x0;
+    short x1;
+
+    error = JIT_ERROR_OK;
+
     /* initialize TX struct and try to parse JSON */
     memset(&txpkt, 0, sizeof txpkt);
-    root_val = json_parse_string_with_comments((const char*)(buff_down + 4)); /* JSON offset */
+    root_val = json_parse_string_with_comments(json);
     if (root_val == nullptr)
     {
         NS_LOG_WARN("[down] invalid JSON, TX aborted");
-        return CheckPullCondition();
+        return false;
     }
 
     /* look for JSON sub-object 'txpk' */
@@ -996,7 +1073,7 @@ UdpForwarder::ReceiveDatagram(Ptr<Socket> sockDown)
     {
         NS_LOG_WARN("[down] no \"txpk\" object in JSON, TX aborted");
         json_value_free(root_val);
-        return CheckPullCondition();
+        return false;
     }
 
     /* Parse "immediate" tag, or target timestamp, or UTC time to be converted by GPS (mandatory) */
@@ -1009,9 +1086,9 @@ UdpForwarder::ReceiveDatagram(Ptr<Socket> sockDown)
         NS_LOG_WARN("[down] class C not supported, TX aborted");
         json_value_free(root_val);
 
-        /* send acknoledge datagram to server */
-        send_tx_ack(buff_down[1], buff_down[2], JIT_ERROR_INVALID);
-        return CheckPullCondition();
+        /* acknowledge the error to the server */
+        error = JIT_ERROR_INVALID;
+        return false;
     }
     else
     {
@@ -1020,9 +1097,6 @@ UdpForwarder::ReceiveDatagram(Ptr<Socket> sockDown)
         {
             /* TX procedure: send on timestamp value */
             txpkt.count_us = (uint32_t)json_value_get_number(val);
-
-            /* Concentrator timestamp is given, we consider it is a Class A downlink */
-            downlink_type = JIT_PKT_TYPE_DOWNLINK_CLASS_A;
         }
         else
         {
@@ -1033,7 +1107,7 @@ UdpForwarder::ReceiveDatagram(Ptr<Socket> sockDown)
                 NS_LOG_WARN("[down] no mandatory \"txpk.tmst\" or \"txpk.tmms\" objects in "
                             "JSON, TX aborted");
                 json_value_free(root_val);
-                return CheckPullCondition();
+                return false;
             }
             else
             {
@@ -1041,9 +1115,9 @@ UdpForwarder::ReceiveDatagram(Ptr<Socket> sockDown)
                             "time, TX aborted");
                 json_value_free(root_val);
 
-                /* send acknoledge datagram to server */
-                send_tx_ack(buff_down[1], buff_down[2], JIT_ERROR_GPS_UNLOCKED);
-                return CheckPullCondition();
+                /* acknowledge the error to the server */
+                error = JIT_ERROR_GPS_UNLOCKED;
+                return false;
             }
         }
     }
@@ -1061,7 +1135,7 @@ UdpForwarder::ReceiveDatagram(Ptr<Socket> sockDown)
     {
         NS_LOG_WARN("[down] no mandatory \"txpk.freq\" object in JSON, TX aborted");
         json_value_free(root_val);
-        return CheckPullCondition();
+        return false;
     }
     txpkt.freq_hz = (uint32_t)((double)(1.0e6) * json_value_get_number(val));
 
@@ -1071,7 +1145,7 @@ UdpForwarder::ReceiveDatagram(Ptr<Socket> sockDown)
     {
         NS_LOG_WARN("[down] no mandatory \"txpk.rfch\" object in JSON, TX aborted");
         json_value_free(root_val);
-        return CheckPullCondition();
+        return false;
     }
     txpkt.rf_chain = (uint8_t)json_value_get_number(val);
 
@@ -1079,7 +1153,7 @@ UdpForwarder::ReceiveDatagram(Ptr<Socket> sockDown)
     val = json_object_get_value(txpk_obj, "powe");
     if (val != nullptr)
     {
-        txpkt.rf_power = (int8_t)json_value_get_number(val) - antenna_gain;
+        txpkt.rf_power = (int8_t)json_value_get_number(val) - antennaGain;
     }
 
     /* Parse modulation (mandatory) */
@@ -1088,7 +1162,7 @@ UdpForwarder::ReceiveDatagram(Ptr<Socket> sockDown)
     {
         NS_LOG_WARN("[down] no mandatory \"txpk.modu\" object in JSON, TX aborted");
         json_value_free(root_val);
-        return CheckPullCondition();
+        return false;
     }
     if (strcmp(str, "LORA") == 0)
     {
@@ -1101,14 +1175,14 @@ UdpForwarder::ReceiveDatagram(Ptr<Socket> sockDown)
         {
             NS_LOG_WARN("[down] no mandatory \"txpk.datr\" object in JSON, TX aborted");
             json_value_free(root_val);
-            return CheckPullCondition();
+            return false;
         }
         i = sscanf(str, "SF%2hdBW%3hd", &x0, &x1);
         if (i != 2)
         {
             NS_LOG_WARN("[down] format error in \"txpk.datr\", TX aborted");
             json_value_free(root_val);
-            return CheckPullCondition();
+            return false;
         }
         switch (x0)
         {
@@ -1133,7 +1207,7 @@ UdpForwarder::ReceiveDatagram(Ptr<Socket> sockDown)
         default:
             NS_LOG_WARN("[down] format error in \"txpk.datr\", invalid SF, TX aborted");
             json_value_free(root_val);
-            return CheckPullCondition();
+            return false;
         }
         switch (x1)
         {
@@ -1149,7 +1223,7 @@ UdpForwarder::ReceiveDatagram(Ptr<Socket> sockDown)
         default:
             NS_LOG_WARN("[down] format error in \"txpk.datr\", invalid BW, TX aborted");
             json_value_free(root_val);
-            return CheckPullCondition();
+            return false;
         }
 
         /* Parse ECC coding rate (optional field) */
@@ -1158,7 +1232,7 @@ UdpForwarder::ReceiveDatagram(Ptr<Socket> sockDown)
         {
             NS_LOG_WARN("[down] no mandatory \"txpk.codr\" object in json, TX aborted");
             json_value_free(root_val);
-            return CheckPullCondition();
+            return false;
         }
         if (strcmp(str, "4/5") == 0)
         {
@@ -1180,7 +1254,7 @@ UdpForwarder::ReceiveDatagram(Ptr<Socket> sockDown)
         {
             NS_LOG_WARN("[down] format error in \"txpk.codr\", TX aborted");
             json_value_free(root_val);
-            return CheckPullCondition();
+            return false;
         }
 
         /* Parse signal polarity switch (optional field) */
@@ -1215,15 +1289,15 @@ UdpForwarder::ReceiveDatagram(Ptr<Socket> sockDown)
         NS_LOG_WARN("[down] FSK modulation not supported, TX aborted");
         json_value_free(root_val);
 
-        /* send acknoledge datagram to server */
-        send_tx_ack(buff_down[1], buff_down[2], JIT_ERROR_INVALID);
-        return CheckPullCondition();
+        /* acknowledge the error to the server */
+        error = JIT_ERROR_INVALID;
+        return false;
     }
     else
     {
         NS_LOG_WARN("[down] invalid modulation in \"txpk.modu\", TX aborted");
         json_value_free(root_val);
-        return CheckPullCondition();
+        return false;
     }
 
     /* Parse payload length (mandatory) */
@@ -1232,7 +1306,7 @@ UdpForwarder::ReceiveDatagram(Ptr<Socket> sockDown)
     {
         NS_LOG_WARN("[down] no mandatory \"txpk.size\" object in JSON, TX aborted");
         json_value_free(root_val);
-        return CheckPullCondition();
+        return false;
     }
     txpkt.size = (uint16_t)json_value_get_number(val);
 
@@ -1242,7 +1316,7 @@ UdpForwarder::ReceiveDatagram(Ptr<Socket> sockDown)
     {
         NS_LOG_WARN("[down] no mandatory \"txpk.data\" object in JSON, TX aborted");
         json_value_free(root_val);
-        return CheckPullCondition();
+        return false;
     }
     i = b64_to_bin(str, strlen(str), txpkt.payload, sizeof txpkt.payload);
     if (i != txpkt.size)
@@ -1252,64 +1326,7 @@ UdpForwarder::ReceiveDatagram(Ptr<Socket> sockDown)
 
     /* free the JSON parse tree from memory */
     json_value_free(root_val);
-
-    /* select TX mode */
-    txpkt.tx_mode = TIMESTAMPED;
-
-    /* record measurement data */
-    meas_dw_dgram_rcv += 1;          /* count only datagrams with no JSON errors */
-    meas_dw_network_byte += msg_len; /* meas_dw_network_byte */
-    meas_dw_payload_byte += txpkt.size;
-
-    /* check TX parameter before trying to queue packet */
-    jit_result = JIT_ERROR_OK;
-    if ((txpkt.freq_hz < tx_freq_min[txpkt.rf_chain]) ||
-        (txpkt.freq_hz > tx_freq_max[txpkt.rf_chain]))
-    {
-        jit_result = JIT_ERROR_TX_FREQ;
-        NS_LOG_ERROR("Packet REJECTED, unsupported frequency - "
-                     << (unsigned)txpkt.freq_hz << " (min:" << (unsigned)tx_freq_min[txpkt.rf_chain]
-                     << ",max:" << (unsigned)tx_freq_max[txpkt.rf_chain] << ")");
-    }
-    if (jit_result == JIT_ERROR_OK)
-    {
-        for (i = 0; i < txlut.size; i++)
-        {
-            if (txlut.lut[i].rf_power == txpkt.rf_power)
-            {
-                /* this RF power is supported, we can continue */
-                break;
-            }
-        }
-        if (i == txlut.size)
-        {
-            /* this RF power is not supported */
-            jit_result = JIT_ERROR_TX_POWER;
-            NS_LOG_ERROR("Packet REJECTED, unsupported RF power for TX - "
-                         << (unsigned)txpkt.rf_power);
-        }
-    }
-
-    /* insert packet to be sent into JIT queue */
-    if (jit_result == JIT_ERROR_OK)
-    {
-        uint32_t time_us = GetRawConcentratorTimestamp();
-        NS_LOG_DEBUG("current_concentrator_time=" << time_us << ", count_us=" << txpkt.count_us
-                                                  << ", time_diff=" << txpkt.count_us - time_us);
-        GetTimeOfDay(&current_unix_time);
-        get_concentrator_time(&current_concentrator_time, current_unix_time);
-        jit_result = jit_enqueue(&jit_queue, &current_concentrator_time, &txpkt, downlink_type);
-        if (jit_result != JIT_ERROR_OK)
-        {
-            NS_LOG_ERROR("Packet REJECTED (jit error=" << jit_result << ")");
-        }
-        meas_nb_tx_requested += 1;
-    }
-
-    /* Send acknoledge datagram to server */
-    send_tx_ack(buff_down[1], buff_down[2], jit_result);
-
-    CheckPullCondition();
+    return true;
 }
 
 void
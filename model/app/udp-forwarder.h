@@ -129,6 +129,32 @@ class UdpForwarder : public Application
      */
     bool ReceiveFromLora(Ptr<LorawanMac> mac, Ptr<const Packet> packet);
 
+    /**
+     * Serialize a received packet as a JSON object of the rxpk array of
+     * PUSH_DATA datagrams.
+     *
+     * \param p The received packet and its metadata.
+     * \param buff The buffer of the datagram.
+     * \param size The size left in the buffer.
+     * \return The number of written chars.
+     */
+    static int SerializeRxpk(const lgw_pkt_rx_s& p, char* buff, int size);
+
+    /**
+     * Parse the JSON txpk object of PULL_RESP datagrams.
+     *
+     * \param json The JSON payload of the datagram, null-terminated.
+     * \param antennaGain The antenna gain subtracted from the requested TX power (dBi).
+     * \param txpkt The packet to transmit, filled on success.
+     * \param error The error to acknowledge to the server on failure, or JIT_ERROR_OK if
+     * the failure is not acknowledged.
+     * \return Whether the packet can be transmitted.
+     */
+    static bool ParseTxpk(const char* json,
+                          int8_t antennaGain,
+                          lgw_pkt_tx_s& txpkt,
+                          enum jit_error_e& error);
+
   protected:
     void DoDispose() override;
 
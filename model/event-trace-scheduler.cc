@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2026 University of Bologna
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Alessandro Aimi <alessandro.aimi@unibo.it>
+ */
+
+#include "event-trace-scheduler.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/object-factory.h"
+#include "ns3/string.h"
+
+#include <cstring>
+
+namespace ns3
+{
+namespace lorawan
+{
+
+NS_LOG_COMPONENT_DEFINE("EventTraceScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED(EventTraceScheduler);
+
+static const char TRACE_MAGIC[8] = {'L', 'O', 'R', 'A', 'E', 'V', 'T', 'S'};
+static const uint32_t TRACE_VERSION = 1;
+static const std::size_t TRACE_HEADER_SIZE = 16;
+static const std::size_t TRACE_RECORD_SIZE = 16;
+
+TypeId
+EventTraceScheduler::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::EventTraceScheduler")
+            .SetParent<Scheduler>()
+            .SetGroupName("lorawan")
+            .AddConstructor<EventTraceScheduler>()
+            .AddAttribute("Filename",
+                          "Name of the file of recorded operations",
+                          StringValue("scheduler-trace.bin"),
+                          MakeStringAccessor(&EventTraceScheduler::m_filename),
+                          MakeStringChecker())
+            .AddAttribute("SchedulerType",
+                          "Type of the scheduler whose operations are recorded",
+                          StringValue("ns3::MapScheduler"),
+                          MakeStringAccessor(&EventTraceScheduler::m_schedulerType),
+                          MakeStringChecker());
+    return tid;
+}
+
+EventTraceScheduler::EventTraceScheduler()
+    : m_filename("scheduler-trace.bin"),
+      m_schedulerType("ns3::MapScheduler"),
+      m_buffer(1 << 20)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+EventTraceScheduler::~EventTraceScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+EventTraceScheduler::Insert(const Event& ev)
+{
+    Write(ev, INSERT);
+    m_scheduler->Insert(ev);
+}
+
+bool
+EventTraceScheduler::IsEmpty() const
+{
+    return !m_scheduler || m_scheduler->IsEmpty();
+}
+
+Scheduler::Event
+EventTraceScheduler::PeekNext() const
+{
+    NS_ASSERT(!IsEmpty());
+    return m_scheduler->PeekNext();
+}
+
+Scheduler::Event
+EventTraceScheduler::RemoveNext()
+{
+    NS_ASSERT(!IsEmpty());
+    Event ev = m_scheduler->RemoveNext();
+    Write(ev, REMOVE_NEXT);
+    return ev;
+}
+
+void
+EventTraceScheduler::Remove(const Event& ev)
+{
+    NS_ASSERT(!IsEmpty());
+    Write(ev, REMOVE);
+    m_scheduler->Remove(ev);
+}
+
+std::vector<EventTraceScheduler::Record>
+EventTraceScheduler::Read(const std::string& filename)
+{
+    NS_LOG_FUNCTION(filename);
+
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    NS_ABORT_MSG_IF(!file.is_open(), "Unable to open event trace " << filename);
+    std::size_t size = file.tellg();
+    file.seekg(0);
+    char header[TRACE_HEADER_SIZE];
+    file.read(header, TRACE_HEADER_SIZE);
+    uint32_t version;
+    std::memcpy(&version, header + 8, 4);
+    NS_ABORT_MSG_IF(!file || std::memcmp(header, TRACE_MAGIC, 8) != 0 ||
+                        version != TRACE_VERSION,
+                    "Invalid event trace " << filename);
+
+    // A trace cut by an interrupted simulation ends with a partial record
+    std::vector<Record> records((size - TRACE_HEADER_SIZE) / TRACE_RECORD_SIZE);
+    char data[TRACE_RECORD_SIZE];
+    for (auto& record : records)
+    {
+        file.read(data, TRACE_RECORD_SIZE);
+        std::memcpy(&record.ts, data, 8);
+        std::memcpy(&record.uid, data + 8, 4);
+        std::memcpy(&record.operation, data + 12, 4);
+    }
+    NS_ABORT_MSG_IF(!file, "Unable to read event trace " << filename);
+    return records;
+}
+
+void
+EventTraceScheduler::Write(const Event& ev, Operation operation)
+{
+    if (!m_scheduler)
+    {
+        ObjectFactory factory(m_schedulerType);
+        m_scheduler = factory.Create<Scheduler>();
+        m_file.rdbuf()->pubsetbuf(m_buffer.data(), m_buffer.size());
+        m_file.open(m_filename, std::ios::binary | std::ios::trunc);
+        NS_ABORT_MSG_IF(!m_file.is_open(), "Unable to open event trace " << m_filename);
+        char header[TRACE_HEADER_SIZE] = {};
+        std::memcpy(header, TRACE_MAGIC, 8);
+        std::memcpy(header + 8, &TRACE_VERSION, 4);
+        m_file.write(header, TRACE_HEADER_SIZE);
+        NS_LOG_INFO("Recording the operations of " << m_schedulerType << " to " << m_filename);
+    }
+
+    char data[TRACE_RECORD_SIZE];
+    std::memcpy(data, &ev.key.m_ts, 8);
+    std::memcpy(data + 8, &ev.key.m_uid, 4);
+    std::memcpy(data + 12, &operation, 4);
+    m_file.write(data, TRACE_RECORD_SIZE);
+}
+
+} // namespace lorawan
+} // namespace ns3
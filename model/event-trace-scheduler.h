@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2026 University of Bologna
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Alessandro Aimi <alessandro.aimi@unibo.it>
+ */
+
+#ifndef EVENT_TRACE_SCHEDULER_H
+#define EVENT_TRACE_SCHEDULER_H
+
+#include "ns3/scheduler.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+namespace lorawan
+{
+
+/**
+ * An event scheduler recording the operations of another one to a file.
+ *
+ * Select it with the SchedulerType global value
+ * ("ns3::EventTraceScheduler"), to record the event mix of a simulation
+ * and replay it on other schedulers with the scheduler-benchmark example.
+ *
+ * Files start with a 16-byte header (magic "LORAEVTS", version), followed by
+ * 16-byte records (timestamp, event uid, operation) in host byte order.
+ * Queries of the next event are not recorded.
+ */
+class EventTraceScheduler : public Scheduler
+{
+  public:
+    /**
+     * Operation on the scheduler.
+     */
+    enum Operation : uint32_t
+    {
+        INSERT,      //!< Insert
+        REMOVE_NEXT, //!< RemoveNext
+        REMOVE,      //!< Remove
+    };
+
+    /**
+     * A recorded operation.
+     */
+    struct Record
+    {
+        uint64_t ts;         //!< Timestamp of the event
+        uint32_t uid;        //!< Uid of the event
+        Operation operation; //!< Operation
+    };
+
+    static TypeId GetTypeId();
+
+    EventTraceScheduler();
+    ~EventTraceScheduler() override;
+
+    void Insert(const Event& ev) override;
+    bool IsEmpty() const override;
+    Event PeekNext() const override;
+    Event RemoveNext() override;
+    void Remove(const Event& ev) override;
+
+    /**
+     * Read all the operations recorded in a file.
+     *
+     * \param filename The name of the file.
+     * \return The operations.
+     */
+    static std::vector<Record> Read(const std::string& filename);
+
+  private:
+    /**
+     * Record an operation, creating the scheduler and the file at the first one.
+     *
+     * \param ev The event.
+     * \param operation The operation.
+     */
+    void Write(const Event& ev, Operation operation);
+
+    std::string m_filename;      //!< Name of the file
+    std::string m_schedulerType; //!< Type of the recorded scheduler
+
+    Ptr<Scheduler> m_scheduler; //!< Recorded scheduler
+    std::ofstream m_file;       //!< Output file
+    std::vector<char> m_buffer; //!< Buffer of the output file
+};
+
+} // namespace lorawan
+} // namespace ns3
+
+#endif /* EVENT_TRACE_SCHEDULER_H */
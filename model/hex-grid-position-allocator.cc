@@ -9,8 +9,11 @@
 
 #include "hex-grid-position-allocator.h"
 
+#include "ns3/abort.h"
 #include "ns3/double.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 
@@ -98,6 +101,56 @@ HexGridPositionAllocator::SetZ(double z)
     ResetCoordinates();
 }
 
+uint32_t
+HexGridPositionAllocator::GetIndex(const Vector& position) const
+{
+    NS_LOG_FUNCTION(this << position);
+
+    // Coordinates in the basis of the vectors of sectors 0 and 1
+    double b = -position.x / (std::sin(p3) * m_d);
+    double a = position.y / m_d - std::cos(p3) * b;
+
+    // Round to the closest grid position (cube coordinates a + b + c = 0)
+    double c = -a - b;
+    int q = std::lround(a);
+    int r = std::lround(b);
+    int s = std::lround(c);
+    double dq = std::abs(q - a);
+    double dr = std::abs(r - b);
+    double ds = std::abs(s - c);
+    if (dq > dr && dq > ds)
+    {
+        q = -r - s;
+    }
+    else if (dr > ds)
+    {
+        r = -q - s;
+    }
+
+    int ring = (std::abs(q) + std::abs(r) + std::abs(q + r)) / 2;
+    if (ring == 0)
+    {
+        return 0;
+    }
+
+    // Sector vectors in the same basis
+    const int sectors[6][2] = {{1, 0}, {0, 1}, {-1, 1}, {-1, 0}, {0, -1}, {1, -1}};
+    for (int sector = 0; sector < 6; sector++)
+    {
+        const int* radial = sectors[sector];
+        const int* side = sectors[(sector + 2) % 6];
+        int hq = q - ring * radial[0];
+        int hr = r - ring * radial[1];
+        int hex = std::max(std::abs(hq), std::abs(hr));
+        if (hex >= 0 && hex < ring && hq == hex * side[0] && hr == hex * side[1])
+        {
+            return 1 + 3 * ring * (ring - 1) + sector * ring + hex;
+        }
+    }
+    NS_ABORT_MSG("Grid position not found");
+    return 0;
+}
+
 Vector
 HexGridPositionAllocator::ObtainCurrentPosition() const
 {
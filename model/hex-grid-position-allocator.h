@@ -36,6 +36,18 @@ class HexGridPositionAllocator : public PositionAllocator
 
     void SetZ(double z);
 
+    /**
+     * Get the allocation order of the grid position closest to a point, i.e.,
+     * the number of positions returned by GetNext before it.
+     *
+     * Nodes can then be grouped by the cell of the grid they fall in, e.g., to
+     * assign the area of each gateway to a system id in distributed simulations.
+     *
+     * \param position The point.
+     * \return The index of the closest grid position.
+     */
+    uint32_t GetIndex(const Vector& position) const;
+
   private:
     /**
      * Refer to hexagonal tiling. We build concentric rings
@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) 2026 University of Bologna
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Alessandro Aimi <alessandro.aimi@unibo.it>
+ */
+
+#include "ladder-scheduler.h"
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace ns3
+{
+namespace lorawan
+{
+
+NS_LOG_COMPONENT_DEFINE("LadderScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED(LadderScheduler);
+
+/**
+ * Add timestamps without overflowing.
+ *
+ * \param a The first term.
+ * \param b The second term.
+ * \return The sum, or the largest timestamp.
+ */
+static uint64_t
+AddSaturating(uint64_t a, uint64_t b)
+{
+    return std::min(a, std::numeric_limits<uint64_t>::max() - b) + b;
+}
+
+TypeId
+LadderScheduler::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::LadderScheduler")
+            .SetParent<Scheduler>()
+            .SetGroupName("lorawan")
+            .AddConstructor<LadderScheduler>()
+            .AddAttribute("Threshold",
+                          "Maximum number of events of a bucket moved to the bottom tier "
+                          "instead of being spread over a new rung",
+                          UintegerValue(50),
+                          MakeUintegerAccessor(&LadderScheduler::m_threshold),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("MaxRungs",
+                          "Maximum number of rungs",
+                          UintegerValue(8),
+                          MakeUintegerAccessor(&LadderScheduler::m_maxRungs),
+                          MakeUintegerChecker<uint32_t>(1));
+    return tid;
+}
+
+LadderScheduler::LadderScheduler()
+    : m_threshold(50),
+      m_maxRungs(8),
+      m_topStart(0),
+      m_topMin(std::numeric_limits<uint64_t>::max()),
+      m_topMax(0),
+      m_nRungs(0),
+      m_size(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+LadderScheduler::~LadderScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+LadderScheduler::Insert(const Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+
+    uint64_t ts = ev.key.m_ts;
+    if (ts >= m_topStart)
+    {
+        m_top.push_back(ev);
+        m_topMin = std::min(m_topMin, ts);
+        m_topMax = std::max(m_topMax, ts);
+    }
+    else
+    {
+        uint32_t i = FindRung(ts);
+        if (i < m_nRungs)
+        {
+            GetBucket(m_rungs[i], ts).push_back(ev);
+        }
+        else
+        {
+            m_bottom.push_back(ev);
+            std::push_heap(m_bottom.begin(), m_bottom.end(), IsLater);
+        }
+    }
+    ++m_size;
+
+    if (m_bottom.empty())
+    {
+        Refill();
+    }
+}
+
+bool
+LadderScheduler::IsEmpty() const
+{
+    return m_size == 0;
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext() const
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!IsEmpty());
+
+    return m_bottom.front();
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!IsEmpty());
+
+    std::pop_heap(m_bottom.begin(), m_bottom.end(), IsLater);
+    Event ev = m_bottom.back();
+    m_bottom.pop_back();
+    --m_size;
+
+    if (m_bottom.empty())
+    {
+        Refill();
+    }
+    return ev;
+}
+
+void
+LadderScheduler::Remove(const Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+
+    // The tier of an event only depends on its timestamp
+    uint64_t ts = ev.key.m_ts;
+    std::vector<Event>* events = &m_bottom;
+    if (ts >= m_topStart)
+    {
+        events = &m_top;
+    }
+    else if (FindRung(ts) < m_nRungs)
+    {
+        events = &GetBucket(m_rungs[FindRung(ts)], ts);
+    }
+    auto it = std::find_if(events->begin(), events->end(), [&ev](const Event& other) {
+        return other.key.m_uid == ev.key.m_uid;
+    });
+    NS_ASSERT_MSG(it != events->end(), "Event not found in the scheduler");
+    NS_ASSERT(it->impl == ev.impl);
+    *it = events->back();
+    events->pop_back();
+    if (events == &m_bottom)
+    {
+        std::make_heap(m_bottom.begin(), m_bottom.end(), IsLater);
+    }
+    --m_size;
+
+    if (m_bottom.empty())
+    {
+        Refill();
+    }
+}
+
+void
+LadderScheduler::Refill()
+{
+    NS_LOG_FUNCTION(this);
+
+    while (m_bottom.empty() && m_size > 0)
+    {
+        // Keep storage for a new rung, so that references to rungs stay valid
+        if (m_rungs.size() <= m_nRungs)
+        {
+            m_rungs.emplace_back();
+        }
+
+        if (m_nRungs == 0)
+        {
+            // All remaining events are in the top tier
+            if (m_top.size() <= m_threshold)
+            {
+                m_bottom.swap(m_top);
+                std::make_heap(m_bottom.begin(), m_bottom.end(), IsLater);
+                m_topStart = AddSaturating(m_topMax, 1);
+            }
+            else
+            {
+                Spread(m_top, m_topMin, m_topMax);
+                const Rung& rung = m_rungs[0];
+                uint64_t last = rung.start + (rung.buckets.size() - 1) * rung.width;
+                m_topStart = AddSaturating(last, rung.width);
+            }
+            m_top.clear();
+            m_topMin = std::numeric_limits<uint64_t>::max();
+            m_topMax = 0;
+            continue;
+        }
+
+        Rung& rung = m_rungs[m_nRungs - 1];
+        uint32_t n = rung.buckets.size();
+        while (rung.current < n && rung.buckets[rung.current].empty())
+        {
+            ++rung.current;
+            rung.next = AddSaturating(rung.next, rung.width);
+        }
+        if (rung.current == n)
+        {
+            --m_nRungs;
+            continue;
+        }
+
+        // Move the current bucket down, so that new events before its end
+        // are inserted in the next rung or in the bottom tier
+        std::vector<Event>& bucket = rung.buckets[rung.current];
+        uint64_t last = AddSaturating(rung.next, rung.width - 1);
+        ++rung.current;
+        rung.next = AddSaturating(rung.next, rung.width);
+        if (bucket.size() > m_threshold && rung.width > 1 && m_nRungs < m_maxRungs)
+        {
+            uint64_t start = std::min_element(bucket.begin(), bucket.end(), [](auto& a, auto& b) {
+                                 return a.key.m_ts < b.key.m_ts;
+                             })->key.m_ts;
+            Spread(bucket, start, last);
+        }
+        else
+        {
+            m_bottom.swap(bucket);
+            std::make_heap(m_bottom.begin(), m_bottom.end(), IsLater);
+        }
+        bucket.clear();
+    }
+}
+
+void
+LadderScheduler::Spread(std::vector<Event>& events, uint64_t start, uint64_t last)
+{
+    NS_LOG_FUNCTION(this << events.size() << start << last);
+
+    // About one event per bucket
+    uint64_t span = last - start;
+    uint64_t width = span / events.size() + 1;
+    Rung& rung = m_rungs[m_nRungs++];
+    rung.start = start;
+    rung.width = width;
+    rung.next = start;
+    rung.current = 0;
+    rung.buckets.resize(span / width + 1);
+    for (const auto& ev : events)
+    {
+        GetBucket(rung, ev.key.m_ts).push_back(ev);
+    }
+    NS_LOG_DEBUG("Rung " << m_nRungs << " of " << rung.buckets.size() << " buckets of width "
+                         << width << " for " << events.size() << " events");
+}
+
+uint32_t
+LadderScheduler::FindRung(uint64_t ts) const
+{
+    uint32_t i = 0;
+    while (i < m_nRungs && ts < m_rungs[i].next)
+    {
+        ++i;
+    }
+    return i;
+}
+
+std::vector<Scheduler::Event>&
+LadderScheduler::GetBucket(Rung& rung, uint64_t ts)
+{
+    std::size_t index = (ts - rung.start) / rung.width;
+    return rung.buckets[std::min(index, rung.buckets.size() - 1)];
+}
+
+bool
+LadderScheduler::IsLater(const Event& a, const Event& b)
+{
+    return b.key < a.key;
+}
+
+} // namespace lorawan
+} // namespace ns3
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2026 University of Bologna
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Alessandro Aimi <alessandro.aimi@unibo.it>
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "ns3/scheduler.h"
+
+#include <vector>
+
+namespace ns3
+{
+namespace lorawan
+{
+
+/**
+ * An event scheduler based on a ladder queue.
+ *
+ * Events are kept in three tiers (Tang, Goh and Thng, "Ladder queue: an O(1)
+ * priority queue structure for large-scale discrete event simulation", 2005).
+ * Far future events are appended unsorted to the top tier. When earlier events
+ * are exhausted, the top tier is spread over a rung of buckets of equal width,
+ * and the first non-empty bucket is moved to the bottom tier, a binary heap,
+ * or spread over a finer rung if it holds too many events. Events inserted
+ * before the start of the top tier go directly to the bucket covering their
+ * time, or to the bottom tier.
+ *
+ * This suits LoRaWAN simulations, where the many far future events of
+ * applications are only touched twice, while the few near future events of
+ * PHYs and MACs stay in a small heap.
+ *
+ * Select it with the SchedulerType global value ("ns3::LadderScheduler").
+ */
+class LadderScheduler : public Scheduler
+{
+  public:
+    static TypeId GetTypeId();
+
+    LadderScheduler();
+    ~LadderScheduler() override;
+
+    void Insert(const Event& ev) override;
+    bool IsEmpty() const override;
+    Event PeekNext() const override;
+    Event RemoveNext() override;
+    void Remove(const Event& ev) override;
+
+  private:
+    /**
+     * A rung of buckets of equal width.
+     */
+    struct Rung
+    {
+        uint64_t start;                          //!< Timestamp of the first bucket
+        uint64_t width;                          //!< Timestamps covered by each bucket
+        uint64_t next;                           //!< Timestamp of the current bucket
+        uint32_t current;                        //!< Index of the first bucket not moved down
+        std::vector<std::vector<Event>> buckets; //!< Events of each bucket
+    };
+
+    /**
+     * Move the earliest events to the bottom tier, which must be empty.
+     */
+    void Refill();
+
+    /**
+     * Spread events over a new rung.
+     *
+     * \param events The events.
+     * \param start The smallest timestamp of the events.
+     * \param last The largest timestamp that the rung must cover.
+     */
+    void Spread(std::vector<Event>& events, uint64_t start, uint64_t last);
+
+    /**
+     * Get the rung covering a timestamp earlier than the start of the top tier.
+     *
+     * \param ts The timestamp.
+     * \return The index of the rung, or the number of rungs for the bottom tier.
+     */
+    uint32_t FindRung(uint64_t ts) const;
+
+    /**
+     * Get the bucket of a rung covering a timestamp.
+     *
+     * \param rung The rung.
+     * \param ts The timestamp.
+     * \return The events of the bucket.
+     */
+    static std::vector<Event>& GetBucket(Rung& rung, uint64_t ts);
+
+    /**
+     * Order of events in the bottom heap.
+     *
+     * \param a The first event.
+     * \param b The second event.
+     * \return Whether a is later than b.
+     */
+    static bool IsLater(const Event& a, const Event& b);
+
+    uint32_t m_threshold; //!< Maximum number of events of buckets moved to the bottom
+    uint32_t m_maxRungs;  //!< Maximum number of rungs
+
+    std::vector<Event> m_top; //!< Unsorted far future events
+    uint64_t m_topStart;      //!< Smallest timestamp of events of the top tier
+    uint64_t m_topMin;        //!< Smallest timestamp in the top tier
+    uint64_t m_topMax;        //!< Largest timestamp in the top tier
+
+    std::vector<Rung> m_rungs; //!< Rungs, from the coarsest, including unused ones
+    uint32_t m_nRungs;         //!< Number of rungs in use
+
+    std::vector<Event> m_bottom; //!< Heap of the earliest events
+    uint64_t m_size;             //!< Total number of events
+};
+
+} // namespace lorawan
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
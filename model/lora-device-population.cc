@@ -0,0 +1,353 @@
+/*
+ * Copyright (c) 2026 University of Bologna
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Alessandro Aimi <alessandro.aimi@unibo.it>
+ */
+
+#include "lora-device-population.h"
+
+#include "ns3/LoRaMacCrypto.h"
+#include "ns3/boolean.h"
+#include "ns3/building-list.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/lora-frame-header.h"
+#include "ns3/lora-tag.h"
+#include "ns3/lorawan-mac-header.h"
+#include "ns3/node-list.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+namespace ns3
+{
+namespace lorawan
+{
+
+NS_LOG_COMPONENT_DEFINE("LoraDevicePopulation");
+
+NS_OBJECT_ENSURE_REGISTERED(LoraDevicePopulation);
+
+// Spreading factors of EU868 data rates DR0 to DR5, all on 125 kHz
+static const uint8_t SF_FOR_DATA_RATE[] = {12, 11, 10, 9, 8, 7};
+
+TypeId
+LoraDevicePopulation::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::LoraDevicePopulation")
+            .SetParent<Object>()
+            .SetGroupName("lorawan")
+            .AddConstructor<LoraDevicePopulation>()
+            .AddAttribute("PayloadSize",
+                          "Size of the application payload of uplinks (bytes)",
+                          UintegerValue(10),
+                          MakeUintegerAccessor(&LoraDevicePopulation::m_payloadSize),
+                          MakeUintegerChecker<uint8_t>())
+            .AddAttribute("DutyCycle",
+                          "Duty cycle limit of devices, used to stretch their period",
+                          DoubleValue(0.01),
+                          MakeDoubleAccessor(&LoraDevicePopulation::m_dutyCycle),
+                          MakeDoubleChecker<double>(0, 1))
+            .AddAttribute("EnableCryptography",
+                          "Whether to compute the MIC of uplinks, with keys of the default "
+                          "key store. Must be set before adding devices.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&LoraDevicePopulation::m_enableCrypto),
+                          MakeBooleanChecker())
+            .AddAttribute("FirstId",
+                          "Id of the first device in traces, to keep ids of devices distinct "
+                          "from the ones of nodes. By default, the number of nodes at Start, "
+                          "so that ids follow the ones of existing nodes.",
+                          UintegerValue(AUTO_FIRST_ID),
+                          MakeUintegerAccessor(&LoraDevicePopulation::m_firstId),
+                          MakeUintegerChecker<uint32_t>())
+            .AddTraceSource("StartSending",
+                            "Trace source indicating a device started an uplink",
+                            MakeTraceSourceAccessor(&LoraDevicePopulation::m_startSending),
+                            "ns3::Packet::TracedCallback")
+            .AddTraceSource("SentNewPacket",
+                            "Trace source indicating a device sent a new uplink",
+                            MakeTraceSourceAccessor(&LoraDevicePopulation::m_sentNewPacket),
+                            "ns3::Packet::TracedCallback");
+    return tid;
+}
+
+LoraDevicePopulation::LoraDevicePopulation()
+    : m_frequencies({868.1e6, 868.3e6, 868.5e6}),
+      m_payloadSize(10),
+      m_dutyCycle(0.01),
+      m_enableCrypto(false),
+      m_firstId(AUTO_FIRST_ID)
+{
+    NS_LOG_FUNCTION(this);
+
+    m_mobility = CreateObject<ConstantPositionMobilityModel>();
+    m_phy = CreateObject<EndDeviceLoraPhy>();
+    m_phy->SetMobility(m_mobility);
+    m_uniformRV = CreateObject<UniformRandomVariable>();
+}
+
+LoraDevicePopulation::~LoraDevicePopulation()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+uint32_t
+LoraDevicePopulation::AddDevice(const Vector& position,
+                                LoraDeviceAddress address,
+                                uint8_t dataRate,
+                                Time period)
+{
+    NS_LOG_FUNCTION(this << position << address << unsigned(dataRate) << period);
+    NS_ASSERT_MSG(dataRate < sizeof(SF_FOR_DATA_RATE), "Unsupported data rate");
+    NS_ASSERT_MSG(period.IsStrictlyPositive(), "The period of uplinks must be positive");
+
+    // Building-aware loss models need the building info of the sender
+    if (!m_buildingInfo && BuildingList::GetNBuildings())
+    {
+        m_buildingInfo = CreateObject<MobilityBuildingInfo>();
+        m_mobility->AggregateObject(m_buildingInfo);
+    }
+    m_positions.push_back(position);
+    m_addresses.push_back(address.Get());
+    m_periods.push_back(period);
+    m_fCnts.push_back(0);
+    m_dataRates.push_back(dataRate);
+    m_txPowers.push_back(14);
+    if (m_enableCrypto)
+    {
+        if (!m_keyStore)
+        {
+            m_keyStore = LoraKeyStore::GetDefault();
+        }
+        m_keys.push_back(m_keyStore->AddDevice());
+    }
+    return m_positions.size() - 1;
+}
+
+uint32_t
+LoraDevicePopulation::GetNDevices() const
+{
+    return m_positions.size();
+}
+
+Vector
+LoraDevicePopulation::GetPosition(uint32_t device) const
+{
+    return m_positions.at(device);
+}
+
+LoraDeviceAddress
+LoraDevicePopulation::GetDeviceAddress(uint32_t device) const
+{
+    return LoraDeviceAddress(m_addresses.at(device));
+}
+
+uint16_t
+LoraDevicePopulation::GetFCnt(uint32_t device) const
+{
+    return m_fCnts.at(device);
+}
+
+void
+LoraDevicePopulation::SetDataRate(uint32_t device, uint8_t dataRate)
+{
+    NS_LOG_FUNCTION(this << device << unsigned(dataRate));
+    NS_ASSERT_MSG(dataRate < sizeof(SF_FOR_DATA_RATE), "Unsupported data rate");
+
+    m_dataRates.at(device) = dataRate;
+}
+
+void
+LoraDevicePopulation::SetTxPower(uint32_t device, double txPowerDbm)
+{
+    NS_LOG_FUNCTION(this << device << txPowerDbm);
+
+    m_txPowers.at(device) = int8_t(txPowerDbm);
+}
+
+void
+LoraDevicePopulation::SetChannel(Ptr<LoraChannel> channel)
+{
+    NS_LOG_FUNCTION(this << channel);
+
+    m_channel = channel;
+}
+
+void
+LoraDevicePopulation::SetFrequencies(const std::vector<double>& frequencies)
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT_MSG(!frequencies.empty(), "At least one frequency is needed");
+
+    m_frequencies = frequencies;
+}
+
+void
+LoraDevicePopulation::Start(Time start)
+{
+    NS_LOG_FUNCTION(this << start);
+    NS_ASSERT_MSG(m_channel, "The channel of the population was not set");
+
+    Stop();
+    if (m_firstId == AUTO_FIRST_ID)
+    {
+        m_firstId = NodeList::GetNNodes();
+    }
+    m_queue.reserve(m_positions.size());
+    Time now = Simulator::Now();
+    for (uint32_t device = 0; device < m_positions.size(); ++device)
+    {
+        Time offset = Seconds(m_uniformRV->GetValue(0, m_periods[device].GetSeconds()));
+        Enqueue(device, now + start + offset);
+    }
+    ScheduleTimer();
+}
+
+void
+LoraDevicePopulation::Stop()
+{
+    NS_LOG_FUNCTION(this);
+
+    Simulator::Cancel(m_timer);
+    m_queue.clear();
+}
+
+int64_t
+LoraDevicePopulation::AssignStreams(int64_t stream)
+{
+    NS_LOG_FUNCTION(this << stream);
+
+    m_uniformRV->SetStream(stream);
+    return 1;
+}
+
+void
+LoraDevicePopulation::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+
+    Stop();
+    m_channel = nullptr;
+    m_phy = nullptr;
+    m_mobility = nullptr;
+    m_buildingInfo = nullptr;
+    m_keyStore = nullptr;
+    Object::DoDispose();
+}
+
+void
+LoraDevicePopulation::ProcessTimer()
+{
+    NS_LOG_FUNCTION(this);
+
+    Time now = Simulator::Now();
+    while (!m_queue.empty() && m_queue.front().first <= now.GetTimeStep())
+    {
+        uint32_t device = m_queue.front().second;
+        std::pop_heap(m_queue.begin(), m_queue.end(), std::greater<>());
+        m_queue.pop_back();
+
+        Time duration = Transmit(device);
+        // Respect the duty cycle if the period is too short
+        Time offTime = Seconds(duration.GetSeconds() / m_dutyCycle);
+        Enqueue(device, now + Max(m_periods[device], offTime));
+    }
+    ScheduleTimer();
+}
+
+Time
+LoraDevicePopulation::Transmit(uint32_t device)
+{
+    NS_LOG_FUNCTION(this << device);
+
+    uint32_t address = m_addresses[device];
+    uint16_t fCnt = m_fCnts[device];
+
+    // Build the frame as ClassAEndDeviceLorawanMac does
+    Ptr<Packet> packet = Create<Packet>(m_payloadSize);
+    LoraFrameHeader fHdr;
+    fHdr.SetAsUplink();
+    fHdr.SetFPort(1);
+    fHdr.SetAddress(LoraDeviceAddress(address));
+    fHdr.SetAdr(false);
+    fHdr.SetAdrAckReq(false);
+    fHdr.SetFCnt(fCnt);
+    packet->AddHeader(fHdr);
+    LorawanMacHeader mHdr;
+    mHdr.SetFType(LorawanMacHeader::UNCONFIRMED_DATA_UP);
+    mHdr.SetMajor(0);
+    packet->AddHeader(mHdr);
+
+    // 4 Bytes of MIC
+    uint32_t mic = 0;
+    if (m_enableCrypto)
+    {
+        uint8_t buff[256];
+        uint32_t size = packet->CopyData(buff, 256);
+        mic = m_keyStore->ComputeMic(m_keys[device], buff, size, UPLINK, address, fCnt);
+    }
+    uint8_t micser[4];
+    std::memcpy(micser, &mic, 4);
+    packet->AddAtEnd(Create<Packet>(micser, 4));
+
+    // Configure tx params
+    uint8_t dataRate = m_dataRates[device];
+    LoraPhyTxParameters txParams;
+    txParams.sf = SF_FOR_DATA_RATE[dataRate];
+    txParams.bandwidthHz = 125000;
+    txParams.lowDataRateOptimizationEnabled = LoraPhy::GetTSym(txParams) > MilliSeconds(16);
+    uint32_t channel = m_uniformRV->GetInteger(0, m_frequencies.size() - 1);
+    double frequency = m_frequencies[channel];
+
+    LoraTag tag;
+    tag.SetDataRate(dataRate);
+    tag.SetFrequency(frequency);
+    tag.SetTxParameters(txParams);
+    packet->AddPacketTag(tag);
+
+    Time duration = LoraPhy::GetTimeOnAir(packet->GetSize(), txParams);
+    NS_LOG_DEBUG("Device " << device << " sends FCnt " << fCnt << " at DR"
+                           << unsigned(dataRate) << " on " << frequency << " Hz for "
+                           << duration.As(Time::MS));
+
+    // The channel reads the position of the sender when the packet is sent
+    m_mobility->SetPosition(m_positions[device]);
+    if (m_buildingInfo)
+    {
+        m_buildingInfo->MakeConsistent(m_mobility);
+    }
+    m_channel->Send(m_phy, packet, m_txPowers[device], txParams.sf, duration, frequency);
+    m_startSending(packet, m_firstId + device);
+    m_sentNewPacket(packet);
+
+    m_fCnts[device]++;
+    return duration;
+}
+
+void
+LoraDevicePopulation::Enqueue(uint32_t device, Time time)
+{
+    m_queue.emplace_back(time.GetTimeStep(), device);
+    std::push_heap(m_queue.begin(), m_queue.end(), std::greater<>());
+}
+
+void
+LoraDevicePopulation::ScheduleTimer()
+{
+    if (m_queue.empty())
+    {
+        return;
+    }
+    Time delay = TimeStep(m_queue.front().first) - Simulator::Now();
+    m_timer = Simulator::Schedule(delay, &LoraDevicePopulation::ProcessTimer, this);
+}
+
+} // namespace lorawan
+} // namespace ns3
@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2026 University of Bologna
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Alessandro Aimi <alessandro.aimi@unibo.it>
+ */
+
+#ifndef LORA_DEVICE_POPULATION_H
+#define LORA_DEVICE_POPULATION_H
+
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/end-device-lora-phy.h"
+#include "ns3/event-id.h"
+#include "ns3/lora-channel.h"
+#include "ns3/lora-device-address.h"
+#include "ns3/lora-key-store.h"
+#include "ns3/mobility-building-info.h"
+#include "ns3/object.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/traced-callback.h"
+#include "ns3/vector.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+namespace lorawan
+{
+
+/**
+ * A compact population of periodic class A end devices.
+ *
+ * Instead of a node with a full protocol stack per device, the state of all
+ * devices is kept in per-field tables indexed by device, and the
+ * transmissions of all devices are driven by a single timer. Devices send
+ * unconfirmed uplinks of fixed size, built as the ones of
+ * ClassAEndDeviceLorawanMac, on the same LoraChannel as regular devices, so
+ * that gateways and forwarders receive them unchanged. Devices of the
+ * population do not receive downlinks.
+ *
+ * Each device transmits on a random channel among the configured frequencies,
+ * with a period that is stretched if needed to respect the duty cycle.
+ *
+ * Devices only keep their position: a single mobility model, shared by all
+ * of them, is moved to the position of each device before it transmits. If
+ * buildings exist, the mobility model is given a MobilityBuildingInfo, as
+ * BuildingsHelper::Install does for nodes.
+ */
+class LoraDevicePopulation : public Object
+{
+  public:
+    static TypeId GetTypeId();
+
+    LoraDevicePopulation();
+    ~LoraDevicePopulation() override;
+
+    /**
+     * Add a device to the population.
+     *
+     * \param position The position of the device.
+     * \param address The network address of the device.
+     * \param dataRate The data rate of uplinks (EU868 DR0 to DR5).
+     * \param period The interval between uplinks.
+     * \return The index of the device in the population.
+     */
+    uint32_t AddDevice(const Vector& position,
+                       LoraDeviceAddress address,
+                       uint8_t dataRate,
+                       Time period);
+
+    /**
+     * \return The number of devices in the population.
+     */
+    uint32_t GetNDevices() const;
+
+    /**
+     * \param device The index of the device.
+     * \return The position of the device.
+     */
+    Vector GetPosition(uint32_t device) const;
+
+    /**
+     * \param device The index of the device.
+     * \return The network address of the device.
+     */
+    LoraDeviceAddress GetDeviceAddress(uint32_t device) const;
+
+    /**
+     * \param device The index of the device.
+     * \return The frame counter of the next uplink of the device.
+     */
+    uint16_t GetFCnt(uint32_t device) const;
+
+    /**
+     * Set the data rate of uplinks of a device.
+     *
+     * \param device The index of the device.
+     * \param dataRate The data rate (EU868 DR0 to DR5).
+     */
+    void SetDataRate(uint32_t device, uint8_t dataRate);
+
+    /**
+     * Set the transmission power of a device.
+     *
+     * \param device The index of the device.
+     * \param txPowerDbm The transmission power (dBm).
+     */
+    void SetTxPower(uint32_t device, double txPowerDbm);
+
+    /**
+     * Set the channel devices transmit on.
+     *
+     * \param channel The channel.
+     */
+    void SetChannel(Ptr<LoraChannel> channel);
+
+    /**
+     * Set the frequencies devices pick their transmission channel from.
+     *
+     * \param frequencies The frequencies (Hz).
+     */
+    void SetFrequencies(const std::vector<double>& frequencies);
+
+    /**
+     * Schedule the first uplink of every device at a random offset in its
+     * period after a start time.
+     *
+     * \param start The delay after which devices start transmitting.
+     */
+    void Start(Time start);
+
+    /**
+     * Stop all transmissions.
+     */
+    void Stop();
+
+    /**
+     * Assign a fixed random variable stream number to the random variables
+     * used by this model.
+     *
+     * \param stream The first stream index to use.
+     * \return The number of stream indices assigned by this model.
+     */
+    int64_t AssignStreams(int64_t stream);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /**
+     * Transmit the uplinks of all devices that are due and reschedule the timer.
+     */
+    void ProcessTimer();
+
+    /**
+     * Build and transmit the next uplink of a device.
+     *
+     * \param device The index of the device.
+     * \return The time on air of the uplink.
+     */
+    Time Transmit(uint32_t device);
+
+    /**
+     * Insert the next uplink of a device in the queue of the timer.
+     *
+     * \param device The index of the device.
+     * \param time The time of the uplink.
+     */
+    void Enqueue(uint32_t device, Time time);
+
+    /**
+     * Arm the timer for the earliest uplink in the queue.
+     */
+    void ScheduleTimer();
+
+    // Per-device tables
+    std::vector<Vector> m_positions;   //!< Positions of devices
+    std::vector<uint32_t> m_addresses; //!< Network addresses of devices
+    std::vector<Time> m_periods;       //!< Intervals between uplinks
+    std::vector<uint16_t> m_fCnts;     //!< Frame counters of the next uplinks
+    std::vector<uint8_t> m_dataRates;  //!< Data rates of uplinks
+    std::vector<int8_t> m_txPowers;    //!< Transmission powers (dBm)
+    std::vector<uint32_t> m_keys;      //!< Indices of devices in the key store
+
+    /**
+     * Upcoming uplinks, as a min-heap of (time step, device index)
+     */
+    std::vector<std::pair<int64_t, uint32_t>> m_queue;
+    EventId m_timer; //!< The timer of the earliest upcoming uplink
+
+    Ptr<LoraChannel> m_channel;                    //!< The channel devices transmit on
+    std::vector<double> m_frequencies;             //!< Frequencies of uplinks (Hz)
+    Ptr<EndDeviceLoraPhy> m_phy;                   //!< Sender of uplinks on the channel
+    Ptr<ConstantPositionMobilityModel> m_mobility; //!< Position of the transmitting device
+    Ptr<MobilityBuildingInfo> m_buildingInfo;      //!< Building of the transmitting device
+    Ptr<UniformRandomVariable> m_uniformRV;        //!< Channels and start offsets
+    Ptr<LoraKeyStore> m_keyStore;                  //!< Session keys, if cryptography is enabled
+    uint8_t m_payloadSize;                         //!< Size of the application payload
+    double m_dutyCycle;                            //!< Duty cycle limit of devices
+    bool m_enableCrypto;                           //!< Whether to compute MICs
+    uint32_t m_firstId;                            //!< Id of the first device in traces
+
+    /**
+     * Value of FirstId for ids following the ones of nodes existing at Start
+     */
+    static constexpr uint32_t AUTO_FIRST_ID = UINT32_MAX;
+
+    /**
+     * The trace source fired when a device starts an uplink, with the id of
+     * the device (FirstId plus its index).
+     */
+    TracedCallback<Ptr<const Packet>, uint32_t> m_startSending;
+
+    /**
+     * The trace source fired when a device sends a new uplink.
+     */
+    TracedCallback<Ptr<const Packet>> m_sentNewPacket;
+};
+
+} // namespace lorawan
+} // namespace ns3
+
+#endif /* LORA_DEVICE_POPULATION_H */
@@ -204,5 +204,14 @@ LoraTag::GetSnr() const
     return m_snr;
 }
 
+void
+LoraTag::WriteTo(Ptr<Packet> packet)
+{
+    if (!packet->ReplacePacketTag(*this))
+    {
+        packet->AddPacketTag(*this);
+    }
+}
+
 } // namespace lorawan
 } // namespace ns3
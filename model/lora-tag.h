@@ -15,6 +15,7 @@
 
 #include "ns3/lora-phy.h"
 #include "ns3/nstime.h"
+#include "ns3/packet.h"
 #include "ns3/tag.h"
 
 namespace ns3
@@ -149,6 +150,16 @@ class LoraTag : public Tag
      */
     double GetSnr() const;
 
+    /**
+     * Write this tag to a packet, updating in place the LoraTag that the
+     * packet already carries, if any. Layers modifying the tag should peek
+     * it and write it back with this method: removing and adding the tag
+     * again reallocates the tag list of the packet.
+     *
+     * \param packet The packet.
+     */
+    void WriteTo(Ptr<Packet> packet);
+
   private:
     LoraPhyTxParameters m_params; //!< The PHY transmission parameters of this packet
     uint8_t m_dataRate;           //!< The data rate of this packet
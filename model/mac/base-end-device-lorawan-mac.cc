@@ -15,9 +15,13 @@
 
 #include "base-end-device-lorawan-mac.h"
 
+#include "ns3/LoRaMacCrypto.h"
 #include "ns3/end-device-lora-phy.h"
 #include "ns3/simulator.h"
 
+#include <algorithm>
+#include <cstring>
+
 namespace ns3
 {
 namespace lorawan
@@ -116,6 +120,7 @@ BaseEndDeviceLorawanMac::BaseEndDeviceLorawanMac()
       m_ADRACKReq(false),
       // Private Header fields
       m_fType(LorawanMacHeader::UNCONFIRMED_DATA_UP),
+      m_fPort(1),
       m_address(LoraDeviceAddress(0)),
       m_ADRBit(false),
       m_fCnt(0),
@@ -125,10 +130,12 @@ BaseEndDeviceLorawanMac::BaseEndDeviceLorawanMac()
       m_aggregatedDutyCycle(1),
       // Private MAC layer context
       m_lastKnownLinkMargin(0),
-      m_lastKnownGatewayCount(0)
+      m_lastKnownGatewayCount(0),
+      // Private Utilities
+      m_keyStore(nullptr),
+      m_keyIndex(0)
 {
     NS_LOG_FUNCTION(this);
-    m_crypto = new LoRaMacCrypto();
     m_uniformRV = CreateObject<UniformRandomVariable>();
 }
 
@@ -169,13 +176,9 @@ BaseEndDeviceLorawanMac::GetNextTransmissionDelay()
     NS_LOG_FUNCTION(this);
 
     // Check legal duty cycle
-    Time waitingTime = Time::Max();
-    for (const auto& llc : m_channelManager->GetEnabledChannelList())
-    {
-        waitingTime = std::min(waitingTime, m_channelManager->GetWaitingTime(llc));
-        NS_LOG_DEBUG("Waiting time before the next transmission in channel with frequecy "
-                     << llc->GetFrequency() << " is = " << waitingTime.GetSeconds() << ".");
-    }
+    Time waitingTime = m_channelManager->GetMinWaitingTime();
+    NS_LOG_DEBUG("Waiting time before the next transmission in any enabled channel is = "
+                 << waitingTime.GetSeconds() << ".");
 
     // Check if we are busy and if we need to postpone more (overridden function!)
     waitingTime = Max(waitingTime, GetBusyTransmissionDelay());
@@ -225,13 +228,6 @@ BaseEndDeviceLorawanMac::DoSend(Ptr<Packet> packet)
     }
     else // Retransmission
     {
-        // Remove MIC and headers
-        packet->RemoveAtEnd(4);
-        LorawanMacHeader mHdr;
-        packet->RemoveHeader(mHdr);
-        LoraFrameHeader fHdr;
-        fHdr.SetAsUplink();
-        packet->RemoveHeader(fHdr);
         NS_LOG_DEBUG("Retransmitting an old packet.");
     }
 
@@ -241,31 +237,58 @@ BaseEndDeviceLorawanMac::DoSend(Ptr<Packet> packet)
         ExecuteADRBackoff();
     }
 
-    // Add the Lora Frame Header to the packet
-    LoraFrameHeader fHdr;
-    FillHeader(fHdr);
-    packet->AddHeader(fHdr);
-    NS_LOG_INFO("Added frame header of size " << (unsigned)fHdr.GetSerializedSize() << " bytes.");
+    // On retransmissions, reuse the serialized frame if possible
+    bool reuseFrame = !packetIsNew && PatchCachedFrame(packet);
+    if (!reuseFrame)
+    {
+        if (!packetIsNew)
+        {
+            // Remove MIC and headers
+            packet->RemoveAtEnd(4);
+            LorawanMacHeader mHdr;
+            packet->RemoveHeader(mHdr);
+            LoraFrameHeader fHdr;
+            fHdr.SetAsUplink();
+            packet->RemoveHeader(fHdr);
+        }
+
+        // Add the Lora Frame Header to the packet
+        LoraFrameHeader fHdr;
+        m_txContext.fOpts = m_fOpts;
+        FillHeader(fHdr);
+        packet->AddHeader(fHdr);
+        NS_LOG_INFO("Added frame header of size " << (unsigned)fHdr.GetSerializedSize()
+                                                  << " bytes.");
+    }
+
     // Check that MACPayload length is below the allowed maximum
-    if (packet->GetSize() > m_maxMacPayloadForDataRate.at(m_dataRate))
+    uint32_t macPayloadSize = reuseFrame ? packet->GetSize() - 1 - 4 : packet->GetSize();
+    if (macPayloadSize > m_maxMacPayloadForDataRate.at(m_dataRate))
     {
         NS_LOG_ERROR("Attempting to send a packet ("
-                     << (unsigned)packet->GetSize() << "B) larger than the maximum allowed"
+                     << (unsigned)macPayloadSize << "B) larger than the maximum allowed"
                      << " size (" << (unsigned)m_maxMacPayloadForDataRate.at(m_dataRate)
                      << "B) at this DataRate (DR" << unsigned(m_dataRate)
                      << "). Transmission canceled.");
         return;
     }
 
-    // Add the Lorawan Mac header to the packet
-    NS_LOG_DEBUG("Message type is " << m_fType);
-    LorawanMacHeader mHdr;
-    FillHeader(mHdr);
-    packet->AddHeader(mHdr);
-    NS_LOG_INFO("Added MAC header of size " << mHdr.GetSerializedSize() << " bytes.");
+    if (!reuseFrame)
+    {
+        // Add the Lorawan Mac header to the packet
+        NS_LOG_DEBUG("Message type is " << m_fType);
+        LorawanMacHeader mHdr;
+        FillHeader(mHdr);
+        packet->AddHeader(mHdr);
+        NS_LOG_INFO("Added MAC header of size " << mHdr.GetSerializedSize() << " bytes.");
 
-    // Add (eventually encrypted) MIC to the end of the packet
-    AddMIC(packet);
+        // Add (eventually encrypted) MIC to the end of the packet
+        AddMIC(packet);
+
+        // Keep the serialized frame for retransmissions
+        m_txContext.frame.resize(packet->GetSize());
+        packet->CopyData(m_txContext.frame.data(), m_txContext.frame.size());
+    }
 
     // Set context to busy
     m_txContext.busy = true;
@@ -308,57 +331,58 @@ BaseEndDeviceLorawanMac::ExecuteADRBackoff()
         else
         {
             // Enable default channels and set nbTrans to 1
-            m_channelManager->GetChannel(0)->EnableForUplink();
-            m_channelManager->GetChannel(1)->EnableForUplink();
-            m_channelManager->GetChannel(2)->EnableForUplink();
+            m_channelManager->EnableChannel(0);
+            m_channelManager->EnableChannel(1);
+            m_channelManager->EnableChannel(2);
             m_nbTrans = 1;
         }
     }
 }
 
-Ptr<LogicalChannel>
+Ptr<const LogicalChannel>
 BaseEndDeviceLorawanMac::GetChannelForTx()
 {
     NS_LOG_FUNCTION(this);
 
-    auto channels = Shuffle(m_channelManager->GetEnabledChannelList());
-    for (auto& llc : channels)
+    // Mark the enabled channels we can send the packet on right now
+    uint16_t enabledMask = m_channelManager->GetEnabledChannelMask();
+    uint16_t availableMask = 0;
+    uint8_t nAvailable = 0;
+    for (uint8_t i = 0; i < RegionalChannelPlan::MAX_CHANNELS; i++)
     {
-        NS_LOG_DEBUG("Frequency of the current channel: " << llc->GetFrequency());
-
-        // Verify that we can send the packet
-        Time waitingTime = m_channelManager->GetWaitingTime(llc);
-        NS_LOG_DEBUG("Waiting time for current channel = " << waitingTime.GetSeconds());
-
-        // Send immediately if we can
-        if (waitingTime == Seconds(0))
+        if (!(enabledMask & (1 << i)))
         {
-            return llc;
+            continue;
         }
-        else
+        auto llc = m_channelManager->GetChannel(i);
+        Time waitingTime = m_channelManager->GetWaitingTime(llc);
+        NS_LOG_DEBUG("Waiting time for channel " << llc->GetFrequency()
+                                                 << " = " << waitingTime.GetSeconds());
+        if (waitingTime == Seconds(0))
         {
-            NS_LOG_DEBUG("Packet cannot be immediately transmitted on "
-                         << "the current channel because of duty cycle limitations.");
+            availableMask |= (1 << i);
+            nAvailable++;
         }
     }
-    return nullptr; // In this case, no suitable channel was found
-}
 
-std::vector<Ptr<LogicalChannel>>
-BaseEndDeviceLorawanMac::Shuffle(std::vector<Ptr<LogicalChannel>> vector)
-{
-    NS_LOG_FUNCTION(this << vector);
-
-    int size = vector.size();
-    for (int i = 0; i < size; ++i)
+    if (!nAvailable)
     {
-        uint8_t random = m_uniformRV->GetInteger(0, size - 1);
-        auto tmp = vector.at(random);
-        vector.at(random) = vector.at(i);
-        vector.at(i) = tmp;
+        NS_LOG_DEBUG("Packet cannot be immediately transmitted on "
+                     << "any channel because of duty cycle limitations.");
+        return nullptr; // In this case, no suitable channel was found
     }
 
-    return vector;
+    // Pick one of them uniformly at random
+    uint32_t pick = m_uniformRV->GetInteger(0, nAvailable - 1);
+    for (uint8_t i = 0; i < RegionalChannelPlan::MAX_CHANNELS; i++)
+    {
+        if ((availableMask & (1 << i)) && !pick--)
+        {
+            return m_channelManager->GetChannel(i);
+        }
+    }
+    NS_ASSERT_MSG(false, "Available channel not found");
+    return nullptr;
 }
 
 ////////////////////////
@@ -379,7 +403,7 @@ BaseEndDeviceLorawanMac::FillHeader(LoraFrameHeader& fHdr)
     NS_LOG_FUNCTION(this << fHdr);
 
     fHdr.SetAsUplink();
-    fHdr.SetFPort(1); // TODO Use an appropriate frame port based on the application
+    fHdr.SetFPort(m_fPort);
     fHdr.SetAddress(m_address);
     fHdr.SetAdr(m_ADRBit);
     fHdr.SetAdrAckReq(m_ADRACKReq);
@@ -427,14 +451,12 @@ BaseEndDeviceLorawanMac::AddMIC(Ptr<Packet> packet)
     {
         uint8_t buff[256];
         packet->CopyData(buff, 256);
-        m_crypto->ComputeCmacB0(buff,
-                                packet->GetSize(),
-                                F_NWK_S_INT_KEY,
-                                false,
-                                UPLINK,
-                                m_address.Get(),
-                                m_fCnt,
-                                &mic);
+        mic = GetKeyStore()->ComputeMic(m_keyIndex,
+                                        buff,
+                                        packet->GetSize(),
+                                        UPLINK,
+                                        m_address.Get(),
+                                        m_fCnt);
     }
     // Re-serialize message to add the MIC
     uint8_t micser[4];
@@ -442,6 +464,67 @@ BaseEndDeviceLorawanMac::AddMIC(Ptr<Packet> packet)
     packet->AddAtEnd(Create<Packet>(micser, 4));
 }
 
+bool
+BaseEndDeviceLorawanMac::PatchCachedFrame(Ptr<Packet> packet)
+{
+    NS_LOG_FUNCTION(this << packet);
+
+    // New FOpts would change the length of the frame
+    std::vector<uint8_t>& frame = m_txContext.frame;
+    if (frame.size() != packet->GetSize() || m_fOpts != m_txContext.fOpts)
+    {
+        return false;
+    }
+
+    // Bytes preceding the FOpts: 1 (MHDR) + 4 (DevAddr) + 1 (FCtrl) + 2 (FCnt),
+    // same layout as LorawanMacHeader and LoraFrameHeader serialization
+    uint8_t fixed[8];
+    uint32_t devAddr = m_address.Get();
+    fixed[0] = uint8_t(m_fType << 5);
+    fixed[1] = devAddr & 0xFF;
+    fixed[2] = (devAddr >> 8) & 0xFF;
+    fixed[3] = (devAddr >> 16) & 0xFF;
+    fixed[4] = (devAddr >> 24) & 0xFF;
+    fixed[5] = (frame[5] & 0b111111) | uint8_t(m_ADRBit << 7) | uint8_t(m_ADRACKReq << 6);
+    fixed[6] = m_fCnt & 0xFF;
+    fixed[7] = (m_fCnt >> 8) & 0xFF;
+
+    if (std::equal(fixed, fixed + sizeof(fixed), frame.begin()))
+    {
+        NS_LOG_INFO("Reusing the serialized frame as is.");
+        return true;
+    }
+
+    // Patch the header fields and recompute the MIC
+    std::copy(fixed, fixed + sizeof(fixed), frame.begin());
+    uint32_t micOffset = frame.size() - 4;
+    uint32_t mic = 0;
+    if (m_enableCrypto)
+    {
+        mic = GetKeyStore()
+                  ->ComputeMic(m_keyIndex, frame.data(), micOffset, UPLINK, devAddr, m_fCnt);
+    }
+    std::memcpy(frame.data() + micOffset, &mic, 4);
+
+    // Update the headers of the packet, so that its metadata and tags are kept
+    packet->RemoveAtEnd(4);
+    LorawanMacHeader mHdr;
+    packet->RemoveHeader(mHdr);
+    LoraFrameHeader fHdr;
+    fHdr.SetAsUplink();
+    packet->RemoveHeader(fHdr);
+    fHdr.SetAddress(m_address);
+    fHdr.SetAdr(m_ADRBit);
+    fHdr.SetAdrAckReq(m_ADRACKReq);
+    fHdr.SetFCnt(m_fCnt);
+    packet->AddHeader(fHdr);
+    FillHeader(mHdr);
+    packet->AddHeader(mHdr);
+    packet->AddAtEnd(Create<Packet>(frame.data() + micOffset, 4));
+    NS_LOG_INFO("Patched the serialized frame header, FCnt=" << unsigned(m_fCnt & 0xFFFF));
+    return true;
+}
+
 void
 BaseEndDeviceLorawanMac::ApplyMACCommands(LoraFrameHeader fHdr, Ptr<const Packet> packet)
 {
@@ -456,91 +539,64 @@ BaseEndDeviceLorawanMac::ApplyMACCommands(LoraFrameHeader fHdr, Ptr<const Packet
     }
 
     // Parse and apply downlink MAC commands, queue answers
-    for (auto& cmd : fHdr.GetCommands())
-    {
+    fHdr.VisitCommands([this](const auto& cmd) {
+        using T = std::decay_t<decltype(cmd)>;
         NS_LOG_DEBUG("Iterating over the MAC commands...");
-        switch (cmd->GetCommandType())
+        if constexpr (std::is_same_v<T, LinkCheckAns>)
         {
-        case (LINK_CHECK_ANS): {
             NS_LOG_DEBUG("Detected a LinkCheckAns command.");
-            // Cast the command
-            auto linkCheckAns = DynamicCast<LinkCheckAns>(cmd);
-            // Call the appropriate function to take action
-            OnLinkCheckAns(linkCheckAns->GetMargin(), linkCheckAns->GetGwCnt());
-            break;
+            OnLinkCheckAns(cmd.GetMargin(), cmd.GetGwCnt());
         }
-        case (LINK_ADR_REQ): {
+        else if constexpr (std::is_same_v<T, LinkAdrReq>)
+        {
             NS_LOG_DEBUG("Detected a LinkAdrReq command.");
-            // Cast the command
-            auto linkAdrReq = DynamicCast<LinkAdrReq>(cmd);
-            // Call the appropriate function to take action
-            OnLinkAdrReq(linkAdrReq->GetDataRate(),
-                         linkAdrReq->GetTxPower(),
-                         linkAdrReq->GetEnabledChannelsList(),
-                         linkAdrReq->GetRepetitions());
-            break;
+            OnLinkAdrReq(cmd.GetDataRate(),
+                         cmd.GetTxPower(),
+                         cmd.GetEnabledChannelsList(),
+                         cmd.GetRepetitions());
         }
-        case (DUTY_CYCLE_REQ): {
+        else if constexpr (std::is_same_v<T, DutyCycleReq>)
+        {
             NS_LOG_DEBUG("Detected a DutyCycleReq command.");
-            // Cast the command
-            auto dutyCycleReq = DynamicCast<DutyCycleReq>(cmd);
-            // Call the appropriate function to take action
-            OnDutyCycleReq(dutyCycleReq->GetMaximumAllowedDutyCycle());
-            break;
+            OnDutyCycleReq(cmd.GetMaximumAllowedDutyCycle());
         }
-        case (RX_PARAM_SETUP_REQ): {
+        else if constexpr (std::is_same_v<T, RxParamSetupReq>)
+        {
             NS_LOG_DEBUG("Detected a RxParamSetupReq command.");
-            // Cast the command
-            auto rxParamSetupReq = DynamicCast<RxParamSetupReq>(cmd);
-            // Call the appropriate function to take action
-            OnRxParamSetupReq(rxParamSetupReq);
-            break;
+            OnRxParamSetupReq(Create<RxParamSetupReq>(cmd));
         }
-        case (DEV_STATUS_REQ): {
+        else if constexpr (std::is_same_v<T, DevStatusReq>)
+        {
             NS_LOG_DEBUG("Detected a DevStatusReq command.");
-            // Cast the command
-            auto devStatusReq = DynamicCast<DevStatusReq>(cmd);
-            // Call the appropriate function to take action
             OnDevStatusReq();
-            break;
         }
-        case (NEW_CHANNEL_REQ): {
+        else if constexpr (std::is_same_v<T, NewChannelReq>)
+        {
             NS_LOG_DEBUG("Detected a NewChannelReq command.");
-            // Cast the command
-            auto newChannelReq = DynamicCast<NewChannelReq>(cmd);
-            // Call the appropriate function to take action
-            OnNewChannelReq(newChannelReq->GetChannelIndex(),
-                            newChannelReq->GetFrequency(),
-                            newChannelReq->GetMinDataRate(),
-                            newChannelReq->GetMaxDataRate());
-            break;
+            OnNewChannelReq(cmd.GetChannelIndex(),
+                            cmd.GetFrequency(),
+                            cmd.GetMinDataRate(),
+                            cmd.GetMaxDataRate());
         }
-        case (RX_TIMING_SETUP_REQ): {
+        else if constexpr (std::is_same_v<T, RxTimingSetupReq>)
+        {
             NS_LOG_DEBUG("Detected a RxTimingSetupReq command.");
-            // Cast the command
-            auto rxTimingSetupReq = DynamicCast<RxTimingSetupReq>(cmd);
-            // Call the appropriate function to take action
-            OnRxTimingSetupReq(rxTimingSetupReq->GetDelay());
-            break;
+            OnRxTimingSetupReq(cmd.GetDelay());
         }
-        case (TX_PARAM_SETUP_REQ): {
+        else if constexpr (std::is_same_v<T, TxParamSetupReq>)
+        {
             /* Not mandatory in the EU868 region */
-            break;
         }
-        case (DL_CHANNEL_REQ): {
+        else if constexpr (std::is_same_v<T, DlChannelReq>)
+        {
             NS_LOG_DEBUG("Detected a DlChannelReq command.");
-            // Cast the command
-            auto dlChannelReq = DynamicCast<DlChannelReq>(cmd);
-            // Call the appropriate function to take action
-            OnDlChannelReq(dlChannelReq->GetChannelIndex(), dlChannelReq->GetFrequency());
-            break;
+            OnDlChannelReq(cmd.GetChannelIndex(), cmd.GetFrequency());
         }
-        default: {
+        else
+        {
             NS_LOG_ERROR("CID not recognized");
-            break;
-        }
         }
-    }
+    });
 }
 
 void
@@ -564,19 +620,19 @@ BaseEndDeviceLorawanMac::AppendCmdsFromFRMPayload(LoraFrameHeader& fHdr, Ptr<con
         }
         NS_LOG_INFO("Encrypted payload: " << std::hex << str << std::dec);
 
-        int result = m_crypto->PayloadEncrypt(cmds,
-                                              size,
-                                              F_NWK_S_INT_KEY,
-                                              m_address.Get(),
-                                              DOWNLINK,
-                                              fHdr.GetFCnt());
+        GetKeyStore()->PayloadEncrypt(m_keyIndex,
+                                      LoraKeyStore::NWK_SKEY,
+                                      cmds,
+                                      size,
+                                      m_address.Get(),
+                                      DOWNLINK,
+                                      fHdr.GetFCnt());
 
         for (uint32_t j = 0; j < size; j++)
         {
             sprintf(&str[2 * j], "%02X", cmds[j]);
         }
-        NS_LOG_INFO("Decryption result: " << result << ", payload: " << std::hex << str
-                                          << std::dec);
+        NS_LOG_INFO("Decrypted payload: " << std::hex << str << std::dec);
     }
 
     //! Trigger alternative de/serialization
@@ -683,18 +739,22 @@ BaseEndDeviceLorawanMac::OnLinkAdrReq(uint8_t dataRate,
     if (channelMaskOk && dataRateOk && txPowerOk)
     {
         // Cycle over all channels in the list
-        for (uint32_t i = 0; i < m_channelManager->GetChannelList().size(); i++)
+        for (uint8_t i = 0; i < RegionalChannelPlan::MAX_CHANNELS; i++)
         {
+            if (!m_channelManager->GetChannel(i))
+            {
+                continue;
+            }
             if (std::find(enabledChannels.begin(), enabledChannels.end(), i) !=
                 enabledChannels.end())
             {
-                m_channelManager->GetChannelList().at(i)->EnableForUplink();
-                NS_LOG_DEBUG("Channel " << i << " enabled");
+                m_channelManager->EnableChannel(i);
+                NS_LOG_DEBUG("Channel " << unsigned(i) << " enabled");
             }
             else
             {
-                m_channelManager->GetChannelList().at(i)->DisableForUplink();
-                NS_LOG_DEBUG("Channel " << i << " disabled");
+                m_channelManager->DisableChannel(i);
+                NS_LOG_DEBUG("Channel " << unsigned(i) << " disabled");
             }
         }
 
@@ -814,6 +874,13 @@ BaseEndDeviceLorawanMac::GetFType()
     return m_fType;
 }
 
+void
+BaseEndDeviceLorawanMac::SetFPort(uint8_t fPort)
+{
+    NS_ASSERT_MSG(fPort > 0 && fPort < 224, "Invalid application frame port " << unsigned(fPort));
+    m_fPort = fPort;
+}
+
 void
 BaseEndDeviceLorawanMac::SetDataRate(uint8_t dataRate)
 {
@@ -874,6 +941,26 @@ BaseEndDeviceLorawanMac::GetADRBackoff() const
     return m_enableADRBackoff;
 }
 
+void
+BaseEndDeviceLorawanMac::SetKeyStore(Ptr<LoraKeyStore> keyStore, uint32_t index)
+{
+    NS_LOG_FUNCTION(this << keyStore << index);
+    NS_ASSERT_MSG(index < keyStore->GetNDevices(), "Device not registered in the key store");
+    m_keyStore = keyStore;
+    m_keyIndex = index;
+}
+
+Ptr<LoraKeyStore>
+BaseEndDeviceLorawanMac::GetKeyStore()
+{
+    if (!m_keyStore)
+    {
+        m_keyStore = LoraKeyStore::GetDefault();
+        m_keyIndex = m_keyStore->AddDevice();
+    }
+    return m_keyStore;
+}
+
 void
 BaseEndDeviceLorawanMac::DoInitialize()
 {
@@ -893,7 +980,7 @@ BaseEndDeviceLorawanMac::DoDispose()
     m_txContext.packet = nullptr;
     m_uniformRV = nullptr;
     m_nextTx.Cancel();
-    delete m_crypto;
+    m_keyStore = nullptr;
     LorawanMac::DoDispose();
 }
 
@@ -18,11 +18,11 @@
 
 #include "lora-device-address.h"
 #include "lora-frame-header.h"
+#include "lora-key-store.h"
 #include "lorawan-mac-header.h"
 #include "lorawan-mac.h"
 #include "mac-command.h"
 
-#include "ns3/LoRaMacCrypto.h"
 #include "ns3/traced-value.h"
 
 #define ADR_ACK_LIMIT 64
@@ -46,6 +46,9 @@ class BaseEndDeviceLorawanMac : public LorawanMac
         uint8_t nbTxLeft;
         bool waitingAck = false;
         bool busy = false;
+        // Serialized PHYPayload (with MIC) of the last transmission, reused by retransmissions
+        std::vector<uint8_t> frame;
+        std::list<Ptr<MacCommand>> fOpts; //!< MAC commands serialized in the frame FOpts
     };
 
   public:
@@ -124,6 +127,13 @@ class BaseEndDeviceLorawanMac : public LorawanMac
      */
     LorawanMacHeader::FType GetFType();
 
+    /**
+     * Set the frame port of packets sent with the Send method.
+     *
+     * \param fPort The frame port, between 1 and 223 for application data.
+     */
+    void SetFPort(uint8_t fPort);
+
     /**
      * Set the data rate this end device will use when transmitting. For End
      * Devices, this value is assumed to be fixed, and can be modified via MAC
@@ -196,6 +206,17 @@ class BaseEndDeviceLorawanMac : public LorawanMac
      */
     bool GetADRBackoff() const;
 
+    /**
+     * Set the key store holding the session keys of this device.
+     *
+     * If never called, the device is registered with default keys in the
+     * default store the first time cryptography is needed.
+     *
+     * \param keyStore The key store.
+     * \param index The index of this device in the key store.
+     */
+    void SetKeyStore(Ptr<LoraKeyStore> keyStore, uint32_t index);
+
   protected:
     void DoInitialize() override;
     void DoDispose() override;
@@ -215,9 +236,12 @@ class BaseEndDeviceLorawanMac : public LorawanMac
     /**
      * Find a suitable channel for transmission. The channel is chosen among the
      * ones that are available in the ED's LogicalChannel, based on their duty
-     * cycle limitations.
+     * cycle limitations, picking uniformly at random among the ones that are
+     * available right away.
+     *
+     * \return The channel, or nullptr if none is available.
      */
-    Ptr<LogicalChannel> GetChannelForTx();
+    Ptr<const LogicalChannel> GetChannelForTx();
 
     ///////////////////////////
     // Protected MAC Actions //
@@ -336,13 +360,6 @@ class BaseEndDeviceLorawanMac : public LorawanMac
     /* Check if we need to backoff parameters after long radio silence */
     void ExecuteADRBackoff();
 
-    /**
-     * Randomly shuffle a Ptr<LogicalChannel> vector.
-     *
-     * Used to pick a random channel on which to send the packet.
-     */
-    std::vector<Ptr<LogicalChannel>> Shuffle(std::vector<Ptr<LogicalChannel>> vector);
-
     /////////////////////////////////
     //  Private MAC layer actions  //
     /////////////////////////////////
@@ -364,6 +381,18 @@ class BaseEndDeviceLorawanMac : public LorawanMac
     /* Add Message Integrity Code (4 Bytes) at the end of the packet */
     void AddMIC(Ptr<Packet> packet);
 
+    /**
+     * Prepare a retransmission reusing the frame serialized in the tx context.
+     *
+     * The fixed part of the headers (MHDR, DevAddr, FCtrl and FCnt) is patched
+     * in the cached frame and the MIC is only recomputed if these bytes
+     * changed, in which case the headers of the packet are updated as well.
+     *
+     * \param packet The packet of the previous transmission.
+     * \return False if the FOpts changed and the frame must be rebuilt.
+     */
+    bool PatchCachedFrame(Ptr<Packet> packet);
+
     /**
      * Manage the case of MAC commands being in the FRMPayload.
      *
@@ -444,6 +473,11 @@ class BaseEndDeviceLorawanMac : public LorawanMac
      */
     LorawanMacHeader::FType m_fType;
 
+    /**
+     * The frame port to apply to packets sent with the Send method.
+     */
+    uint8_t m_fPort;
+
     /**
      * The address of this device.
      */
@@ -503,9 +537,20 @@ class BaseEndDeviceLorawanMac : public LorawanMac
     ///////////////////////
 
     /**
-     * Class containing cryptographic keys and functions
+     * Get the key store of this device, registering it in the default one if
+     * no store was set.
+     */
+    Ptr<LoraKeyStore> GetKeyStore();
+
+    /**
+     * Store containing the session keys of this device
+     */
+    Ptr<LoraKeyStore> m_keyStore;
+
+    /**
+     * Index of this device in the key store
      */
-    LoRaMacCrypto* m_crypto;
+    uint32_t m_keyIndex;
 };
 
 } // namespace lorawan
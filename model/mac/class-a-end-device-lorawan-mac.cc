@@ -87,13 +87,13 @@ ClassAEndDeviceLorawanMac::SendToPhy(Ptr<Packet> packet)
 
     // Tag packet with datarate and frequency
     LoraTag tag;
-    packet->RemovePacketTag(tag); // Needed in case of retx!
+    packet->PeekPacketTag(tag); // Needed in case of retx!
     tag.SetDataRate(m_dataRate);
     tag.SetFrequency(frequency);
-    packet->AddPacketTag(tag);
+    tag.WriteTo(packet);
 
     // Get the duration
-    Time duration = m_phy->GetTimeOnAir(packet, m_txParams);
+    Time duration = LoraPhy::GetTimeOnAir(packet->GetSize(), m_txParams);
     NS_LOG_DEBUG("Duration: " << duration.GetSeconds());
     // Add the event to the channelHelper to keep track of duty cycle
     m_channelManager->AddEvent(duration, m_lastTxCh);
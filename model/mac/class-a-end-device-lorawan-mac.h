@@ -168,7 +168,7 @@ class ClassAEndDeviceLorawanMac : public BaseEndDeviceLorawanMac
     /**
      * Last channel used for tx
      */
-    Ptr<LogicalChannel> m_lastTxCh;
+    Ptr<const LogicalChannel> m_lastTxCh;
 
     /**
      * Reception window process manager.
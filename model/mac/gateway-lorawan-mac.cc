@@ -66,14 +66,14 @@ GatewayLorawanMac::Send(Ptr<Packet> packet)
     NS_LOG_DEBUG("BW: " << m_txParams.bandwidthHz << " Hz");
 
     // Find the transmission power for the desired frequency (always max possible)
-    double txPower = m_channelManager->GetTxPowerForChannel(Create<LogicalChannel>(frequency));
+    double txPower = m_channelManager->GetTxPowerForFrequency(frequency);
     NS_LOG_DEBUG("Freq: " << frequency << " Hz");
 
     // Get the duration
-    Time duration = m_phy->GetTimeOnAir(packet, m_txParams);
+    Time duration = LoraPhy::GetTimeOnAir(packet->GetSize(), m_txParams);
     NS_LOG_DEBUG("Duration: " << duration.GetSeconds());
     // Add the event to the channelHelper to keep track of duty cycle
-    m_channelManager->AddEvent(duration, Create<LogicalChannel>(frequency));
+    m_channelManager->AddEvent(duration, frequency);
 
     // Send the packet to the PHY layer to send it on the channel
     m_phy->Send(packet, m_txParams, frequency, txPower);
@@ -133,7 +133,7 @@ GatewayLorawanMac::GetWaitingTime(double frequency)
 {
     NS_LOG_FUNCTION_NOARGS();
 
-    return m_channelManager->GetWaitingTime(Create<LogicalChannel>(frequency));
+    return m_channelManager->GetWaitingTime(frequency);
 }
 } // namespace lorawan
 } // namespace ns3
@@ -35,7 +35,9 @@ LogicalChannelManager::GetTypeId()
 }
 
 LogicalChannelManager::LogicalChannelManager()
-    : m_lastTxDuration(0),
+    : m_plan(Create<RegionalChannelPlan>()),
+      m_enabledMask(0),
+      m_lastTxDuration(0),
       m_lastTxStart(0)
 {
     NS_LOG_FUNCTION(this);
@@ -46,62 +48,64 @@ LogicalChannelManager::~LogicalChannelManager()
     NS_LOG_FUNCTION(this);
 }
 
-std::vector<Ptr<LogicalChannel>>
+std::vector<Ptr<const LogicalChannel>>
 LogicalChannelManager::GetChannelList()
 {
     NS_LOG_FUNCTION(this);
 
-    std::vector<Ptr<LogicalChannel>> vector;
-    vector.reserve(m_channelList.size());
-    for (auto& llc : m_channelList)
+    std::vector<Ptr<const LogicalChannel>> vector;
+    vector.reserve(RegionalChannelPlan::MAX_CHANNELS);
+    for (uint8_t i = 0; i < RegionalChannelPlan::MAX_CHANNELS; i++)
     {
-        vector.push_back(llc.second);
+        if (auto llc = m_plan->GetChannel(i); bool(llc))
+        {
+            vector.push_back(llc);
+        }
     }
 
     return vector;
 }
 
-std::vector<Ptr<LogicalChannel>>
+std::vector<Ptr<const LogicalChannel>>
 LogicalChannelManager::GetEnabledChannelList()
 {
     NS_LOG_FUNCTION(this);
 
-    std::vector<Ptr<LogicalChannel>> vector;
-    for (auto& llc : m_channelList)
+    std::vector<Ptr<const LogicalChannel>> vector;
+    vector.reserve(RegionalChannelPlan::MAX_CHANNELS);
+    for (uint8_t i = 0; i < RegionalChannelPlan::MAX_CHANNELS; i++)
     {
-        if (llc.second->IsEnabledForUplink())
+        if (m_enabledMask & (1 << i))
         {
-            vector.push_back(llc.second);
+            vector.push_back(m_plan->GetChannel(i));
         }
     }
 
     return vector;
 }
 
-Ptr<LogicalChannel>
+Ptr<const LogicalChannel>
 LogicalChannelManager::GetChannel(uint8_t chIndex)
 {
     NS_LOG_FUNCTION(this);
 
-    return (m_channelList.count(chIndex)) ? m_channelList.at(chIndex) : nullptr;
+    return m_plan->GetChannel(chIndex);
 }
 
-Ptr<SubBand>
-LogicalChannelManager::GetSubBandFromChannel(const Ptr<LogicalChannel> channel)
+Ptr<const SubBand>
+LogicalChannelManager::GetSubBandFromChannel(const Ptr<const LogicalChannel> channel)
 {
-    return GetSubBandFromFrequency(channel->GetFrequency());
+    return m_plan->GetSubBand(GetSubBandIndex(channel));
 }
 
-Ptr<SubBand>
+Ptr<const SubBand>
 LogicalChannelManager::GetSubBandFromFrequency(double frequency)
 {
     // Get the SubBand this frequency belongs to
-    for (auto& sub : m_subBandList)
+    uint8_t index = m_plan->GetSubBandIndexFromFrequency(frequency);
+    if (index != RegionalChannelPlan::NO_SUBBAND)
     {
-        if (sub->BelongsToSubBand(frequency))
-        {
-            return sub;
-        }
+        return m_plan->GetSubBand(index);
     }
 
     NS_LOG_ERROR("Requested frequency: " << frequency);
@@ -114,7 +118,16 @@ void
 LogicalChannelManager::AddChannel(uint8_t chIndex, Ptr<LogicalChannel> logicalChannel)
 {
     NS_LOG_FUNCTION(this << (unsigned)chIndex << logicalChannel);
-    m_channelList[chIndex] = logicalChannel;
+    MakePlanUnique();
+    m_plan->SetChannel(chIndex, logicalChannel);
+    if (logicalChannel->IsEnabledForUplink())
+    {
+        m_enabledMask |= (1 << chIndex);
+    }
+    else
+    {
+        m_enabledMask &= ~(1 << chIndex);
+    }
 }
 
 void
@@ -134,7 +147,11 @@ LogicalChannelManager::SetReplyFrequency(uint8_t chIndex, double replyFrequency)
     NS_LOG_FUNCTION(this << (unsigned)chIndex << replyFrequency);
     auto channel = GetChannel(chIndex);
     NS_ASSERT_MSG(bool(channel), "Selected uplink channel does not exist");
-    channel->SetReplyFrequency(replyFrequency);
+    // Channels of the plan may be shared, change a copy
+    MakePlanUnique();
+    auto copy = Create<LogicalChannel>(*channel);
+    copy->SetReplyFrequency(replyFrequency);
+    m_plan->SetChannel(chIndex, copy);
 }
 
 void
@@ -142,14 +159,18 @@ LogicalChannelManager::AddSubBand(Ptr<SubBand> subBand)
 {
     NS_LOG_FUNCTION(this << subBand);
 
-    m_subBandList.push_back(subBand);
+    MakePlanUnique();
+    m_plan->AddSubBand(subBand);
+    m_nextTransmissionTime.push_back(Time(0));
 }
 
 void
 LogicalChannelManager::RemoveChannel(uint8_t chIndex)
 {
     // Search and remove the channel from the list
-    m_channelList.erase(chIndex);
+    MakePlanUnique();
+    m_plan->RemoveChannel(chIndex);
+    m_enabledMask &= ~(1 << chIndex);
 }
 
 Time
@@ -172,13 +193,13 @@ LogicalChannelManager::GetAggregatedWaitingTime(double aggregatedDutyCycle)
 }
 
 Time
-LogicalChannelManager::GetWaitingTime(const Ptr<LogicalChannel> channel)
+LogicalChannelManager::GetWaitingTime(const Ptr<const LogicalChannel> channel)
 {
     NS_LOG_FUNCTION(this << channel);
 
     // SubBand waiting time
     Time subBandWaitingTime =
-        GetSubBandFromChannel(channel)->GetNextTransmissionTime() - Simulator::Now();
+        m_nextTransmissionTime[GetSubBandIndex(channel)] - Simulator::Now();
 
     // Handle case in which waiting time is negative
     subBandWaitingTime = Max(subBandWaitingTime, Seconds(0));
@@ -188,58 +209,178 @@ LogicalChannelManager::GetWaitingTime(const Ptr<LogicalChannel> channel)
     return subBandWaitingTime;
 }
 
+Time
+LogicalChannelManager::GetWaitingTime(double frequency)
+{
+    NS_LOG_FUNCTION(this << frequency);
+
+    // SubBand waiting time
+    Time subBandWaitingTime =
+        Max(m_nextTransmissionTime[GetSubBandIndex(frequency)] - Simulator::Now(), Seconds(0));
+
+    NS_LOG_DEBUG("Waiting time: " << subBandWaitingTime.GetSeconds());
+
+    return subBandWaitingTime;
+}
+
+Time
+LogicalChannelManager::GetMinWaitingTime()
+{
+    NS_LOG_FUNCTION(this);
+
+    // Earliest next transmission time among SubBands of enabled channels
+    Time nextTransmissionTime = Time::Max();
+    for (uint8_t i = 0; i < RegionalChannelPlan::MAX_CHANNELS; i++)
+    {
+        if (m_enabledMask & (1 << i))
+        {
+            uint8_t index = m_plan->GetSubBandIndex(i);
+            NS_ABORT_MSG_IF(index == RegionalChannelPlan::NO_SUBBAND,
+                            "Logical channel doesn't belong to a known SubBand");
+            nextTransmissionTime = Min(nextTransmissionTime, m_nextTransmissionTime[index]);
+        }
+    }
+
+    if (nextTransmissionTime == Time::Max())
+    {
+        return nextTransmissionTime;
+    }
+    Time waitingTime = Max(nextTransmissionTime - Simulator::Now(), Seconds(0));
+
+    NS_LOG_DEBUG("Minimum waiting time: " << waitingTime.GetSeconds());
+
+    return waitingTime;
+}
+
 void
-LogicalChannelManager::AddEvent(Time duration, Ptr<LogicalChannel> channel)
+LogicalChannelManager::AddEvent(Time duration, Ptr<const LogicalChannel> channel)
 {
     NS_LOG_FUNCTION(this << duration << channel);
 
-    auto subBand = GetSubBandFromChannel(channel);
+    RegisterTransmission(duration, GetSubBandIndex(channel));
+}
+
+void
+LogicalChannelManager::AddEvent(Time duration, double frequency)
+{
+    NS_LOG_FUNCTION(this << duration << frequency);
+
+    RegisterTransmission(duration, GetSubBandIndex(frequency));
+}
 
-    double dutyCycle = subBand->GetDutyCycle();
+void
+LogicalChannelManager::RegisterTransmission(Time duration, uint8_t index)
+{
+    double dutyCycle = m_plan->GetSubBand(index)->GetDutyCycle();
     m_lastTxDuration = duration;
     // Events need to be registered before starting tx!
     m_lastTxStart = Simulator::Now();
 
     // Computation of necessary waiting time on this sub-band
-    subBand->SetNextTransmissionTime(Simulator::Now() + duration / dutyCycle);
+    m_nextTransmissionTime[index] = Simulator::Now() + duration / dutyCycle;
 
     NS_LOG_DEBUG("Time on air: " << m_lastTxDuration.As(Time::MS));
     NS_LOG_DEBUG("Current time: " << Simulator::Now().As(Time::S));
     NS_LOG_DEBUG("Next transmission on this sub-band allowed at time: "
-                 << (subBand->GetNextTransmissionTime()).As(Time::S));
+                 << m_nextTransmissionTime[index].As(Time::S));
 }
 
 double
-LogicalChannelManager::GetTxPowerForChannel(Ptr<LogicalChannel> logicalChannel)
+LogicalChannelManager::GetTxPowerForChannel(Ptr<const LogicalChannel> logicalChannel)
 {
     NS_LOG_FUNCTION_NOARGS();
 
     // Get the maxTxPowerDbm from the SubBand this channel is in
-    for (const auto& sub : m_subBandList)
+    return m_plan->GetSubBand(GetSubBandIndex(logicalChannel))->GetMaxTxPowerDbm();
+}
+
+double
+LogicalChannelManager::GetTxPowerForFrequency(double frequency)
+{
+    NS_LOG_FUNCTION(this << frequency);
+
+    return m_plan->GetSubBand(GetSubBandIndex(frequency))->GetMaxTxPowerDbm();
+}
+
+void
+LogicalChannelManager::DisableChannel(uint8_t chIndex)
+{
+    NS_LOG_FUNCTION(this << (unsigned)chIndex);
+    NS_ASSERT_MSG(bool(m_plan->GetChannel(chIndex)), "Channel does not exist");
+    m_enabledMask &= ~(1 << chIndex);
+}
+
+void
+LogicalChannelManager::EnableChannel(uint8_t chIndex)
+{
+    NS_LOG_FUNCTION(this << (unsigned)chIndex);
+    NS_ASSERT_MSG(bool(m_plan->GetChannel(chIndex)), "Channel does not exist");
+    m_enabledMask |= (1 << chIndex);
+}
+
+uint16_t
+LogicalChannelManager::GetEnabledChannelMask() const
+{
+    return m_enabledMask;
+}
+
+void
+LogicalChannelManager::SetChannelPlan(Ptr<RegionalChannelPlan> plan)
+{
+    NS_LOG_FUNCTION(this << plan);
+
+    m_plan = plan;
+    m_enabledMask = 0;
+    for (uint8_t i = 0; i < RegionalChannelPlan::MAX_CHANNELS; i++)
     {
-        // Check whether this channel is in this SubBand
-        if (sub->BelongsToSubBand(logicalChannel->GetFrequency()))
+        if (auto llc = m_plan->GetChannel(i); bool(llc) && llc->IsEnabledForUplink())
         {
-            return sub->GetMaxTxPowerDbm();
+            m_enabledMask |= (1 << i);
         }
     }
+    m_nextTransmissionTime.assign(m_plan->GetNSubBands(), Time(0));
+}
 
-    NS_ABORT_MSG("Logical channel doesn't belong to a known SubBand");
+Ptr<const RegionalChannelPlan>
+LogicalChannelManager::GetChannelPlan() const
+{
+    return m_plan;
 }
 
 void
-LogicalChannelManager::DisableChannel(uint8_t chIndex)
+LogicalChannelManager::MakePlanUnique()
 {
-    NS_LOG_FUNCTION(this << (unsigned)chIndex);
-    m_channelList.at(chIndex)->DisableForUplink();
+    if (m_plan->GetReferenceCount() > 1)
+    {
+        NS_LOG_DEBUG("Copying shared channel plan before modification");
+        m_plan = Create<RegionalChannelPlan>(*m_plan);
+    }
+}
+
+uint8_t
+LogicalChannelManager::GetSubBandIndex(const Ptr<const LogicalChannel>& channel) const
+{
+    uint8_t index = m_plan->GetSubBandIndex(channel);
+    NS_ABORT_MSG_IF(index == RegionalChannelPlan::NO_SUBBAND,
+                    "Logical channel doesn't belong to a known SubBand");
+    return index;
+}
+
+uint8_t
+LogicalChannelManager::GetSubBandIndex(double frequency) const
+{
+    uint8_t index = m_plan->GetSubBandIndexFromFrequency(frequency);
+    NS_ABORT_MSG_IF(index == RegionalChannelPlan::NO_SUBBAND,
+                    "Frequency " << frequency << " doesn't belong to a known SubBand");
+    return index;
 }
 
 void
 LogicalChannelManager::DoDispose()
 {
     NS_LOG_FUNCTION(this);
-    m_subBandList.clear();
-    m_channelList.clear();
+    m_plan = nullptr;
+    m_nextTransmissionTime.clear();
     Object::DoDispose();
 }
 
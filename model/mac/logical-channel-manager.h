@@ -14,15 +14,13 @@
 #define LOGICAL_CHANNEL_MANAGER_H
 
 #include "logical-channel.h"
+#include "regional-channel-plan.h"
 #include "sub-band.h"
 
 #include "ns3/nstime.h"
 #include "ns3/object.h"
 #include "ns3/packet.h"
 
-#include <iterator>
-#include <list>
-#include <map>
 #include <vector>
 
 namespace ns3
@@ -35,9 +33,15 @@ namespace lorawan
  * channels that the device is supposed to be using, and establishes their
  * relationship with SubBands.
  *
- * This class also takes into account duty cycle limitations, by updating a list
- * of SubBand objects and providing methods to query whether transmission on a
- * set channel is admissible or not.
+ * This class also takes into account duty cycle limitations, by keeping the
+ * next allowed transmission time of each SubBand and providing methods to
+ * query whether transmission on a set channel is admissible or not.
+ *
+ * Channels and SubBands are described by a RegionalChannelPlan that can be
+ * shared by all devices of a region. The plan is copied the first time this
+ * manager modifies it, while the per-device state is restricted to a bitmask
+ * of the channels enabled for uplink and to the SubBands' next transmission
+ * times.
  */
 class LogicalChannelManager : public Object
 {
@@ -68,7 +72,25 @@ class LogicalChannelManager : public Object
      * \return A Time instance containing the waiting time before transmission is
      * allowed on the channel.
      */
-    Time GetWaitingTime(const Ptr<LogicalChannel> channel);
+    Time GetWaitingTime(const Ptr<const LogicalChannel> channel);
+
+    /**
+     * Get the time it is necessary to wait for before transmitting on a given
+     * frequency, without the need of a channel instance.
+     *
+     * \param frequency The frequency (Hz) we want to know the waiting time for.
+     * \return A Time instance containing the waiting time before transmission is
+     * allowed on the frequency.
+     */
+    Time GetWaitingTime(double frequency);
+
+    /**
+     * Get the minimum time it is necessary to wait for before transmitting on
+     * any of the channels enabled for uplink.
+     * \remark This function does not take into account aggregate waiting time.
+     * \return The waiting time, Time::Max () if no channel is enabled.
+     */
+    Time GetMinWaitingTime();
 
     /**
      * Preemptively register the transmission of a packet.
@@ -76,14 +98,23 @@ class LogicalChannelManager : public Object
      * \param duration The duration of the transmission event.
      * \param channel The channel the transmission is made on.
      */
-    void AddEvent(Time duration, Ptr<LogicalChannel> channel);
+    void AddEvent(Time duration, Ptr<const LogicalChannel> channel);
+
+    /**
+     * Preemptively register the transmission of a packet, without the need of
+     * a channel instance.
+     *
+     * \param duration The duration of the transmission event.
+     * \param frequency The frequency (Hz) the transmission is made on.
+     */
+    void AddEvent(Time duration, double frequency);
 
     /**
      * Get the list of LogicalChannels currently registered on this helper.
      *
      * \return A list of the managed channels.
      */
-    std::vector<Ptr<LogicalChannel>> GetChannelList();
+    std::vector<Ptr<const LogicalChannel>> GetChannelList();
 
     /**
      * Get the list of LogicalChannels currently registered on this helper
@@ -91,14 +122,18 @@ class LogicalChannelManager : public Object
      *
      * \return A list of the managed channels enabled for Uplink transmission.
      */
-    std::vector<Ptr<LogicalChannel>> GetEnabledChannelList();
+    std::vector<Ptr<const LogicalChannel>> GetEnabledChannelList();
 
     /**
      *  Get a pointer to the LogicalChannel at a certain index.
      *
+     *  The channel may be shared with other managers, so it can only be
+     *  changed through the methods of this class.
+     *
      *  \param chIndex The index of the channel to get.
+     *  \return The channel, or nullptr if no channel is defined at this index.
      */
-    Ptr<LogicalChannel> GetChannel(uint8_t chIndex);
+    Ptr<const LogicalChannel> GetChannel(uint8_t chIndex);
 
     /**
      * Add a new channel at a fixed index.
@@ -151,7 +186,16 @@ class LogicalChannelManager : public Object
      * transmission power.
      * \return The power in dBm.
      */
-    double GetTxPowerForChannel(Ptr<LogicalChannel> logicalChannel);
+    double GetTxPowerForChannel(Ptr<const LogicalChannel> logicalChannel);
+
+    /**
+     * Returns the maximum transmission power [dBm] that is allowed on a
+     * frequency, without the need of a channel instance.
+     *
+     * \param frequency The frequency (Hz).
+     * \return The power in dBm.
+     */
+    double GetTxPowerForFrequency(double frequency);
 
     /**
      * Get the SubBand a channel belongs to.
@@ -159,7 +203,7 @@ class LogicalChannelManager : public Object
      * \param channel The channel whose SubBand we want to get.
      * \return The SubBand the channel belongs to.
      */
-    Ptr<SubBand> GetSubBandFromChannel(const Ptr<LogicalChannel> channel);
+    Ptr<const SubBand> GetSubBandFromChannel(const Ptr<const LogicalChannel> channel);
 
     /**
      * Get the SubBand a frequency belongs to.
@@ -167,7 +211,7 @@ class LogicalChannelManager : public Object
      * \param frequency The frequency we want to check.
      * \return The SubBand the frequency belongs to.
      */
-    Ptr<SubBand> GetSubBandFromFrequency(double frequency);
+    Ptr<const SubBand> GetSubBandFromFrequency(double frequency);
 
     /**
      * Disable the channel at a specified index.
@@ -176,21 +220,81 @@ class LogicalChannelManager : public Object
      */
     void DisableChannel(uint8_t chIndex);
 
+    /**
+     * Enable the channel at a specified index.
+     *
+     * \param chIndex The index of the channel to enable.
+     */
+    void EnableChannel(uint8_t chIndex);
+
+    /**
+     * Get the bitmask of the channels enabled for uplink.
+     *
+     * \return The bitmask (bit i set if channel i is enabled).
+     */
+    uint16_t GetEnabledChannelMask() const;
+
+    /**
+     * Use a channel plan, possibly shared with other managers.
+     *
+     * Channels of the plan that are enabled for uplink are enabled, and duty
+     * cycle state is reset.
+     *
+     * \param plan The channel plan.
+     */
+    void SetChannelPlan(Ptr<RegionalChannelPlan> plan);
+
+    /**
+     * Get the channel plan in use.
+     *
+     * \return The channel plan.
+     */
+    Ptr<const RegionalChannelPlan> GetChannelPlan() const;
+
   protected:
     void DoDispose() override;
 
   private:
     /**
-     * A list of the SubBands that are currently registered within this helper.
+     * Make sure the plan is not shared with other managers before modifying it.
+     */
+    void MakePlanUnique();
+
+    /**
+     * Get the index of the SubBand of a channel, aborting if there is none.
+     * \param channel The channel.
+     * \return The SubBand index in the plan.
+     */
+    uint8_t GetSubBandIndex(const Ptr<const LogicalChannel>& channel) const;
+
+    /**
+     * Get the index of the SubBand of a frequency, aborting if there is none.
+     * \param frequency The frequency (Hz).
+     * \return The SubBand index in the plan.
+     */
+    uint8_t GetSubBandIndex(double frequency) const;
+
+    /**
+     * Register the transmission of a packet in a SubBand.
+     * \param duration The duration of the transmission event.
+     * \param index The SubBand index in the plan.
+     */
+    void RegisterTransmission(Time duration, uint8_t index);
+
+    /**
+     * The channels and SubBands this manager uses, possibly shared.
+     */
+    Ptr<RegionalChannelPlan> m_plan;
+
+    /**
+     * The channels enabled for uplink. This represents the node's channel mask.
      */
-    std::list<Ptr<SubBand>> m_subBandList;
+    uint16_t m_enabledMask;
 
     /**
-     * A vector of the LogicalChannels that are currently registered within
-     * this helper. This vector represents the node's channel mask. The first N
-     * channels are the default ones for a fixed region.
+     * The next time a transmission will be allowed in each SubBand of the plan.
      */
-    std::map<uint8_t, Ptr<LogicalChannel>> m_channelList;
+    std::vector<Time> m_nextTransmissionTime;
 
     Time m_lastTxDuration; //!< Duration of the last frame (seconds).
 
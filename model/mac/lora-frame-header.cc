@@ -33,13 +33,13 @@ LoraFrameHeader::LoraFrameHeader()
       m_fPending(false),
       m_fOptsLen(0),
       m_fCnt(0),
+      m_nCommands(0),
       m_frmpCmdsLen(0)
 {
 }
 
 LoraFrameHeader::~LoraFrameHeader()
 {
-    m_macCommands.clear();
 }
 
 TypeId
@@ -94,11 +94,10 @@ LoraFrameHeader::Serialize(Buffer::Iterator start) const
     start.WriteU16(m_fCnt);
 
     // FOpts field
-    for (auto it = m_macCommands.begin(); it != m_macCommands.end(); it++)
-    {
+    VisitCommands([&start](const auto& cmd) {
         NS_LOG_DEBUG("Serializing a MAC command");
-        (*it)->Serialize(start);
-    }
+        cmd.Serialize(start);
+    });
 
     // FPort
     if (m_fPort > -1 && !m_frmpCmdsLen)
@@ -126,7 +125,8 @@ LoraFrameHeader::Deserialize(Buffer::Iterator start)
     NS_LOG_FUNCTION_NOARGS();
 
     // Empty the list of MAC commands
-    m_macCommands.clear();
+    m_nCommands = 0;
+    m_moreCommands.clear();
 
     // Read from buffer and save into local variables
     m_address.Set(start.ReadU32());
@@ -151,7 +151,7 @@ LoraFrameHeader::Deserialize(Buffer::Iterator start)
 
     // Deserialize MAC commands
     NS_LOG_DEBUG("Starting deserialization of MAC commands");
-    for (uint8_t byteNumber = 0; byteNumber < m_fOptsLen + m_frmpCmdsLen;)
+    for (uint16_t byteNumber = 0; byteNumber < m_fOptsLen + m_frmpCmdsLen;)
     {
         uint8_t cid = start.PeekU8();
         NS_LOG_DEBUG("CID: " << unsigned(cid));
@@ -168,65 +168,47 @@ LoraFrameHeader::Deserialize(Buffer::Iterator start)
             // request for a link check
             case (0x02): {
                 NS_LOG_DEBUG("Creating a LinkCheckReq command");
-                Ptr<LinkCheckReq> command = Create<LinkCheckReq>();
-                byteNumber += command->Deserialize(start);
-                m_macCommands.emplace_back(command);
+                byteNumber += DeserializeCommand<LinkCheckReq>(start);
                 break;
             }
             case (0x03): {
                 NS_LOG_DEBUG("Creating a LinkAdrAns command");
-                Ptr<LinkAdrAns> command = Create<LinkAdrAns>();
-                byteNumber += command->Deserialize(start);
-                m_macCommands.emplace_back(command);
+                byteNumber += DeserializeCommand<LinkAdrAns>(start);
                 break;
             }
             case (0x04): {
                 NS_LOG_DEBUG("Creating a DutyCycleAns command");
-                Ptr<DutyCycleAns> command = Create<DutyCycleAns>();
-                byteNumber += command->Deserialize(start);
-                m_macCommands.emplace_back(command);
+                byteNumber += DeserializeCommand<DutyCycleAns>(start);
                 break;
             }
             case (0x05): {
                 NS_LOG_DEBUG("Creating a RxParamSetupAns command");
-                Ptr<RxParamSetupAns> command = Create<RxParamSetupAns>();
-                byteNumber += command->Deserialize(start);
-                m_macCommands.emplace_back(command);
+                byteNumber += DeserializeCommand<RxParamSetupAns>(start);
                 break;
             }
             case (0x06): {
                 NS_LOG_DEBUG("Creating a DevStatusAns command");
-                Ptr<DevStatusAns> command = Create<DevStatusAns>();
-                byteNumber += command->Deserialize(start);
-                m_macCommands.emplace_back(command);
+                byteNumber += DeserializeCommand<DevStatusAns>(start);
                 break;
             }
             case (0x07): {
                 NS_LOG_DEBUG("Creating a NewChannelAns command");
-                Ptr<NewChannelAns> command = Create<NewChannelAns>();
-                byteNumber += command->Deserialize(start);
-                m_macCommands.emplace_back(command);
+                byteNumber += DeserializeCommand<NewChannelAns>(start);
                 break;
             }
             case (0x08): {
                 NS_LOG_DEBUG("Creating a RxTimingSetupAns command");
-                Ptr<RxTimingSetupAns> command = Create<RxTimingSetupAns>();
-                byteNumber += command->Deserialize(start);
-                m_macCommands.emplace_back(command);
+                byteNumber += DeserializeCommand<RxTimingSetupAns>(start);
                 break;
             }
             case (0x09): {
                 NS_LOG_DEBUG("Creating a TxParamSetupAns command");
-                Ptr<TxParamSetupAns> command = Create<TxParamSetupAns>();
-                byteNumber += command->Deserialize(start);
-                m_macCommands.emplace_back(command);
+                byteNumber += DeserializeCommand<TxParamSetupAns>(start);
                 break;
             }
             case (0x0A): {
                 NS_LOG_DEBUG("Creating a DlChannelAns command");
-                Ptr<DlChannelAns> command = Create<DlChannelAns>();
-                byteNumber += command->Deserialize(start);
-                m_macCommands.emplace_back(command);
+                byteNumber += DeserializeCommand<DlChannelAns>(start);
                 break;
             }
             default: {
@@ -242,65 +224,47 @@ LoraFrameHeader::Deserialize(Buffer::Iterator start)
             // answer to a link check
             case (0x02): {
                 NS_LOG_DEBUG("Creating a LinkCheckAns command");
-                Ptr<LinkCheckAns> command = Create<LinkCheckAns>();
-                byteNumber += command->Deserialize(start);
-                m_macCommands.emplace_back(command);
+                byteNumber += DeserializeCommand<LinkCheckAns>(start);
                 break;
             }
             case (0x03): {
                 NS_LOG_DEBUG("Creating a LinkAdrReq command");
-                Ptr<LinkAdrReq> command = Create<LinkAdrReq>();
-                byteNumber += command->Deserialize(start);
-                m_macCommands.emplace_back(command);
+                byteNumber += DeserializeCommand<LinkAdrReq>(start);
                 break;
             }
             case (0x04): {
                 NS_LOG_DEBUG("Creating a DutyCycleReq command");
-                Ptr<DutyCycleReq> command = Create<DutyCycleReq>();
-                byteNumber += command->Deserialize(start);
-                m_macCommands.emplace_back(command);
+                byteNumber += DeserializeCommand<DutyCycleReq>(start);
                 break;
             }
             case (0x05): {
                 NS_LOG_DEBUG("Creating a RxParamSetupReq command");
-                Ptr<RxParamSetupReq> command = Create<RxParamSetupReq>();
-                byteNumber += command->Deserialize(start);
-                m_macCommands.emplace_back(command);
+                byteNumber += DeserializeCommand<RxParamSetupReq>(start);
                 break;
             }
             case (0x06): {
                 NS_LOG_DEBUG("Creating a DevStatusReq command");
-                Ptr<DevStatusReq> command = Create<DevStatusReq>();
-                byteNumber += command->Deserialize(start);
-                m_macCommands.emplace_back(command);
+                byteNumber += DeserializeCommand<DevStatusReq>(start);
                 break;
             }
             case (0x07): {
                 NS_LOG_DEBUG("Creating a NewChannelReq command");
-                Ptr<NewChannelReq> command = Create<NewChannelReq>();
-                byteNumber += command->Deserialize(start);
-                m_macCommands.emplace_back(command);
+                byteNumber += DeserializeCommand<NewChannelReq>(start);
                 break;
             }
             case (0x08): {
                 NS_LOG_DEBUG("Creating a RxTimingSetupReq command");
-                Ptr<RxTimingSetupReq> command = Create<RxTimingSetupReq>();
-                byteNumber += command->Deserialize(start);
-                m_macCommands.emplace_back(command);
+                byteNumber += DeserializeCommand<RxTimingSetupReq>(start);
                 break;
             }
             case (0x09): {
                 NS_LOG_DEBUG("Creating a TxParamSetupReq command");
-                Ptr<TxParamSetupReq> command = Create<TxParamSetupReq>();
-                byteNumber += command->Deserialize(start);
-                m_macCommands.emplace_back(command);
+                byteNumber += DeserializeCommand<TxParamSetupReq>(start);
                 break;
             }
             case (0x0A): {
                 NS_LOG_DEBUG("Creating a DlChannelReq command");
-                Ptr<DlChannelReq> command = Create<DlChannelReq>();
-                byteNumber += command->Deserialize(start);
-                m_macCommands.emplace_back(command);
+                byteNumber += DeserializeCommand<DlChannelReq>(start);
                 break;
             }
             default: {
@@ -343,10 +307,7 @@ LoraFrameHeader::Print(std::ostream& os) const
     os << "(FRMPCmdsLen=" << unsigned(m_frmpCmdsLen) << ")" << std::endl;
     os << "FCnt=" << unsigned(m_fCnt) << std::endl;
 
-    for (auto it = m_macCommands.begin(); it != m_macCommands.end(); it++)
-    {
-        (*it)->Print(os);
-    }
+    VisitCommands([&os](const auto& cmd) { cmd.Print(os); });
 
     if (m_fPort > -1)
     {
@@ -451,11 +412,7 @@ LoraFrameHeader::GetFOptsLen() const
 {
     // Sum the serialized lenght of all commands in the list
     uint8_t fOptsLen = 0;
-    std::list<Ptr<MacCommand>>::const_iterator it;
-    for (it = m_macCommands.begin(); it != m_macCommands.end(); it++)
-    {
-        fOptsLen = fOptsLen + (*it)->GetSerializedSize();
-    }
+    VisitCommands([&fOptsLen](const auto& cmd) { fOptsLen += cmd.GetSerializedSize(); });
     return fOptsLen;
 }
 
@@ -482,11 +439,7 @@ LoraFrameHeader::AddLinkCheckReq()
 {
     NS_LOG_FUNCTION_NOARGS();
 
-    Ptr<LinkCheckReq> command = Create<LinkCheckReq>();
-    m_macCommands.emplace_back(command);
-
-    NS_LOG_DEBUG("Command SerializedSize: " << unsigned(command->GetSerializedSize()));
-    m_fOptsLen += command->GetSerializedSize();
+    AddCommand(LinkCheckReq());
 }
 
 void
@@ -494,10 +447,7 @@ LoraFrameHeader::AddLinkCheckAns(uint8_t margin, uint8_t gwCnt)
 {
     NS_LOG_FUNCTION(this << unsigned(margin) << unsigned(gwCnt));
 
-    Ptr<LinkCheckAns> command = Create<LinkCheckAns>(margin, gwCnt);
-    m_macCommands.emplace_back(command);
-
-    m_fOptsLen += command->GetSerializedSize();
+    AddCommand(LinkCheckAns(margin, gwCnt));
 }
 
 void
@@ -521,10 +471,7 @@ LoraFrameHeader::AddLinkAdrReq(uint8_t dataRate,
     NS_LOG_DEBUG("Creating LinkAdrReq with: DR = " << unsigned(dataRate)
                                                    << " and txPower = " << unsigned(txPower));
 
-    Ptr<LinkAdrReq> command = Create<LinkAdrReq>(dataRate, txPower, channelMask, 0, repetitions);
-    m_macCommands.emplace_back(command);
-
-    m_fOptsLen += command->GetSerializedSize();
+    AddCommand(LinkAdrReq(dataRate, txPower, channelMask, 0, repetitions));
 }
 
 void
@@ -532,10 +479,7 @@ LoraFrameHeader::AddLinkAdrAns(bool powerAck, bool dataRateAck, bool channelMask
 {
     NS_LOG_FUNCTION(this << powerAck << dataRateAck << channelMaskAck);
 
-    Ptr<LinkAdrAns> command = Create<LinkAdrAns>(powerAck, dataRateAck, channelMaskAck);
-    m_macCommands.emplace_back(command);
-
-    m_fOptsLen += command->GetSerializedSize();
+    AddCommand(LinkAdrAns(powerAck, dataRateAck, channelMaskAck));
 }
 
 void
@@ -543,11 +487,7 @@ LoraFrameHeader::AddDutyCycleReq(uint8_t dutyCycle)
 {
     NS_LOG_FUNCTION(this << unsigned(dutyCycle));
 
-    Ptr<DutyCycleReq> command = Create<DutyCycleReq>(dutyCycle);
-
-    m_macCommands.emplace_back(command);
-
-    m_fOptsLen += command->GetSerializedSize();
+    AddCommand(DutyCycleReq(dutyCycle));
 }
 
 void
@@ -555,11 +495,7 @@ LoraFrameHeader::AddDutyCycleAns()
 {
     NS_LOG_FUNCTION(this);
 
-    Ptr<DutyCycleAns> command = Create<DutyCycleAns>();
-
-    m_macCommands.emplace_back(command);
-
-    m_fOptsLen += command->GetSerializedSize();
+    AddCommand(DutyCycleAns());
 }
 
 void
@@ -570,11 +506,7 @@ LoraFrameHeader::AddRxParamSetupReq(uint8_t rx1DrOffset, uint8_t rx2DataRate, do
     // Evaluate whether to eliminate this assert in case new offsets can be defined.
     NS_ASSERT(0 <= rx1DrOffset && rx1DrOffset <= 5);
 
-    Ptr<RxParamSetupReq> command = Create<RxParamSetupReq>(rx1DrOffset, rx2DataRate, frequency);
-
-    m_macCommands.emplace_back(command);
-
-    m_fOptsLen += command->GetSerializedSize();
+    AddCommand(RxParamSetupReq(rx1DrOffset, rx2DataRate, frequency));
 }
 
 void
@@ -582,11 +514,7 @@ LoraFrameHeader::AddRxParamSetupAns()
 {
     NS_LOG_FUNCTION(this);
 
-    Ptr<RxParamSetupAns> command = Create<RxParamSetupAns>();
-
-    m_macCommands.emplace_back(command);
-
-    m_fOptsLen += command->GetSerializedSize();
+    AddCommand(RxParamSetupAns());
 }
 
 void
@@ -594,11 +522,7 @@ LoraFrameHeader::AddDevStatusReq()
 {
     NS_LOG_FUNCTION(this);
 
-    Ptr<DevStatusReq> command = Create<DevStatusReq>();
-
-    m_macCommands.emplace_back(command);
-
-    m_fOptsLen += command->GetSerializedSize();
+    AddCommand(DevStatusReq());
 }
 
 void
@@ -609,20 +533,26 @@ LoraFrameHeader::AddNewChannelReq(uint8_t chIndex,
 {
     NS_LOG_FUNCTION(this);
 
-    Ptr<NewChannelReq> command =
-        Create<NewChannelReq>(chIndex, frequency, minDataRate, maxDataRate);
-
-    m_macCommands.emplace_back(command);
+    AddCommand(NewChannelReq(chIndex, frequency, minDataRate, maxDataRate));
+}
 
-    m_fOptsLen += command->GetSerializedSize();
+uint16_t
+LoraFrameHeader::GetNCommands() const
+{
+    return m_nCommands;
 }
 
 std::list<Ptr<MacCommand>>
-LoraFrameHeader::GetCommands()
+LoraFrameHeader::GetCommands() const
 {
     NS_LOG_FUNCTION_NOARGS();
 
-    return m_macCommands;
+    std::list<Ptr<MacCommand>> commands;
+    VisitCommands([&commands](const auto& cmd) {
+        using T = std::decay_t<decltype(cmd)>;
+        commands.emplace_back(Create<T>(cmd));
+    });
+    return commands;
 }
 
 void
@@ -630,8 +560,86 @@ LoraFrameHeader::AddCommand(Ptr<MacCommand> macCommand)
 {
     NS_LOG_FUNCTION(this << macCommand);
 
-    m_macCommands.push_back(macCommand);
-    m_fOptsLen += macCommand->GetSerializedSize();
+    // Store a copy of the command by value
+    switch (macCommand->GetCommandType())
+    {
+    case (LINK_CHECK_REQ):
+        AddCommand(*DynamicCast<LinkCheckReq>(macCommand));
+        break;
+    case (LINK_CHECK_ANS):
+        AddCommand(*DynamicCast<LinkCheckAns>(macCommand));
+        break;
+    case (LINK_ADR_REQ):
+        AddCommand(*DynamicCast<LinkAdrReq>(macCommand));
+        break;
+    case (LINK_ADR_ANS):
+        AddCommand(*DynamicCast<LinkAdrAns>(macCommand));
+        break;
+    case (DUTY_CYCLE_REQ):
+        AddCommand(*DynamicCast<DutyCycleReq>(macCommand));
+        break;
+    case (DUTY_CYCLE_ANS):
+        AddCommand(*DynamicCast<DutyCycleAns>(macCommand));
+        break;
+    case (RX_PARAM_SETUP_REQ):
+        AddCommand(*DynamicCast<RxParamSetupReq>(macCommand));
+        break;
+    case (RX_PARAM_SETUP_ANS):
+        AddCommand(*DynamicCast<RxParamSetupAns>(macCommand));
+        break;
+    case (DEV_STATUS_REQ):
+        AddCommand(*DynamicCast<DevStatusReq>(macCommand));
+        break;
+    case (DEV_STATUS_ANS):
+        AddCommand(*DynamicCast<DevStatusAns>(macCommand));
+        break;
+    case (NEW_CHANNEL_REQ):
+        AddCommand(*DynamicCast<NewChannelReq>(macCommand));
+        break;
+    case (NEW_CHANNEL_ANS):
+        AddCommand(*DynamicCast<NewChannelAns>(macCommand));
+        break;
+    case (RX_TIMING_SETUP_REQ):
+        AddCommand(*DynamicCast<RxTimingSetupReq>(macCommand));
+        break;
+    case (RX_TIMING_SETUP_ANS):
+        AddCommand(*DynamicCast<RxTimingSetupAns>(macCommand));
+        break;
+    case (TX_PARAM_SETUP_REQ):
+        AddCommand(*DynamicCast<TxParamSetupReq>(macCommand));
+        break;
+    case (TX_PARAM_SETUP_ANS):
+        AddCommand(*DynamicCast<TxParamSetupAns>(macCommand));
+        break;
+    case (DL_CHANNEL_REQ):
+        AddCommand(*DynamicCast<DlChannelReq>(macCommand));
+        break;
+    case (DL_CHANNEL_ANS):
+        AddCommand(*DynamicCast<DlChannelAns>(macCommand));
+        break;
+    default:
+        NS_LOG_ERROR("Invalid MAC command type");
+        break;
+    }
+}
+
+MacCommandVariant&
+LoraFrameHeader::AddCommandSlot()
+{
+    if (m_nCommands < INLINE_COMMANDS)
+    {
+        return m_macCommands[m_nCommands++];
+    }
+    m_nCommands++;
+    return m_moreCommands.emplace_back();
+}
+
+template <typename T>
+uint8_t
+LoraFrameHeader::DeserializeCommand(Buffer::Iterator& start)
+{
+    // Parse the command directly in its slot
+    return AddCommandSlot().emplace<T>().Deserialize(start);
 }
 
 } // namespace lorawan
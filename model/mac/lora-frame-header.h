@@ -16,8 +16,14 @@
 #include "lora-device-address.h"
 #include "mac-command.h"
 
+#include "ns3/abort.h"
 #include "ns3/header.h"
 
+#include <array>
+#include <list>
+#include <type_traits>
+#include <vector>
+
 namespace ns3
 {
 namespace lorawan
@@ -38,6 +44,13 @@ namespace lorawan
 class LoraFrameHeader : public Header
 {
   public:
+    /**
+     * Number of MAC commands stored inline in a header. FOpts is at most 15
+     * bytes long and each command takes at least 1 byte, further commands
+     * (only found in the FRMPayload of frames on port 0) are stored on the heap.
+     */
+    static constexpr uint8_t INLINE_COMMANDS = 15;
+
     LoraFrameHeader();
     ~LoraFrameHeader() override;
 
@@ -203,9 +216,39 @@ class LoraFrameHeader : public Header
     /**
      * Return a pointer to a MacCommand, or 0 if the MacCommand does not exist
      * in this header.
+     *
+     * \remark The returned command is a copy allocated on the heap, prefer
+     * FindMacCommand when possible.
      */
     template <typename T>
-    inline Ptr<T> GetMacCommand();
+    inline Ptr<T> GetMacCommand() const;
+
+    /**
+     * Find the first MAC command of a given type stored in this header.
+     *
+     * \return A pointer to the command, or nullptr if the command does not
+     * exist in this header. It is valid as long as the header is not modified.
+     */
+    template <typename T>
+    inline const T* FindMacCommand() const;
+
+    /**
+     * Call a visitor on each MAC command of this header, in order.
+     *
+     * The visitor is called with a const reference to the concrete command
+     * type (e.g., const LinkAdrReq&), so that dispatch does not require casts.
+     *
+     * \param visitor A callable accepting any MAC command type.
+     */
+    template <typename Visitor>
+    inline void VisitCommands(Visitor&& visitor) const;
+
+    /**
+     * Get the number of MAC commands in this header.
+     *
+     * \return The number of commands.
+     */
+    uint16_t GetNCommands() const;
 
     /**
      * Byte lenght of serialized MacCommands coming from FRMPayload.
@@ -299,14 +342,24 @@ class LoraFrameHeader : public Header
 
     /**
      * Return a list of pointers to all the MAC commands saved in this header.
+     *
+     * \remark Commands are copied on the heap, prefer VisitCommands when possible.
      */
-    std::list<Ptr<MacCommand>> GetCommands();
+    std::list<Ptr<MacCommand>> GetCommands() const;
 
     /**
      * Add a predefined command to the list.
      */
     void AddCommand(Ptr<MacCommand> macCommand);
 
+    /**
+     * Add a command to the list.
+     *
+     * \param command The command, of a type among those of MacCommandVariant.
+     */
+    template <typename T, typename = std::enable_if_t<std::is_base_of_v<MacCommand, T>>>
+    inline void AddCommand(const T& command);
+
   private:
     int m_fPort;
 
@@ -320,13 +373,37 @@ class LoraFrameHeader : public Header
 
     uint16_t m_fCnt;
 
-    Buffer m_fOpts;
+    /**
+     * Deserialize a MAC command of a given type in the next free slot.
+     *
+     * \param start The buffer iterator, pointing at the command CID.
+     * \return The number of consumed bytes.
+     */
+    template <typename T>
+    uint8_t DeserializeCommand(Buffer::Iterator& start);
 
     /**
-     * List containing all the MacCommand instances that are contained in this
-     * LoraFrameHeader.
+     * Get the slot of a MAC command.
+     *
+     * \param i The index of the command, lower than m_nCommands.
+     * \return The slot.
+     */
+    inline const MacCommandVariant& GetCommandSlot(uint16_t i) const;
+
+    /**
+     * Make room for a new MAC command.
+     *
+     * \return The slot of the new command.
+     */
+    MacCommandVariant& AddCommandSlot();
+
+    /**
+     * Array containing the first MAC commands of this LoraFrameHeader, stored
+     * inline. Only the first m_nCommands elements are valid.
      */
-    std::list<Ptr<MacCommand>> m_macCommands;
+    std::array<MacCommandVariant, INLINE_COMMANDS> m_macCommands;
+    std::vector<MacCommandVariant> m_moreCommands; //!< MAC commands past INLINE_COMMANDS
+    uint16_t m_nCommands;                          //!< Number of valid commands
 
     bool m_isUplink;
 
@@ -335,19 +412,60 @@ class LoraFrameHeader : public Header
 
 template <typename T>
 Ptr<T>
-LoraFrameHeader::GetMacCommand()
+LoraFrameHeader::GetMacCommand() const
+{
+    if (const T* cmd = FindMacCommand<T>(); cmd)
+    {
+        return Create<T>(*cmd);
+    }
+    // If no command was found, return 0
+    return nullptr;
+}
+
+template <typename T>
+const T*
+LoraFrameHeader::FindMacCommand() const
 {
-    // Iterate on MAC commands and try casting
-    for (const auto& cmd : m_macCommands)
+    for (uint16_t i = 0; i < m_nCommands; i++)
     {
-        if (auto deriv = DynamicCast<T>(cmd); bool(deriv))
+        if (const T* cmd = std::get_if<T>(&GetCommandSlot(i)); cmd)
         {
-            return deriv;
+            return cmd;
         }
     }
-    // If no command was found, return 0
     return nullptr;
 }
+
+template <typename Visitor>
+void
+LoraFrameHeader::VisitCommands(Visitor&& visitor) const
+{
+    for (uint16_t i = 0; i < m_nCommands; i++)
+    {
+        std::visit(
+            [&visitor](const auto& cmd) {
+                if constexpr (!std::is_same_v<std::decay_t<decltype(cmd)>, std::monostate>)
+                {
+                    visitor(cmd);
+                }
+            },
+            GetCommandSlot(i));
+    }
+}
+
+template <typename T, typename>
+void
+LoraFrameHeader::AddCommand(const T& command)
+{
+    AddCommandSlot() = command;
+    m_fOptsLen += command.GetSerializedSize();
+}
+
+const MacCommandVariant&
+LoraFrameHeader::GetCommandSlot(uint16_t i) const
+{
+    return (i < INLINE_COMMANDS) ? m_macCommands[i] : m_moreCommands[i - INLINE_COMMANDS];
+}
 } // namespace lorawan
 
 } // namespace ns3
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2026 University of Bologna
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Alessandro Aimi <alessandro.aimi@unibo.it>
+ */
+
+#include "lora-key-store.h"
+
+#include "ns3/LoRaMacCrypto.h"
+#include "ns3/log.h"
+#include "ns3/se-identity.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+namespace lorawan
+{
+
+NS_LOG_COMPONENT_DEFINE("LoraKeyStore");
+
+NS_OBJECT_ENSURE_REGISTERED(LoraKeyStore);
+
+TypeId
+LoraKeyStore::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::LoraKeyStore")
+                            .SetParent<Object>()
+                            .SetGroupName("lorawan")
+                            .AddConstructor<LoraKeyStore>();
+    return tid;
+}
+
+LoraKeyStore::LoraKeyStore()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+LoraKeyStore::~LoraKeyStore()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+/// Store shared by default among devices of the current simulation
+static Ptr<LoraKeyStore> g_defaultStore = nullptr;
+
+Ptr<LoraKeyStore>
+LoraKeyStore::GetDefault()
+{
+    if (!g_defaultStore)
+    {
+        g_defaultStore = CreateObject<LoraKeyStore>();
+        // Devices of the next simulation in the same process get a new store
+        Simulator::ScheduleDestroy([]() { g_defaultStore = nullptr; });
+    }
+    return g_defaultStore;
+}
+
+LoraKeyStore::Key
+LoraKeyStore::GetDefaultKey(KeyType type)
+{
+    // Same values the LoRaMacCrypto soft-se is initialized with
+    static const SecureElementNvmData_t seNvm = {.KeyList = SOFT_SE_KEY_LIST};
+    KeyIdentifier_t id = (type == NWK_SKEY) ? F_NWK_S_INT_KEY : APP_S_KEY;
+    for (const auto& item : seNvm.KeyList)
+    {
+        if (item.KeyID == id)
+        {
+            Key key;
+            std::copy(item.KeyValue, item.KeyValue + SE_KEY_SIZE, key.begin());
+            return key;
+        }
+    }
+    NS_ABORT_MSG("Key not found in the soft-se key list");
+    return Key();
+}
+
+uint32_t
+LoraKeyStore::AddDevice()
+{
+    NS_LOG_FUNCTION(this);
+
+    static const Key nwkSKey = GetDefaultKey(NWK_SKEY);
+    static const Key appSKey = GetDefaultKey(APP_SKEY);
+    return AddDevice(nwkSKey, appSKey);
+}
+
+uint32_t
+LoraKeyStore::AddDevice(const Key& nwkSKey, const Key& appSKey)
+{
+    NS_LOG_FUNCTION(this);
+
+    m_nwkSKey.push_back(GetExpandedIndex(nwkSKey));
+    m_appSKey.push_back(GetExpandedIndex(appSKey));
+    return m_nwkSKey.size() - 1;
+}
+
+void
+LoraKeyStore::SetKey(uint32_t device, KeyType type, const Key& key)
+{
+    NS_LOG_FUNCTION(this << device << type);
+    NS_ASSERT_MSG(device < m_nwkSKey.size(), "Device " << device << " not in the store");
+
+    // Expanded keys are never removed, as other devices may be using them
+    uint32_t index = GetExpandedIndex(key);
+    if (type == NWK_SKEY)
+    {
+        m_nwkSKey[device] = index;
+    }
+    else
+    {
+        m_appSKey[device] = index;
+    }
+}
+
+LoraKeyStore::Key
+LoraKeyStore::GetKey(uint32_t device, KeyType type) const
+{
+    NS_ASSERT_MSG(device < m_nwkSKey.size(), "Device " << device << " not in the store");
+    return m_keys[(type == NWK_SKEY) ? m_nwkSKey[device] : m_appSKey[device]];
+}
+
+uint32_t
+LoraKeyStore::GetNDevices() const
+{
+    return m_nwkSKey.size();
+}
+
+uint32_t
+LoraKeyStore::GetNExpandedKeys() const
+{
+    return m_keys.size();
+}
+
+uint32_t
+LoraKeyStore::ComputeMic(uint32_t device,
+                         const uint8_t* msg,
+                         uint16_t len,
+                         uint8_t dir,
+                         uint32_t devAddr,
+                         uint32_t fCnt) const
+{
+    NS_LOG_FUNCTION(this << device << len);
+    NS_ASSERT_MSG(len <= 256, "Message too long for MIC computation");
+
+    // B0 block, as in LoRaMacCrypto::PrepareB0
+    uint8_t b0[16];
+    b0[0] = 0x49;
+    b0[1] = b0[2] = b0[3] = b0[4] = 0x00;
+    b0[5] = dir;
+    b0[6] = devAddr & 0xFF;
+    b0[7] = (devAddr >> 8) & 0xFF;
+    b0[8] = (devAddr >> 16) & 0xFF;
+    b0[9] = (devAddr >> 24) & 0xFF;
+    b0[10] = fCnt & 0xFF;
+    b0[11] = (fCnt >> 8) & 0xFF;
+    b0[12] = (fCnt >> 16) & 0xFF;
+    b0[13] = (fCnt >> 24) & 0xFF;
+    b0[14] = 0x00;
+    b0[15] = len & 0xFF;
+
+    uint8_t cmac[AES_CMAC_DIGEST_LENGTH];
+    AES_CMAC_Compute(&GetExpanded(device, NWK_SKEY), b0, msg, len, cmac);
+    return (uint32_t)cmac[3] << 24 | (uint32_t)cmac[2] << 16 | (uint32_t)cmac[1] << 8 |
+           (uint32_t)cmac[0];
+}
+
+void
+LoraKeyStore::PayloadEncrypt(uint32_t device,
+                             KeyType type,
+                             uint8_t* buffer,
+                             uint16_t size,
+                             uint32_t devAddr,
+                             uint8_t dir,
+                             uint32_t fCnt) const
+{
+    NS_LOG_FUNCTION(this << device << type << size);
+
+    const aes_context* ctx = &GetExpanded(device, type).rijndael;
+
+    // Same A blocks as in LoRaMacCrypto::PayloadEncrypt
+    uint8_t aBlock[16] = {0};
+    uint8_t sBlock[16];
+    aBlock[0] = 0x01;
+    aBlock[5] = dir;
+    aBlock[6] = devAddr & 0xFF;
+    aBlock[7] = (devAddr >> 8) & 0xFF;
+    aBlock[8] = (devAddr >> 16) & 0xFF;
+    aBlock[9] = (devAddr >> 24) & 0xFF;
+    aBlock[10] = fCnt & 0xFF;
+    aBlock[11] = (fCnt >> 8) & 0xFF;
+    aBlock[12] = (fCnt >> 16) & 0xFF;
+    aBlock[13] = (fCnt >> 24) & 0xFF;
+
+    uint8_t ctr = 1;
+    for (uint16_t offset = 0; offset < size; offset += 16)
+    {
+        aBlock[15] = ctr++;
+        aes_encrypt(aBlock, sBlock, ctx);
+        for (uint16_t i = 0; i < 16 && offset + i < size; i++)
+        {
+            buffer[offset + i] ^= sBlock[i];
+        }
+    }
+}
+
+uint32_t
+LoraKeyStore::GetExpandedIndex(const Key& key)
+{
+    auto it = m_keyIndex.find(key);
+    if (it != m_keyIndex.end())
+    {
+        return it->second;
+    }
+
+    AES_CMAC_KEY_CTX ctx;
+    AES_CMAC_PrepareKey(&ctx, key.data());
+    m_keys.push_back(key);
+    m_expanded.push_back(ctx);
+    uint32_t index = m_keys.size() - 1;
+    m_keyIndex.emplace(key, index);
+    NS_LOG_DEBUG("Expanded new key, " << m_keys.size() << " distinct keys in store");
+    return index;
+}
+
+const AES_CMAC_KEY_CTX&
+LoraKeyStore::GetExpanded(uint32_t device, KeyType type) const
+{
+    NS_ASSERT_MSG(device < m_nwkSKey.size(), "Device " << device << " not in the store");
+    return m_expanded[(type == NWK_SKEY) ? m_nwkSKey[device] : m_appSKey[device]];
+}
+
+} // namespace lorawan
+} // namespace ns3
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2026 University of Bologna
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Alessandro Aimi <alessandro.aimi@unibo.it>
+ */
+
+#ifndef LORA_KEY_STORE_H
+#define LORA_KEY_STORE_H
+
+#include "ns3/cmac.h"
+#include "ns3/object.h"
+
+#include <array>
+#include <map>
+#include <vector>
+
+namespace ns3
+{
+namespace lorawan
+{
+
+/**
+ * Central store of the LoRaWAN 1.0.x session keys of end devices.
+ *
+ * Devices are registered once and then reference their keys by index.
+ * Per-device data is kept as structure-of-arrays of indices into a pool of
+ * expanded keys (AES key schedule and CMAC subkeys). Identical keys are
+ * expanded only once, so that devices sharing the same session keys (the
+ * common case in simulations) also share the same expanded material.
+ */
+class LoraKeyStore : public Object
+{
+  public:
+    /**
+     * A 128-bit AES key.
+     */
+    using Key = std::array<uint8_t, 16>;
+
+    /**
+     * Session key of a device.
+     */
+    enum KeyType
+    {
+        NWK_SKEY, //!< Network session key (FNwkSIntKey, SNwkSIntKey and NwkSEncKey)
+        APP_SKEY, //!< Application session key
+    };
+
+    static TypeId GetTypeId();
+
+    LoraKeyStore();
+    ~LoraKeyStore() override;
+
+    /**
+     * Get the store shared by default among all devices that were not
+     * explicitly assigned to one. The store is released when the simulation
+     * is destroyed, so that keys do not accumulate across simulations run in
+     * the same process.
+     *
+     * \return The default key store.
+     */
+    static Ptr<LoraKeyStore> GetDefault();
+
+    /**
+     * Get the default session keys, i.e., the ones of the soft secure element
+     * identity (se-identity.h) also used by the server registration helpers.
+     *
+     * \param type The session key type.
+     * \return The key value.
+     */
+    static Key GetDefaultKey(KeyType type);
+
+    /**
+     * Register a new device with the default session keys.
+     *
+     * \return The index of the device in the store.
+     */
+    uint32_t AddDevice();
+
+    /**
+     * Register a new device.
+     *
+     * \param nwkSKey The network session key.
+     * \param appSKey The application session key.
+     * \return The index of the device in the store.
+     */
+    uint32_t AddDevice(const Key& nwkSKey, const Key& appSKey);
+
+    /**
+     * Change a session key of a registered device.
+     *
+     * \param device The index of the device.
+     * \param type The session key type.
+     * \param key The new key value.
+     */
+    void SetKey(uint32_t device, KeyType type, const Key& key);
+
+    /**
+     * Get a session key of a registered device.
+     *
+     * \param device The index of the device.
+     * \param type The session key type.
+     * \return The key value.
+     */
+    Key GetKey(uint32_t device, KeyType type) const;
+
+    /**
+     * \return The number of registered devices.
+     */
+    uint32_t GetNDevices() const;
+
+    /**
+     * \return The number of distinct keys expanded in the store.
+     */
+    uint32_t GetNExpandedKeys() const;
+
+    /**
+     * Compute the MIC of a data frame with the network session key.
+     *
+     * \param device The index of the device.
+     * \param msg The serialized frame without MIC.
+     * \param len The length of the frame.
+     * \param dir Frame direction (UPLINK or DOWNLINK).
+     * \param devAddr The device address.
+     * \param fCnt The frame counter.
+     * \return The MIC, in the same format as LoRaMacCrypto::ComputeCmacB0.
+     */
+    uint32_t ComputeMic(uint32_t device,
+                        const uint8_t* msg,
+                        uint16_t len,
+                        uint8_t dir,
+                        uint32_t devAddr,
+                        uint32_t fCnt) const;
+
+    /**
+     * Encrypt (or decrypt) a FRMPayload in place.
+     *
+     * \param device The index of the device.
+     * \param type The session key to use.
+     * \param buffer The payload.
+     * \param size The payload size.
+     * \param devAddr The device address.
+     * \param dir Frame direction (UPLINK or DOWNLINK).
+     * \param fCnt The frame counter.
+     */
+    void PayloadEncrypt(uint32_t device,
+                        KeyType type,
+                        uint8_t* buffer,
+                        uint16_t size,
+                        uint32_t devAddr,
+                        uint8_t dir,
+                        uint32_t fCnt) const;
+
+  private:
+    /**
+     * Get the index of the expanded material of a key, expanding it if new.
+     *
+     * \param key The key value.
+     * \return The index in m_expanded.
+     */
+    uint32_t GetExpandedIndex(const Key& key);
+
+    /**
+     * Get the expanded material of a device key.
+     *
+     * \param device The index of the device.
+     * \param type The session key type.
+     * \return The expanded key.
+     */
+    const AES_CMAC_KEY_CTX& GetExpanded(uint32_t device, KeyType type) const;
+
+    std::vector<uint32_t> m_nwkSKey; //!< Per-device index of the network session key
+    std::vector<uint32_t> m_appSKey; //!< Per-device index of the application session key
+
+    std::vector<Key> m_keys;                  //!< Distinct key values
+    std::vector<AES_CMAC_KEY_CTX> m_expanded; //!< Expanded material of each distinct key
+    std::map<Key, uint32_t> m_keyIndex;       //!< Lookup from key value to its index
+};
+
+} // namespace lorawan
+} // namespace ns3
+
+#endif /* LORA_KEY_STORE_H */
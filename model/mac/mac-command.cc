@@ -313,7 +313,7 @@ LinkAdrReq::Print(std::ostream& os) const
 }
 
 uint8_t
-LinkAdrReq::GetDataRate()
+LinkAdrReq::GetDataRate() const
 {
     NS_LOG_FUNCTION(this);
 
@@ -321,7 +321,7 @@ LinkAdrReq::GetDataRate()
 }
 
 uint8_t
-LinkAdrReq::GetTxPower()
+LinkAdrReq::GetTxPower() const
 {
     NS_LOG_FUNCTION(this);
 
@@ -329,7 +329,7 @@ LinkAdrReq::GetTxPower()
 }
 
 std::list<int>
-LinkAdrReq::GetEnabledChannelsList()
+LinkAdrReq::GetEnabledChannelsList() const
 {
     NS_LOG_FUNCTION(this);
 
@@ -347,7 +347,7 @@ LinkAdrReq::GetEnabledChannelsList()
 }
 
 int
-LinkAdrReq::GetRepetitions()
+LinkAdrReq::GetRepetitions() const
 {
     NS_LOG_FUNCTION(this);
 
@@ -1030,7 +1030,7 @@ RxTimingSetupReq::Print(std::ostream& os) const
 }
 
 Time
-RxTimingSetupReq::GetDelay()
+RxTimingSetupReq::GetDelay() const
 {
     NS_LOG_FUNCTION(this);
 
@@ -17,6 +17,8 @@
 #include "ns3/nstime.h"
 #include "ns3/object.h"
 
+#include <variant>
+
 namespace ns3
 {
 namespace lorawan
@@ -219,7 +221,7 @@ class LinkAdrReq : public MacCommand
      *
      * \return An unsigned 8-bit integer containing the data rate.
      */
-    uint8_t GetDataRate();
+    uint8_t GetDataRate() const;
 
     /**
      * Get the transmission power prescribed by this MAC command.
@@ -230,7 +232,7 @@ class LinkAdrReq : public MacCommand
      *
      * \return The TX power, encoded as an unsigned 8-bit integer.
      */
-    uint8_t GetTxPower();
+    uint8_t GetTxPower() const;
 
     /**
      * Get the list of enabled channels. This method takes the 16-bit channel mask
@@ -238,14 +240,14 @@ class LinkAdrReq : public MacCommand
      *
      * \return The list of enabled channels.
      */
-    std::list<int> GetEnabledChannelsList();
+    std::list<int> GetEnabledChannelsList() const;
 
     /**
      * Get the number of repetitions prescribed by this MAC command.
      *
      * \return The number of repetitions.
      */
-    int GetRepetitions();
+    int GetRepetitions() const;
 
   private:
     uint8_t m_dataRate;
@@ -535,7 +537,7 @@ class RxTimingSetupReq : public MacCommand
      *
      * \return The delay.
      */
-    Time GetDelay();
+    Time GetDelay() const;
 
   private:
     uint8_t m_delay;
@@ -641,6 +643,32 @@ class DlChannelAns : public MacCommand
     bool m_channelFrequencyOk;
 };
 
+/**
+ * Value-type representation of a MAC command of any kind.
+ *
+ * Commands stored this way live inline in their container and do not require
+ * a heap allocation. std::monostate represents the absence of a command.
+ */
+using MacCommandVariant = std::variant<std::monostate,
+                                       LinkCheckReq,
+                                       LinkCheckAns,
+                                       LinkAdrReq,
+                                       LinkAdrAns,
+                                       DutyCycleReq,
+                                       DutyCycleAns,
+                                       RxParamSetupReq,
+                                       RxParamSetupAns,
+                                       DevStatusReq,
+                                       DevStatusAns,
+                                       NewChannelReq,
+                                       NewChannelAns,
+                                       RxTimingSetupReq,
+                                       RxTimingSetupAns,
+                                       TxParamSetupReq,
+                                       TxParamSetupAns,
+                                       DlChannelReq,
+                                       DlChannelAns>;
+
 } // namespace lorawan
 
 } // namespace ns3
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2026 University of Bologna
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Alessandro Aimi <alessandro.aimi@unibo.it>
+ */
+
+#include "regional-channel-plan.h"
+
+#include "ns3/log.h"
+
+namespace ns3
+{
+namespace lorawan
+{
+
+NS_LOG_COMPONENT_DEFINE("RegionalChannelPlan");
+
+RegionalChannelPlan::RegionalChannelPlan()
+{
+    NS_LOG_FUNCTION(this);
+    m_channelSubBand.fill(NO_SUBBAND);
+}
+
+RegionalChannelPlan::~RegionalChannelPlan()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+uint8_t
+RegionalChannelPlan::AddSubBand(Ptr<SubBand> subBand)
+{
+    NS_LOG_FUNCTION(this << subBand);
+    NS_ASSERT_MSG(m_subBands.size() < NO_SUBBAND, "Too many SubBands in the plan");
+
+    m_subBands.push_back(subBand);
+    uint8_t index = m_subBands.size() - 1;
+
+    // Resolve channels that were added before their SubBand
+    for (uint8_t i = 0; i < MAX_CHANNELS; i++)
+    {
+        if (m_channels[i] && m_channelSubBand[i] == NO_SUBBAND &&
+            subBand->BelongsToSubBand(m_channels[i]->GetFrequency()))
+        {
+            m_channelSubBand[i] = index;
+        }
+    }
+    return index;
+}
+
+void
+RegionalChannelPlan::SetChannel(uint8_t chIndex, Ptr<const LogicalChannel> channel)
+{
+    NS_LOG_FUNCTION(this << (unsigned)chIndex << channel);
+    NS_ABORT_MSG_IF(chIndex >= MAX_CHANNELS, "Channel index " << (unsigned)chIndex
+                                                              << " out of range");
+
+    m_channels[chIndex] = channel;
+    m_channelSubBand[chIndex] = GetSubBandIndexFromFrequency(channel->GetFrequency());
+}
+
+void
+RegionalChannelPlan::RemoveChannel(uint8_t chIndex)
+{
+    NS_LOG_FUNCTION(this << (unsigned)chIndex);
+
+    if (chIndex < MAX_CHANNELS)
+    {
+        m_channels[chIndex] = nullptr;
+        m_channelSubBand[chIndex] = NO_SUBBAND;
+    }
+}
+
+Ptr<const LogicalChannel>
+RegionalChannelPlan::GetChannel(uint8_t chIndex) const
+{
+    return (chIndex < MAX_CHANNELS) ? m_channels[chIndex] : nullptr;
+}
+
+uint16_t
+RegionalChannelPlan::GetChannelMask() const
+{
+    uint16_t mask = 0;
+    for (uint8_t i = 0; i < MAX_CHANNELS; i++)
+    {
+        if (m_channels[i])
+        {
+            mask |= (1 << i);
+        }
+    }
+    return mask;
+}
+
+uint8_t
+RegionalChannelPlan::GetSubBandIndex(uint8_t chIndex) const
+{
+    return (chIndex < MAX_CHANNELS) ? m_channelSubBand[chIndex] : NO_SUBBAND;
+}
+
+uint8_t
+RegionalChannelPlan::GetSubBandIndexFromFrequency(double frequency) const
+{
+    for (uint8_t i = 0; i < m_subBands.size(); i++)
+    {
+        if (m_subBands[i]->BelongsToSubBand(frequency))
+        {
+            return i;
+        }
+    }
+    return NO_SUBBAND;
+}
+
+uint8_t
+RegionalChannelPlan::GetSubBandIndex(const Ptr<const LogicalChannel>& channel) const
+{
+    // Channels of the plan are found by identity, without comparing frequencies
+    for (uint8_t i = 0; i < MAX_CHANNELS; i++)
+    {
+        if (PeekPointer(m_channels[i]) == PeekPointer(channel))
+        {
+            return m_channelSubBand[i];
+        }
+    }
+    return GetSubBandIndexFromFrequency(channel->GetFrequency());
+}
+
+Ptr<const SubBand>
+RegionalChannelPlan::GetSubBand(uint8_t index) const
+{
+    NS_ASSERT(index < m_subBands.size());
+    return m_subBands[index];
+}
+
+uint8_t
+RegionalChannelPlan::GetNSubBands() const
+{
+    return m_subBands.size();
+}
+
+} // namespace lorawan
+} // namespace ns3
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2026 University of Bologna
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Alessandro Aimi <alessandro.aimi@unibo.it>
+ */
+
+#ifndef REGIONAL_CHANNEL_PLAN_H
+#define REGIONAL_CHANNEL_PLAN_H
+
+#include "logical-channel.h"
+#include "sub-band.h"
+
+#include "ns3/simple-ref-count.h"
+
+#include <array>
+#include <vector>
+
+namespace ns3
+{
+namespace lorawan
+{
+
+/**
+ * This class describes the channels and SubBands of a region, together with
+ * the SubBand each channel belongs to.
+ *
+ * A plan is meant to be shared among all the LogicalChannelManager instances
+ * of a region, and must be considered immutable once shared: managers hold
+ * their per-device state (enabled channels, duty cycle) separately, and copy
+ * the plan before modifying it (copy-on-write). Channels are only handed out
+ * as const for this reason.
+ */
+class RegionalChannelPlan : public SimpleRefCount<RegionalChannelPlan>
+{
+  public:
+    static constexpr uint8_t MAX_CHANNELS = 16; //!< Size of the LoRaWAN channel mask
+    static constexpr uint8_t NO_SUBBAND = 0xFF; //!< SubBand index of unmatched channels
+
+    RegionalChannelPlan();
+    virtual ~RegionalChannelPlan();
+
+    /**
+     * Add a SubBand to the plan.
+     *
+     * \param subBand The SubBand, only its static properties are used.
+     * \return The index of the SubBand in the plan.
+     */
+    uint8_t AddSubBand(Ptr<SubBand> subBand);
+
+    /**
+     * Set (add or replace) the channel at a given index.
+     *
+     * \param chIndex The index of the channel.
+     * \param channel The channel.
+     */
+    void SetChannel(uint8_t chIndex, Ptr<const LogicalChannel> channel);
+
+    /**
+     * Remove the channel at a given index.
+     *
+     * \param chIndex The index of the channel.
+     */
+    void RemoveChannel(uint8_t chIndex);
+
+    /**
+     * Get the channel at a given index.
+     *
+     * \param chIndex The index of the channel.
+     * \return The channel, or nullptr if no channel is defined at this index.
+     */
+    Ptr<const LogicalChannel> GetChannel(uint8_t chIndex) const;
+
+    /**
+     * Get the bitmask of the indexes where a channel is defined.
+     *
+     * \return The bitmask (bit i set if channel i exists).
+     */
+    uint16_t GetChannelMask() const;
+
+    /**
+     * Get the index of the SubBand of a channel.
+     *
+     * \param chIndex The index of the channel.
+     * \return The index of the SubBand, or NO_SUBBAND.
+     */
+    uint8_t GetSubBandIndex(uint8_t chIndex) const;
+
+    /**
+     * Get the index of the SubBand a frequency belongs to.
+     *
+     * \param frequency The frequency (Hz).
+     * \return The index of the SubBand, or NO_SUBBAND.
+     */
+    uint8_t GetSubBandIndexFromFrequency(double frequency) const;
+
+    /**
+     * Get the index of the SubBand of a channel, looking first for the
+     * channel instance in the plan and then for its frequency.
+     *
+     * \param channel The channel.
+     * \return The index of the SubBand, or NO_SUBBAND.
+     */
+    uint8_t GetSubBandIndex(const Ptr<const LogicalChannel>& channel) const;
+
+    /**
+     * Get a SubBand of the plan.
+     *
+     * The SubBand may be shared with other plans, so it cannot be changed.
+     *
+     * \param index The index of the SubBand.
+     * \return The SubBand.
+     */
+    Ptr<const SubBand> GetSubBand(uint8_t index) const;
+
+    /**
+     * Get the number of SubBands in the plan.
+     *
+     * \return The number of SubBands.
+     */
+    uint8_t GetNSubBands() const;
+
+  private:
+    std::array<Ptr<const LogicalChannel>, MAX_CHANNELS> m_channels; //!< Channels by index
+    std::array<uint8_t, MAX_CHANNELS> m_channelSubBand;             //!< SubBand of each channel
+    std::vector<Ptr<const SubBand>> m_subBands;                     //!< The SubBands of the plan
+};
+
+} // namespace lorawan
+} // namespace ns3
+
+#endif /* REGIONAL_CHANNEL_PLAN_H */
@@ -0,0 +1,312 @@
+/*
+ * Copyright (c) 2026 University of Bologna
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Alessandro Aimi <alessandro.aimi@unibo.it>
+ */
+
+#include "distributed-lora-channel.h"
+
+#include "end-device-lora-phy.h"
+
+#include "ns3/double.h"
+#include "ns3/header.h"
+#include "ns3/mpi-interface.h"
+#include "ns3/mpi-receiver.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ns3
+{
+namespace lorawan
+{
+
+NS_LOG_COMPONENT_DEFINE("DistributedLoraChannel");
+
+NS_OBJECT_ENSURE_REGISTERED(DistributedLoraChannel);
+
+NS_OBJECT_ENSURE_REGISTERED(LoraRankTag);
+
+TypeId
+LoraRankTag::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::LoraRankTag")
+                            .SetParent<Tag>()
+                            .SetGroupName("lorawan")
+                            .AddConstructor<LoraRankTag>();
+    return tid;
+}
+
+TypeId
+LoraRankTag::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+LoraRankTag::LoraRankTag(uint32_t systemId)
+    : m_systemId(systemId)
+{
+}
+
+uint32_t
+LoraRankTag::GetSerializedSize() const
+{
+    return 4;
+}
+
+void
+LoraRankTag::Serialize(TagBuffer i) const
+{
+    i.WriteU32(m_systemId);
+}
+
+void
+LoraRankTag::Deserialize(TagBuffer i)
+{
+    m_systemId = i.ReadU32();
+}
+
+void
+LoraRankTag::Print(std::ostream& os) const
+{
+    os << m_systemId;
+}
+
+uint32_t
+LoraRankTag::GetSystemId() const
+{
+    return m_systemId;
+}
+
+namespace
+{
+
+/**
+ * Reception parameters of a transmission forwarded to another rank, computed
+ * by the rank of the sender.
+ */
+class LoraRemoteTransmissionHeader : public Header
+{
+  public:
+    static TypeId GetTypeId()
+    {
+        static TypeId tid = TypeId("ns3::LoraRemoteTransmissionHeader")
+                                .SetParent<Header>()
+                                .SetGroupName("lorawan")
+                                .AddConstructor<LoraRemoteTransmissionHeader>();
+        return tid;
+    }
+
+    TypeId GetInstanceTypeId() const override
+    {
+        return GetTypeId();
+    }
+
+    uint32_t GetSerializedSize() const override
+    {
+        return 25;
+    }
+
+    void Serialize(Buffer::Iterator start) const override
+    {
+        start.WriteHtonU64(DoubleToBits(rxPowerDbm));
+        start.WriteU8(sf);
+        start.WriteHtonU64(duration.GetTimeStep());
+        start.WriteHtonU64(DoubleToBits(frequency));
+    }
+
+    uint32_t Deserialize(Buffer::Iterator start) override
+    {
+        rxPowerDbm = BitsToDouble(start.ReadNtohU64());
+        sf = start.ReadU8();
+        duration = TimeStep(start.ReadNtohU64());
+        frequency = BitsToDouble(start.ReadNtohU64());
+        return GetSerializedSize();
+    }
+
+    void Print(std::ostream& os) const override
+    {
+        os << "rxPower=" << rxPowerDbm << "dBm, SF=" << (unsigned)sf << ", duration=" << duration
+           << ", frequency=" << frequency;
+    }
+
+    double rxPowerDbm = 0; //!< Power at the receiver (dBm)
+    uint8_t sf = 0;        //!< Spreading factor
+    Time duration;         //!< Duration of the transmission
+    double frequency = 0;  //!< Frequency of the transmission (Hz)
+
+  private:
+    static uint64_t DoubleToBits(double value)
+    {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    static double BitsToDouble(uint64_t bits)
+    {
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+};
+
+NS_OBJECT_ENSURE_REGISTERED(LoraRemoteTransmissionHeader);
+
+} // namespace
+
+TypeId
+DistributedLoraChannel::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::DistributedLoraChannel")
+            .SetParent<LoraChannel>()
+            .SetGroupName("lorawan")
+            .AddConstructor<DistributedLoraChannel>()
+            .AddAttribute("Lookahead",
+                          "Minimum delay of receptions at nodes simulated by other ranks, it "
+                          "must not be smaller than the lookahead of the distributed simulator. "
+                          "Remote receptions are delayed by the maximum between this and the "
+                          "propagation delay, so they are late when it exceeds the latter",
+                          TimeValue(MilliSeconds(1)),
+                          MakeTimeAccessor(&DistributedLoraChannel::m_lookahead),
+                          MakeTimeChecker(TimeStep(1)))
+            .AddAttribute("RemoteRxPowerThreshold",
+                          "Received power (dBm) under which transmissions are not forwarded to "
+                          "nodes simulated by other ranks",
+                          DoubleValue(-200),
+                          MakeDoubleAccessor(&DistributedLoraChannel::m_remoteThreshold),
+                          MakeDoubleChecker<double>());
+    return tid;
+}
+
+DistributedLoraChannel::DistributedLoraChannel()
+    : m_partitioned(false)
+{
+    NS_LOG_FUNCTION(this);
+    Simulator::ScheduleNow(&DistributedLoraChannel::Partition, Ptr<DistributedLoraChannel>(this));
+}
+
+DistributedLoraChannel::DistributedLoraChannel(Ptr<PropagationLossModel> loss,
+                                               Ptr<PropagationDelayModel> delay)
+    : LoraChannel(loss, delay),
+      m_partitioned(false)
+{
+    NS_LOG_FUNCTION(this << loss << delay);
+    Simulator::ScheduleNow(&DistributedLoraChannel::Partition, Ptr<DistributedLoraChannel>(this));
+}
+
+DistributedLoraChannel::~DistributedLoraChannel()
+{
+    NS_LOG_FUNCTION(this);
+    m_remoteUp.clear();
+    m_remoteDown.clear();
+}
+
+void
+DistributedLoraChannel::Send(Ptr<LoraPhy> sender,
+                             Ptr<Packet> packet,
+                             double txPowerDbm,
+                             uint8_t sf,
+                             Time duration,
+                             double frequency) const
+{
+    NS_LOG_FUNCTION(this << sender << packet << txPowerDbm << (unsigned)sf << duration
+                         << frequency);
+    NS_ASSERT_MSG(m_partitioned, "Transmission before the start of the simulation");
+
+    // Receivers of this rank
+    LoraChannel::Send(sender, packet, txPowerDbm, sf, duration, frequency);
+
+    // Receivers of other ranks
+    auto senderMobility = sender->GetMobility();
+    bool down = !DynamicCast<EndDeviceLoraPhy>(sender);
+    const auto& receivers = (down) ? m_remoteDown : m_remoteUp;
+    for (const auto& phy : receivers)
+    {
+        auto receiverMobility = phy->GetMobility();
+        LoraRemoteTransmissionHeader header;
+        header.rxPowerDbm = GetRxPower(txPowerDbm, senderMobility, receiverMobility);
+        if (header.rxPowerDbm < m_remoteThreshold)
+        {
+            continue;
+        }
+        header.sf = sf;
+        header.duration = duration;
+        header.frequency = frequency;
+
+        // Events of other ranks cannot be scheduled within the lookahead
+        Time delay = Max(m_delay->GetDelay(senderMobility, receiverMobility), m_lookahead);
+        Ptr<Packet> remotePacket = packet->Copy();
+        remotePacket->AddPacketTag(LoraRankTag(Simulator::GetSystemId()));
+        remotePacket->AddHeader(header);
+        Ptr<NetDevice> device = phy->GetDevice();
+        NS_LOG_DEBUG("Forwarding to node " << device->GetNode()->GetId() << " of rank "
+                                           << device->GetNode()->GetSystemId() << ": "
+                                           << header);
+        MpiInterface::SendPacket(remotePacket,
+                                 Simulator::Now() + delay,
+                                 device->GetNode()->GetId(),
+                                 device->GetIfIndex());
+    }
+}
+
+void
+DistributedLoraChannel::Partition()
+{
+    NS_LOG_FUNCTION(this);
+
+    if (m_partitioned)
+    {
+        return;
+    }
+    m_partitioned = true;
+
+    uint32_t systemId = Simulator::GetSystemId();
+    auto isLocal = [systemId](const Ptr<LoraPhy>& phy) {
+        return phy->GetDevice()->GetNode()->GetSystemId() == systemId;
+    };
+    auto split = [&isLocal](std::vector<Ptr<LoraPhy>>& local,
+                            std::vector<Ptr<LoraPhy>>& remote) {
+        auto it = std::stable_partition(local.begin(), local.end(), isLocal);
+        remote.assign(it, local.end());
+        local.erase(it, local.end());
+        // Transmissions of other ranks reach local PHYs through their device
+        for (const auto& phy : local)
+        {
+            if (phy->GetDevice()->GetObject<MpiReceiver>())
+            {
+                // Already partitioned by another distributed channel
+                continue;
+            }
+            auto receiver = CreateObject<MpiReceiver>();
+            receiver->SetReceiveCallback(
+                MakeBoundCallback(&DistributedLoraChannel::ReceiveRemote, phy));
+            phy->GetDevice()->AggregateObject(receiver);
+        }
+    };
+    split(m_phyListUp, m_remoteUp);
+    split(m_phyListDown, m_remoteDown);
+
+    NS_LOG_INFO("Rank " << systemId << ": " << m_phyListUp.size() + m_phyListDown.size()
+                        << " local PHYs, " << m_remoteUp.size() + m_remoteDown.size()
+                        << " remote PHYs");
+}
+
+void
+DistributedLoraChannel::ReceiveRemote(Ptr<LoraPhy> phy, Ptr<Packet> packet)
+{
+    NS_LOG_FUNCTION(phy << packet);
+
+    LoraRemoteTransmissionHeader header;
+    packet->RemoveHeader(header);
+    NS_LOG_DEBUG("Received from another rank: " << header);
+    phy->StartReceive(packet, header.rxPowerDbm, header.sf, header.duration, header.frequency);
+}
+
+} // namespace lorawan
+} // namespace ns3
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2026 University of Bologna
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Alessandro Aimi <alessandro.aimi@unibo.it>
+ */
+
+#ifndef DISTRIBUTED_LORA_CHANNEL_H
+#define DISTRIBUTED_LORA_CHANNEL_H
+
+#include "lora-channel.h"
+
+#include "ns3/tag.h"
+
+namespace ns3
+{
+namespace lorawan
+{
+
+/**
+ * Packet tag carrying the rank (system id) of the sender of a transmission
+ * received from another rank of a distributed simulation.
+ */
+class LoraRankTag : public Tag
+{
+  public:
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+
+    /**
+     * Create a tag with the rank of the sender.
+     *
+     * \param systemId The rank of the sender.
+     */
+    LoraRankTag(uint32_t systemId = 0);
+
+    uint32_t GetSerializedSize() const override;
+    void Serialize(TagBuffer i) const override;
+    void Deserialize(TagBuffer i) override;
+    void Print(std::ostream& os) const override;
+
+    /**
+     * \return The rank of the sender.
+     */
+    uint32_t GetSystemId() const;
+
+  private:
+    uint32_t m_systemId; //!< Rank of the sender
+};
+
+/**
+ * A LoraChannel for distributed (MPI) simulations.
+ *
+ * Every rank builds the whole topology, with nodes created with the system id
+ * of the rank that simulates them. The channel delivers transmissions to the
+ * PHYs of local nodes as the LoraChannel does, and forwards them through the
+ * MpiInterface to the PHYs of nodes simulated by other ranks, together with
+ * the reception parameters computed at the sender's rank.
+ *
+ * Receptions at nodes of other ranks are scheduled max(delay, Lookahead)
+ * after the start of the transmission, where delay is the one given by the
+ * propagation delay model. Since the granted time window of the distributed
+ * simulator only accounts for PointToPoint links between ranks, the Lookahead
+ * must not be smaller than the delay of the shortest such link (e.g., the
+ * gateway-server links), which then must exist. Whenever the Lookahead
+ * exceeds the propagation delay, as with a ConstantSpeed delay model and
+ * links of a few milliseconds, remote receptions are late by the difference:
+ * this shifts their overlaps with local transmissions in interference
+ * computations and the arrival of downlinks in the receive windows of end
+ * devices. Remote receptions are only exact if the links between ranks are
+ * not faster than the minimum propagation delay between their nodes, and the
+ * Lookahead is set to it.
+ *
+ * Transmissions forwarded to another rank carry a LoraRankTag with the rank of
+ * the sender, so that trace consumers (e.g., the LoraPacketTracker) can match
+ * them with the transmission of the other rank.
+ *
+ * Only the default granted time window synchronization is supported.
+ */
+class DistributedLoraChannel : public LoraChannel
+{
+  public:
+    static TypeId GetTypeId();
+
+    DistributedLoraChannel();
+    ~DistributedLoraChannel() override;
+
+    /**
+     * Construct a DistributedLoraChannel with a loss and delay model.
+     *
+     * \param loss The loss model to associate to this channel.
+     * \param delay The delay model to associate to this channel.
+     */
+    DistributedLoraChannel(Ptr<PropagationLossModel> loss, Ptr<PropagationDelayModel> delay);
+
+    void Send(Ptr<LoraPhy> sender,
+              Ptr<Packet> packet,
+              double txPowerDbm,
+              uint8_t sf,
+              Time duration,
+              double frequency) const override;
+
+  private:
+    /**
+     * Split the connected PHYs between local and remote ones, and prepare the
+     * devices of local PHYs to receive transmissions from other ranks.
+     *
+     * Executed at the start of the simulation, when PHYs are attached to their
+     * devices and nodes. Devices connected to several distributed channels
+     * share the MpiReceiver aggregated by the first one.
+     */
+    void Partition();
+
+    /**
+     * Deliver a transmission forwarded by another rank.
+     *
+     * \param phy The receiving PHY.
+     * \param packet The packet, with the reception parameters header.
+     */
+    static void ReceiveRemote(Ptr<LoraPhy> phy, Ptr<Packet> packet);
+
+    Time m_lookahead;                       //!< Minimum delay of remote receptions
+    double m_remoteThreshold;               //!< Power under which remote PHYs are ignored
+    bool m_partitioned;                     //!< Whether PHYs were split already
+    std::vector<Ptr<LoraPhy>> m_remoteUp;   //!< Gateway PHYs of other ranks
+    std::vector<Ptr<LoraPhy>> m_remoteDown; //!< End device PHYs of other ranks
+};
+
+} // namespace lorawan
+} // namespace ns3
+
+#endif /* DISTRIBUTED_LORA_CHANNEL_H */
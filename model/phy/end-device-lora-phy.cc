@@ -97,12 +97,12 @@ EndDeviceLoraPhy::Send(Ptr<Packet> packet,
 
     // Tag the packet with information about its Spreading Factor
     LoraTag tag;
-    packet->RemovePacketTag(tag);
+    packet->PeekPacketTag(tag);
     tag.SetTxParameters(txParams);
-    packet->AddPacketTag(tag);
+    tag.WriteTo(packet);
 
     // Get the time a packet with these parameters will take to be transmitted
-    Time duration = GetTimeOnAir(packet, txParams);
+    Time duration = GetTimeOnAir(packet->GetSize(), txParams);
     NS_LOG_DEBUG("Duration of packet: " << duration.As(Time::MS) << ", SF"
                                         << unsigned(txParams.sf));
 
@@ -252,9 +252,9 @@ EndDeviceLoraPhy::GetFilteredDuration(Ptr<const Packet> packet, Time duration) c
     {
         // Get transmission parameters
         LoraTag tag;
-        copy->RemovePacketTag(tag);
+        packet->PeekPacketTag(tag);
         // MHDR (1B) + 4B of Addr in FHdr
-        return GetTimeOnAir(Create<Packet>(5), tag.GetTxParameters());
+        return GetTimeOnAir(5, tag.GetTxParameters());
     }
     return duration;
 }
@@ -297,10 +297,10 @@ EndDeviceLoraPhy::EndReceive(Ptr<Packet> packet, Ptr<LoraInterferenceHelper::Eve
         NS_LOG_INFO("Packet destroyed by interference");
         // Update the packet's LoraTag
         LoraTag tag;
-        packet->RemovePacketTag(tag);
+        packet->PeekPacketTag(tag);
         tag.SetDestroyedBy(packetDestroyed);
         tag.SetReceptionTime(Simulator::Now());
-        packet->AddPacketTag(tag);
+        tag.WriteTo(packet);
         // If there is one, perform the callback to inform the upper layer of the
         // lost packet
         if (!m_rxFailedCallback.IsNull())
@@ -316,11 +316,11 @@ EndDeviceLoraPhy::EndReceive(Ptr<Packet> packet, Ptr<LoraInterferenceHelper::Eve
     // Set the receive power, frequency and SNR of this packet in the LoraTag:
     // here this information is useful for filling the packet sniffing header.
     LoraTag tag;
-    packet->RemovePacketTag(tag);
+    packet->PeekPacketTag(tag);
     tag.SetReceptionTime(Simulator::Now());
     tag.SetReceivePower(event->GetRxPowerdBm());
     tag.SetSnr(RxPowerToSNR(event->GetRxPowerdBm()));
-    packet->AddPacketTag(tag);
+    tag.WriteTo(packet);
     // If there is one, perform the callback to inform the upper layer
     if (!m_rxOkCallback.IsNull())
     {
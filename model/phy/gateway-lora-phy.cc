@@ -205,10 +205,10 @@ GatewayLoraPhy::EndReceive(Ptr<Packet> packet, Ptr<LoraInterferenceHelper::Event
         NS_LOG_DEBUG("packetDestroyed by interference on SF " << unsigned(packetDestroyed));
         // Update the packet's LoraTag
         LoraTag tag;
-        packet->RemovePacketTag(tag);
+        packet->PeekPacketTag(tag);
         tag.SetDestroyedBy(packetDestroyed);
         tag.SetReceptionTime(Simulator::Now());
-        packet->AddPacketTag(tag);
+        tag.WriteTo(packet);
         // Fire the trace source
         m_interferedPacket(packet, m_nodeId);
     }
@@ -220,11 +220,11 @@ GatewayLoraPhy::EndReceive(Ptr<Packet> packet, Ptr<LoraInterferenceHelper::Event
         // information can be useful for upper layers trying to control link
         // quality and to fill the packet sniffing header.
         LoraTag tag;
-        packet->RemovePacketTag(tag);
+        packet->PeekPacketTag(tag);
         tag.SetReceptionTime(Simulator::Now());
         tag.SetReceivePower(event->GetRxPowerdBm());
         tag.SetSnr(RxPowerToSNR(event->GetRxPowerdBm()));
-        packet->AddPacketTag(tag);
+        tag.WriteTo(packet);
         // Forward the packet to the upper layer
         if (!m_rxOkCallback.IsNull())
         {
@@ -274,12 +274,12 @@ GatewayLoraPhy::Send(Ptr<Packet> packet,
 
     // Tag packet with PHY layer tx info
     LoraTag tag;
-    packet->RemovePacketTag(tag);
+    packet->PeekPacketTag(tag);
     tag.SetTxParameters(txParams);
-    packet->AddPacketTag(tag);
+    tag.WriteTo(packet);
 
     // Get the time a packet with these parameters will take to be transmitted
-    Time duration = GetTimeOnAir(packet, txParams);
+    Time duration = GetTimeOnAir(packet->GetSize(), txParams);
     NS_LOG_DEBUG("Duration of packet: " << duration << ", SF" << unsigned(txParams.sf));
 
     // Set state to transmistting
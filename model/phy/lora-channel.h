@@ -106,12 +106,12 @@ class LoraChannel : public Channel
      * When this method is called, the channel schedules an internal Receive call
      * that performs the actual call to the PHY's StartReceive function.
      */
-    void Send(Ptr<LoraPhy> sender,
-              Ptr<Packet> packet,
-              double txPowerDbm,
-              uint8_t sf,
-              Time duration,
-              double frequency) const;
+    virtual void Send(Ptr<LoraPhy> sender,
+                      Ptr<Packet> packet,
+                      double txPowerDbm,
+                      uint8_t sf,
+                      Time duration,
+                      double frequency) const;
 
     /**
      * Compute the received power when transmitting from a point to another one.
@@ -129,7 +129,7 @@ class LoraChannel : public Channel
                       Ptr<MobilityModel> senderMobility,
                       Ptr<MobilityModel> receiverMobility) const;
 
-  private:
+  protected:
     /**
      * The vector containing the PHYs that are currently connected to the
      * channel.
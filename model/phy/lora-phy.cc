@@ -14,6 +14,9 @@
 
 #include "ns3/node.h"
 
+#include <array>
+#include <cmath>
+
 #define NOISE_FIGURE 6 //! Noise Figure (dB)
 
 namespace ns3
@@ -25,6 +28,80 @@ NS_LOG_COMPONENT_DEFINE("LoraPhy");
 
 NS_OBJECT_ENSURE_REGISTERED(LoraPhy);
 
+static constexpr uint8_t TOA_MIN_SF = 5;      //!< Smallest SF of the time on air table
+static constexpr uint8_t TOA_MAX_SF = 12;     //!< Largest SF of the time on air table
+static constexpr uint32_t TOA_MAX_SIZE = 255; //!< Largest size of the time on air table
+
+/**
+ * Index of an entry of the time on air table.
+ *
+ * \param sf The spreading factor.
+ * \param de Whether low data rate optimization is enabled.
+ * \param crc Whether CRC is enabled.
+ * \param h Whether the header is implicit.
+ * \param size The payload size (bytes).
+ * \return The index.
+ */
+static constexpr std::size_t
+ToaIndex(int sf, bool de, bool crc, bool h, uint32_t size)
+{
+    return ((((sf - TOA_MIN_SF) * 2 + de) * 2 + crc) * 2 + h) * (TOA_MAX_SIZE + 1) + size;
+}
+
+/**
+ * Build the table of code blocks of payloads, max(ceil((8 PL - 4 SF + 28 +
+ * 16 CRC - 20 H) / (4 (SF - 2 DE))), 0), for each SF, low data rate
+ * optimization, CRC, header mode and size. The coding rate, preamble and
+ * bandwidth scale durations linearly, so they are applied at lookup.
+ *
+ * \return The table.
+ */
+static constexpr auto
+MakeToaTable()
+{
+    std::array<uint8_t, ToaIndex(TOA_MAX_SF + 1, false, false, false, 0)> table{};
+    for (int sf = TOA_MIN_SF; sf <= TOA_MAX_SF; ++sf)
+    {
+        for (int de = 0; de < 2; ++de)
+        {
+            for (int crc = 0; crc < 2; ++crc)
+            {
+                for (int h = 0; h < 2; ++h)
+                {
+                    for (int pl = 0; pl <= int(TOA_MAX_SIZE); ++pl)
+                    {
+                        int num = 8 * pl - 4 * sf + 28 + 16 * crc - 20 * h;
+                        int den = 4 * (sf - 2 * de);
+                        table[ToaIndex(sf, de, crc, h, pl)] = num > 0 ? (num + den - 1) / den : 0;
+                    }
+                }
+            }
+        }
+    }
+    return table;
+}
+
+static constexpr auto TOA_CODE_BLOCKS = MakeToaTable(); //!< Code blocks of payloads
+
+/**
+ * Symbol time, when the bandwidth divides one second in an integer number of
+ * nanoseconds, as the ones of LoRaWAN regions do.
+ *
+ * \param txParams The transmission parameters.
+ * \return The symbol time (ns), 0 if not an integer.
+ */
+static int64_t
+GetTSymNs(const LoraPhyTxParameters& txParams)
+{
+    auto bandwidth = int64_t(txParams.bandwidthHz);
+    if (txParams.sf > 30 || bandwidth <= 0 || bandwidth != txParams.bandwidthHz ||
+        1000000000 % bandwidth)
+    {
+        return 0;
+    }
+    return (int64_t(1) << txParams.sf) * (1000000000 / bandwidth);
+}
+
 TypeId
 LoraPhy::GetTypeId()
 {
@@ -209,25 +286,51 @@ Time
 LoraPhy::GetTSym(const LoraPhyTxParameters& txParams)
 {
     NS_LOG_FUNCTION(txParams);
-    return Seconds(pow(2, int(txParams.sf)) / (txParams.bandwidthHz));
+    if (int64_t tSym = GetTSymNs(txParams); tSym)
+    {
+        return NanoSeconds(tSym);
+    }
+    return Seconds(std::ldexp(1.0, txParams.sf) / txParams.bandwidthHz);
 }
 
 Time
 LoraPhy::GetTimeOnAir(Ptr<const Packet> packet, const LoraPhyTxParameters& txParams)
 {
     NS_LOG_FUNCTION(packet << txParams);
+    return GetTimeOnAir(packet->GetSize(), txParams);
+}
+
+Time
+LoraPhy::GetTimeOnAir(uint32_t size, const LoraPhyTxParameters& txParams)
+{
+    NS_LOG_FUNCTION(size << txParams);
 
     // The contents of this function are based on [1].
     // [1] SX1272 LoRa modem designer's guide.
 
+    // Fast path: payload symbols from the table, durations in integer quarters of symbol
+    int64_t tSym = GetTSymNs(txParams);
+    if (tSym && txParams.sf >= TOA_MIN_SF && txParams.sf <= TOA_MAX_SF && size <= TOA_MAX_SIZE)
+    {
+        uint32_t codeBlocks = TOA_CODE_BLOCKS[ToaIndex(txParams.sf,
+                                                        txParams.lowDataRateOptimizationEnabled,
+                                                        txParams.crcEnabled,
+                                                        txParams.headerDisabled,
+                                                        size)];
+        // Preamble (nPreamble + 4.25) and payload (8 + blocks * (cr + 4)) symbols
+        int64_t quarters =
+            4 * txParams.nPreamble + 17 + 4 * (8 + codeBlocks * (txParams.codingRate + 4));
+        return NanoSeconds(tSym * quarters / 4);
+    }
+
     // Compute the symbol duration
-    Time tSym = GetTSym(txParams);
+    Time tSymTime = GetTSym(txParams);
 
     // Compute the preamble duration
-    Time tPreamble = (double(txParams.nPreamble) + 4.25) * tSym;
+    Time tPreamble = (double(txParams.nPreamble) + 4.25) * tSymTime;
 
     // Payload size
-    uint32_t pl = packet->GetSize(); // Size in bytes
+    uint32_t pl = size; // Size in bytes
     NS_LOG_DEBUG("Packet of size " << pl << " bytes");
 
     // This step is needed since the formula deals with double values.
@@ -244,10 +347,10 @@ LoraPhy::GetTimeOnAir(Ptr<const Packet> packet, const LoraPhyTxParameters& txPar
         8 + std::max(std::ceil(num / den) * (txParams.codingRate + 4), double(0));
 
     // Time to transmit the payload
-    Time tPayload = payloadSymbNb * tSym;
+    Time tPayload = payloadSymbNb * tSymTime;
 
     NS_LOG_DEBUG("Time computation: num = " << num << ", den = " << den << ", payloadSymbNb = "
-                                            << payloadSymbNb << ", tSym = " << tSym);
+                                            << payloadSymbNb << ", tSym = " << tSymTime);
     NS_LOG_DEBUG("tPreamble = " << tPreamble);
     NS_LOG_DEBUG("tPayload = " << tPayload);
     NS_LOG_DEBUG("Total time = " << tPreamble + tPayload);
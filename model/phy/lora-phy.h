@@ -231,6 +231,21 @@ class LoraPhy : public Object
      */
     static Time GetTimeOnAir(Ptr<const Packet> packet, const LoraPhyTxParameters& txParams);
 
+    /**
+     * Compute the time that a payload of a certain size will take to be
+     * transmitted, without building a packet.
+     *
+     * Payload symbols are read from a table computed at compile time for SF5
+     * to SF12 and sizes up to 255 bytes, and durations are computed in
+     * integer nanoseconds for bandwidths dividing one second, as the ones of
+     * LoRaWAN regions do. Other configurations fall back to the formula.
+     *
+     * \param size The size of the PHY payload (bytes), headers and trailers included.
+     * \param txParams The set of parameters that will be used for transmission.
+     * \return The time necessary to transmit the payload.
+     */
+    static Time GetTimeOnAir(uint32_t size, const LoraPhyTxParameters& txParams);
+
     /**
      * Compute the Signal to Noise Ratio (SNR) from the transmission power
      * measured at packet reception.
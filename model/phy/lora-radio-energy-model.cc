@@ -14,11 +14,15 @@
 
 #include "lora-radio-energy-model.h"
 
+#include "ns3/boolean.h"
+#include "ns3/double.h"
 #include "ns3/energy-source.h"
 #include "ns3/log.h"
 #include "ns3/pointer.h"
 #include "ns3/simulator.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 namespace lorawan
@@ -65,6 +69,13 @@ LoraRadioEnergyModel::GetTypeId()
                           PointerValue(),
                           MakePointerAccessor(&LoraRadioEnergyModel::m_txCurrentModel),
                           MakePointerChecker<LoraTxCurrentModel>())
+            .AddAttribute("LazyAccounting",
+                          "Whether to compute energy consumption only when it is queried. "
+                          "The energy source is then updated only by its periodic updates "
+                          "and at its predicted depletion time.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&LoraRadioEnergyModel::m_lazyAccounting),
+                          MakeBooleanChecker())
             .AddTraceSource(
                 "TotalEnergyConsumption",
                 "Total energy consumption of the radio device.",
@@ -80,6 +91,15 @@ LoraRadioEnergyModel::LoraRadioEnergyModel()
     m_lastUpdateTime = Seconds(0.0);
     m_nPendingChangeState = 0;
     m_isSupersededChangeState = false;
+    m_lazyAccounting = false;
+    m_pendingCharge = 0.0;
+    m_sourceCharge = 0.0;
+    m_sourceUpdateTime = Seconds(0.0);
+    m_sourceUpdateInterval = Time::Max();
+    m_depletionThresholdJ = 0.0;
+    m_firstCheckEnergyJ = 0.0;
+    m_firstCheckTime = Time::Max();
+    m_checkingDepletion = false;
     m_energyDepletionCallback.Nullify();
     m_source = nullptr;
     // set callback for EndDeviceLoraPhy listener
@@ -102,12 +122,33 @@ LoraRadioEnergyModel::SetEnergySource(Ptr<EnergySource> source)
     NS_LOG_FUNCTION(this << source);
     NS_ASSERT(source != nullptr);
     m_source = source;
+
+    if (m_lazyAccounting)
+    {
+        // Sources without low battery threshold are depleted when empty
+        DoubleValue threshold;
+        if (source->GetAttributeFailSafe("BasicEnergyLowBatteryThreshold", threshold))
+        {
+            m_depletionThresholdJ = threshold.Get() * source->GetInitialEnergy();
+        }
+        TimeValue interval;
+        if (source->GetAttributeFailSafe("PeriodicEnergyUpdateInterval", interval))
+        {
+            m_sourceUpdateInterval = interval.Get();
+        }
+        m_depletionCheck.Cancel();
+        m_depletionCheck = Simulator::ScheduleNow(&LoraRadioEnergyModel::CheckDepletion, this);
+    }
 }
 
 double
 LoraRadioEnergyModel::GetTotalEnergyConsumption() const
 {
     NS_LOG_FUNCTION(this);
+    if (m_lazyAccounting)
+    {
+        UpdateTotalEnergyConsumption();
+    }
     return m_totalEnergyConsumption;
 }
 
@@ -216,6 +257,14 @@ LoraRadioEnergyModel::ChangeState(int newState)
 {
     NS_LOG_FUNCTION(this << newState);
 
+    if (m_lazyAccounting)
+    {
+        // Energy is computed from the charge when queried
+        AccumulateCharge();
+        SetLoraRadioState((EndDeviceLoraPhy::State)newState);
+        return;
+    }
+
     Time duration = Simulator::Now() - m_lastUpdateTime;
     NS_ASSERT(duration.GetNanoSeconds() >= 0); // check if duration is valid
 
@@ -278,6 +327,10 @@ LoraRadioEnergyModel::HandleEnergyDepletion()
 {
     NS_LOG_FUNCTION(this);
     NS_LOG_DEBUG("LoraRadioEnergyModel:Energy is depleted!");
+    if (m_lazyAccounting)
+    {
+        SettleSourceCharge();
+    }
     // invoke energy depletion callback, if set.
     if (!m_energyDepletionCallback.IsNull())
     {
@@ -290,6 +343,17 @@ LoraRadioEnergyModel::HandleEnergyChanged()
 {
     NS_LOG_FUNCTION(this);
     NS_LOG_DEBUG("LoraRadioEnergyModel:Energy changed!");
+    if (m_lazyAccounting)
+    {
+        // The periodic updates of the source detect depletion by themselves,
+        // checking again after each of them would defeat lazy accounting
+        bool periodic = (Simulator::Now() - m_sourceUpdateTime == m_sourceUpdateInterval);
+        SettleSourceCharge();
+        if (!periodic)
+        {
+            RescheduleDepletionCheck();
+        }
+    }
 }
 
 void
@@ -297,11 +361,22 @@ LoraRadioEnergyModel::HandleEnergyRecharged()
 {
     NS_LOG_FUNCTION(this);
     NS_LOG_DEBUG("LoraRadioEnergyModel:Energy is recharged!");
+    if (m_lazyAccounting)
+    {
+        SettleSourceCharge();
+    }
     // invoke energy recharged callback, if set.
     if (!m_energyRechargedCallback.IsNull())
     {
         m_energyRechargedCallback();
     }
+    // restart predicting depletion from the new consumption rate
+    if (m_lazyAccounting)
+    {
+        m_firstCheckTime = Time::Max();
+        m_depletionCheck.Cancel();
+        m_depletionCheck = Simulator::ScheduleNow(&LoraRadioEnergyModel::CheckDepletion, this);
+    }
 }
 
 LoraRadioEnergyModelPhyListener*
@@ -319,6 +394,7 @@ void
 LoraRadioEnergyModel::DoDispose()
 {
     NS_LOG_FUNCTION(this);
+    m_depletionCheck.Cancel();
     m_source = nullptr;
     m_txCurrentModel = nullptr;
     DeviceEnergyModel::DoDispose();
@@ -328,7 +404,26 @@ double
 LoraRadioEnergyModel::DoGetCurrentA() const
 {
     NS_LOG_FUNCTION(this);
-    switch (m_currentState)
+    if (m_lazyAccounting)
+    {
+        // The source multiplies the current by the time elapsed since its
+        // previous update, which is when the charge was last settled
+        Time now = Simulator::Now();
+        double seconds = (now - m_sourceUpdateTime).GetSeconds();
+        if (seconds > 0)
+        {
+            double charge = m_sourceCharge + (now - m_lastUpdateTime).GetSeconds() *
+                                                 GetStateCurrentA(m_currentState);
+            return charge / seconds;
+        }
+    }
+    return GetStateCurrentA(m_currentState);
+}
+
+double
+LoraRadioEnergyModel::GetStateCurrentA(EndDeviceLoraPhy::State state) const
+{
+    switch (state)
     {
     case EndDeviceLoraPhy::STANDBY:
         return m_idleCurrentA;
@@ -339,8 +434,92 @@ LoraRadioEnergyModel::DoGetCurrentA() const
     case EndDeviceLoraPhy::SLEEP:
         return m_sleepCurrentA;
     default:
-        NS_FATAL_ERROR("LoraRadioEnergyModel:Undefined radio state:" << m_currentState);
+        NS_FATAL_ERROR("LoraRadioEnergyModel:Undefined radio state:" << state);
+    }
+}
+
+void
+LoraRadioEnergyModel::AccumulateCharge() const
+{
+    Time now = Simulator::Now();
+    double charge = (now - m_lastUpdateTime).GetSeconds() * GetStateCurrentA(m_currentState);
+    m_pendingCharge += charge;
+    m_sourceCharge += charge;
+    m_lastUpdateTime = now;
+}
+
+void
+LoraRadioEnergyModel::UpdateTotalEnergyConsumption() const
+{
+    AccumulateCharge();
+    if (m_pendingCharge > 0)
+    {
+        m_totalEnergyConsumption += m_pendingCharge * m_source->GetSupplyVoltage();
+        m_pendingCharge = 0.0;
+        NS_LOG_DEBUG("LoraRadioEnergyModel:Total energy consumption is " << m_totalEnergyConsumption
+                                                                         << "J");
+    }
+}
+
+void
+LoraRadioEnergyModel::SettleSourceCharge()
+{
+    AccumulateCharge();
+    m_sourceCharge = 0.0;
+    m_sourceUpdateTime = Simulator::Now();
+}
+
+void
+LoraRadioEnergyModel::CheckDepletion()
+{
+    NS_LOG_FUNCTION(this);
+
+    // Querying the remaining energy updates the source, which handles depletion
+    m_checkingDepletion = true;
+    double energyJ = m_source->GetRemainingEnergy() - m_depletionThresholdJ;
+    m_checkingDepletion = false;
+    if (energyJ <= 0)
+    {
+        return;
+    }
+
+    // Predict from the average consumption since the first check, or from the
+    // highest current of the radio as long as it is unknown
+    Time now = Simulator::Now();
+    double powerW = 0.0;
+    if (now > m_firstCheckTime && m_firstCheckEnergyJ > energyJ)
+    {
+        powerW = (m_firstCheckEnergyJ - energyJ) / (now - m_firstCheckTime).GetSeconds();
+    }
+    else
+    {
+        if (m_firstCheckTime == Time::Max())
+        {
+            m_firstCheckEnergyJ = energyJ;
+            m_firstCheckTime = now;
+        }
+        powerW = std::max({m_txCurrentA, m_rxCurrentA, m_idleCurrentA, m_sleepCurrentA}) *
+                 m_source->GetSupplyVoltage();
+    }
+    if (powerW <= 0)
+    {
+        return;
+    }
+    Time delay = Seconds(energyJ / powerW);
+    NS_LOG_DEBUG("LoraRadioEnergyModel:Predicted depletion in " << delay.As(Time::S));
+    m_depletionCheck.Cancel();
+    m_depletionCheck = Simulator::Schedule(delay, &LoraRadioEnergyModel::CheckDepletion, this);
+}
+
+void
+LoraRadioEnergyModel::RescheduleDepletionCheck()
+{
+    if (m_checkingDepletion || !m_source)
+    {
+        return;
     }
+    m_depletionCheck.Cancel();
+    m_depletionCheck = Simulator::ScheduleNow(&LoraRadioEnergyModel::CheckDepletion, this);
 }
 
 void
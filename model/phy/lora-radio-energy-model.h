@@ -19,6 +19,8 @@
 #include "lora-tx-current-model.h"
 
 #include "ns3/device-energy-model.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
 #include "ns3/traced-value.h"
 
 namespace ns3
@@ -124,6 +126,17 @@ class LoraRadioEnergyModelPhyListener : public EndDeviceLoraPhyListener
  * object. The EnergySource object will query this model for the total current.
  * Then the EnergySource object uses the total current to calculate energy.
  *
+ * With lazy accounting, transactions only accumulate the charge drawn by the
+ * radio. The energy consumption is computed when it is queried, and the
+ * EnergySource is given the average current since its previous update when it
+ * updates itself (periodically, or when its remaining energy is queried).
+ * Querying the current has no side effect: the charge given to the source is
+ * settled when the source notifies the model that its energy changed, was
+ * depleted or recharged, so states are expected to draw a nonzero current. An
+ * event is scheduled at the depletion time of the source predicted from its
+ * rate of consumption, and moved whenever the source is updated, to let it
+ * detect depletion: the periodic updates of the source can then be made rare
+ * to speed up large simulations.
  */
 class LoraRadioEnergyModel : public DeviceEnergyModel
 {
@@ -284,6 +297,44 @@ class LoraRadioEnergyModel : public DeviceEnergyModel
   private:
     void DoDispose() override;
 
+    /**
+     * \brief Gets the current drawn in a state.
+     *
+     * \param state The radio state.
+     * \returns The current (A).
+     */
+    double GetStateCurrentA(EndDeviceLoraPhy::State state) const;
+
+    /**
+     * \brief Accumulates the charge drawn in the current state since the last
+     *        state change (lazy accounting).
+     */
+    void AccumulateCharge() const;
+
+    /**
+     * \brief Converts the accumulated charge to total energy consumption (lazy
+     *        accounting).
+     */
+    void UpdateTotalEnergyConsumption() const;
+
+    /**
+     * \brief Starts a new window of charge given to the energy source, after
+     *        the source was updated (lazy accounting).
+     */
+    void SettleSourceCharge();
+
+    /**
+     * \brief Updates the energy source and schedules the next update at its
+     *        predicted depletion time (lazy accounting).
+     */
+    void CheckDepletion();
+
+    /**
+     * \brief Predicts the depletion time again from now, after the source was
+     *        updated outside of CheckDepletion (lazy accounting).
+     */
+    void RescheduleDepletionCheck();
+
     /**
      * \returns Current draw of device, at current state.
      *
@@ -310,11 +361,23 @@ class LoraRadioEnergyModel : public DeviceEnergyModel
     Ptr<LoraTxCurrentModel> m_txCurrentModel; ///< current model
 
     /// This variable keeps track of the total energy consumed by this model.
-    TracedValue<double> m_totalEnergyConsumption;
+    mutable TracedValue<double> m_totalEnergyConsumption;
 
     // State variables.
     EndDeviceLoraPhy::State m_currentState; ///< current state the radio is in
-    Time m_lastUpdateTime;                  ///< time stamp of previous energy update
+    mutable Time m_lastUpdateTime;          ///< time stamp of previous energy update
+
+    // Lazy accounting variables.
+    bool m_lazyAccounting;           ///< whether energy is computed only when queried
+    mutable double m_pendingCharge;  ///< charge not yet converted to energy (C)
+    mutable double m_sourceCharge;   ///< charge drawn since the last source update (C)
+    Time m_sourceUpdateTime;         ///< time stamp of the last source update
+    Time m_sourceUpdateInterval;     ///< interval of the periodic updates of the source
+    double m_depletionThresholdJ;    ///< remaining energy at which the source is depleted
+    double m_firstCheckEnergyJ;      ///< remaining energy at the first depletion check
+    Time m_firstCheckTime;           ///< time stamp of the first depletion check
+    EventId m_depletionCheck;        ///< next depletion check
+    bool m_checkingDepletion;        ///< whether CheckDepletion is updating the source
 
     uint8_t m_nPendingChangeState;  ///< pending state change
     bool m_isSupersededChangeState; ///< superseded change state
@@ -9,13 +9,16 @@
 
 #include "range-position-allocator.h"
 
+#include "ns3/abort.h"
 #include "ns3/double.h"
 #include "ns3/mobility-module.h"
 #include "ns3/node-container.h"
 #include "ns3/pointer.h"
 #include "ns3/string.h"
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
 
 namespace ns3
 {
@@ -24,6 +27,16 @@ NS_LOG_COMPONENT_DEFINE("RangePositionAllocator");
 
 NS_OBJECT_ENSURE_REGISTERED(RangePositionAllocator);
 
+// Maximum number of points drawn for a position before giving up
+static const uint32_t MAX_ATTEMPTS = 1000000;
+
+// Key of the grid cell of coordinates (cx, cy)
+static int64_t
+CellKey(int64_t cx, int64_t cy)
+{
+    return int64_t((uint64_t(cx) << 32) | uint32_t(cy));
+}
+
 TypeId
 RangePositionAllocator::GetTypeId()
 {
@@ -65,6 +78,8 @@ RangePositionAllocator::GetTypeId()
 }
 
 RangePositionAllocator::RangePositionAllocator()
+    : m_indexRange(0),
+      m_areasZ(std::numeric_limits<double>::quiet_NaN())
 {
     m_rv = CreateObject<UniformRandomVariable>();
 }
@@ -116,56 +131,123 @@ RangePositionAllocator::SetNodes(NodeContainer nodes)
     {
         m_nodes.push_back(*i);
     }
+    // Positions are indexed again at the next allocation
+    m_positions.clear();
 }
 
-bool
-RangePositionAllocator::OutOfRange(double x, double y, double z) const
+void
+RangePositionAllocator::BuildIndex() const
 {
-    bool oor = true;
-    for (auto i : m_nodes)
+    NS_ABORT_MSG_IF(m_nodes.empty(), "No nodes to allocate positions in range of");
+    NS_ABORT_MSG_IF(m_range <= 0, "The range from nodes must be positive");
+
+    m_positions.clear();
+    m_grid.clear();
+    m_indexRange = m_range;
+    m_areasZ = std::numeric_limits<double>::quiet_NaN();
+    for (uint32_t i = 0; i < m_nodes.size(); ++i)
     {
-        Ptr<MobilityModel> pos = CreateObject<ConstantPositionMobilityModel>();
-        pos->SetPosition(Vector(x, y, z));
-        double dist = i->GetObject<MobilityModel>()->GetDistanceFrom(pos);
-
-        if (dist <= 1.0)
+        Vector position = m_nodes[i]->GetObject<MobilityModel>()->GetPosition();
+        m_positions.push_back(position);
+        // Add the node to all cells overlapped by the square around its disc
+        int64_t xmin = std::floor((position.x - m_range) / m_range);
+        int64_t xmax = std::floor((position.x + m_range) / m_range);
+        int64_t ymin = std::floor((position.y - m_range) / m_range);
+        int64_t ymax = std::floor((position.y + m_range) / m_range);
+        for (int64_t cx = xmin; cx <= xmax; ++cx)
         {
-            return true;
+            for (int64_t cy = ymin; cy <= ymax; ++cy)
+            {
+                m_grid[CellKey(cx, cy)].push_back(i);
+            }
         }
+    }
+    NS_LOG_DEBUG("Indexed " << m_positions.size() << " nodes in " << m_grid.size() << " cells");
+}
+
+void
+RangePositionAllocator::ComputeAreas(double z) const
+{
+    m_areas.resize(m_positions.size());
+    double total = 0;
+    for (uint32_t i = 0; i < m_positions.size(); ++i)
+    {
+        // Squared radius of the coverage disc at this height
+        double dz = z - m_positions[i].z;
+        total += std::max(0.0, m_range * m_range - dz * dz);
+        m_areas[i] = total;
+    }
+    NS_ABORT_MSG_IF(total <= 0, "No node is in range at height " << z);
+    m_areasZ = z;
+}
 
-        if (dist < m_range)
+bool
+RangePositionAllocator::IsFirstInRange(uint32_t node, const Vector& position) const
+{
+    for (auto i : m_grid.at(GetCell(position.x, position.y)))
+    {
+        double dist = CalculateDistance(position, m_positions[i]);
+        if (dist <= 1.0 || (i < node && dist < m_range))
         {
-            oor = false;
+            return false;
         }
     }
-    return oor;
+    return true;
+}
+
+int64_t
+RangePositionAllocator::GetCell(double x, double y) const
+{
+    return CellKey(std::floor(x / m_indexRange), std::floor(y / m_indexRange));
 }
 
 Vector
 RangePositionAllocator::GetNext() const
 {
-    double x;
-    double y;
-    double z;
+    double z = (bool(m_zrv) == 0) ? m_z : m_zrv->GetValue();
+    if (m_positions.empty() || m_indexRange != m_range)
+    {
+        BuildIndex();
+    }
+    if (z != m_areasZ)
+    {
+        ComputeAreas(z);
+    }
 
-    z = (bool(m_zrv) == 0) ? m_z : m_zrv->GetValue();
+    Vector position;
+    uint32_t node;
+    uint32_t attempts = 0;
     do
     {
-        x = m_rv->GetValue(-m_rho, m_rho);
-        y = m_rv->GetValue(-m_rho, m_rho);
-    } while (std::sqrt(x * x + y * y) > m_rho || OutOfRange(x + m_x, y + m_y, z));
-
-    x += m_x;
-    y += m_y;
-    NS_LOG_DEBUG("In-range position x=" << x << ", y=" << y << ", z=" << z);
-    return Vector(x, y, z);
+        NS_ABORT_MSG_IF(attempts++ == MAX_ATTEMPTS,
+                        "No position in range of nodes found in the allocation disc after "
+                            << MAX_ATTEMPTS << " attempts, check rho, range and node positions");
+        // Draw a node with probability proportional to the area of its disc
+        double area = m_rv->GetValue(0, m_areas.back());
+        node = std::upper_bound(m_areas.begin(), m_areas.end(), area) - m_areas.begin();
+        node = std::min<uint32_t>(node, m_areas.size() - 1);
+        // Draw a point uniformly in the disc
+        const Vector& center = m_positions[node];
+        double dz = z - center.z;
+        double radius = std::sqrt(std::max(0.0, m_range * m_range - dz * dz));
+        double rho = radius * std::sqrt(m_rv->GetValue(0, 1));
+        double theta = m_rv->GetValue(0, 2 * M_PI);
+        position = Vector(center.x + rho * std::cos(theta), center.y + rho * std::sin(theta), z);
+    } while (std::hypot(position.x - m_x, position.y - m_y) > m_rho ||
+             !IsFirstInRange(node, position));
+
+    NS_LOG_DEBUG("In-range position x=" << position.x << ", y=" << position.y << ", z=" << z);
+    return position;
 }
 
 int64_t
 RangePositionAllocator::AssignStreams(int64_t stream)
 {
     m_rv->SetStream(stream);
-    m_zrv->SetStream(stream);
+    if (m_zrv)
+    {
+        m_zrv->SetStream(stream);
+    }
     return 1;
 }
 
@@ -14,12 +14,23 @@
 #include "ns3/position-allocator.h"
 
 #include <cmath>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
 
 /**
  * \brief Produce positions in range of a set of nodes.
+ *
+ * Positions are uniformly distributed over the part of the allocation disc
+ * that is within range of at least one node (and farther than 1 m from all
+ * of them). A node is drawn with probability proportional to the area of its
+ * coverage disc at the height of the position, a point is drawn in that disc,
+ * and it is kept only if the drawn node is the first one covering it. Node
+ * positions are read at the first allocation and indexed in a grid, so that
+ * only nearby nodes are checked. The simulation is aborted if no position is
+ * accepted after a million draws, e.g., if no node is in range of the disc.
  */
 class RangePositionAllocator : public PositionAllocator
 {
@@ -67,7 +78,34 @@ class RangePositionAllocator : public PositionAllocator
     int64_t AssignStreams(int64_t stream) override;
 
   private:
-    bool OutOfRange(double x, double y, double z) const;
+    /**
+     * Index the positions of nodes in a grid of cells as large as the range.
+     */
+    void BuildIndex() const;
+
+    /**
+     * Compute the cumulative areas of coverage discs of nodes at a height.
+     *
+     * \param z The height of positions.
+     */
+    void ComputeAreas(double z) const;
+
+    /**
+     * Check that a position is in range of a node, not too close to any node,
+     * and not in range of any node before it.
+     *
+     * \param node The index of the node.
+     * \param position The position.
+     * \return Whether the position is accepted for the node.
+     */
+    bool IsFirstInRange(uint32_t node, const Vector& position) const;
+
+    /**
+     * \param x The abscissa.
+     * \param y The ordinate.
+     * \return The key of the grid cell containing a position.
+     */
+    int64_t GetCell(double x, double y) const;
 
     Ptr<UniformRandomVariable> m_rv; //!< pointer to uniform random variable
     double m_rho;                    //!< value of the radius of the disc
@@ -77,6 +115,16 @@ class RangePositionAllocator : public PositionAllocator
     double m_z;                      //!< z coordinate of the disc
     Ptr<RandomVariableStream> m_zrv; //!< random variable to extract z coordinates
     std::vector<Ptr<Node>> m_nodes;  //!< the nodes to be in range of
+
+    mutable std::vector<Vector> m_positions; //!< Positions of nodes, read at the first allocation
+    mutable double m_indexRange;             //!< Range of the current index
+    mutable std::vector<double> m_areas;     //!< Cumulative areas of coverage discs of nodes
+    mutable double m_areasZ;                 //!< Height the areas were computed for
+
+    /**
+     * Indices of the nodes whose coverage disc overlaps each cell of the grid
+     */
+    mutable std::unordered_map<int64_t, std::vector<uint32_t>> m_grid;
 };
 
 } // namespace ns3
@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2026 University of Bologna
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Alessandro Aimi <alessandro.aimi@unibo.it>
+ */
+
+#include "shadowing-field-propagation-loss-model.h"
+
+#include "ns3/abort.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SHADOWING_FIELD_MMAP
+#endif
+
+namespace ns3
+{
+namespace lorawan
+{
+
+NS_LOG_COMPONENT_DEFINE("ShadowingFieldPropagationLossModel");
+
+NS_OBJECT_ENSURE_REGISTERED(ShadowingFieldPropagationLossModel);
+
+// Layout of raster files: magic, version, nx, ny, padding, xMin, yMin, step, values
+static const char FIELD_MAGIC[8] = {'L', 'O', 'R', 'A', 'S', 'H', 'D', 'W'};
+static const uint32_t FIELD_VERSION = 1;
+static const std::size_t FIELD_HEADER_SIZE = 48;
+
+TypeId
+ShadowingFieldPropagationLossModel::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::ShadowingFieldPropagationLossModel")
+            .SetParent<PropagationLossModel>()
+            .SetGroupName("lorawan")
+            .AddConstructor<ShadowingFieldPropagationLossModel>()
+            .AddAttribute("StandardDeviation",
+                          "Standard deviation of the shadowing of a link (dB)",
+                          DoubleValue(4.0),
+                          MakeDoubleAccessor(&ShadowingFieldPropagationLossModel::m_sigma),
+                          MakeDoubleChecker<double>(0))
+            .AddAttribute(
+                "CorrelationDistance",
+                "The distance at which the correlation of the field falls to 1/e (m)",
+                DoubleValue(110.0),
+                MakeDoubleAccessor(&ShadowingFieldPropagationLossModel::m_correlationDistance),
+                MakeDoubleChecker<double>(0))
+            .AddAttribute("Resolution",
+                          "Distance between points of generated rasters (m)",
+                          DoubleValue(10.0),
+                          MakeDoubleAccessor(&ShadowingFieldPropagationLossModel::m_resolution),
+                          MakeDoubleChecker<double>(std::numeric_limits<double>::min()));
+    return tid;
+}
+
+ShadowingFieldPropagationLossModel::ShadowingFieldPropagationLossModel()
+    : m_sigma(4.0),
+      m_correlationDistance(110.0),
+      m_resolution(10.0),
+      m_nx(0),
+      m_ny(0),
+      m_xMin(0),
+      m_yMin(0),
+      m_step(0),
+      m_field(nullptr),
+      m_mapping(nullptr),
+      m_mappingSize(0)
+{
+    NS_LOG_FUNCTION(this);
+
+    m_normal = CreateObject<NormalRandomVariable>();
+    m_normal->SetAttribute("Mean", DoubleValue(0.0));
+    m_normal->SetAttribute("Variance", DoubleValue(1.0));
+}
+
+ShadowingFieldPropagationLossModel::~ShadowingFieldPropagationLossModel()
+{
+    NS_LOG_FUNCTION(this);
+
+    Clear();
+}
+
+void
+ShadowingFieldPropagationLossModel::Generate(const Box& box)
+{
+    NS_LOG_FUNCTION(this << box);
+    NS_ABORT_MSG_IF(box.xMax < box.xMin || box.yMax < box.yMin, "Invalid bounding box");
+
+    Clear();
+    m_step = m_resolution;
+    m_xMin = box.xMin;
+    m_yMin = box.yMin;
+    m_nx = std::max<uint32_t>(2, std::ceil((box.xMax - box.xMin) / m_step) + 1);
+    m_ny = std::max<uint32_t>(2, std::ceil((box.yMax - box.yMin) / m_step) + 1);
+    NS_LOG_INFO("Generating a shadowing field of " << m_nx << "x" << m_ny << " points");
+
+    // Separable exponential correlation is obtained exactly by a first order
+    // autoregression along both axes: every point depends on its three
+    // preceding neighbors, and the innovation keeps the variance to one.
+    double rho = std::exp(-m_step / m_correlationDistance);
+    double edge = std::sqrt(1 - rho * rho);
+    double inner = 1 - rho * rho;
+    m_storage.resize(std::size_t(m_nx) * m_ny);
+    float* z = m_storage.data();
+    for (uint32_t i = 0; i < m_ny; ++i)
+    {
+        float* row = z + std::size_t(i) * m_nx;
+        const float* prev = row - m_nx;
+        for (uint32_t j = 0; j < m_nx; ++j)
+        {
+            double e = m_normal->GetValue();
+            if (i == 0 && j == 0)
+            {
+                row[j] = e;
+            }
+            else if (i == 0)
+            {
+                row[j] = rho * row[j - 1] + edge * e;
+            }
+            else if (j == 0)
+            {
+                row[j] = rho * prev[j] + edge * e;
+            }
+            else
+            {
+                row[j] = rho * (row[j - 1] + prev[j]) - rho * rho * prev[j - 1] + inner * e;
+            }
+        }
+    }
+    m_field = z;
+}
+
+void
+ShadowingFieldPropagationLossModel::Save(const std::string& filename) const
+{
+    NS_LOG_FUNCTION(this << filename);
+    NS_ABORT_MSG_IF(!m_field, "No shadowing field to save");
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    NS_ABORT_MSG_IF(!file.is_open(), "Unable to open shadowing field file " << filename);
+    char header[FIELD_HEADER_SIZE] = {};
+    std::memcpy(header, FIELD_MAGIC, 8);
+    std::memcpy(header + 8, &FIELD_VERSION, 4);
+    std::memcpy(header + 12, &m_nx, 4);
+    std::memcpy(header + 16, &m_ny, 4);
+    std::memcpy(header + 24, &m_xMin, 8);
+    std::memcpy(header + 32, &m_yMin, 8);
+    std::memcpy(header + 40, &m_step, 8);
+    file.write(header, FIELD_HEADER_SIZE);
+    file.write(reinterpret_cast<const char*>(m_field), sizeof(float) * m_nx * m_ny);
+    NS_ABORT_MSG_IF(!file, "Unable to write shadowing field file " << filename);
+}
+
+void
+ShadowingFieldPropagationLossModel::Load(const std::string& filename)
+{
+    NS_LOG_FUNCTION(this << filename);
+
+    Clear();
+    const char* data = nullptr;
+    std::size_t size = 0;
+#ifdef SHADOWING_FIELD_MMAP
+    int fd = open(filename.c_str(), O_RDONLY);
+    NS_ABORT_MSG_IF(fd < 0, "Unable to open shadowing field file " << filename);
+    struct stat st;
+    NS_ABORT_MSG_IF(fstat(fd, &st) < 0, "Unable to stat shadowing field file " << filename);
+    size = st.st_size;
+    NS_ABORT_MSG_IF(size < FIELD_HEADER_SIZE, "Invalid shadowing field file " << filename);
+    m_mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    NS_ABORT_MSG_IF(m_mapping == MAP_FAILED, "Unable to map shadowing field file " << filename);
+    m_mappingSize = size;
+    data = static_cast<const char*>(m_mapping);
+#else
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    NS_ABORT_MSG_IF(!file.is_open(), "Unable to open shadowing field file " << filename);
+    size = file.tellg();
+    NS_ABORT_MSG_IF(size < FIELD_HEADER_SIZE, "Invalid shadowing field file " << filename);
+    m_storage.resize((size + sizeof(float) - 1) / sizeof(float));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(m_storage.data()), size);
+    data = reinterpret_cast<const char*>(m_storage.data());
+#endif
+
+    uint32_t version;
+    std::memcpy(&version, data + 8, 4);
+    NS_ABORT_MSG_IF(std::memcmp(data, FIELD_MAGIC, 8) != 0 || version != FIELD_VERSION,
+                    "Invalid shadowing field file " << filename);
+    std::memcpy(&m_nx, data + 12, 4);
+    std::memcpy(&m_ny, data + 16, 4);
+    std::memcpy(&m_xMin, data + 24, 8);
+    std::memcpy(&m_yMin, data + 32, 8);
+    std::memcpy(&m_step, data + 40, 8);
+    NS_ABORT_MSG_IF(m_nx < 2 || m_ny < 2 ||
+                        size != FIELD_HEADER_SIZE + sizeof(float) * std::size_t(m_nx) * m_ny,
+                    "Truncated shadowing field file " << filename);
+    NS_ABORT_MSG_IF(!(m_step > 0), "Invalid resolution in shadowing field file " << filename);
+    m_field = reinterpret_cast<const float*>(data + FIELD_HEADER_SIZE);
+    NS_LOG_INFO("Loaded a shadowing field of " << m_nx << "x" << m_ny << " points");
+}
+
+double
+ShadowingFieldPropagationLossModel::GetValue(const Vector& position) const
+{
+    NS_ASSERT_MSG(m_field, "The shadowing field was not generated nor loaded");
+
+    // Raster coordinates, clamped to the edges
+    double fx = std::clamp((position.x - m_xMin) / m_step, 0.0, double(m_nx - 1));
+    double fy = std::clamp((position.y - m_yMin) / m_step, 0.0, double(m_ny - 1));
+    uint32_t j = std::min<uint32_t>(fx, m_nx - 2);
+    uint32_t i = std::min<uint32_t>(fy, m_ny - 2);
+    double tx = fx - j;
+    double ty = fy - i;
+
+    const float* p = m_field + std::size_t(i) * m_nx + j;
+    double bottom = p[0] + tx * (p[1] - p[0]);
+    double top = p[m_nx] + tx * (p[m_nx + 1] - p[m_nx]);
+    return m_sigma * (bottom + ty * (top - bottom));
+}
+
+double
+ShadowingFieldPropagationLossModel::DoCalcRxPower(double txPowerDbm,
+                                                  Ptr<MobilityModel> a,
+                                                  Ptr<MobilityModel> b) const
+{
+    NS_LOG_FUNCTION(this << txPowerDbm << a << b);
+
+    double loss = (GetValue(a->GetPosition()) + GetValue(b->GetPosition())) / M_SQRT2;
+    NS_LOG_INFO("Shadowing loss: " << loss);
+    return txPowerDbm - loss;
+}
+
+int64_t
+ShadowingFieldPropagationLossModel::DoAssignStreams(int64_t stream)
+{
+    m_normal->SetStream(stream);
+    return 1;
+}
+
+void
+ShadowingFieldPropagationLossModel::Clear()
+{
+#ifdef SHADOWING_FIELD_MMAP
+    if (m_mapping)
+    {
+        munmap(m_mapping, m_mappingSize);
+    }
+#endif
+    m_mapping = nullptr;
+    m_mappingSize = 0;
+    m_storage.clear();
+    m_storage.shrink_to_fit();
+    m_field = nullptr;
+}
+
+} // namespace lorawan
+} // namespace ns3
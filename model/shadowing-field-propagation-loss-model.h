@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2026 University of Bologna
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Alessandro Aimi <alessandro.aimi@unibo.it>
+ */
+
+#ifndef SHADOWING_FIELD_PROPAGATION_LOSS_MODEL_H
+#define SHADOWING_FIELD_PROPAGATION_LOSS_MODEL_H
+
+#include "ns3/box.h"
+#include "ns3/mobility-model.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/random-variable-stream.h"
+
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+namespace lorawan
+{
+
+/**
+ * Spatially correlated shadowing from a precomputed Gaussian field.
+ *
+ * The field is generated once over the bounding box of the scenario as a
+ * dense raster of zero-mean Gaussian values, with exponential correlation
+ * exp(-|dx|/d) * exp(-|dy|/d) for a correlation distance d. Lookups
+ * interpolate bilinearly the four raster points around a position, and
+ * positions outside the box take the value of the closest edge.
+ *
+ * The shadowing of a link is the sum of the field at its two ends, scaled
+ * to keep the configured standard deviation: links sharing an end are
+ * correlated, and the loss is the same in both directions.
+ *
+ * The raster can be saved to a file and loaded back (memory-mapped when
+ * possible) to reuse the same field across runs.
+ */
+class ShadowingFieldPropagationLossModel : public PropagationLossModel
+{
+  public:
+    static TypeId GetTypeId();
+
+    ShadowingFieldPropagationLossModel();
+    ~ShadowingFieldPropagationLossModel() override;
+
+    /**
+     * Generate the field over a bounding box, replacing any previous one.
+     *
+     * Only the x and y bounds of the box are used.
+     *
+     * \param box The bounding box of the scenario.
+     */
+    void Generate(const Box& box);
+
+    /**
+     * Save the raster to a file, in host byte order.
+     *
+     * \param filename The name of the file.
+     */
+    void Save(const std::string& filename) const;
+
+    /**
+     * Load a raster saved with Save, replacing any previous one.
+     *
+     * \param filename The name of the file.
+     */
+    void Load(const std::string& filename);
+
+    /**
+     * Get the value of the field at a position.
+     *
+     * \param position The position.
+     * \return The shadowing value (dB).
+     */
+    double GetValue(const Vector& position) const;
+
+  private:
+    double DoCalcRxPower(double txPowerDbm,
+                         Ptr<MobilityModel> a,
+                         Ptr<MobilityModel> b) const override;
+
+    int64_t DoAssignStreams(int64_t stream) override;
+
+    /**
+     * Release the current raster.
+     */
+    void Clear();
+
+    double m_sigma;               //!< Standard deviation of shadowing (dB)
+    double m_correlationDistance; //!< Distance at which correlation falls to 1/e (m)
+    double m_resolution;          //!< Distance between raster points (m)
+
+    uint32_t m_nx;        //!< Number of raster points along x
+    uint32_t m_ny;        //!< Number of raster points along y
+    double m_xMin;        //!< Abscissa of the first raster point
+    double m_yMin;        //!< Ordinate of the first raster point
+    double m_step;        //!< Distance between raster points of the current raster (m)
+    const float* m_field; //!< Row-major raster values (rows along y)
+
+    std::vector<float> m_storage; //!< Raster values, if not memory-mapped
+    void* m_mapping;              //!< Memory-mapped file, if any
+    std::size_t m_mappingSize;    //!< Size of the memory-mapped file
+
+    Ptr<NormalRandomVariable> m_normal; //!< Innovations of the field
+};
+
+} // namespace lorawan
+} // namespace ns3
+
+#endif /* SHADOWING_FIELD_PROPAGATION_LOSS_MODEL_H */
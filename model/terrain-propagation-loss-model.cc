@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2026 University of Bologna
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Alessandro Aimi <alessandro.aimi@unibo.it>
+ */
+
+#include "terrain-propagation-loss-model.h"
+
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ns3
+{
+namespace lorawan
+{
+
+NS_LOG_COMPONENT_DEFINE("TerrainPropagationLossModel");
+
+NS_OBJECT_ENSURE_REGISTERED(TerrainPropagationLossModel);
+
+static const double EARTH_RADIUS = 6371e3;      // m
+static const double SPEED_OF_LIGHT = 299792458; // m/s
+
+TypeId
+TerrainPropagationLossModel::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::TerrainPropagationLossModel")
+            .SetParent<PropagationLossModel>()
+            .SetGroupName("lorawan")
+            .AddConstructor<TerrainPropagationLossModel>()
+            .AddAttribute("Frequency",
+                          "The carrier frequency (Hz)",
+                          DoubleValue(868e6),
+                          MakeDoubleAccessor(&TerrainPropagationLossModel::m_frequency),
+                          MakeDoubleChecker<double>(0))
+            .AddAttribute("ProfileStep",
+                          "The distance between samples of elevation profiles (m)",
+                          DoubleValue(30),
+                          MakeDoubleAccessor(&TerrainPropagationLossModel::m_profileStep),
+                          MakeDoubleChecker<double>(std::numeric_limits<double>::min()))
+            .AddAttribute("KFactor",
+                          "The effective Earth radius factor",
+                          DoubleValue(4.0 / 3),
+                          MakeDoubleAccessor(&TerrainPropagationLossModel::m_kFactor),
+                          MakeDoubleChecker<double>(0))
+            .AddAttribute("ClutterHeight",
+                          "The height of antennas above which clutter loss is not applied (m)",
+                          DoubleValue(10),
+                          MakeDoubleAccessor(&TerrainPropagationLossModel::m_clutterHeight),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("MaxCachedTiles",
+                          "The maximum number of tiles of each raster kept in memory, "
+                          "applied to rasters set afterwards",
+                          UintegerValue(256),
+                          MakeUintegerAccessor(&TerrainPropagationLossModel::m_maxTiles),
+                          MakeUintegerChecker<uint32_t>(1));
+    return tid;
+}
+
+TerrainPropagationLossModel::TerrainPropagationLossModel()
+    : m_frequency(868e6),
+      m_profileStep(30),
+      m_kFactor(4.0 / 3),
+      m_clutterHeight(10),
+      m_maxTiles(256),
+      m_clutter(256, 0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TerrainPropagationLossModel::~TerrainPropagationLossModel()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+TerrainPropagationLossModel::SetElevationRaster(const std::string& filename)
+{
+    NS_LOG_FUNCTION(this << filename);
+
+    m_elevation = Create<TerrainRaster>(filename, m_maxTiles);
+}
+
+void
+TerrainPropagationLossModel::SetLandCoverRaster(const std::string& filename)
+{
+    NS_LOG_FUNCTION(this << filename);
+
+    m_landCover = Create<TerrainRaster>(filename, m_maxTiles);
+}
+
+void
+TerrainPropagationLossModel::SetClutterLoss(uint8_t landCover, double loss)
+{
+    NS_LOG_FUNCTION(this << unsigned(landCover) << loss);
+
+    m_clutter[landCover] = loss;
+}
+
+double
+TerrainPropagationLossModel::GetDiffractionLoss(const Vector& a, const Vector& b) const
+{
+    NS_LOG_FUNCTION(this << a << b);
+
+    double d = std::hypot(b.x - a.x, b.y - a.y);
+    if (!m_elevation || d < 2 * m_profileStep)
+    {
+        return 0;
+    }
+
+    // Elevation profile, including the two ends
+    m_profile.resize(std::ceil(d / m_profileStep) + 1);
+    m_elevation->SampleLine(a.x, a.y, b.x, b.y, m_profile);
+    std::size_t n = m_profile.size();
+    // Antennas are z above the ground
+    double ha = m_profile.front() + a.z;
+    double hb = m_profile.back() + b.z;
+
+    // Fresnel-Kirchhoff parameter of the most obstructing point
+    double lambda = SPEED_OF_LIGHT / m_frequency;
+    double radius = m_kFactor * EARTH_RADIUS;
+    double vMax = -std::numeric_limits<double>::infinity();
+    for (std::size_t k = 1; k < n - 1; ++k)
+    {
+        double d1 = d * k / (n - 1);
+        double d2 = d - d1;
+        double bulge = d1 * d2 / (2 * radius);
+        double h = m_profile[k] + bulge - (ha + (hb - ha) * d1 / d);
+        vMax = std::max(vMax, h * std::sqrt(2 * d / (lambda * d1 * d2)));
+    }
+
+    // Knife-edge approximation of ITU-R P.526
+    if (vMax <= -0.78)
+    {
+        return 0;
+    }
+    double loss = 6.9 + 20 * std::log10(std::sqrt((vMax - 0.1) * (vMax - 0.1) + 1) + vMax - 0.1);
+    NS_LOG_DEBUG("Diffraction: v=" << vMax << ", loss=" << loss << "dB");
+    return loss;
+}
+
+double
+TerrainPropagationLossModel::GetClutterLoss(const Vector& position) const
+{
+    if (!m_landCover || position.z >= m_clutterHeight)
+    {
+        return 0;
+    }
+    return m_clutter[uint8_t(m_landCover->GetNearest(position.x, position.y))];
+}
+
+double
+TerrainPropagationLossModel::DoCalcRxPower(double txPowerDbm,
+                                           Ptr<MobilityModel> a,
+                                           Ptr<MobilityModel> b) const
+{
+    NS_LOG_FUNCTION(this << txPowerDbm << a << b);
+
+    Vector aPosition = a->GetPosition();
+    Vector bPosition = b->GetPosition();
+    double loss = GetDiffractionLoss(aPosition, bPosition) + GetClutterLoss(aPosition) +
+                  GetClutterLoss(bPosition);
+    NS_LOG_INFO("Terrain loss: " << loss);
+    return txPowerDbm - loss;
+}
+
+int64_t
+TerrainPropagationLossModel::DoAssignStreams(int64_t stream)
+{
+    return 0;
+}
+
+} // namespace lorawan
+} // namespace ns3
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2026 University of Bologna
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Alessandro Aimi <alessandro.aimi@unibo.it>
+ */
+
+#ifndef TERRAIN_PROPAGATION_LOSS_MODEL_H
+#define TERRAIN_PROPAGATION_LOSS_MODEL_H
+
+#include "terrain-raster.h"
+
+#include "ns3/mobility-model.h"
+#include "ns3/propagation-loss-model.h"
+
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+namespace lorawan
+{
+
+/**
+ * Excess loss due to terrain obstructions and clutter, from raster maps.
+ *
+ * This model is meant to be chained after a path loss model. The elevation
+ * profile of each link is sampled from a digital elevation model along the
+ * straight line between its ends, accounting for the curvature of the
+ * (effective) Earth, and the most obstructing point is taken as a knife edge
+ * (ITU-R P.526). Each end of a link whose antenna is lower than the clutter
+ * height adds the clutter loss of the land cover class at its position.
+ *
+ * The z coordinate of positions is the height of antennas above the ground,
+ * not above sea level: the elevation of the ground is added from the raster,
+ * so positions must not include it. Other models of the chain see the same
+ * z, as a relative height. Rasters are read from TerrainRaster files,
+ * loading tiles as needed.
+ */
+class TerrainPropagationLossModel : public PropagationLossModel
+{
+  public:
+    static TypeId GetTypeId();
+
+    TerrainPropagationLossModel();
+    ~TerrainPropagationLossModel() override;
+
+    /**
+     * Set the digital elevation model.
+     *
+     * \param filename The name of a TerrainRaster file of elevations (m).
+     */
+    void SetElevationRaster(const std::string& filename);
+
+    /**
+     * Set the land cover map.
+     *
+     * \param filename The name of a TerrainRaster file of land cover classes.
+     */
+    void SetLandCoverRaster(const std::string& filename);
+
+    /**
+     * Set the clutter loss of a land cover class.
+     *
+     * \param landCover The land cover class.
+     * \param loss The loss (dB).
+     */
+    void SetClutterLoss(uint8_t landCover, double loss);
+
+    /**
+     * Compute the diffraction loss of the terrain between two positions.
+     *
+     * \param a The first position.
+     * \param b The second position.
+     * \return The loss (dB).
+     */
+    double GetDiffractionLoss(const Vector& a, const Vector& b) const;
+
+  private:
+    double DoCalcRxPower(double txPowerDbm,
+                         Ptr<MobilityModel> a,
+                         Ptr<MobilityModel> b) const override;
+
+    int64_t DoAssignStreams(int64_t stream) override;
+
+    /**
+     * Get the clutter loss at an end of a link.
+     *
+     * \param position The position of the end.
+     * \return The loss (dB).
+     */
+    double GetClutterLoss(const Vector& position) const;
+
+    double m_frequency;            //!< Carrier frequency (Hz)
+    double m_profileStep;          //!< Distance between samples of profiles (m)
+    double m_kFactor;              //!< Effective Earth radius factor
+    double m_clutterHeight;        //!< Height of antennas above which clutter is ignored (m)
+    uint32_t m_maxTiles;           //!< Maximum number of loaded tiles per raster
+    std::vector<double> m_clutter; //!< Clutter loss by land cover class (dB)
+
+    Ptr<TerrainRaster> m_elevation; //!< Digital elevation model
+    Ptr<TerrainRaster> m_landCover; //!< Land cover classes
+
+    mutable std::vector<double> m_profile; //!< Elevations of the last computed profile
+};
+
+} // namespace lorawan
+} // namespace ns3
+
+#endif /* TERRAIN_PROPAGATION_LOSS_MODEL_H */
@@ -0,0 +1,328 @@
+/*
+ * Copyright (c) 2026 University of Bologna
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Alessandro Aimi <alessandro.aimi@unibo.it>
+ */
+
+#include "terrain-raster.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define TERRAIN_RASTER_MMAP
+#endif
+
+namespace ns3
+{
+namespace lorawan
+{
+
+NS_LOG_COMPONENT_DEFINE("TerrainRaster");
+
+static const char RASTER_MAGIC[8] = {'L', 'O', 'R', 'A', 'T', 'I', 'L', 'E'};
+static const uint32_t RASTER_VERSION = 1;
+static const std::size_t RASTER_HEADER_SIZE = 64;
+
+TerrainRaster::TerrainRaster(const std::string& filename, uint32_t maxTiles)
+    : m_filename(filename),
+      m_fd(-1),
+      m_maxTiles(std::max<uint32_t>(1, maxTiles)),
+      m_lastIndex(UINT32_MAX),
+      m_lastData(nullptr)
+{
+    NS_LOG_FUNCTION(this << filename << maxTiles);
+
+    char header[RASTER_HEADER_SIZE];
+    std::ifstream file(filename, std::ios::binary);
+    NS_ABORT_MSG_IF(!file.is_open(), "Unable to open raster file " << filename);
+    file.read(header, RASTER_HEADER_SIZE);
+    uint32_t version;
+    uint32_t type;
+    std::memcpy(&version, header + 8, 4);
+    std::memcpy(&type, header + 12, 4);
+    NS_ABORT_MSG_IF(!file || std::memcmp(header, RASTER_MAGIC, 8) != 0 ||
+                        version != RASTER_VERSION || type > UINT8,
+                    "Invalid raster file " << filename);
+    std::memcpy(&m_nx, header + 16, 4);
+    std::memcpy(&m_ny, header + 20, 4);
+    std::memcpy(&m_tileSize, header + 24, 4);
+    std::memcpy(&m_xMin, header + 32, 8);
+    std::memcpy(&m_yMin, header + 40, 8);
+    std::memcpy(&m_resolution, header + 48, 8);
+    NS_ABORT_MSG_IF(m_nx < 2 || m_ny < 2 || m_tileSize == 0 || !(m_resolution > 0),
+                    "Invalid raster file " << filename);
+    m_type = DataType(type);
+    m_valueSize = (m_type == FLOAT32) ? sizeof(float) : sizeof(uint8_t);
+    m_nTilesX = (m_nx + m_tileSize - 1) / m_tileSize;
+    uint32_t nTilesY = (m_ny + m_tileSize - 1) / m_tileSize;
+    std::size_t tileBytes = std::size_t(m_tileSize) * m_tileSize * m_valueSize;
+    std::size_t expectedSize = RASTER_HEADER_SIZE + std::size_t(m_nTilesX) * nTilesY * tileBytes;
+
+    // Tiles are loaded lazily, so a truncated file must be caught here
+    std::size_t size = 0;
+#ifdef TERRAIN_RASTER_MMAP
+    m_fd = open(filename.c_str(), O_RDONLY);
+    NS_ABORT_MSG_IF(m_fd < 0, "Unable to open raster file " << filename);
+    struct stat st;
+    NS_ABORT_MSG_IF(fstat(m_fd, &st) < 0, "Unable to stat raster file " << filename);
+    size = st.st_size;
+#else
+    file.seekg(0, std::ios::end);
+    size = file.tellg();
+#endif
+    NS_ABORT_MSG_IF(size < expectedSize, "Truncated raster file " << filename);
+    NS_LOG_INFO("Opened raster " << filename << " of " << m_nx << "x" << m_ny << " points");
+}
+
+TerrainRaster::~TerrainRaster()
+{
+    NS_LOG_FUNCTION(this);
+
+    for (auto& tile : m_tiles)
+    {
+        Unload(tile.second);
+    }
+#ifdef TERRAIN_RASTER_MMAP
+    close(m_fd);
+#endif
+}
+
+void
+TerrainRaster::Write(const std::string& filename,
+                     DataType type,
+                     uint32_t nx,
+                     uint32_t ny,
+                     double xMin,
+                     double yMin,
+                     double resolution,
+                     const std::vector<float>& values,
+                     uint32_t tileSize)
+{
+    NS_LOG_FUNCTION(filename << type << nx << ny << xMin << yMin << resolution << tileSize);
+    NS_ABORT_MSG_IF(nx < 2 || ny < 2 || tileSize == 0, "Invalid raster size");
+    NS_ABORT_MSG_IF(!(resolution > 0), "The raster resolution must be positive");
+    NS_ABORT_MSG_IF(values.size() != std::size_t(nx) * ny, "Wrong number of raster values");
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    NS_ABORT_MSG_IF(!file.is_open(), "Unable to open raster file " << filename);
+    char header[RASTER_HEADER_SIZE] = {};
+    uint32_t dataType = type;
+    std::memcpy(header, RASTER_MAGIC, 8);
+    std::memcpy(header + 8, &RASTER_VERSION, 4);
+    std::memcpy(header + 12, &dataType, 4);
+    std::memcpy(header + 16, &nx, 4);
+    std::memcpy(header + 20, &ny, 4);
+    std::memcpy(header + 24, &tileSize, 4);
+    std::memcpy(header + 32, &xMin, 8);
+    std::memcpy(header + 40, &yMin, 8);
+    std::memcpy(header + 48, &resolution, 8);
+    file.write(header, RASTER_HEADER_SIZE);
+
+    // Tiles on the edges are padded with the values of the last points
+    uint32_t nTilesX = (nx + tileSize - 1) / tileSize;
+    uint32_t nTilesY = (ny + tileSize - 1) / tileSize;
+    std::vector<char> tile(std::size_t(tileSize) * tileSize *
+                           ((type == FLOAT32) ? sizeof(float) : sizeof(uint8_t)));
+    for (uint32_t ty = 0; ty < nTilesY; ++ty)
+    {
+        for (uint32_t tx = 0; tx < nTilesX; ++tx)
+        {
+            for (uint32_t k = 0; k < tileSize * tileSize; ++k)
+            {
+                uint32_t i = std::min(ty * tileSize + k / tileSize, ny - 1);
+                uint32_t j = std::min(tx * tileSize + k % tileSize, nx - 1);
+                float value = values[std::size_t(i) * nx + j];
+                if (type == FLOAT32)
+                {
+                    std::memcpy(&tile[k * sizeof(float)], &value, sizeof(float));
+                }
+                else
+                {
+                    // Converting floats out of the range of uint8_t is undefined
+                    float clamped = (value > 0) ? std::min(value, 255.0f) : 0.0f;
+                    tile[k] = char(uint8_t(clamped));
+                }
+            }
+            file.write(tile.data(), tile.size());
+        }
+    }
+    NS_ABORT_MSG_IF(!file, "Unable to write raster file " << filename);
+}
+
+double
+TerrainRaster::Interpolate(double x, double y) const
+{
+    double fx = std::clamp((x - m_xMin) / m_resolution, 0.0, double(m_nx - 1));
+    double fy = std::clamp((y - m_yMin) / m_resolution, 0.0, double(m_ny - 1));
+    uint32_t j = std::min<uint32_t>(fx, m_nx - 2);
+    uint32_t i = std::min<uint32_t>(fy, m_ny - 2);
+    return Blend(i, j, fx - j, fy - i);
+}
+
+double
+TerrainRaster::GetNearest(double x, double y) const
+{
+    double fx = std::clamp((x - m_xMin) / m_resolution, 0.0, double(m_nx - 1));
+    double fy = std::clamp((y - m_yMin) / m_resolution, 0.0, double(m_ny - 1));
+    return GetPoint(std::lround(fy), std::lround(fx));
+}
+
+void
+TerrainRaster::SampleLine(double x0,
+                          double y0,
+                          double x1,
+                          double y1,
+                          std::vector<double>& values) const
+{
+    std::size_t n = values.size();
+    NS_ASSERT_MSG(n >= 2, "At least the two ends of the segment are needed");
+
+    // Grid coordinates of all positions first, in a loop without branches
+    // nor calls that compilers vectorize
+    m_columns.resize(n);
+    m_rows.resize(n);
+    m_tx.resize(n);
+    m_ty.resize(n);
+    int32_t* columns = m_columns.data();
+    int32_t* rows = m_rows.data();
+    double* tx = m_tx.data();
+    double* ty = m_ty.data();
+    double dx = (x1 - x0) / (n - 1);
+    double dy = (y1 - y0) / (n - 1);
+    double maxX = m_nx - 1;
+    double maxY = m_ny - 1;
+    int32_t lastColumn = m_nx - 2;
+    int32_t lastRow = m_ny - 2;
+    for (std::size_t k = 0; k < n; ++k)
+    {
+        double fx = std::min(std::max((x0 + k * dx - m_xMin) / m_resolution, 0.0), maxX);
+        double fy = std::min(std::max((y0 + k * dy - m_yMin) / m_resolution, 0.0), maxY);
+        columns[k] = std::min(int32_t(fx), lastColumn);
+        rows[k] = std::min(int32_t(fy), lastRow);
+        tx[k] = fx - columns[k];
+        ty[k] = fy - rows[k];
+    }
+
+    // Then the values, gathered from tiles: consecutive positions mostly fall
+    // in the same tile, which is then found without looking up the cache
+    for (std::size_t k = 0; k < n; ++k)
+    {
+        values[k] = Blend(rows[k], columns[k], tx[k], ty[k]);
+    }
+}
+
+double
+TerrainRaster::GetResolution() const
+{
+    return m_resolution;
+}
+
+uint32_t
+TerrainRaster::GetNLoadedTiles() const
+{
+    return m_tiles.size();
+}
+
+double
+TerrainRaster::Blend(uint32_t i, uint32_t j, double tx, double ty) const
+{
+    double bottom = GetPoint(i, j) + tx * (GetPoint(i, j + 1) - GetPoint(i, j));
+    double top = GetPoint(i + 1, j) + tx * (GetPoint(i + 1, j + 1) - GetPoint(i + 1, j));
+    return bottom + ty * (top - bottom);
+}
+
+double
+TerrainRaster::GetPoint(uint32_t i, uint32_t j) const
+{
+    uint32_t index = (i / m_tileSize) * m_nTilesX + j / m_tileSize;
+    const uint8_t* data = (index == m_lastIndex) ? m_lastData : GetTile(index);
+    std::size_t offset = std::size_t(i % m_tileSize) * m_tileSize + j % m_tileSize;
+    if (m_type == FLOAT32)
+    {
+        float value;
+        std::memcpy(&value, data + offset * sizeof(float), sizeof(float));
+        return value;
+    }
+    return data[offset];
+}
+
+const uint8_t*
+TerrainRaster::GetTile(uint32_t index) const
+{
+    auto it = m_tiles.find(index);
+    if (it != m_tiles.end())
+    {
+        // Mark as most recently used
+        m_used.splice(m_used.begin(), m_used, it->second.used);
+    }
+    else
+    {
+        if (m_tiles.size() >= m_maxTiles)
+        {
+            // Unload the least recently used tile
+            auto evicted = m_tiles.find(m_used.back());
+            NS_LOG_DEBUG("Unloading tile " << evicted->first << " of " << m_filename);
+            Unload(evicted->second);
+            m_tiles.erase(evicted);
+            m_used.pop_back();
+        }
+
+        NS_LOG_DEBUG("Loading tile " << index << " of " << m_filename);
+        std::size_t tileBytes = std::size_t(m_tileSize) * m_tileSize * m_valueSize;
+        std::size_t offset = RASTER_HEADER_SIZE + std::size_t(index) * tileBytes;
+        Tile tile;
+#ifdef TERRAIN_RASTER_MMAP
+        // Mappings must start at a page boundary
+        std::size_t page = sysconf(_SC_PAGESIZE);
+        std::size_t start = offset - offset % page;
+        tile.mappingSize = tileBytes + offset - start;
+        tile.mapping = mmap(nullptr, tile.mappingSize, PROT_READ, MAP_PRIVATE, m_fd, start);
+        NS_ABORT_MSG_IF(tile.mapping == MAP_FAILED, "Unable to map tile of " << m_filename);
+        tile.data = static_cast<const uint8_t*>(tile.mapping) + (offset - start);
+#else
+        std::ifstream file(m_filename, std::ios::binary);
+        file.seekg(offset);
+        tile.buffer.resize(tileBytes);
+        file.read(reinterpret_cast<char*>(tile.buffer.data()), tileBytes);
+        NS_ABORT_MSG_IF(!file, "Unable to read tile of " << m_filename);
+        tile.mapping = nullptr;
+        tile.mappingSize = 0;
+        tile.data = tile.buffer.data();
+#endif
+        m_used.push_front(index);
+        tile.used = m_used.begin();
+        it = m_tiles.emplace(index, std::move(tile)).first;
+    }
+
+    m_lastIndex = index;
+    m_lastData = it->second.data;
+    return m_lastData;
+}
+
+void
+TerrainRaster::Unload(Tile& tile) const
+{
+#ifdef TERRAIN_RASTER_MMAP
+    munmap(tile.mapping, tile.mappingSize);
+#endif
+    if (tile.data == m_lastData)
+    {
+        m_lastIndex = UINT32_MAX;
+        m_lastData = nullptr;
+    }
+}
+
+} // namespace lorawan
+} // namespace ns3
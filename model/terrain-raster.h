@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2026 University of Bologna
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Alessandro Aimi <alessandro.aimi@unibo.it>
+ */
+
+#ifndef TERRAIN_RASTER_H
+#define TERRAIN_RASTER_H
+
+#include "ns3/simple-ref-count.h"
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+namespace lorawan
+{
+
+/**
+ * Read access to a georeferenced raster stored as a tiled binary file.
+ *
+ * The raster is a grid of points, resolution meters apart, starting at
+ * (xMin, yMin) in simulation coordinates. Points are grouped in square
+ * tiles that are loaded (memory-mapped when possible) at their first access,
+ * and unloaded in least recently used order when more than a maximum number
+ * of tiles are loaded. Positions outside the raster take the value of the
+ * closest edge.
+ *
+ * Files start with a 64-byte header (magic "LORATILE", version, data type,
+ * nx, ny, tile size, xMin, yMin, resolution), followed by the tiles in
+ * row-major order, each one with its points in row-major order. Values are
+ * in host byte order. Files are produced with Write.
+ */
+class TerrainRaster : public SimpleRefCount<TerrainRaster>
+{
+  public:
+    /**
+     * Type of the values of a raster.
+     */
+    enum DataType
+    {
+        FLOAT32, //!< Continuous values, like elevations
+        UINT8,   //!< Classes, like land cover
+    };
+
+    /**
+     * Open a raster file.
+     *
+     * \param filename The name of the file.
+     * \param maxTiles The maximum number of tiles kept loaded.
+     */
+    TerrainRaster(const std::string& filename, uint32_t maxTiles = 256);
+    ~TerrainRaster();
+
+    TerrainRaster(const TerrainRaster&) = delete;
+    TerrainRaster& operator=(const TerrainRaster&) = delete;
+
+    /**
+     * Write a raster file.
+     *
+     * \param filename The name of the file.
+     * \param type The type of values.
+     * \param nx The number of points along x.
+     * \param ny The number of points along y.
+     * \param xMin The abscissa of the first point.
+     * \param yMin The ordinate of the first point.
+     * \param resolution The distance between points (m), strictly positive.
+     * \param values The values of points, in row-major order (rows along y).
+     *        UINT8 values are truncated, and clamped to [0, 255].
+     * \param tileSize The number of points on each side of tiles.
+     */
+    static void Write(const std::string& filename,
+                      DataType type,
+                      uint32_t nx,
+                      uint32_t ny,
+                      double xMin,
+                      double yMin,
+                      double resolution,
+                      const std::vector<float>& values,
+                      uint32_t tileSize = 256);
+
+    /**
+     * Get the value at a position, interpolated bilinearly from the four
+     * surrounding points.
+     *
+     * \param x The abscissa.
+     * \param y The ordinate.
+     * \return The value.
+     */
+    double Interpolate(double x, double y) const;
+
+    /**
+     * Get the value of the point closest to a position.
+     *
+     * \param x The abscissa.
+     * \param y The ordinate.
+     * \return The value.
+     */
+    double GetNearest(double x, double y) const;
+
+    /**
+     * Interpolate the values at evenly spaced positions along a segment.
+     *
+     * Grid coordinates of all positions are computed in a first pass that
+     * compilers vectorize, and values are then gathered from tiles.
+     *
+     * \param x0 The abscissa of the first position.
+     * \param y0 The ordinate of the first position.
+     * \param x1 The abscissa of the last position.
+     * \param y1 The ordinate of the last position.
+     * \param values The values, one per position, with at least 2 elements.
+     */
+    void SampleLine(double x0, double y0, double x1, double y1, std::vector<double>& values) const;
+
+    /**
+     * \return The distance between points (m).
+     */
+    double GetResolution() const;
+
+    /**
+     * \return The number of tiles currently loaded.
+     */
+    uint32_t GetNLoadedTiles() const;
+
+  private:
+    /**
+     * A loaded tile.
+     */
+    struct Tile
+    {
+        const uint8_t* data;                //!< Values of the tile
+        void* mapping;                      //!< Memory mapping, if any
+        std::size_t mappingSize;            //!< Size of the memory mapping
+        std::vector<uint8_t> buffer;        //!< Values, if not memory-mapped
+        std::list<uint32_t>::iterator used; //!< Position in the LRU list
+    };
+
+    /**
+     * Interpolate bilinearly between four points.
+     *
+     * \param i The row of the bottom left point.
+     * \param j The column of the bottom left point.
+     * \param tx The offset of the position from the point along x (fraction of a cell).
+     * \param ty The offset of the position from the point along y (fraction of a cell).
+     * \return The value.
+     */
+    double Blend(uint32_t i, uint32_t j, double tx, double ty) const;
+
+    /**
+     * Get the value of a point.
+     *
+     * \param i The row of the point.
+     * \param j The column of the point.
+     * \return The value.
+     */
+    double GetPoint(uint32_t i, uint32_t j) const;
+
+    /**
+     * Get the values of a tile, loading it if needed.
+     *
+     * \param index The index of the tile.
+     * \return The values.
+     */
+    const uint8_t* GetTile(uint32_t index) const;
+
+    /**
+     * Unload a tile.
+     *
+     * \param tile The tile.
+     */
+    void Unload(Tile& tile) const;
+
+    std::string m_filename; //!< Name of the file
+    int m_fd;               //!< Descriptor of the file, if memory-mapped
+    DataType m_type;        //!< Type of values
+    uint32_t m_valueSize;   //!< Size of values (bytes)
+    uint32_t m_nx;          //!< Number of points along x
+    uint32_t m_ny;          //!< Number of points along y
+    uint32_t m_tileSize;    //!< Number of points on each side of tiles
+    uint32_t m_nTilesX;     //!< Number of tiles along x
+    double m_xMin;          //!< Abscissa of the first point
+    double m_yMin;          //!< Ordinate of the first point
+    double m_resolution;    //!< Distance between points (m)
+    uint32_t m_maxTiles;    //!< Maximum number of loaded tiles
+
+    mutable std::unordered_map<uint32_t, Tile> m_tiles; //!< Loaded tiles by index
+    mutable std::list<uint32_t> m_used;                 //!< Loaded tiles, most recent first
+    mutable uint32_t m_lastIndex;                       //!< Index of the last accessed tile
+    mutable const uint8_t* m_lastData;                  //!< Values of the last accessed tile
+
+    // Scratch buffers of SampleLine
+    mutable std::vector<int32_t> m_columns; //!< Columns of positions
+    mutable std::vector<int32_t> m_rows;    //!< Rows of positions
+    mutable std::vector<double> m_tx;       //!< Offsets of positions along x
+    mutable std::vector<double> m_ty;       //!< Offsets of positions along y
+};
+
+} // namespace lorawan
+} // namespace ns3
+
+#endif /* TERRAIN_RASTER_H */
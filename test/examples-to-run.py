@@ -16,6 +16,14 @@ cpp_examples = [
     ("parallel-reception-example", "True", "True"),
     ("frame-counter-update", "True", "True"),
     ("pcap-example", "True", "True"),
+    ("lorawan-benchmark --minTime=0.001 --runs=1", "True", "False"),
+    (
+        "scaling-benchmark --devices=20 --rings=1 --traffic=periodic,poisson --hours=0.1 "
+        "--population=10000",
+        "True",
+        "False",
+    ),
+    ("distributed-network-example", "ENABLE_MPI", "False"),
 ]
 
 # A list of Python examples to run in order to ensure that they remain
@@ -1,18 +1,50 @@
 
 // Include headers of classes to test
+#include "ns3/LoRaMacCrypto.h"
+#include "ns3/adr-component.h"
+#include "ns3/async-file-writer.h"
+#include "ns3/basic-energy-source.h"
+#include "ns3/boolean.h"
 #include "ns3/constant-position-mobility-model.h"
 #include "ns3/end-device-lora-phy.h"
+#include "ns3/event-trace-scheduler.h"
 #include "ns3/gateway-lora-phy.h"
+#include "ns3/hex-grid-position-allocator.h"
+#include "ns3/integer.h"
 #include "ns3/log.h"
 #include "ns3/lora-frame-header.h"
+#include "ns3/lora-device-population.h"
+#include "ns3/lora-key-store.h"
+#include "ns3/lora-packet-log.h"
+#include "ns3/lora-pcapng-capture.h"
+#include "ns3/lora-radio-energy-model.h"
+#include "ns3/lora-tag.h"
 #include "ns3/lorawan-helper.h"
 #include "ns3/lorawan-mac-header.h"
+#include "ns3/mac48-address.h"
+#include "ns3/map-scheduler.h"
 #include "ns3/mobility-helper.h"
+#include "ns3/network-controller-components.h"
+#include "ns3/network-status.h"
+#include "ns3/node-list.h"
 #include "ns3/one-shot-sender-helper.h"
+#include "ns3/range-position-allocator.h"
+#include "ns3/shadowing-field-propagation-loss-model.h"
+#include "ns3/terrain-propagation-loss-model.h"
+#include "ns3/traffic-trace.h"
+#include "ns3/uinteger.h"
 
 // An essential include is test.h
 #include "ns3/test.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <sstream>
+
 using namespace ns3;
 using namespace lorawan;
 
@@ -358,6 +390,21 @@ HeaderTest::DoRun()
                           "Margin changes in the serialization/deserialization process");
     NS_TEST_EXPECT_MSG_EQ(gwCnt, 1, "GwCnt changes in the serialization/deserialization process");
 
+    // Value access to the deserialized commands
+    const LinkCheckAns* linkCheckAnsValue = fHdr.FindMacCommand<LinkCheckAns>();
+    NS_TEST_ASSERT_MSG_NE(linkCheckAnsValue, nullptr, "FindMacCommand does not find the command");
+    NS_TEST_EXPECT_MSG_EQ(unsigned(linkCheckAnsValue->GetMargin()),
+                          10,
+                          "FindMacCommand returns a wrong command");
+    NS_TEST_EXPECT_MSG_EQ(fHdr.FindMacCommand<LinkAdrReq>(),
+                          nullptr,
+                          "FindMacCommand finds a command not in the header");
+    unsigned fOptsLen = 0;
+    fHdr.VisitCommands([&fOptsLen](const auto& cmd) { fOptsLen += cmd.GetSerializedSize(); });
+    NS_TEST_EXPECT_MSG_EQ(fOptsLen,
+                          unsigned(fHdr.GetFOptsLen()),
+                          "VisitCommands does not visit all the commands");
+
     /////////////////////////////////////////////////
     // Test a combination of the two above classes //
     /////////////////////////////////////////////////
@@ -402,6 +449,43 @@ HeaderTest::DoRun()
     NS_TEST_EXPECT_MSG_EQ(linkCheckAns->GetGwCnt(),
                           1,
                           "Removed header's MAC command contents don't match");
+
+    ///////////////////////////////////////////////////
+    // Test MAC commands in the FRMPayload (FPort 0) //
+    ///////////////////////////////////////////////////
+    // They are not limited by the size of FOpts
+    const uint16_t nFrmpCmds = 40;
+    std::vector<uint8_t> frmpCmds(nFrmpCmds, 0x06); // DevStatusReq
+    frmpCmds[nFrmpCmds - 3] = 0x02;                 // LinkCheckAns
+    frmpCmds[nFrmpCmds - 2] = 1;                    // Margin
+    frmpCmds[nFrmpCmds - 1] = 1;                    // GwCnt
+
+    LoraFrameHeader frmpHdr;
+    frmpHdr.SetAsDownlink();
+    frmpHdr.SetFPort(0);
+    frmpHdr.SetAddress(LoraDeviceAddress(56, 1864));
+    frmpHdr.SetFRMPaylodCmdsLen(nFrmpCmds);
+    Buffer frmpBuf;
+    frmpBuf.AddAtStart(nFrmpCmds);
+    frmpBuf.Begin().Write(frmpCmds.data(), nFrmpCmds);
+    frmpBuf.AddAtStart(frmpHdr.GetSerializedSize());
+    frmpHdr.Serialize(frmpBuf.Begin());
+    frmpHdr.Deserialize(frmpBuf.Begin());
+
+    NS_TEST_EXPECT_MSG_EQ(frmpHdr.GetNCommands(),
+                          nFrmpCmds - 3 + 1,
+                          "MAC commands of the FRMPayload were dropped");
+    LoraFrameHeader frmpHdrCopy = frmpHdr;
+    unsigned nDevStatusReq = 0;
+    frmpHdrCopy.VisitCommands([&nDevStatusReq](const auto& cmd) {
+        nDevStatusReq += std::is_same_v<std::decay_t<decltype(cmd)>, DevStatusReq>;
+    });
+    NS_TEST_EXPECT_MSG_EQ(nDevStatusReq, nFrmpCmds - 3, "Wrong MAC commands in the FRMPayload");
+    const LinkCheckAns* lastCommand = frmpHdrCopy.FindMacCommand<LinkCheckAns>();
+    NS_TEST_ASSERT_MSG_NE(lastCommand, nullptr, "Last MAC command of the FRMPayload not found");
+    NS_TEST_EXPECT_MSG_EQ(unsigned(lastCommand->GetMargin()),
+                          1,
+                          "Wrong last MAC command in the FRMPayload");
 }
 
 /*******************
@@ -1175,6 +1259,57 @@ LogicalChannelTest::DoRun()
     NS_TEST_EXPECT_MSG_EQ(channelHelper->GetWaitingTime(channel4),
                           Time(0),
                           "Waiting time affects other subbands");
+
+    // Shared channel plan tests
+    // (per-device state on a common plan)
+    ///////////////////////////////////////
+
+    auto plan = Create<RegionalChannelPlan>();
+    plan->AddSubBand(Create<SubBand>(868000000, 868700000, 0.01, 14));
+    plan->SetChannel(0, channel0);
+    plan->SetChannel(1, channel1);
+
+    Ptr<LogicalChannelManager> manager0 = CreateObject<LogicalChannelManager>();
+    Ptr<LogicalChannelManager> manager1 = CreateObject<LogicalChannelManager>();
+    manager0->SetChannelPlan(plan);
+    manager1->SetChannelPlan(plan);
+
+    // Duty cycle is tracked per device
+    manager0->AddEvent(Seconds(2), channel0);
+    NS_TEST_EXPECT_MSG_EQ(manager0->GetMinWaitingTime(),
+                          expectedTimeOff,
+                          "Waiting time doesn't behave as expected");
+    NS_TEST_EXPECT_MSG_EQ(manager1->GetMinWaitingTime(),
+                          Time(0),
+                          "Duty cycle state is shared among devices");
+
+    // Channel mask is tracked per device
+    manager0->DisableChannel(1);
+    NS_TEST_EXPECT_MSG_EQ(manager0->GetEnabledChannelList().size(),
+                          1U,
+                          "DisableChannel doesn't behave as expected");
+    NS_TEST_EXPECT_MSG_EQ(manager1->GetEnabledChannelList().size(),
+                          2U,
+                          "Channel mask is shared among devices");
+
+    // Modifying the plan of a device does not affect the others
+    manager1->AddChannel(2, channel2);
+    NS_TEST_EXPECT_MSG_EQ(manager1->GetChannelList().size(),
+                          3U,
+                          "AddChannel doesn't behave as expected");
+    NS_TEST_EXPECT_MSG_EQ(manager0->GetChannelList().size(),
+                          2U,
+                          "Channel plan modification is not copy-on-write");
+    NS_TEST_EXPECT_MSG_EQ(bool(plan->GetChannel(2)),
+                          false,
+                          "Shared channel plan was modified");
+    manager1->SetReplyFrequency(0, 869525000);
+    NS_TEST_EXPECT_MSG_EQ(manager1->GetChannel(0)->GetReplyFrequency(),
+                          869525000,
+                          "SetReplyFrequency doesn't behave as expected");
+    NS_TEST_EXPECT_MSG_EQ(manager0->GetChannel(0)->GetReplyFrequency(),
+                          channel0->GetReplyFrequency(),
+                          "Shared channel was modified");
 }
 
 /*****************
@@ -1286,6 +1421,45 @@ TimeOnAirTest::DoRun()
     txParams.codingRate = 1;
     duration = LoraPhy::GetTimeOnAir(packet, txParams);
     NS_TEST_EXPECT_MSG_EQ_TOL(duration.GetSeconds(), 2.301952, 0.0001, "Unexpected duration");
+
+    // The size-based lookup matches the formula of the SX1272 designer's guide
+    uint32_t mismatches = 0;
+    for (uint8_t sf = 7; sf <= 12; ++sf)
+    {
+        for (double bw : {125000, 250000, 500000})
+        {
+            for (uint8_t cr = 1; cr <= 4; ++cr)
+            {
+                for (int flags = 0; flags < 8; ++flags)
+                {
+                    LoraPhyTxParameters params;
+                    params.sf = sf;
+                    params.bandwidthHz = bw;
+                    params.codingRate = cr;
+                    params.headerDisabled = flags & 1;
+                    params.crcEnabled = flags & 2;
+                    params.lowDataRateOptimizationEnabled = flags & 4;
+                    double tSym = std::pow(2, sf) / bw;
+                    for (uint32_t size = 0; size <= 255; ++size)
+                    {
+                        double num = 8.0 * size - 4 * sf + 28 + 16 * params.crcEnabled -
+                                     20 * params.headerDisabled;
+                        double den = 4 * (sf - 2 * params.lowDataRateOptimizationEnabled);
+                        double symbols = params.nPreamble + 4.25 + 8 +
+                                         std::max(std::ceil(num / den) * (cr + 4), 0.0);
+                        double toa = LoraPhy::GetTimeOnAir(size, params).GetSeconds();
+                        mismatches += std::abs(toa - symbols * tSym) > 1e-9;
+                    }
+                }
+            }
+        }
+    }
+    NS_TEST_EXPECT_MSG_EQ(mismatches, 0U, "Size-based time on air differs from the formula");
+
+    // Non-standard bandwidths use the formula
+    txParams.bandwidthHz = 41666.67;
+    duration = LoraPhy::GetTimeOnAir(50, txParams);
+    NS_TEST_EXPECT_MSG_EQ_TOL(duration.GetSeconds(), 6.905855, 0.0001, "Unexpected duration");
 }
 
 /**************************
@@ -1748,9 +1922,12 @@ class LorawanMacTest : public TestCase
   public:
     LorawanMacTest();
     ~LorawanMacTest() override;
+    void StartSending(Ptr<const Packet> packet, uint32_t id);
 
   private:
     void DoRun() override;
+
+    std::vector<Ptr<Packet>> m_sent; //!< Copies of the frames sent by the PHY
 };
 
 // Add some help text to this case to describe what it is intended to test
@@ -1766,10 +1943,1629 @@ LorawanMacTest::~LorawanMacTest()
 
 // This method is the pure virtual method from class TestCase that every
 // TestCase must implement
+void
+LorawanMacTest::StartSending(Ptr<const Packet> packet, uint32_t id)
+{
+    NS_LOG_FUNCTION(packet << id);
+
+    m_sent.push_back(packet->Copy());
+}
+
 void
 LorawanMacTest::DoRun()
 {
     NS_LOG_DEBUG("LorawanMacTest");
+
+    // Retransmissions of a confirmed uplink reuse the serialized frame
+    auto loss = CreateObject<LogDistancePropagationLossModel>();
+    auto delay = CreateObject<ConstantSpeedPropagationDelayModel>();
+    auto channel = CreateObject<LoraChannel>(loss, delay);
+
+    NodeContainer endDevices;
+    endDevices.Create(1);
+    MobilityHelper mobility;
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mobility.Install(endDevices);
+
+    LoraPhyHelper phyHelper;
+    phyHelper.SetChannel(channel);
+    phyHelper.SetType("ns3::EndDeviceLoraPhy");
+    LorawanMacHelper macHelper;
+    macHelper.SetType("ns3::ClassAEndDeviceLorawanMac");
+    LorawanHelper helper;
+    NetDeviceContainer devices = helper.Install(phyHelper, macHelper, endDevices);
+
+    LoraDeviceAddress address(0x26011234);
+    auto device = DynamicCast<LoraNetDevice>(devices.Get(0));
+    auto mac = DynamicCast<BaseEndDeviceLorawanMac>(device->GetMac());
+    auto keyStore = CreateObject<LoraKeyStore>();
+    uint32_t keyIndex = keyStore->AddDevice();
+    mac->SetKeyStore(keyStore, keyIndex);
+    mac->SetDeviceAddress(address);
+    mac->SetFType(LorawanMacHeader::CONFIRMED_DATA_UP);
+    mac->SetNumberOfTransmissions(3);
+    mac->SetDataRate(5);
+    mac->SetAttribute("EnableCryptography", BooleanValue(true));
+    device->GetPhy()->TraceConnectWithoutContext(
+        "StartSending",
+        MakeCallback(&LorawanMacTest::StartSending, this));
+
+    // No network server answers, and the ADR bit changes after the first attempt
+    Simulator::Schedule(Seconds(1), &LorawanMac::Send, mac, Create<Packet>(10));
+    Simulator::Schedule(Seconds(1.5), [mac]() {
+        mac->SetAttribute("ADRBit", BooleanValue(true));
+    });
+    Simulator::Stop(Seconds(100));
+    Simulator::Run();
+    Simulator::Destroy();
+
+    NS_TEST_ASSERT_MSG_EQ(m_sent.size(), 3, "Wrong number of transmissions");
+    for (uint32_t i = 0; i < m_sent.size(); i++)
+    {
+        // Frame built without the cache
+        Ptr<Packet> frame = Create<Packet>(10);
+        LoraFrameHeader fHdr;
+        fHdr.SetAsUplink();
+        fHdr.SetFPort(1);
+        fHdr.SetAddress(address);
+        fHdr.SetAdr(i > 0);
+        fHdr.SetFCnt(0);
+        frame->AddHeader(fHdr);
+        LorawanMacHeader mHdr;
+        mHdr.SetFType(LorawanMacHeader::CONFIRMED_DATA_UP);
+        mHdr.SetMajor(0);
+        frame->AddHeader(mHdr);
+        uint32_t size = frame->GetSize();
+        std::vector<uint8_t> expected(size + 4);
+        frame->CopyData(expected.data(), size);
+        uint32_t mic =
+            keyStore->ComputeMic(keyIndex, expected.data(), size, UPLINK, address.Get(), 0);
+        std::memcpy(expected.data() + size, &mic, 4);
+
+        std::vector<uint8_t> sent(m_sent[i]->GetSize());
+        m_sent[i]->CopyData(sent.data(), sent.size());
+        NS_TEST_EXPECT_MSG_EQ((sent == expected), true, "Wrong frame in transmission " << i);
+
+        // Headers of the packet are consistent with its bytes
+        LorawanMacHeader sentMHdr;
+        m_sent[i]->RemoveHeader(sentMHdr);
+        LoraFrameHeader sentFHdr;
+        sentFHdr.SetAsUplink();
+        m_sent[i]->RemoveHeader(sentFHdr);
+        NS_TEST_EXPECT_MSG_EQ(sentFHdr.GetAdr(), (i > 0), "Wrong ADR bit in transmission " << i);
+        NS_TEST_EXPECT_MSG_EQ(m_sent[i]->GetSize(), 10 + 4, "Wrong payload size");
+    }
+}
+
+/**************
+ * CryptoTest *
+ **************/
+
+class CryptoTest : public TestCase
+{
+  public:
+    CryptoTest();
+    ~CryptoTest() override;
+
+  private:
+    void DoRun() override;
+};
+
+// Add some help text to this case to describe what it is intended to test
+CryptoTest::CryptoTest()
+    : TestCase("Verify that key store MIC computations match LoRaMacCrypto")
+{
+}
+
+// Reminder that the test case should clean up after itself
+CryptoTest::~CryptoTest()
+{
+}
+
+// This method is the pure virtual method from class TestCase that every
+// TestCase must implement
+void
+CryptoTest::DoRun()
+{
+    NS_LOG_DEBUG("CryptoTest");
+
+    LoRaMacCrypto crypto;
+
+    // Known value for a 20 bytes message
+    uint8_t msg[20];
+    for (uint8_t i = 0; i < 20; i++)
+    {
+        msg[i] = i * 7 + 20;
+    }
+    uint32_t mic = 0;
+    crypto.ComputeCmacB0(msg, 20, F_NWK_S_INT_KEY, false, UPLINK, 0x01020318, 60, &mic);
+    NS_TEST_EXPECT_MSG_EQ(mic, 0x52265fee, "Unexpected MIC value");
+
+    // Messages of different length (both complete and padded last blocks)
+    const uint16_t lengths[] = {0, 1, 15, 16, 17, 20, 31, 32, 33, 64, 100, 255};
+    const uint16_t nDevices = 24;
+    uint8_t buffer[256];
+    for (uint16_t i = 0; i < 256; i++)
+    {
+        buffer[i] = i * 13;
+    }
+    LoRaMacCrypto reference;
+
+    // Devices registered with the same keys share the expanded material
+    auto keyStore = CreateObject<LoraKeyStore>();
+    for (uint16_t i = 0; i < nDevices; i++)
+    {
+        keyStore->AddDevice();
+    }
+    NS_TEST_EXPECT_MSG_EQ(keyStore->GetNDevices(), nDevices, "Wrong number of devices");
+    NS_TEST_EXPECT_MSG_EQ(keyStore->GetNExpandedKeys(), 1, "Default keys should be shared");
+
+    LoraKeyStore::Key otherKey;
+    otherKey.fill(0xAB);
+    keyStore->SetKey(1, LoraKeyStore::NWK_SKEY, otherKey);
+    NS_TEST_EXPECT_MSG_EQ(keyStore->GetNExpandedKeys(), 2, "New key should have been expanded");
+
+    // MICs computed from the store match the ones of the soft-se
+    for (uint16_t i = 0; i < nDevices; i++)
+    {
+        uint16_t len = lengths[i % 12];
+        uint32_t devAddr = 0x26000000u + i;
+        uint32_t storeMic = keyStore->ComputeMic(i, buffer, len, UPLINK, devAddr, i);
+        reference.ComputeCmacB0(buffer, len, F_NWK_S_INT_KEY, false, UPLINK, devAddr, i, &mic);
+        if (i == 1)
+        {
+            NS_TEST_EXPECT_MSG_NE(storeMic, mic, "MIC should depend on the device key");
+            continue;
+        }
+        NS_TEST_EXPECT_MSG_EQ(storeMic, mic, "Wrong MIC from key store for device " << i);
+    }
+
+    // Payload encryption matches the soft-se one and is its own inverse
+    uint8_t payload[50];
+    std::copy(buffer, buffer + 50, payload);
+    keyStore->PayloadEncrypt(0, LoraKeyStore::NWK_SKEY, payload, 50, 0x26000000, DOWNLINK, 3);
+    uint8_t expected[50];
+    std::copy(buffer, buffer + 50, expected);
+    reference.PayloadEncrypt(expected, 50, F_NWK_S_INT_KEY, 0x26000000, DOWNLINK, 3);
+    NS_TEST_EXPECT_MSG_EQ(std::equal(payload, payload + 50, expected),
+                          true,
+                          "Encryption differs from the soft-se one");
+    keyStore->PayloadEncrypt(0, LoraKeyStore::NWK_SKEY, payload, 50, 0x26000000, DOWNLINK, 3);
+    NS_TEST_EXPECT_MSG_EQ(std::equal(payload, payload + 50, buffer),
+                          true,
+                          "Decryption did not give back the plaintext");
+
+    // The default store lasts for one simulation
+    Ptr<LoraKeyStore> store = LoraKeyStore::GetDefault();
+    store->AddDevice();
+    NS_TEST_EXPECT_MSG_EQ(LoraKeyStore::GetDefault(), store, "Default store not shared");
+    Simulator::Destroy();
+    NS_TEST_EXPECT_MSG_EQ(LoraKeyStore::GetDefault()->GetNDevices(),
+                          0,
+                          "Default store kept across simulations");
+    Simulator::Destroy();
+}
+
+/*********************
+ * UplinkContextTest *
+ *********************/
+
+class UplinkContextTest : public TestCase
+{
+  public:
+    UplinkContextTest();
+    ~UplinkContextTest() override;
+
+  private:
+    void DoRun() override;
+};
+
+// Add some help text to this case to describe what it is intended to test
+UplinkContextTest::UplinkContextTest()
+    : TestCase("Verify that parsed uplinks drive the network status and controller components")
+{
+}
+
+// Reminder that the test case should clean up after itself
+UplinkContextTest::~UplinkContextTest()
+{
+}
+
+// This method is the pure virtual method from class TestCase that every
+// TestCase must implement
+void
+UplinkContextTest::DoRun()
+{
+    NS_LOG_DEBUG("UplinkContextTest");
+
+    LoraDeviceAddress address(0x26011234);
+    auto edMac = CreateObject<ClassAEndDeviceLorawanMac>();
+    edMac->SetDeviceAddress(address);
+    Address gwAddress = Mac48Address::Allocate();
+    auto networkStatus = CreateObject<NetworkStatus>();
+    networkStatus->AddNode(edMac);
+    networkStatus->AddGateway(gwAddress, CreateObject<GatewayStatus>(gwAddress, nullptr, nullptr));
+
+    auto linkCheck = CreateObject<LinkCheckComponent>();
+    auto adr = CreateObject<AdrComponent>();
+    adr->SetAttribute("HistoryRange", IntegerValue(5));
+
+    // Strong SF12 uplinks asking for ADR, the last one with a LinkCheckReq
+    const uint16_t nUplinks = 5;
+    for (uint16_t fCnt = 0; fCnt < nUplinks; fCnt++)
+    {
+        Ptr<Packet> packet = Create<Packet>(10);
+        LoraFrameHeader fHdr;
+        fHdr.SetAsUplink();
+        fHdr.SetFPort(1);
+        fHdr.SetAddress(address);
+        fHdr.SetAdr(true);
+        fHdr.SetFCnt(fCnt);
+        if (fCnt == nUplinks - 1)
+        {
+            fHdr.AddLinkCheckReq();
+        }
+        packet->AddHeader(fHdr);
+        LorawanMacHeader mHdr;
+        mHdr.SetFType(LorawanMacHeader::UNCONFIRMED_DATA_UP);
+        packet->AddHeader(mHdr);
+        LoraTag tag;
+        tag.SetDataRate(0);
+        tag.SetFrequency(868100000);
+        tag.SetReceivePower(-70);
+        tag.WriteTo(packet);
+
+        UplinkContext uplink(packet, gwAddress);
+        NS_TEST_EXPECT_MSG_EQ(unsigned(uplink.macHeader.GetFType()),
+                              unsigned(LorawanMacHeader::UNCONFIRMED_DATA_UP),
+                              "Wrong frame type in the context");
+        NS_TEST_EXPECT_MSG_EQ(uplink.frameHeader.GetFCnt(), fCnt, "Wrong FCnt in the context");
+        NS_TEST_EXPECT_MSG_EQ(bool(uplink.frameHeader.FindMacCommand<LinkCheckReq>()),
+                              (fCnt == nUplinks - 1),
+                              "Wrong MAC commands in the context");
+        NS_TEST_EXPECT_MSG_EQ(uplink.tag.GetReceivePower(), -70, "Wrong tag in the context");
+
+        uplink.gwId = networkStatus->GetGatewayId(gwAddress);
+        uplink.status = networkStatus->GetEndDeviceStatus(address);
+        NS_TEST_ASSERT_MSG_NE(uplink.status, nullptr, "Device status not found");
+        networkStatus->OnReceivedPacket(uplink);
+        linkCheck->OnReceivedPacket(uplink, networkStatus);
+        adr->OnReceivedPacket(uplink, networkStatus);
+    }
+
+    Ptr<EndDeviceStatus> edStatus = networkStatus->GetEndDeviceStatus(address);
+    NS_TEST_EXPECT_MSG_EQ(edStatus->GetNReceivedPackets(), nUplinks, "Wrong history size");
+    linkCheck->BeforeSendingReply(edStatus, networkStatus);
+    adr->BeforeSendingReply(edStatus, networkStatus);
+    NS_TEST_EXPECT_MSG_EQ(edStatus->NeedsReply(), true, "No reply scheduled");
+
+    const LoraFrameHeader& reply = edStatus->m_reply.frameHeader;
+    const LinkCheckAns* linkCheckAns = reply.FindMacCommand<LinkCheckAns>();
+    NS_TEST_ASSERT_MSG_NE(linkCheckAns, nullptr, "No LinkCheckAns in the reply");
+    NS_TEST_EXPECT_MSG_EQ(unsigned(linkCheckAns->GetGwCnt()), 1, "Wrong gateway count");
+    const LinkAdrReq* linkAdrReq = reply.FindMacCommand<LinkAdrReq>();
+    NS_TEST_ASSERT_MSG_NE(linkAdrReq, nullptr, "No LinkAdrReq in the reply");
+    NS_TEST_EXPECT_MSG_GT(unsigned(linkAdrReq->GetDataRate()), 0, "Data rate was not increased");
+
+    linkCheck->Dispose();
+    adr->Dispose();
+    networkStatus->Dispose();
+}
+
+/*********************
+ * PacketTrackerTest *
+ *********************/
+
+class PacketTrackerTest : public TestCase
+{
+  public:
+    PacketTrackerTest();
+    ~PacketTrackerTest() override;
+
+  private:
+    void DoRun() override;
+};
+
+// Add some help text to this case to describe what it is intended to test
+PacketTrackerTest::PacketTrackerTest()
+    : TestCase("Verify that counting windows of the packet tracker follow packet outcomes")
+{
+}
+
+// Reminder that the test case should clean up after itself
+PacketTrackerTest::~PacketTrackerTest()
+{
+}
+
+// This method is the pure virtual method from class TestCase that every
+// TestCase must implement
+void
+PacketTrackerTest::DoRun()
+{
+    NS_LOG_DEBUG("PacketTrackerTest");
+
+    auto uplink = []() {
+        Ptr<Packet> packet = Create<Packet>(10);
+        LorawanMacHeader mHdr;
+        mHdr.SetFType(LorawanMacHeader::UNCONFIRMED_DATA_UP);
+        packet->AddHeader(mHdr);
+        return packet;
+    };
+
+    LoraPacketTracker tracker;
+    Ptr<Packet> old = uplink();
+    tracker.TransmissionCallback(old, 0);
+    tracker.MacTransmissionCallback(old);
+    uint32_t window = tracker.OpenCountingWindow();
+    // Outcomes of packets sent before the window are not counted
+    tracker.PacketReceptionCallback(old, 10);
+    tracker.MacGwReceptionCallback(old);
+
+    Ptr<Packet> p1 = uplink();
+    tracker.TransmissionCallback(p1, 0);
+    tracker.MacTransmissionCallback(p1);
+    tracker.UnderSensitivityCallback(p1, 10);
+    tracker.InterferenceCallback(p1, 11);
+    tracker.InterferenceCallback(p1, 11); // Only the first outcome is kept
+    Ptr<Packet> p2 = uplink();
+    tracker.TransmissionCallback(p2, 1);
+    tracker.LostBecauseTxCallback(p2, 10);
+    tracker.PacketReceptionCallback(p2, 11);
+    tracker.MacTransmissionCallback(p2);
+    tracker.MacGwReceptionCallback(p2);
+    tracker.MacGwReceptionCallback(p2);
+
+    NS_TEST_EXPECT_MSG_EQ(tracker.PrintPhyPacketsGlobally(window),
+                          "2 1 1 0 0 0",
+                          "Wrong global counts");
+    GwsPhyPktPrint gws;
+    GwsPhyPktCount gwsCount;
+    tracker.PrintPhyPacketsAllGws(window, gws);
+    NS_TEST_EXPECT_MSG_EQ(gws[10].s, "2 0 0 0 1 1", "Wrong counts at gateway 10");
+    NS_TEST_EXPECT_MSG_EQ(gws[11].s, "2 1 1 0 0 0", "Wrong counts at gateway 11");
+    DevPktCount devices;
+    tracker.CountAllDevicesPackets(window, devices);
+    NS_TEST_EXPECT_MSG_EQ(devices.size(), 1, "Wrong number of devices");
+    NS_TEST_EXPECT_MSG_EQ(devices.begin()->second.sent, 2, "Wrong number of sent packets");
+    NS_TEST_EXPECT_MSG_EQ(devices.begin()->second.received, 1, "Wrong number of received packets");
+
+    tracker.ResetCountingWindow(window);
+    tracker.InterferenceCallback(p2, 12);
+    NS_TEST_EXPECT_MSG_EQ(tracker.PrintPhyPacketsGlobally(window),
+                          "0 0 0 0 0 0",
+                          "Window was not reset");
+    tracker.PrintPhyPacketsAllGws(window, gws);
+    NS_TEST_EXPECT_MSG_EQ(gws.empty(), true, "Window was not reset");
+
+    // Binary log of packet events
+    std::string filename = CreateTempDirFilename("packets.bin");
+    {
+        LoraPacketTracker logger;
+        logger.EnableBinaryLog(filename, false);
+        logger.TransmissionCallback(p1, 0);
+        logger.InterferenceCallback(p1, 10);
+        logger.PacketReceptionCallback(p1, 11);
+    }
+    LoraPacketLogReader reader(filename);
+    NS_TEST_EXPECT_MSG_EQ(reader.GetNRecords(), 3, "Wrong number of records");
+    NS_TEST_EXPECT_MSG_EQ(reader.PrintPhyPacketsGlobally(Seconds(0), Seconds(1)),
+                          "1 1 0 0 0 0",
+                          "Wrong global counts from the log");
+    reader.CountPhyPacketsAllGws(Seconds(0), Seconds(1), gwsCount);
+    NS_TEST_EXPECT_MSG_EQ(gwsCount[10].v[2], 1, "Wrong counts at gateway 10 from the log");
+}
+
+/*****************
+ * PacketLogTest *
+ *****************/
+
+class PacketLogTest : public TestCase
+{
+  public:
+    PacketLogTest();
+    ~PacketLogTest() override;
+
+  private:
+    void DoRun() override;
+};
+
+// Add some help text to this case to describe what it is intended to test
+PacketLogTest::PacketLogTest()
+    : TestCase("Verify that packet log reports match the tracker with retransmissions")
+{
+}
+
+// Reminder that the test case should clean up after itself
+PacketLogTest::~PacketLogTest()
+{
+}
+
+// This method is the pure virtual method from class TestCase that every
+// TestCase must implement
+void
+PacketLogTest::DoRun()
+{
+    NS_LOG_DEBUG("PacketLogTest");
+
+    std::string filename = CreateTempDirFilename("retransmissions.bin");
+    Time stop = Seconds(300);
+    std::string phyGlobal;
+    GwsPhyPktCount phyGws;
+    DevPktCount devices;
+    std::string macGlobal;
+    std::string macCpsr;
+    std::vector<int> phyGw;
+    std::string statistics;
+    {
+        auto loss = CreateObject<LogDistancePropagationLossModel>();
+        auto delay = CreateObject<ConstantSpeedPropagationDelayModel>();
+        auto channel = CreateObject<LoraChannel>(loss, delay);
+        MobilityHelper mobility;
+        auto allocator = CreateObject<ListPositionAllocator>();
+        allocator->Add(Vector(0, 0, 15));
+        allocator->Add(Vector(100, 0, 1));
+        allocator->Add(Vector(-100, 0, 1));
+        mobility.SetPositionAllocator(allocator);
+        mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+        NodeContainer gateways;
+        gateways.Create(1);
+        mobility.Install(gateways);
+        NodeContainer endDevices;
+        endDevices.Create(2);
+        mobility.Install(endDevices);
+
+        LoraPhyHelper phyHelper;
+        phyHelper.SetChannel(channel);
+        LorawanMacHelper macHelper;
+        LorawanHelper helper;
+        helper.EnablePacketTracking();
+        helper.GetPacketTracker().EnableBinaryLog(filename, true);
+        phyHelper.SetType("ns3::GatewayLoraPhy");
+        macHelper.SetType("ns3::GatewayLorawanMac");
+        helper.Install(phyHelper, macHelper, gateways);
+        phyHelper.SetType("ns3::EndDeviceLoraPhy");
+        macHelper.SetType("ns3::ClassAEndDeviceLorawanMac");
+        NetDeviceContainer devs = helper.Install(phyHelper, macHelper, endDevices);
+
+        // Confirmed uplinks are never acknowledged without a network server
+        for (uint32_t i = 0; i < devs.GetN(); i++)
+        {
+            auto mac = DynamicCast<BaseEndDeviceLorawanMac>(
+                DynamicCast<LoraNetDevice>(devs.Get(i))->GetMac());
+            mac->SetFType(LorawanMacHeader::CONFIRMED_DATA_UP);
+            mac->SetNumberOfTransmissions(3);
+            mac->SetDataRate(5);
+            Simulator::Schedule(Seconds(1 + 10 * i), &LorawanMac::Send, mac, Create<Packet>(10));
+            Simulator::Schedule(Seconds(100 + 10 * i), &LorawanMac::Send, mac, Create<Packet>(10));
+        }
+        Simulator::Stop(stop);
+        Simulator::Run();
+        statistics = helper.GetPacketTracker().PrintSimulationStatistics();
+        Simulator::Destroy();
+
+        LoraPacketTracker& tracker = helper.GetPacketTracker();
+        phyGlobal = tracker.PrintPhyPacketsGlobally(Seconds(0), stop);
+        tracker.CountPhyPacketsAllGws(Seconds(0), stop, phyGws);
+        tracker.CountAllDevicesPackets(Seconds(0), stop, devices);
+        macGlobal = tracker.CountMacPacketsGlobally(Seconds(0), stop);
+        macCpsr = tracker.CountMacPacketsGloballyCpsr(Seconds(0), stop);
+        phyGw = tracker.CountPhyPacketsPerGw(Seconds(0), stop, gateways.Get(0)->GetId());
+    } // The log is written when the tracker is destroyed
+
+    // Each transmission of the 4 confirmed uplinks is counted, with one
+    // outcome at the gateway
+    NS_TEST_EXPECT_MSG_EQ(phyGlobal.substr(0, 3), "12 ", "Wrong number of PHY transmissions");
+    NS_TEST_ASSERT_MSG_EQ(phyGw.size(), 6, "Wrong number of PHY counts of the gateway");
+    NS_TEST_EXPECT_MSG_EQ(phyGw[0], 12, "Wrong number of PHY transmissions at the gateway");
+    NS_TEST_EXPECT_MSG_EQ(phyGw[1] + phyGw[2] + phyGw[3] + phyGw[4] + phyGw[5],
+                          12,
+                          "Wrong number of PHY outcomes at the gateway");
+    NS_TEST_EXPECT_MSG_NE(statistics.find("(12 sent, "),
+                          std::string::npos,
+                          "Wrong number of PHY transmissions in statistics");
+    NS_TEST_EXPECT_MSG_EQ(macGlobal, "4 4", "Wrong number of MAC packets");
+
+    LoraPacketLogReader reader(filename);
+    NS_TEST_EXPECT_MSG_EQ(reader.PrintPhyPacketsGlobally(Seconds(0), stop),
+                          phyGlobal,
+                          "Global PHY counts of the log differ from the tracker");
+    GwsPhyPktCount logGws;
+    reader.CountPhyPacketsAllGws(Seconds(0), stop, logGws);
+    NS_TEST_ASSERT_MSG_EQ(logGws.size(), phyGws.size(), "Wrong number of gateways in the log");
+    for (const auto& gw : phyGws)
+    {
+        NS_TEST_EXPECT_MSG_EQ((logGws[gw.first].v == gw.second.v),
+                              true,
+                              "PHY counts of the log differ at gateway " << gw.first);
+    }
+    DevPktCount logDevices;
+    reader.CountAllDevicesPackets(Seconds(0), stop, logDevices);
+    NS_TEST_ASSERT_MSG_EQ(logDevices.size(), devices.size(), "Wrong number of devices in the log");
+    for (const auto& device : devices)
+    {
+        NS_TEST_EXPECT_MSG_EQ(logDevices[device.first].sent,
+                              device.second.sent,
+                              "Sent packets of the log differ for device " << device.first);
+        NS_TEST_EXPECT_MSG_EQ(logDevices[device.first].received,
+                              device.second.received,
+                              "Received packets of the log differ for device " << device.first);
+    }
+    NS_TEST_EXPECT_MSG_EQ(reader.CountMacPacketsGlobally(Seconds(0), stop),
+                          macGlobal,
+                          "Global MAC counts of the log differ from the tracker");
+    NS_TEST_EXPECT_MSG_EQ(reader.CountMacPacketsGloballyCpsr(Seconds(0), stop),
+                          macCpsr,
+                          "CPSR counts of the log differ from the tracker");
+}
+
+/******************
+ * PopulationTest *
+ ******************/
+
+class PopulationTest : public TestCase
+{
+  public:
+    PopulationTest();
+    ~PopulationTest() override;
+    void StartSending(Ptr<const Packet> packet, uint32_t id);
+    void ReceivedPacket(Ptr<const Packet> packet, uint32_t node);
+
+  private:
+    void DoRun() override;
+
+    int m_sent = 0;
+    int m_received = 0;
+    std::vector<uint32_t> m_ids;
+    Ptr<Packet> m_latestReceivedPacket;
+};
+
+// Add some help text to this case to describe what it is intended to test
+PopulationTest::PopulationTest()
+    : TestCase("Verify that uplinks of a compact device population reach gateways")
+{
+}
+
+// Reminder that the test case should clean up after itself
+PopulationTest::~PopulationTest()
+{
+}
+
+void
+PopulationTest::StartSending(Ptr<const Packet> packet, uint32_t id)
+{
+    NS_LOG_FUNCTION(packet << id);
+
+    m_sent++;
+    m_ids.push_back(id);
+}
+
+void
+PopulationTest::ReceivedPacket(Ptr<const Packet> packet, uint32_t node)
+{
+    NS_LOG_FUNCTION(packet << node);
+
+    m_received++;
+    m_latestReceivedPacket = packet->Copy();
+}
+
+// This method is the pure virtual method from class TestCase that every
+// TestCase must implement
+void
+PopulationTest::DoRun()
+{
+    NS_LOG_DEBUG("PopulationTest");
+
+    auto loss = CreateObject<LogDistancePropagationLossModel>();
+    loss->SetPathLossExponent(3.76);
+    loss->SetReference(1, 7.7);
+    auto delay = CreateObject<ConstantSpeedPropagationDelayModel>();
+    auto channel = CreateObject<LoraChannel>(loss, delay);
+
+    auto gwPhy = CreateObject<GatewayLoraPhy>();
+    auto gwMob = CreateObject<ConstantPositionMobilityModel>();
+    gwMob->SetPosition(Vector(0, 0, 0));
+    gwPhy->SetMobility(gwMob);
+    gwPhy->SetChannel(channel);
+    gwPhy->TraceConnectWithoutContext("ReceivedPacket",
+                                      MakeCallback(&PopulationTest::ReceivedPacket, this));
+    gwPhy->Initialize();
+
+    auto population = CreateObject<LoraDevicePopulation>();
+    population->SetAttribute("FirstId", UintegerValue(100));
+    population->SetChannel(channel);
+    population->AddDevice(Vector(100, 0, 0), LoraDeviceAddress(1), 5, Seconds(10));
+    population->AddDevice(Vector(0, 100, 0), LoraDeviceAddress(2), 5, Seconds(10));
+    // The period of DR0 uplinks is stretched by the duty cycle
+    population->AddDevice(Vector(0, 0, 100), LoraDeviceAddress(3), 0, Seconds(10));
+    population->TraceConnectWithoutContext("StartSending",
+                                           MakeCallback(&PopulationTest::StartSending, this));
+    population->Start(Seconds(0));
+
+    // By default, ids of devices follow the ones of existing nodes
+    NodeContainer nodes;
+    nodes.Create(2);
+    uint32_t firstId = NodeList::GetNNodes();
+    auto other = CreateObject<LoraDevicePopulation>();
+    other->SetChannel(channel);
+    other->AddDevice(Vector(-100, 0, 0), LoraDeviceAddress(4), 5, Seconds(10));
+    other->TraceConnectWithoutContext("StartSending",
+                                      MakeCallback(&PopulationTest::StartSending, this));
+    other->Start(Seconds(0));
+
+    Simulator::Stop(Seconds(100));
+    Simulator::Run();
+    Simulator::Destroy();
+
+    NS_TEST_EXPECT_MSG_EQ(population->GetFCnt(0), 10, "Wrong number of uplinks of device 0");
+    NS_TEST_EXPECT_MSG_EQ(population->GetFCnt(1), 10, "Wrong number of uplinks of device 1");
+    NS_TEST_EXPECT_MSG_LT(population->GetFCnt(2), 3, "Duty cycle was not respected");
+    NS_TEST_EXPECT_MSG_EQ(m_sent,
+                          30 + population->GetFCnt(2),
+                          "Wrong number of uplinks in traces");
+    NS_TEST_EXPECT_MSG_EQ(std::count(m_ids.begin(), m_ids.end(), firstId),
+                          10,
+                          "Wrong default trace id");
+    NS_TEST_EXPECT_MSG_EQ(std::count_if(m_ids.begin(),
+                                        m_ids.end(),
+                                        [](uint32_t id) { return id >= 100 && id < 103; }),
+                          20 + population->GetFCnt(2),
+                          "Wrong trace id");
+    NS_TEST_EXPECT_MSG_EQ(population->GetPosition(2),
+                          Vector(0, 0, 100),
+                          "Devices share a position");
+    NS_TEST_EXPECT_MSG_GT(m_received, 0, "No uplink reached the gateway");
+
+    // The gateway receives a regular LoRaWAN frame
+    LorawanMacHeader mHdr;
+    m_latestReceivedPacket->RemoveHeader(mHdr);
+    NS_TEST_EXPECT_MSG_EQ(unsigned(mHdr.GetFType()),
+                          unsigned(LorawanMacHeader::UNCONFIRMED_DATA_UP),
+                          "Wrong frame type");
+    LoraFrameHeader fHdr;
+    fHdr.SetAsUplink();
+    m_latestReceivedPacket->RemoveHeader(fHdr);
+    NS_TEST_EXPECT_MSG_LT(fHdr.GetAddress().Get() - 1, 3, "Wrong device address");
+    NS_TEST_EXPECT_MSG_EQ(m_latestReceivedPacket->GetSize(), 10 + 4, "Wrong payload size");
+}
+
+/**********************
+ * ShadowingFieldTest *
+ **********************/
+
+class ShadowingFieldTest : public TestCase
+{
+  public:
+    ShadowingFieldTest();
+    ~ShadowingFieldTest() override;
+
+  private:
+    void DoRun() override;
+};
+
+// Add some help text to this case to describe what it is intended to test
+ShadowingFieldTest::ShadowingFieldTest()
+    : TestCase("Verify that shadowing fields are reproducible and can be saved and loaded")
+{
+}
+
+// Reminder that the test case should clean up after itself
+ShadowingFieldTest::~ShadowingFieldTest()
+{
+}
+
+// This method is the pure virtual method from class TestCase that every
+// TestCase must implement
+void
+ShadowingFieldTest::DoRun()
+{
+    NS_LOG_DEBUG("ShadowingFieldTest");
+
+    Box box(-1000, 1000, -500, 500, 0, 0);
+    auto field = CreateObject<ShadowingFieldPropagationLossModel>();
+    field->AssignStreams(1);
+    field->Generate(box);
+    auto same = CreateObject<ShadowingFieldPropagationLossModel>();
+    same->AssignStreams(1);
+    same->Generate(box);
+
+    double sum = 0;
+    double squares = 0;
+    int n = 0;
+    for (double x = -1000; x <= 1000; x += 10)
+    {
+        for (double y = -500; y <= 500; y += 10)
+        {
+            double value = field->GetValue(Vector(x, y, 0));
+            NS_TEST_ASSERT_MSG_EQ(value, same->GetValue(Vector(x, y, 0)), "Field not reproducible");
+            sum += value;
+            squares += value * value;
+            n++;
+        }
+    }
+    NS_TEST_EXPECT_MSG_EQ_TOL(sum / n, 0, 1, "Wrong mean of the field");
+    NS_TEST_EXPECT_MSG_EQ_TOL(std::sqrt(squares / n), 4, 1, "Wrong deviation of the field");
+
+    // The loss is the same in both directions
+    auto a = CreateObject<ConstantPositionMobilityModel>();
+    a->SetPosition(Vector(3, 4, 0));
+    auto b = CreateObject<ConstantPositionMobilityModel>();
+    b->SetPosition(Vector(300, -40, 0));
+    NS_TEST_EXPECT_MSG_EQ(field->CalcRxPower(14, a, b),
+                          field->CalcRxPower(14, b, a),
+                          "Shadowing is not symmetric");
+
+    std::string filename = CreateTempDirFilename("shadowing.bin");
+    field->Save(filename);
+    auto loaded = CreateObject<ShadowingFieldPropagationLossModel>();
+    loaded->Load(filename);
+    for (double x = -1100; x <= 1100; x += 7.3)
+    {
+        Vector position(x, x / 3, 0);
+        NS_TEST_ASSERT_MSG_EQ(loaded->GetValue(position),
+                              field->GetValue(position),
+                              "Loaded field differs");
+    }
+}
+
+/***************
+ * TerrainTest *
+ ***************/
+
+class TerrainTest : public TestCase
+{
+  public:
+    TerrainTest();
+    ~TerrainTest() override;
+
+  private:
+    void DoRun() override;
+};
+
+// Add some help text to this case to describe what it is intended to test
+TerrainTest::TerrainTest()
+    : TestCase("Verify that terrain rasters are read correctly and obstruct links")
+{
+}
+
+// Reminder that the test case should clean up after itself
+TerrainTest::~TerrainTest()
+{
+}
+
+// This method is the pure virtual method from class TestCase that every
+// TestCase must implement
+void
+TerrainTest::DoRun()
+{
+    NS_LOG_DEBUG("TerrainTest");
+
+    // Flat ground at 100 m with a 60 m high ridge around x = 5000 m, and
+    // urban land cover (class 3) for x < 1000 m
+    uint32_t nx = 1001;
+    uint32_t ny = 101;
+    std::vector<float> elevation(nx * ny);
+    std::vector<float> landCover(nx * ny);
+    for (uint32_t i = 0; i < ny; ++i)
+    {
+        for (uint32_t j = 0; j < nx; ++j)
+        {
+            elevation[i * nx + j] = (std::abs(int(j) - 500) < 5) ? 160 : 100;
+            landCover[i * nx + j] = (j < 100) ? 3 : 1;
+        }
+    }
+    std::string dem = CreateTempDirFilename("dem.bin");
+    std::string clutter = CreateTempDirFilename("clutter.bin");
+    TerrainRaster::Write(dem, TerrainRaster::FLOAT32, nx, ny, 0, 0, 10, elevation, 64);
+    TerrainRaster::Write(clutter, TerrainRaster::UINT8, nx, ny, 0, 0, 10, landCover, 64);
+
+    TerrainRaster raster(dem, 2);
+    for (uint32_t j = 0; j < nx; j += 7)
+    {
+        uint32_t i = (j * 13) % ny;
+        NS_TEST_ASSERT_MSG_EQ(raster.Interpolate(j * 10, i * 10),
+                              elevation[i * nx + j],
+                              "Wrong raster value");
+    }
+    NS_TEST_EXPECT_MSG_EQ(raster.GetNLoadedTiles(), 2, "Too many loaded tiles");
+
+    // Lines are sampled as positions are interpolated, also beyond the edges
+    std::vector<double> line(97);
+    raster.SampleLine(-100, 30, 10100, 870, line);
+    for (std::size_t k = 0; k < line.size(); ++k)
+    {
+        double x = -100 + k * (10100 + 100.0) / (line.size() - 1);
+        double y = 30 + k * (870 - 30.0) / (line.size() - 1);
+        NS_TEST_ASSERT_MSG_EQ_TOL(line[k],
+                                  raster.Interpolate(x, y),
+                                  1e-9,
+                                  "Wrong sample " << k << " of the line");
+    }
+
+    // Classes out of range are clamped
+    std::string classes = CreateTempDirFilename("classes.bin");
+    TerrainRaster::Write(classes, TerrainRaster::UINT8, 2, 2, 0, 0, 1, {-5, 300, 7.5, 255}, 2);
+    TerrainRaster classRaster(classes);
+    NS_TEST_EXPECT_MSG_EQ(classRaster.GetNearest(0, 0), 0, "Negative class not clamped");
+    NS_TEST_EXPECT_MSG_EQ(classRaster.GetNearest(1, 0), 255, "Large class not clamped");
+    NS_TEST_EXPECT_MSG_EQ(classRaster.GetNearest(0, 1), 7, "Class not truncated");
+
+    auto terrain = CreateObject<TerrainPropagationLossModel>();
+    terrain->SetElevationRaster(dem);
+    terrain->SetLandCoverRaster(clutter);
+    terrain->SetClutterLoss(3, 12);
+    Vector device(500, 500, 1.5);
+    double clear = terrain->GetDiffractionLoss(device, Vector(4000, 500, 30));
+    double obstructed = terrain->GetDiffractionLoss(device, Vector(9000, 500, 30));
+    NS_TEST_EXPECT_MSG_GT(obstructed, clear + 10, "The ridge does not obstruct the link");
+    NS_TEST_EXPECT_MSG_EQ_TOL(terrain->GetDiffractionLoss(Vector(9000, 500, 30), device),
+                              obstructed,
+                              1e-9,
+                              "Diffraction is not symmetric");
+
+    auto a = CreateObject<ConstantPositionMobilityModel>();
+    a->SetPosition(device);
+    auto b = CreateObject<ConstantPositionMobilityModel>();
+    b->SetPosition(Vector(4000, 500, 30));
+    NS_TEST_EXPECT_MSG_EQ_TOL(14 - terrain->CalcRxPower(14, a, b),
+                              clear + 12,
+                              1e-9,
+                              "Wrong clutter loss");
+}
+
+/******************
+ * LazyEnergyTest *
+ ******************/
+
+class LazyEnergyTest : public TestCase
+{
+  public:
+    LazyEnergyTest();
+    ~LazyEnergyTest() override;
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Record the time of the first depletion of a source.
+     *
+     * \param time The time to set.
+     */
+    static void RecordDepletion(Time* time);
+};
+
+// Add some help text to this case to describe what it is intended to test
+LazyEnergyTest::LazyEnergyTest()
+    : TestCase("Verify that lazy energy accounting matches eager accounting")
+{
+}
+
+// Reminder that the test case should clean up after itself
+LazyEnergyTest::~LazyEnergyTest()
+{
+}
+
+void
+LazyEnergyTest::RecordDepletion(Time* time)
+{
+    if (*time == Time::Max())
+    {
+        *time = Simulator::Now();
+    }
+}
+
+// This method is the pure virtual method from class TestCase that every
+// TestCase must implement
+void
+LazyEnergyTest::DoRun()
+{
+    NS_LOG_DEBUG("LazyEnergyTest");
+
+    // The same radio activity, every 10 seconds, with eager and lazy accounting
+    std::vector<Ptr<BasicEnergySource>> sources;
+    std::vector<Ptr<LoraRadioEnergyModel>> models;
+    std::vector<Time> depletion(2, Time::Max());
+    for (bool lazy : {false, true})
+    {
+        auto source = CreateObject<BasicEnergySource>();
+        source->SetAttribute("BasicEnergySourceInitialEnergyJ", DoubleValue(5));
+        source->SetAttribute("BasicEnergySupplyVoltageV", DoubleValue(3.3));
+        if (lazy)
+        {
+            source->SetAttribute("PeriodicEnergyUpdateInterval", TimeValue(Hours(1000)));
+        }
+        auto model = CreateObject<LoraRadioEnergyModel>();
+        model->SetAttribute("LazyAccounting", BooleanValue(lazy));
+        model->SetEnergySource(source);
+        model->SetEnergyDepletionCallback(
+            MakeBoundCallback(&LazyEnergyTest::RecordDepletion, &depletion[lazy]));
+        source->AppendDeviceEnergyModel(model);
+        for (int k = 0; k < 100; ++k)
+        {
+            Time start = Seconds(10 * k);
+            Simulator::Schedule(start + Seconds(1),
+                                &LoraRadioEnergyModel::ChangeState,
+                                model,
+                                EndDeviceLoraPhy::TX);
+            Simulator::Schedule(start + Seconds(2),
+                                &LoraRadioEnergyModel::ChangeState,
+                                model,
+                                EndDeviceLoraPhy::STANDBY);
+            Simulator::Schedule(start + Seconds(3),
+                                &LoraRadioEnergyModel::ChangeState,
+                                model,
+                                EndDeviceLoraPhy::RX);
+            Simulator::Schedule(start + Seconds(3.5),
+                                &LoraRadioEnergyModel::ChangeState,
+                                model,
+                                EndDeviceLoraPhy::SLEEP);
+        }
+        sources.push_back(source);
+        models.push_back(model);
+    }
+
+    // About 0.1156 J are consumed per period
+    Simulator::Stop(Seconds(205));
+    Simulator::Run();
+    // Querying the current does not settle the charge given to the source
+    double currentA = models[1]->GetCurrentA();
+    NS_TEST_EXPECT_MSG_EQ(models[1]->GetCurrentA(), currentA, "Querying the current changed it");
+    NS_TEST_EXPECT_MSG_EQ_TOL(models[1]->GetTotalEnergyConsumption(),
+                              models[0]->GetTotalEnergyConsumption(),
+                              1e-9,
+                              "Wrong lazy energy consumption");
+    NS_TEST_EXPECT_MSG_EQ_TOL(sources[1]->GetRemainingEnergy(),
+                              sources[0]->GetRemainingEnergy(),
+                              1e-9,
+                              "Wrong remaining energy of the lazy source");
+
+    // Sources are depleted at 10% of their energy, after about 383 s
+    Simulator::Stop(Seconds(395));
+    Simulator::Run();
+    NS_TEST_ASSERT_MSG_NE(depletion[0], Time::Max(), "The eager source was not depleted");
+    NS_TEST_ASSERT_MSG_NE(depletion[1], Time::Max(), "The lazy source was not depleted");
+    NS_TEST_EXPECT_MSG_EQ_TOL(depletion[1].GetSeconds(),
+                              depletion[0].GetSeconds(),
+                              10,
+                              "Depletion of the lazy source was detected too late");
+    Simulator::Destroy();
+}
+
+/*****************
+ * SchedulerTest *
+ *****************/
+
+class SchedulerTest : public TestCase
+{
+  public:
+    SchedulerTest();
+    ~SchedulerTest() override;
+
+  private:
+    void DoRun() override;
+};
+
+// Add some help text to this case to describe what it is intended to test
+SchedulerTest::SchedulerTest()
+    : TestCase("Verify that the ladder scheduler orders events like the map scheduler")
+{
+}
+
+// Reminder that the test case should clean up after itself
+SchedulerTest::~SchedulerTest()
+{
+}
+
+// This method is the pure virtual method from class TestCase that every
+// TestCase must implement
+void
+SchedulerTest::DoRun()
+{
+    NS_LOG_DEBUG("SchedulerTest");
+
+    // Far future events, mostly rescheduled in the near future, with some
+    // removals and some events at the same time
+    std::string filename = CreateTempDirFilename("events.bin");
+    auto ladder = CreateObject<EventTraceScheduler>();
+    ladder->SetAttribute("Filename", StringValue(filename));
+    ladder->SetAttribute("SchedulerType", StringValue("ns3::LadderScheduler"));
+    auto map = CreateObject<MapScheduler>();
+    auto rng = CreateObject<UniformRandomVariable>();
+    std::vector<Scheduler::Event> events;
+    uint32_t uid = 0;
+    auto insert = [&](uint64_t ts) {
+        Scheduler::Event ev;
+        ev.impl = nullptr;
+        ev.key.m_ts = ts;
+        ev.key.m_uid = uid++;
+        ev.key.m_context = 0;
+        ladder->Insert(ev);
+        map->Insert(ev);
+        events.push_back(ev);
+    };
+    for (int i = 0; i < 2000; ++i)
+    {
+        insert(uint64_t(rng->GetValue(0, 1e12)));
+    }
+    uint32_t removed = 0;
+    while (!map->IsEmpty())
+    {
+        NS_TEST_ASSERT_MSG_EQ(ladder->PeekNext().key.m_uid,
+                              map->PeekNext().key.m_uid,
+                              "Wrong next event");
+        Scheduler::Event ev = ladder->RemoveNext();
+        NS_TEST_ASSERT_MSG_EQ(ev.key.m_uid, map->RemoveNext().key.m_uid, "Wrong removed event");
+        if (uid < 20000)
+        {
+            uint64_t now = ev.key.m_ts;
+            insert(now + uint64_t(rng->GetValue(0, 2e9)) * (rng->GetValue() < 0.8));
+            if (rng->GetValue() < 0.2)
+            {
+                insert(now + uint64_t(1e12));
+            }
+        }
+        // Remove a pending event
+        if (uid % 7 == 0 && !events.empty())
+        {
+            uint32_t k = rng->GetInteger(0, events.size() - 1);
+            Scheduler::Event other = events[k];
+            if (ev.key < other.key)
+            {
+                events[k] = events.back();
+                events.pop_back();
+                ladder->Remove(other);
+                map->Remove(other);
+                ++removed;
+            }
+        }
+        NS_TEST_ASSERT_MSG_EQ(ladder->IsEmpty(), map->IsEmpty(), "Wrong emptiness");
+    }
+    NS_TEST_EXPECT_MSG_GT(removed, 0, "No event was removed");
+
+    // Every operation was recorded
+    ladder = nullptr;
+    auto records = EventTraceScheduler::Read(filename);
+    NS_TEST_EXPECT_MSG_EQ(records.size(), 2 * uid, "Wrong number of recorded operations");
+}
+
+/********************
+ * TrafficTraceTest *
+ ********************/
+
+class TrafficTraceTest : public TestCase
+{
+  public:
+    TrafficTraceTest();
+    ~TrafficTraceTest() override;
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Replay a trace to devices 0 and 1, stopping device 1 after 25 seconds.
+     *
+     * \param filename The name of the trace.
+     * \param readAhead The number of records read ahead.
+     */
+    void Replay(const std::string& filename, uint32_t readAhead);
+
+    /**
+     * Keep a record handed by the trace.
+     *
+     * \param record The record.
+     */
+    void Receive(const TrafficTrace::Record& record);
+
+    std::vector<TrafficTrace::Record> m_received; //!< Records handed by the trace
+};
+
+// Add some help text to this case to describe what it is intended to test
+TrafficTraceTest::TrafficTraceTest()
+    : TestCase("Verify that traffic traces are replayed to registered devices in time")
+{
+}
+
+// Reminder that the test case should clean up after itself
+TrafficTraceTest::~TrafficTraceTest()
+{
+}
+
+void
+TrafficTraceTest::Replay(const std::string& filename, uint32_t readAhead)
+{
+    m_received.clear();
+    auto trace = CreateObject<TrafficTrace>();
+    trace->SetAttribute("Filename", StringValue(filename));
+    trace->SetAttribute("ReadAhead", UintegerValue(readAhead));
+    trace->Register(0, MakeCallback(&TrafficTraceTest::Receive, this));
+    trace->Register(1, MakeCallback(&TrafficTraceTest::Receive, this));
+    Simulator::Schedule(Seconds(25), &TrafficTrace::Unregister, trace, 1);
+    Simulator::Run();
+    Simulator::Destroy();
+    trace->Dispose();
+}
+
+void
+TrafficTraceTest::Receive(const TrafficTrace::Record& record)
+{
+    NS_TEST_EXPECT_MSG_EQ(record.time, Simulator::Now(), "Record handed at the wrong time");
+    m_received.push_back(record);
+}
+
+// This method is the pure virtual method from class TestCase that every
+// TestCase must implement
+void
+TrafficTraceTest::DoRun()
+{
+    NS_LOG_DEBUG("TrafficTraceTest");
+
+    std::string csv = CreateTempDirFilename("traffic.csv");
+    {
+        std::ofstream file(csv);
+        file << "time,device,size,fport,payload\n"
+             << "# Device 2 is not registered, device 1 stops at 25 s\n"
+             << "5,0,3\n"
+             << "10.5,1,2,10,abcd\n"
+             << "12,2,4\n"
+             << "20,0x0,1,,ff\n"
+             << "30,1,5\n"
+             << "40,0,10,2\n";
+    }
+    std::string binary = CreateTempDirFilename("traffic.bin");
+    NS_TEST_EXPECT_MSG_EQ(TrafficTrace::Convert(csv, binary), 6, "Wrong number of records");
+
+    for (const auto& filename : {csv, binary})
+    {
+        for (uint32_t readAhead : {1, 1024})
+        {
+            Replay(filename, readAhead);
+            NS_TEST_ASSERT_MSG_EQ(m_received.size(), 4, "Wrong number of records handed");
+            NS_TEST_EXPECT_MSG_EQ(m_received[0].time, Seconds(5), "Wrong time");
+            NS_TEST_EXPECT_MSG_EQ(m_received[0].size, 3, "Wrong size");
+            NS_TEST_EXPECT_MSG_EQ(m_received[0].payload.empty(), true, "Unexpected payload");
+            NS_TEST_EXPECT_MSG_EQ(m_received[1].device, 1, "Wrong device");
+            NS_TEST_EXPECT_MSG_EQ(m_received[1].fPort, 10, "Wrong frame port");
+            NS_TEST_ASSERT_MSG_EQ(m_received[1].payload.size(), 2, "Wrong payload size");
+            NS_TEST_EXPECT_MSG_EQ(m_received[1].payload[1], 0xcd, "Wrong payload");
+            NS_TEST_EXPECT_MSG_EQ(m_received[2].fPort, 0, "Unexpected frame port");
+            NS_TEST_EXPECT_MSG_EQ(m_received[3].time, Seconds(40), "Wrong time");
+        }
+    }
+}
+
+/***************
+ * LoraTagTest *
+ ***************/
+
+class LoraTagTest : public TestCase
+{
+  public:
+    LoraTagTest();
+    ~LoraTagTest() override;
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Count the packet tags of a packet.
+     *
+     * \param packet The packet.
+     * \return The number of tags.
+     */
+    uint32_t CountTags(Ptr<const Packet> packet);
+};
+
+// Add some help text to this case to describe what it is intended to test
+LoraTagTest::LoraTagTest()
+    : TestCase("Verify that LoraTags are updated in place in packets")
+{
+}
+
+// Reminder that the test case should clean up after itself
+LoraTagTest::~LoraTagTest()
+{
+}
+
+uint32_t
+LoraTagTest::CountTags(Ptr<const Packet> packet)
+{
+    uint32_t n = 0;
+    for (auto it = packet->GetPacketTagIterator(); it.HasNext(); it.Next())
+    {
+        ++n;
+    }
+    return n;
+}
+
+// This method is the pure virtual method from class TestCase that every
+// TestCase must implement
+void
+LoraTagTest::DoRun()
+{
+    NS_LOG_DEBUG("LoraTagTest");
+
+    // The tag is added to packets without one
+    Ptr<Packet> packet = Create<Packet>(10);
+    LoraTag tag;
+    tag.SetDataRate(5);
+    tag.WriteTo(packet);
+    NS_TEST_EXPECT_MSG_EQ(CountTags(packet), 1, "Tag not added");
+
+    // The tag is updated in place
+    LoraTag read;
+    packet->PeekPacketTag(read);
+    read.SetFrequency(868100000);
+    read.WriteTo(packet);
+    NS_TEST_EXPECT_MSG_EQ(CountTags(packet), 1, "Tag added twice");
+    packet->PeekPacketTag(read);
+    NS_TEST_EXPECT_MSG_EQ(unsigned(read.GetDataRate()), 5, "Data rate lost");
+    NS_TEST_EXPECT_MSG_EQ(read.GetFrequency(), 868100000, "Frequency not updated");
+
+    // Copies sharing the tag are not modified
+    Ptr<Packet> copy = packet->Copy();
+    read.SetSnr(-5);
+    read.WriteTo(copy);
+    packet->PeekPacketTag(read);
+    NS_TEST_EXPECT_MSG_EQ(read.GetSnr(), 0, "Original packet modified");
+    copy->PeekPacketTag(read);
+    NS_TEST_EXPECT_MSG_EQ(read.GetSnr(), -5, "Copy not updated");
+}
+
+/***********************
+ * AsyncFileWriterTest *
+ ***********************/
+
+class AsyncFileWriterTest : public TestCase
+{
+  public:
+    AsyncFileWriterTest();
+    ~AsyncFileWriterTest() override;
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Read the lines of a file.
+     *
+     * \param filename The name of the file.
+     * \return The lines of the file.
+     */
+    std::vector<std::string> ReadLines(const std::string& filename);
+};
+
+// Add some help text to this case to describe what it is intended to test
+AsyncFileWriterTest::AsyncFileWriterTest()
+    : TestCase("Verify that files are written in order by the background writer and printers")
+{
+}
+
+// Reminder that the test case should clean up after itself
+AsyncFileWriterTest::~AsyncFileWriterTest()
+{
+}
+
+std::vector<std::string>
+AsyncFileWriterTest::ReadLines(const std::string& filename)
+{
+    std::vector<std::string> lines;
+    std::ifstream file(filename);
+    for (std::string line; std::getline(file, line);)
+    {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+// This method is the pure virtual method from class TestCase that every
+// TestCase must implement
+void
+AsyncFileWriterTest::DoRun()
+{
+    NS_LOG_DEBUG("AsyncFileWriterTest");
+
+    // With a small queue, Write waits for the thread instead of losing blocks
+    std::string first = CreateTempDirFilename("first.txt");
+    std::string second = CreateTempDirFilename("second.txt");
+    AsyncFileWriter writer(first, false, 16);
+    for (int i = 0; i < 1000; ++i)
+    {
+        writer.Write(std::to_string(i) + "\n");
+    }
+    writer.Rotate(second);
+    for (int i = 0; i < 10; ++i)
+    {
+        writer.Write(std::to_string(i) + "\n");
+    }
+    writer.Flush();
+    auto lines = ReadLines(first);
+    NS_TEST_ASSERT_MSG_EQ(lines.size(), 1000, "Blocks lost before rotation");
+    for (int i = 0; i < 1000; ++i)
+    {
+        NS_TEST_EXPECT_MSG_EQ(lines[i], std::to_string(i), "Blocks written out of order");
+    }
+    writer.Close();
+    NS_TEST_EXPECT_MSG_EQ(writer.IsOpen(), false, "Writer not closed");
+    NS_TEST_EXPECT_MSG_EQ(ReadLines(second).size(), 10, "Blocks lost after rotation");
+
+    // Periodic prints are written at Simulator::Destroy, while the helper lives
+    std::string devices = CreateTempDirFilename("devices.txt");
+    std::string global = CreateTempDirFilename("global.txt");
+    auto loss = CreateObject<LogDistancePropagationLossModel>();
+    auto delay = CreateObject<ConstantSpeedPropagationDelayModel>();
+    auto channel = CreateObject<LoraChannel>(loss, delay);
+    MobilityHelper mobility;
+    auto allocator = CreateObject<ListPositionAllocator>();
+    allocator->Add(Vector(0, 0, 15));
+    allocator->Add(Vector(100, 0, 1));
+    allocator->Add(Vector(-100, 0, 1));
+    mobility.SetPositionAllocator(allocator);
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    NodeContainer gateways;
+    gateways.Create(1);
+    mobility.Install(gateways);
+    NodeContainer endDevices;
+    endDevices.Create(2);
+    mobility.Install(endDevices);
+
+    LoraPhyHelper phyHelper;
+    phyHelper.SetChannel(channel);
+    LorawanMacHelper macHelper;
+    LorawanHelper helper;
+    helper.EnablePacketTracking();
+    phyHelper.SetType("ns3::GatewayLoraPhy");
+    macHelper.SetType("ns3::GatewayLorawanMac");
+    helper.Install(phyHelper, macHelper, gateways);
+    phyHelper.SetType("ns3::EndDeviceLoraPhy");
+    macHelper.SetType("ns3::ClassAEndDeviceLorawanMac");
+    helper.Install(phyHelper, macHelper, endDevices);
+    OneShotSenderHelper appHelper;
+    appHelper.SetSendTime(Seconds(1));
+    appHelper.Install(endDevices);
+
+    // Two printers share the file, each reporting about its own devices
+    helper.EnablePeriodicDeviceStatusPrinting(endDevices, gateways, devices, Seconds(10));
+    helper.EnablePeriodicDeviceStatusPrinting(NodeContainer(endDevices.Get(1)),
+                                              gateways,
+                                              devices,
+                                              Seconds(10));
+    helper.EnablePeriodicGlobalPerformancePrinting(global, Seconds(10));
+    Simulator::Stop(Seconds(25));
+    Simulator::Run();
+    Simulator::Destroy();
+
+    // Prints at 0, 10 and 20 seconds
+    NS_TEST_EXPECT_MSG_EQ(ReadLines(global).size(), 3, "Wrong number of global prints");
+    std::map<std::string, int> perDevice;
+    for (const auto& line : ReadLines(devices))
+    {
+        std::istringstream fields(line);
+        std::string time;
+        std::string id;
+        fields >> time >> id;
+        perDevice[id]++;
+    }
+    NS_TEST_EXPECT_MSG_EQ(perDevice[std::to_string(endDevices.Get(0)->GetId())],
+                          3,
+                          "Wrong number of prints of the first device");
+    NS_TEST_EXPECT_MSG_EQ(perDevice[std::to_string(endDevices.Get(1)->GetId())],
+                          6,
+                          "Wrong number of prints of the second device");
+}
+
+/*********************
+ * PcapngCaptureTest *
+ *********************/
+
+class PcapngCaptureTest : public TestCase
+{
+  public:
+    PcapngCaptureTest();
+    ~PcapngCaptureTest() override;
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Check the blocks of a file of the capture.
+     *
+     * \param filename The name of the file.
+     * \param interface The interface of the only frame of the file.
+     * \param time The time of the frame.
+     * \param size The size of the frame, without the LoRaTap header.
+     */
+    void CheckFile(const std::string& filename, uint32_t interface, Time time, uint32_t size);
+};
+
+// Add some help text to this case to describe what it is intended to test
+PcapngCaptureTest::PcapngCaptureTest()
+    : TestCase("Verify the blocks of pcapng captures")
+{
+}
+
+// Reminder that the test case should clean up after itself
+PcapngCaptureTest::~PcapngCaptureTest()
+{
+}
+
+void
+PcapngCaptureTest::CheckFile(const std::string& filename,
+                             uint32_t interface,
+                             Time time,
+                             uint32_t size)
+{
+    std::ifstream file(filename, std::ios::binary);
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    auto read = [&data](std::size_t offset, uint32_t bytes) {
+        uint64_t value = 0;
+        for (uint32_t i = 0; i < bytes && offset + i < data.size(); ++i)
+        {
+            value |= uint64_t(uint8_t(data[offset + i])) << (8 * i);
+        }
+        return value;
+    };
+
+    // Section header block
+    NS_TEST_ASSERT_MSG_EQ(data.size() >= 28, true, "File " << filename << " too short");
+    NS_TEST_EXPECT_MSG_EQ(read(0, 4), 0x0a0d0d0a, "Wrong section header block type");
+    NS_TEST_EXPECT_MSG_EQ(read(4, 4), 28, "Wrong section header block length");
+    NS_TEST_EXPECT_MSG_EQ(read(8, 4), 0x1a2b3c4d, "Wrong byte order magic");
+    NS_TEST_EXPECT_MSG_EQ(read(12, 2), 1, "Wrong major version");
+    NS_TEST_EXPECT_MSG_EQ(read(24, 4), 28, "Wrong trailing section header block length");
+
+    // Interface description blocks, with their names
+    std::size_t offset = 28;
+    std::vector<std::string> names = {"first", "second"};
+    for (const auto& name : names)
+    {
+        uint32_t length = read(offset + 4, 4);
+        NS_TEST_EXPECT_MSG_EQ(read(offset, 4), 1, "Wrong interface description block type");
+        NS_TEST_EXPECT_MSG_EQ(read(offset + 8, 2),
+                              PcapHelper::DLT_LORATAP,
+                              "Wrong link type");
+        NS_TEST_EXPECT_MSG_EQ(read(offset + 16, 2), 2, "Missing interface name option");
+        NS_TEST_EXPECT_MSG_EQ(data.substr(offset + 20, read(offset + 18, 2)),
+                              name,
+                              "Wrong interface name");
+        NS_TEST_EXPECT_MSG_EQ(read(offset + length - 4, 4),
+                              length,
+                              "Wrong trailing interface description block length");
+        offset += length;
+    }
+
+    // Enhanced packet block
+    uint32_t length = read(offset + 4, 4);
+    uint32_t captured = LoratapHeader().GetSerializedSize() + size;
+    NS_TEST_EXPECT_MSG_EQ(read(offset, 4), 6, "Wrong enhanced packet block type");
+    NS_TEST_EXPECT_MSG_EQ(read(offset + 8, 4), interface, "Wrong interface of the frame");
+    uint64_t timestamp = (read(offset + 12, 4) << 32) | read(offset + 16, 4);
+    NS_TEST_EXPECT_MSG_EQ(timestamp, time.GetNanoSeconds(), "Wrong timestamp of the frame");
+    NS_TEST_EXPECT_MSG_EQ(read(offset + 20, 4), captured, "Wrong captured length");
+    NS_TEST_EXPECT_MSG_EQ(read(offset + 24, 4), captured, "Wrong original length");
+    NS_TEST_EXPECT_MSG_EQ(length, 32 + captured + (4 - captured % 4) % 4, "Wrong block length");
+    NS_TEST_EXPECT_MSG_EQ(read(offset + length - 4, 4),
+                          length,
+                          "Wrong trailing enhanced packet block length");
+    NS_TEST_EXPECT_MSG_EQ(offset + length, data.size(), "Unexpected data after the frame");
+}
+
+// This method is the pure virtual method from class TestCase that every
+// TestCase must implement
+void
+PcapngCaptureTest::DoRun()
+{
+    NS_LOG_DEBUG("PcapngCaptureTest");
+
+    // Files are rotated after a second, and completed at Simulator::Destroy
+    std::string prefix = CreateTempDirFilename("capture");
+    auto capture = Create<LoraPcapngCapture>(prefix, 0, Seconds(1.5));
+    capture->AddInterface("first");
+    capture->AddInterface("second");
+    Simulator::Schedule(Seconds(1), &LoraPcapngCapture::Write, capture, 0, Create<Packet>(10));
+    Simulator::Schedule(Seconds(3), &LoraPcapngCapture::Write, capture, 1, Create<Packet>(21));
+    Simulator::Run();
+    Simulator::Destroy();
+
+    CheckFile(prefix + "-0.pcapng", 0, Seconds(1), 10);
+    CheckFile(prefix + "-1.pcapng", 1, Seconds(3), 21);
+}
+
+/*************************
+ * PositionAllocatorTest *
+ *************************/
+
+class PositionAllocatorTest : public TestCase
+{
+  public:
+    PositionAllocatorTest();
+    ~PositionAllocatorTest() override;
+
+  private:
+    void DoRun() override;
+};
+
+// Add some help text to this case to describe what it is intended to test
+PositionAllocatorTest::PositionAllocatorTest()
+    : TestCase("Verify in-range position sampling and the indices of hexagonal grid positions")
+{
+}
+
+// Reminder that the test case should clean up after itself
+PositionAllocatorTest::~PositionAllocatorTest()
+{
+}
+
+// This method is the pure virtual method from class TestCase that every
+// TestCase must implement
+void
+PositionAllocatorTest::DoRun()
+{
+    NS_LOG_DEBUG("PositionAllocatorTest");
+
+    // Two overlapping coverage discs
+    double range = 1000;
+    double d = 500;
+    NodeContainer nodes;
+    nodes.Create(2);
+    MobilityHelper mobility;
+    auto nodePositions = CreateObject<ListPositionAllocator>();
+    nodePositions->Add(Vector(0, 0, 0));
+    nodePositions->Add(Vector(d, 0, 0));
+    mobility.SetPositionAllocator(nodePositions);
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mobility.Install(nodes);
+
+    auto allocator = CreateObject<RangePositionAllocator>();
+    allocator->SetNodes(nodes);
+    allocator->SetRange(range);
+    allocator->SetRho(1e6);
+    allocator->AssignStreams(1);
+
+    // Positions are uniform over the union of discs: the share of the ones in
+    // range of both nodes is the area of the lens over the area of the union
+    int n = 4000;
+    int inBoth = 0;
+    for (int k = 0; k < n; ++k)
+    {
+        Vector position = allocator->GetNext();
+        double d0 = CalculateDistance(position, Vector(0, 0, 0));
+        double d1 = CalculateDistance(position, Vector(d, 0, 0));
+        NS_TEST_ASSERT_MSG_EQ((std::min(d0, d1) <= range), true, "Position out of range");
+        NS_TEST_ASSERT_MSG_EQ((std::min(d0, d1) > 1), true, "Position too close to a node");
+        inBoth += (d0 <= range && d1 <= range);
+    }
+    double lens = 2 * range * range * std::acos(d / (2 * range)) -
+                  d / 2 * std::sqrt(4 * range * range - d * d);
+    double expected = lens / (2 * M_PI * range * range - lens);
+    NS_TEST_EXPECT_MSG_EQ_TOL(double(inBoth) / n,
+                              expected,
+                              0.04,
+                              "Positions are not uniform over the union of discs");
+
+    // Positions stay in the allocation disc
+    allocator->SetX(1000);
+    allocator->SetRho(200);
+    for (int k = 0; k < 100; ++k)
+    {
+        Vector position = allocator->GetNext();
+        NS_TEST_ASSERT_MSG_EQ((std::hypot(position.x - 1000, position.y) <= 200),
+                              true,
+                              "Position out of the allocation disc");
+    }
+
+    // Grid positions, and points closer to them than to others, have the
+    // allocation order of the position as index
+    double distance = 3000;
+    auto grid = CreateObject<HexGridPositionAllocator>();
+    grid->SetDistance(distance);
+    for (uint32_t k = 0; k < 61; ++k)
+    {
+        Vector position = grid->GetNext();
+        NS_TEST_EXPECT_MSG_EQ(grid->GetIndex(position), k, "Wrong index of grid position");
+        double angle = k * 0.7;
+        Vector nearby(position.x + 0.4 * distance * std::cos(angle),
+                      position.y + 0.4 * distance * std::sin(angle),
+                      0);
+        NS_TEST_EXPECT_MSG_EQ(grid->GetIndex(nearby), k, "Wrong index of nearby point");
+    }
 }
 
 /**************
@@ -1799,6 +3595,20 @@ LorawanTestSuite::LorawanTestSuite()
     AddTestCase(new TimeOnAirTest, Duration::QUICK);
     AddTestCase(new PhyConnectivityTest, Duration::QUICK);
     AddTestCase(new LorawanMacTest, Duration::QUICK);
+    AddTestCase(new CryptoTest, Duration::QUICK);
+    AddTestCase(new UplinkContextTest, Duration::QUICK);
+    AddTestCase(new PacketTrackerTest, Duration::QUICK);
+    AddTestCase(new PacketLogTest, Duration::QUICK);
+    AddTestCase(new PopulationTest, Duration::QUICK);
+    AddTestCase(new ShadowingFieldTest, Duration::QUICK);
+    AddTestCase(new TerrainTest, Duration::QUICK);
+    AddTestCase(new LazyEnergyTest, Duration::QUICK);
+    AddTestCase(new SchedulerTest, Duration::QUICK);
+    AddTestCase(new TrafficTraceTest, Duration::QUICK);
+    AddTestCase(new LoraTagTest, Duration::QUICK);
+    AddTestCase(new AsyncFileWriterTest, Duration::QUICK);
+    AddTestCase(new PcapngCaptureTest, Duration::QUICK);
+    AddTestCase(new PositionAllocatorTest, Duration::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
@@ -16,7 +16,11 @@
 
 #include "ns3/end-device-status.h"
 #include "ns3/log.h"
+#include "ns3/lora-phy.h"
+#include "ns3/lora-tag.h"
+#include "ns3/mac48-address.h"
 #include "ns3/network-status.h"
+#include "ns3/uinteger.h"
 
 // An essential include is test.h
 #include "ns3/test.h"
@@ -60,6 +64,103 @@ EndDeviceStatusTest::DoRun()
 
     // Create an EndDeviceStatus object
     EndDeviceStatus eds = EndDeviceStatus();
+
+    // Bounded history of received packets
+    auto status = CreateObject<EndDeviceStatus>();
+    status->SetAttribute("HistorySize", UintegerValue(3));
+    Address gw0 = Mac48Address("00:00:00:00:00:01");
+    Address gw1 = Mac48Address("00:00:00:00:00:02");
+    auto receive = [&status](uint16_t fCnt, Address gw) {
+        Ptr<Packet> packet = Create<Packet>(10);
+        LoraFrameHeader fHdr;
+        fHdr.SetAsUplink();
+        fHdr.SetFCnt(fCnt);
+        fHdr.SetAdr(true);
+        packet->AddHeader(fHdr);
+        LorawanMacHeader mHdr;
+        mHdr.SetFType(LorawanMacHeader::UNCONFIRMED_DATA_UP);
+        packet->AddHeader(mHdr);
+        LoraTag tag;
+        tag.SetFrequency(868100000);
+        packet->AddPacketTag(tag);
+        status->InsertReceivedPacket(packet, gw);
+    };
+    for (uint16_t fCnt = 0; fCnt < 5; fCnt++)
+    {
+        receive(fCnt, gw0);
+    }
+    receive(4, gw1); // Same packet received by another gateway
+    receive(2, gw1); // Old packet still in the history
+
+    NS_TEST_EXPECT_MSG_EQ(status->GetNReceivedPackets(), 3, "History is not bounded");
+    const auto& last = status->GetLastReceivedPacketInfo();
+    NS_TEST_EXPECT_MSG_EQ(last.fCnt, 4, "Wrong last received packet");
+    NS_TEST_EXPECT_MSG_EQ(last.adr, true, "ADR bit not parsed");
+    NS_TEST_EXPECT_MSG_EQ(last.gwList.size(), 2, "Gateway not added to the same packet");
+    NS_TEST_EXPECT_MSG_EQ(status->GetReceivedPacketInfo(2).fCnt, 2, "Wrong history order");
+    NS_TEST_EXPECT_MSG_EQ(status->GetReceivedPacketInfo(2).gwList.size(),
+                          2,
+                          "Gateway not added to an old packet");
+
+    // Ranking of the gateways that received the last packet
+    auto rank = [&status](uint16_t fCnt, uint32_t gwId, double rxPower) {
+        Ptr<Packet> packet = Create<Packet>(10);
+        LoraFrameHeader fHdr;
+        fHdr.SetAsUplink();
+        fHdr.SetFCnt(fCnt);
+        packet->AddHeader(fHdr);
+        packet->AddHeader(LorawanMacHeader());
+        LoraTag tag;
+        tag.SetFrequency(868100000);
+        tag.SetReceivePower(rxPower);
+        packet->AddPacketTag(tag);
+        UplinkContext uplink(packet, Mac48Address::Allocate());
+        uplink.gwId = gwId;
+        status->InsertReceivedPacket(uplink);
+    };
+    rank(10, 0, -120);
+    rank(10, 1, -100);
+    rank(10, 2, -110);
+    rank(10, 1, -100); // Duplicate copy from the same gateway
+    NS_TEST_EXPECT_MSG_EQ(unsigned(status->GetNRankedGateways()), 3, "Wrong ranking size");
+    NS_TEST_EXPECT_MSG_EQ(status->GetRankedGateway(0).gwId, 1, "Wrong best gateway");
+    NS_TEST_EXPECT_MSG_EQ(status->GetRankedGateway(2).gwId, 0, "Wrong worst gateway");
+    for (uint32_t gwId = 3; gwId < 3 + EndDeviceStatus::MAX_RANKED_GATEWAYS; gwId++)
+    {
+        rank(10, gwId, -130);
+    }
+    NS_TEST_EXPECT_MSG_EQ(unsigned(status->GetNRankedGateways()),
+                          unsigned(EndDeviceStatus::MAX_RANKED_GATEWAYS),
+                          "Ranking is not bounded");
+    NS_TEST_EXPECT_MSG_EQ(status->GetRankedGateway(2).gwId, 0, "Best gateways were dropped");
+    rank(11, 5, -125); // New packet
+    NS_TEST_EXPECT_MSG_EQ(unsigned(status->GetNRankedGateways()), 1, "Ranking not reset");
+
+    // Windowed SNR statistics
+    status = CreateObject<EndDeviceStatus>();
+    rank(0, 0, -100);
+    rank(0, 1, -110);
+    auto stats = status->GetSnrStatistics(EndDeviceStatus::AVERAGE, 2);
+    NS_TEST_EXPECT_MSG_EQ(stats.count, 1, "Wrong number of packets");
+    NS_TEST_EXPECT_MSG_EQ_TOL(stats.max, LoraPhy::RxPowerToSNR(-105), 1e-9, "Not averaged");
+    rank(1, 0, -120);
+    rank(2, 0, -90);
+    rank(3, 0, -95);
+    stats = status->GetSnrStatistics(EndDeviceStatus::AVERAGE, 2);
+    NS_TEST_EXPECT_MSG_EQ(stats.count, 2, "Window is not bounded");
+    NS_TEST_EXPECT_MSG_EQ_TOL(stats.min, LoraPhy::RxPowerToSNR(-95), 1e-9, "Wrong minimum");
+    NS_TEST_EXPECT_MSG_EQ_TOL(stats.max, LoraPhy::RxPowerToSNR(-90), 1e-9, "Wrong maximum");
+    stats = status->GetSnrStatistics(EndDeviceStatus::MINIMUM, 10);
+    NS_TEST_EXPECT_MSG_EQ(stats.count, 4, "Window not filled from the history");
+    NS_TEST_EXPECT_MSG_EQ_TOL(stats.min, LoraPhy::RxPowerToSNR(-120), 1e-9, "Wrong minimum");
+    rank(3, 1, -80); // Late copy of the last packet
+    stats = status->GetSnrStatistics(EndDeviceStatus::MINIMUM, 10);
+    NS_TEST_EXPECT_MSG_EQ_TOL(stats.max, LoraPhy::RxPowerToSNR(-90), 1e-9, "Wrong maximum");
+    stats = status->GetSnrStatistics(EndDeviceStatus::MAXIMUM, 2);
+    NS_TEST_EXPECT_MSG_EQ_TOL(stats.average,
+                              (LoraPhy::RxPowerToSNR(-90) + LoraPhy::RxPowerToSNR(-80)) / 2,
+                              1e-9,
+                              "Wrong average");
 }
 
 /////////////////////////////
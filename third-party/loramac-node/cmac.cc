@@ -32,6 +32,7 @@ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
 DEALINGS WITH THE SOFTWARE
 
 *****************************************************************************/
+#include <stddef.h>
 #include <stdint.h>
 #include "aes.h"
 #include "cmac.h"
@@ -152,3 +153,75 @@ void AES_CMAC_Final( uint8_t digest[AES_CMAC_DIGEST_LENGTH], AES_CMAC_CTX* ctx )
     aes_encrypt( in, digest, &ctx->rijndael );
     memset1( K, 0, sizeof K );
 }
+
+void AES_CMAC_PrepareKey( AES_CMAC_KEY_CTX* kctx, const uint8_t key[AES_CMAC_KEY_LENGTH] )
+{
+    memset1( kctx->rijndael.ksch, '\0', 240 );
+    aes_set_key( key, AES_CMAC_KEY_LENGTH, &kctx->rijndael );
+
+    /* generate subkeys K1 and K2 once for all messages using this key */
+    memset1( kctx->K1, '\0', 16 );
+    aes_encrypt( kctx->K1, kctx->K1, &kctx->rijndael );
+    if( kctx->K1[0] & 0x80 )
+    {
+        LSHIFT( kctx->K1, kctx->K1 );
+        kctx->K1[15] ^= 0x87;
+    }
+    else
+        LSHIFT( kctx->K1, kctx->K1 );
+
+    if( kctx->K1[0] & 0x80 )
+    {
+        LSHIFT( kctx->K1, kctx->K2 );
+        kctx->K2[15] ^= 0x87;
+    }
+    else
+        LSHIFT( kctx->K1, kctx->K2 );
+}
+
+void AES_CMAC_Compute( const AES_CMAC_KEY_CTX* kctx, const uint8_t prefix[16], const uint8_t* data,
+                       uint32_t len, uint8_t digest[AES_CMAC_DIGEST_LENGTH] )
+{
+    uint8_t  X[16];
+    uint8_t  M[16];
+    uint32_t pLen  = ( prefix != NULL ) ? 16 : 0;
+    uint32_t total = pLen + len;
+    /* the empty message still needs one (padded) block */
+    uint32_t nBlocks = ( total == 0 ) ? 1 : ( total + 15 ) / 16;
+    uint32_t b, i;
+
+    memset1( X, 0, 16 );
+    for( b = 0; b < nBlocks; b++ )
+    {
+        /* block number b of the virtual message (prefix | data) */
+        uint32_t start = b * 16;
+        uint32_t mlen  = MIN( 16, total - start );
+        for( i = 0; i < mlen; i++ )
+        {
+            uint32_t pos = start + i;
+            M[i]         = ( pos < pLen ) ? prefix[pos] : data[pos - pLen];
+        }
+
+        if( b == nBlocks - 1 )
+        {
+            if( mlen == 16 )
+            {
+                /* last block was a complete block */
+                XOR( kctx->K1, M );
+            }
+            else
+            {
+                /* padding(M_last) */
+                M[mlen] = 0x80;
+                while( ++mlen < 16 )
+                    M[mlen] = 0;
+                XOR( kctx->K2, M );
+            }
+        }
+        XOR( M, X );
+        aes_encrypt( X, X, &kctx->rijndael );
+    }
+
+    memcpy1( digest, X, 16 );
+    memset1( M, 0, sizeof M );
+}
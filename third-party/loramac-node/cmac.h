@@ -63,6 +63,27 @@ void     AES_CMAC_Final(uint8_t digest[AES_CMAC_DIGEST_LENGTH], AES_CMAC_CTX  *
             //     __attribute__((__bounded__(__minbytes__,1,AES_CMAC_DIGEST_LENGTH)));
 //__END_DECLS
 
+/*
+ * Pre-expanded key material: AES key schedule and the two CMAC subkeys.
+ * Can be computed once per key and shared by any number of messages.
+ */
+typedef struct _AES_CMAC_KEY_CTX {
+            aes_context    rijndael;
+            uint8_t        K1[16];
+            uint8_t        K2[16];
+    } AES_CMAC_KEY_CTX;
+
+void     AES_CMAC_PrepareKey(AES_CMAC_KEY_CTX * kctx, const uint8_t key[AES_CMAC_KEY_LENGTH]);
+
+/*
+ * CMAC of the message (prefix | data) with pre-expanded key material. The
+ * prefix is an optional 16 bytes block (e.g., the LoRaWAN B0 block), set it
+ * to NULL when not used.
+ */
+void     AES_CMAC_Compute(const AES_CMAC_KEY_CTX * kctx, const uint8_t prefix[16],
+                          const uint8_t * data, uint32_t len,
+                          uint8_t digest[AES_CMAC_DIGEST_LENGTH]);
+
 #ifdef __cplusplus
 }
 #endif